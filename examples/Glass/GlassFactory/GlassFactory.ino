@@ -18,8 +18,6 @@
  */
 #include <LilyGo_Wristband.h>
 #include <LV_Helper.h>
-#include <MadgwickAHRS.h>       //MadgwickAHRS from https://github.com/arduino-libraries/MadgwickAHRS
-#include <cbuf.h>
 #include <WiFi.h>
 #include <esp_sntp.h>
 
@@ -65,14 +63,11 @@ static lv_obj_t *day_label;
 static lv_obj_t *week_label;
 static lv_obj_t *month_label;
 static bool colon;
-static cbuf accel_data_buffer(1);
-static cbuf gyro_data_buffer(1);
 
 static lv_timer_t *noise_timer;
 static lv_timer_t *sensor_timer;
 static lv_timer_t *datetime_timer;
 
-Madgwick filter;
 LilyGo_Button bootPin;
 
 //! You can use EspTouch to configure the network key without changing the WiFi password below
@@ -107,8 +102,6 @@ const char *month_char[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Au
 
 static void lv_gui_init();
 static void lv_gui_select_next_item();
-static void gyro_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len);
-static void accel_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len);
 static void WiFiEvent(WiFiEvent_t event);
 static void timeavailable(struct timeval *t);
 
@@ -201,25 +194,9 @@ void setup()
     amoled.initMicrophone();
 
     // Initialize Sensor
-    accel_data_buffer.resize(sizeof(struct bhy2_data_xyz) * 2);
-    gyro_data_buffer.resize(sizeof(struct bhy2_data_xyz) * 2);
-
-    // initialize variables to pace updates to correct rate
-    filter.begin(100);
-
-    float sample_rate = 100.0;      /* Read out hintr_ctrl measured at 100Hz */
-    uint32_t report_latency_ms = 0; /* Report immediately */
-
-    // Enable acceleration
-    amoled.configure(SENSOR_ID_ACC_PASS, sample_rate, report_latency_ms);
-    // Enable gyroscope
-    amoled.configure(SENSOR_ID_GYRO_PASS, sample_rate, report_latency_ms);
-
-    // Set the acceleration sensor result callback function
-    amoled.onResultEvent(SENSOR_ID_ACC_PASS, accel_process_callback);
-
-    // Set the gyroscope sensor result callback function
-    amoled.onResultEvent(SENSOR_ID_GYRO_PASS, gyro_process_callback);
+    // The BHI260AP fuses accelerometer and gyroscope itself and reports a quaternion at 100Hz.
+    // ORIENTATION_HOST fuses the raw samples on the ESP32 instead
+    amoled.beginOrientation(ORIENTATION_GAME_RV, 100);
 
 
 // The esp_vad function is currently only reserved for Arduino version 2.0.9
@@ -372,29 +349,10 @@ static void lv_tileview_add_sensor(lv_obj_t *parent)
 
         float roll, pitch, heading;
 
-        // Read data from buffer
-        struct bhy2_data_xyz gyr;
-        gyro_data_buffer.read(( char *)&gyr, sizeof(gyr));
-
-        struct bhy2_data_xyz acc;
-        accel_data_buffer.read(( char *)&acc, sizeof(acc));
-
-        float accel_scaling_factor = get_sensor_default_scaling(BHY2_SENSOR_ID_ACC_PASS);
-        float gyro_scaling_factor = get_sensor_default_scaling(BHY2_SENSOR_ID_GYRO_PASS);
-
-        // update the filter, which computes orientation
-        filter.updateIMU(gyr.x * gyro_scaling_factor,
-                         gyr.y * gyro_scaling_factor,
-                         gyr.z * gyro_scaling_factor,
-                         acc.x * accel_scaling_factor,
-                         acc.y * accel_scaling_factor,
-                         acc.z * accel_scaling_factor
-                        );
-
-        // get the heading, pitch and roll
-        roll = filter.getRoll();
-        pitch = filter.getPitch();
-        heading = filter.getYaw();
+        // get the heading, pitch and roll of the latest fused sample
+        roll = amoled.orientation().getRoll();
+        pitch = amoled.orientation().getPitch();
+        heading = amoled.orientation().getYaw();
 
         lv_label_set_text_fmt(label, "Roll:\n\t% 3.2f\nPitch:\n\t% 3.2f\nHeading:\n\t% 3.2f\n", roll, pitch, heading);
 
@@ -728,38 +686,6 @@ static void lv_gui_init()
 #endif  //Version check
 }
 
-static void accel_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
-{
-    struct bhy2_data_xyz data;
-    bhy2_parse_xyz(data_ptr, &data);
-
-    // float scaling_factor = get_sensor_default_scaling(sensor_id);
-    // Serial.print(amoled.getSensorName(sensor_id));
-    // Serial.print(":");
-    // Serial.printf("x: %f, y: %f, z: %f;\r\n",
-    //               data.x * scaling_factor,
-    //               data.y * scaling_factor,
-    //               data.z * scaling_factor
-    //  );
-    accel_data_buffer.write((const char *)&data, sizeof(data));
-}
-
-
-static void gyro_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
-{
-    struct bhy2_data_xyz data;
-    bhy2_parse_xyz(data_ptr, &data);
-    // float scaling_factor = get_sensor_default_scaling(sensor_id);
-    // Serial.print(amoled.getSensorName(sensor_id));
-    // Serial.print(":");
-    // Serial.printf("x: %f, y: %f, z: %f;\r\n",
-    //               data.x * scaling_factor,
-    //               data.y * scaling_factor,
-    //               data.z * scaling_factor
-    //              );
-    gyro_data_buffer.write((const char *)&data, sizeof(data));
-}
-
 static void WiFiEvent(WiFiEvent_t event)
 {
     Serial.printf("[WiFi-event] event: %d\n", event);
@@ -0,0 +1,125 @@
+/**
+ * @file      GlassHeadPose.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      A marker that stays put in front of the wearer while the head turns. The pose
+ *            comes from the head tracker module of the BHI260AP firmware and is predicted
+ *            to the time the frame reaches the panel. The default firmware image has no
+ *            head tracker, give a head orientation build to setSensorFlashFirmware() before
+ *            begin(). Long press the touch button, look straight ahead and nod a few times
+ *            to calibrate how the glasses sit on the head
+ */
+#include <LilyGo_Wristband.h>
+#include <LV_Helper.h>
+#include <headPose.h>
+
+// Marker travel per degree of head motion
+#define PIXELS_PER_DEGREE               3
+
+LilyGo_Class amoled;
+HeadPose head;
+
+lv_obj_t *marker;
+lv_obj_t *label;
+uint32_t report_ms = 0;
+
+void button_event_callback(ButtonState state)
+{
+    if (state == BTN_LONG_PRESSED_EVENT && head.calibrate()) {
+        Serial.println("Look straight ahead and nod");
+        lv_label_set_text(label, "Nod");
+    }
+}
+
+void setup()
+{
+    // Turn on debugging message output, Arduino IDE users please put
+    // Tools -> USB CDC On Boot -> Enable, otherwise there will be no output
+    Serial.begin(115200);
+
+    // Initialization screen and peripherals
+    bool rslt = amoled.begin();
+    if (!rslt) {
+        while (1) {
+            Serial.println("The board model cannot be detected, please raise the Core Debug Level to an error");
+            delay(1000);
+        }
+    }
+
+    // Using glasses requires setting the screen to flip vertically
+    amoled.flipHorizontal(true);
+
+    // Brightness range : 0 ~ 255
+    amoled.setBrightness(255);
+
+    // The displayable area of Glass is 126x126, which requires an offset of 168 pixels.
+    // Only the viewport is rendered and sent to the screen
+    amoled.setViewport(GLASS_VIEWPORT_X, GLASS_VIEWPORT_Y, GLASS_VIEWPORT_WIDTH, GLASS_VIEWPORT_HEIGHT);
+
+    // Initialize lvgl with the asynchronous flush, a frame counts as shown once its
+    // transfer is done
+    beginLvglHelper(amoled, false, true);
+    setLvglHelperFrameCallback(HeadPose::onFrameDone, &head);
+
+    amoled.setEventCallback(button_event_callback);
+
+    // Set the page to all black
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
+    lv_obj_clear_flag(lv_scr_act(), LV_OBJ_FLAG_SCROLLABLE);
+
+    marker = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(marker, 12, 12);
+    lv_obj_set_style_radius(marker, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_bg_color(marker, lv_palette_main(LV_PALETTE_GREEN), 0);
+    lv_obj_set_style_border_width(marker, 0, 0);
+    lv_obj_center(marker);
+
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, 0);
+
+    // The head orientation and the gyroscope at 200Hz, facing forward now
+    if (!head.begin(amoled, 200, true)) {
+        Serial.println("The BHI260AP firmware has no head tracker module");
+        lv_label_set_text(label, "No head tracker");
+        return;
+    }
+    lv_label_set_text(label, head.isCalibrated() ? "" : "Hold to calibrate");
+}
+
+void loop()
+{
+    // Update 6-axis sensor and button state
+    amoled.update();
+
+    // The pose the wearer will have when this frame is on the panel. The marker moves
+    // against the head, so it stays where it was in the world
+    float q[4];
+    if (head.predict(q)) {
+        float yaw = atan2f(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3])) * RAD_TO_DEG;
+        float pitch = asinf(constrain(2 * (q[0] * q[2] - q[3] * q[1]), -1.0f, 1.0f)) * RAD_TO_DEG;
+        lv_obj_align(marker, LV_ALIGN_CENTER, yaw * PIXELS_PER_DEGREE, pitch * PIXELS_PER_DEGREE);
+    }
+
+    if (millis() > report_ms) {
+        report_ms = millis() + 1000;
+        head_pose_latency_t latency;
+        head.getLatency(latency);
+        if (latency.frames) {
+            Serial.printf("Motion to photon over %u frames: mean %llu us, p50 %u us, p95 %u us, max %u us, photon delay %u us\n",
+                          latency.frames, latency.total_us / latency.frames,
+                          HeadPose::getPercentile(latency, 50), HeadPose::getPercentile(latency, 95),
+                          latency.max_us, head.getPhotonDelayUs());
+        }
+        if (head.isCalibrated() && !head.isCalibrating()) {
+            lv_label_set_text(label, "");
+        }
+    }
+
+    // lvgl task processing should be placed in the loop function
+    lv_timer_handler();
+    delay(1);
+}
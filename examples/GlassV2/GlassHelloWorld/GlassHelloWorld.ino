@@ -9,11 +9,6 @@
 #include <LilyGo_Wristband.h>
 #include <LV_Helper.h>
 
-// The resolution of the non-magnified side of the glasses reflection area is about 126x126, 
-// and the magnified area is smaller than 126x126
-#define GlassViewableWidth              126
-#define GlassViewableHeight             126
-
 
 LilyGo_Class amoled;
 
@@ -41,24 +36,18 @@ void setup()
     // Brightness range : 0 ~ 255
     amoled.setBrightness(255);
 
+    // The resolution of the non-magnified side of the glasses reflection area is about 126x126,
+    // and the magnified area is smaller than 126x126.
+    // Only the viewport is rendered and sent to the screen
+    amoled.setViewport(GLASS_V2_VIEWPORT_X, GLASS_V2_VIEWPORT_Y, GLASS_VIEWPORT_WIDTH, GLASS_VIEWPORT_HEIGHT);
+
     // Initialize lvgl
     beginLvglHelper(amoled);
 
     // Set display background color to black
     lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
 
-    // Create a display window object
-    lv_obj_t *window = lv_obj_create(lv_scr_act());
-    // Set window border width zero
-    lv_obj_set_style_border_width(window, 0, 0);
-    // Set display window size
-    lv_obj_set_size(window, GlassViewableWidth, GlassViewableHeight);
-    // Set window position
-    lv_obj_align(window, LV_ALIGN_BOTTOM_MID, 0, 0);
-
-
-
-    lv_obj_t *label = lv_label_create(window);        /*Add a label the current screen*/
+    lv_obj_t *label = lv_label_create(lv_scr_act());        /*Add a label the current screen*/
     lv_label_set_text(label, "Hello World");          /*Set label text*/
     lv_obj_center(label);                             /*Set center alignment*/
 
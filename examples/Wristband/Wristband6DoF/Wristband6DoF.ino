@@ -8,7 +8,6 @@
  */
 #include <LilyGo_Wristband.h>
 #include <LV_Helper.h>
-#include <cbuf.h>
 
 LilyGo_Class amoled;
 
@@ -20,13 +19,28 @@ lv_obj_t *window;
 #define WindowViewableWidth              126
 #define WindowViewableHeight             250
 
-cbuf accel_data_buffer(1);
-cbuf gyro_data_buffer(1);
+// Samples buffered between two screen updates, 100Hz * 100ms with headroom
+#define SAMPLE_RING_DEPTH                32
+
 lv_obj_t *label;
 uint32_t inter_value = 0;
+SensorSample samples[SAMPLE_RING_DEPTH];
 
-static void gyro_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len);
-static void accel_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len);
+// Keep the newest sample of a sensor, scaled to physical units
+static bool read_latest(uint8_t sensor_id, float *xyz)
+{
+    uint32_t count = amoled.readSamples(sensor_id, samples, SAMPLE_RING_DEPTH);
+    if (!count) {
+        return false;
+    }
+    struct bhy2_data_xyz data;
+    bhy2_parse_xyz(samples[count - 1].data, &data);
+    float scaling_factor = get_sensor_default_scaling(sensor_id);
+    xyz[0] = data.x * scaling_factor;
+    xyz[1] = data.y * scaling_factor;
+    xyz[2] = data.z * scaling_factor;
+    return true;
+}
 
 void setup()
 {
@@ -53,10 +67,6 @@ void setup()
     // Initialize lvgl
     beginLvglHelper(amoled);
 
-    // Initialize Sensor
-    accel_data_buffer.resize(sizeof(struct bhy2_data_xyz) * 2);
-    gyro_data_buffer.resize(sizeof(struct bhy2_data_xyz) * 2);
-
     float sample_rate = 100.0;      /* Read out hintr_ctrl measured at 100Hz */
     uint32_t report_latency_ms = 0; /* Report immediately */
 
@@ -65,11 +75,12 @@ void setup()
     // Enable gyroscope
     amoled.configure(SENSOR_ID_GYRO_PASS, sample_rate, report_latency_ms);
 
-    // Set the acceleration sensor result callback function
-    amoled.onResultEvent(SENSOR_ID_ACC_PASS, accel_process_callback);
+    // Keep the samples in lock-free rings instead of handling them in callbacks
+    amoled.enableSampleRing(SENSOR_ID_ACC_PASS, SAMPLE_RING_DEPTH);
+    amoled.enableSampleRing(SENSOR_ID_GYRO_PASS, SAMPLE_RING_DEPTH);
 
-    // Set the gyroscope sensor result callback function
-    amoled.onResultEvent(SENSOR_ID_GYRO_PASS, gyro_process_callback);
+    // Drain the sensor FIFO from a task woken by the sensor interrupt
+    amoled.startDrainTask();
 
     // Set page background black color
     lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
@@ -95,64 +106,27 @@ void setup()
 
 void loop()
 {
-    if (millis() > inter_value) {
-        // Read data from buffer
-        struct bhy2_data_xyz gyr;
-        gyro_data_buffer.read(( char *)&gyr, sizeof(gyr));
-
-        struct bhy2_data_xyz acc;
-        accel_data_buffer.read(( char *)&acc, sizeof(acc));
+    static float gyr[3], acc[3];
 
-        float accel_scaling_factor = get_sensor_default_scaling(BHY2_SENSOR_ID_ACC_PASS);
-        float gyro_scaling_factor = get_sensor_default_scaling(BHY2_SENSOR_ID_GYRO_PASS);
+    if (millis() > inter_value) {
+        // Read data from the rings
+        read_latest(SENSOR_ID_GYRO_PASS, gyr);
+        read_latest(SENSOR_ID_ACC_PASS, acc);
 
-        // update the filter, which computes orientation
         Serial.printf("Gyro: X:% 3.2f Y:% 3.2f Z:% 3.2f Accel: X:% 3.2f Y:% 3.2f Z:% 3.2f \n",
-                      gyr.x * gyro_scaling_factor,
-                      gyr.y * gyro_scaling_factor,
-                      gyr.z * gyro_scaling_factor,
-                      acc.x * accel_scaling_factor,
-                      acc.y * accel_scaling_factor,
-                      acc.z * accel_scaling_factor
-                     );
+                      gyr[0], gyr[1], gyr[2], acc[0], acc[1], acc[2]);
 
         lv_label_set_text_fmt(label,
                               "Gyro:\nX:% 3.2f\nY:% 3.2f\nZ:% 3.2f\nAccel: \nX:% 3.2f\nY:% 3.2f\nZ:% 3.2f",
-                              gyr.x * gyro_scaling_factor,
-                              gyr.y * gyro_scaling_factor,
-                              gyr.z * gyro_scaling_factor,
-                              acc.x * accel_scaling_factor,
-                              acc.y * accel_scaling_factor,
-                              acc.z * accel_scaling_factor
-                             );
+                              gyr[0], gyr[1], gyr[2], acc[0], acc[1], acc[2]);
 
         inter_value = millis() + 100;
     }
 
 
-    // Update 6-axis sensor and button state
+    // Update button state, the sensor is drained by its own task
     amoled.update();
     // lvgl task processing should be placed in the loop function
     lv_timer_handler();
     delay(2);
 }
-
-
-
-
-
-static void accel_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
-{
-    struct bhy2_data_xyz data;
-    bhy2_parse_xyz(data_ptr, &data);
-    accel_data_buffer.write((const char *)&data, sizeof(data));
-}
-
-
-static void gyro_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
-{
-    struct bhy2_data_xyz data;
-    bhy2_parse_xyz(data_ptr, &data);
-    gyro_data_buffer.write((const char *)&data, sizeof(data));
-}
-
@@ -66,6 +66,9 @@ void setup()
     // Tools -> USB CDC On Boot -> Enable, otherwise there will be no output
     Serial.begin(115200);
 
+    // Batched panel bring-up, and skip the panel initialization when waking from sleep()
+    amoled.setFastBoot(true);
+
     // Initialization screen and peripherals
     bool rslt = amoled.begin();
     if (!rslt) {
@@ -117,6 +120,12 @@ void setup()
 
 void loop()
 {
+    static bool reported = false;
+    if (!reported && amoled.getFirstFrameTime()) {
+        reported = true;
+        Serial.printf("%s boot, first frame after %lu us\n", amoled.isWarmResumed() ? "Warm" : "Cold", (unsigned long)amoled.getFirstFrameTime());
+    }
+
     // Check button state
     amoled.update();
     // lvgl task processing should be placed in the loop function
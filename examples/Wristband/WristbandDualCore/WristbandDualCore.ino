@@ -0,0 +1,175 @@
+/**
+ * @file      WristbandDualCore.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      LVGL runs on core 1, the BHI260AP FIFO drain and the battery ADC run on core 0.
+ *            Samples are passed to the UI through the lock-free runtime channel.
+ */
+#include <LilyGo_Wristband.h>
+#include <LV_Helper.h>
+#include <LilyGo_Runtime.h>
+
+LilyGo_Class amoled;
+LilyGo_Runtime runtime;
+
+enum {
+    MSG_ACCEL,
+    MSG_GYRO,
+    MSG_BATTERY,
+};
+
+typedef struct {
+    uint8_t type;
+    float x, y, z;
+} sample_msg_t;
+
+lv_obj_t *label;
+float accel[3], gyro[3];
+uint16_t battery_voltage;
+uint32_t battery_interval = 0;
+uint32_t label_interval = 0;
+
+static void post_xyz(uint8_t type, uint8_t sensor_id, uint8_t *data_ptr)
+{
+    struct bhy2_data_xyz data;
+    bhy2_parse_xyz(data_ptr, &data);
+    float scaling_factor = get_sensor_default_scaling(sensor_id);
+    sample_msg_t msg = {type, data.x * scaling_factor, data.y * scaling_factor, data.z * scaling_factor};
+    runtime.post(&msg);
+}
+
+// Called from amoled.update() on the I/O task
+static void accel_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
+{
+    post_xyz(MSG_ACCEL, sensor_id, data_ptr);
+}
+
+static void gyro_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
+{
+    post_xyz(MSG_GYRO, sensor_id, data_ptr);
+}
+
+// I/O task, core 0. Owns the sensor SPI bus and the ADC
+static void io_loop(void *user_data)
+{
+    // Update 6-axis sensor and button state
+    amoled.update();
+
+    if (millis() > battery_interval) {
+        sample_msg_t msg = {MSG_BATTERY, (float)amoled.getBattVoltage(), 0, 0};
+        runtime.post(&msg);
+        battery_interval = millis() + 1000;
+    }
+}
+
+// UI task, core 1, called with the LVGL lock held
+static void ui_message(const void *data, void *user_data)
+{
+    const sample_msg_t *msg = (const sample_msg_t *)data;
+    switch (msg->type) {
+    case MSG_ACCEL:
+        accel[0] = msg->x; accel[1] = msg->y; accel[2] = msg->z;
+        break;
+    case MSG_GYRO:
+        gyro[0] = msg->x; gyro[1] = msg->y; gyro[2] = msg->z;
+        break;
+    case MSG_BATTERY:
+        battery_voltage = msg->x;
+        break;
+    default:
+        return;
+    }
+
+    if (millis() > label_interval) {
+        lv_label_set_text_fmt(label,
+                              "Gyro:\nX:% 3.2f\nY:% 3.2f\nZ:% 3.2f\nAccel: \nX:% 3.2f\nY:% 3.2f\nZ:% 3.2f\nBatt: %umV",
+                              gyro[0], gyro[1], gyro[2], accel[0], accel[1], accel[2], battery_voltage);
+        label_interval = millis() + 100;
+    }
+}
+
+void setup()
+{
+    // Turn on debugging message output, Arduino IDE users please put
+    // Tools -> USB CDC On Boot -> Enable, otherwise there will be no output
+    Serial.begin(115200);
+
+    // Initialization screen and peripherals
+    bool rslt = amoled.begin();
+    if (!rslt) {
+        while (1) {
+            Serial.println("The board model cannot be detected, please raise the Core Debug Level to an error");
+            delay(1000);
+        }
+    }
+
+    // Set the bracelet screen orientation to portrait
+    amoled.setRotation(0);
+
+    // Brightness range : 0 ~ 255
+    amoled.setBrightness(255);
+
+    // The displayable area of Wristband is 126x250, which requires an offset of 44 pixels.
+    // Only the viewport is rendered and sent to the screen
+    amoled.setViewport(WRISTBAND_VIEWPORT_X, WRISTBAND_VIEWPORT_Y, WRISTBAND_VIEWPORT_WIDTH, WRISTBAND_VIEWPORT_HEIGHT);
+
+    // Initialize lvgl
+    beginLvglHelper(amoled);
+
+    float sample_rate = 100.0;      /* Read out hintr_ctrl measured at 100Hz */
+    uint32_t report_latency_ms = 0; /* Report immediately */
+
+    // Enable acceleration
+    amoled.configure(SENSOR_ID_ACC_PASS, sample_rate, report_latency_ms);
+    // Enable gyroscope
+    amoled.configure(SENSOR_ID_GYRO_PASS, sample_rate, report_latency_ms);
+
+    // Set the acceleration sensor result callback function
+    amoled.onResultEvent(SENSOR_ID_ACC_PASS, accel_process_callback);
+
+    // Set the gyroscope sensor result callback function
+    amoled.onResultEvent(SENSOR_ID_GYRO_PASS, gyro_process_callback);
+
+    // Set page background black color
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
+
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_label_set_text(label, "N/A");
+    lv_obj_center(label);
+
+    // From here on LVGL belongs to the UI task
+    runtime_config_t config = RUNTIME_CONFIG_DEFAULT();
+    config.io_cb = io_loop;
+    config.msg_cb = ui_message;
+    config.msg_size = sizeof(sample_msg_t);
+    if (!runtime.begin(config)) {
+        while (1) {
+            Serial.println("Failed to start the runtime tasks");
+            delay(1000);
+        }
+    }
+}
+
+void loop()
+{
+    runtime_task_stats_t ui, io;
+    runtime.getUiStats(ui);
+    runtime.getIoStats(io);
+    Serial.printf("UI: load %u%% max busy %luus max jitter %luus | IO: load %u%% max busy %luus max jitter %luus | dropped %lu\n",
+                  ui.load, ui.max_busy_us, ui.max_jitter_us,
+                  io.load, io.max_busy_us, io.max_jitter_us,
+                  runtime.getDroppedMessages());
+    runtime.resetStats();
+
+    // lv_* calls from any task other than the UI task must hold the lock
+    {
+        LvglLock lock(runtime);
+        lv_obj_set_style_text_opa(label, ui.load > 80 ? LV_OPA_50 : LV_OPA_COVER, LV_PART_MAIN);
+    }
+
+    delay(1000);
+}
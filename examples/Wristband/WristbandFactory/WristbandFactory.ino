@@ -9,10 +9,8 @@
 #include <LilyGo_Wristband.h> //To use LilyGo Wristband S3, please include <LilyGo_Wristband.h>
 #include <LV_Helper.h>
 #include <time.h>
-#include <cbuf.h>
 #include <WiFi.h>
 #include <esp_sntp.h>
-#include <MadgwickAHRS.h>       //MadgwickAHRS from https://github.com/arduino-libraries/MadgwickAHRS
 #include "particleSensor.h"
 
 LilyGo_Class amoled;
@@ -60,10 +58,6 @@ lv_obj_t *window;
 #define WindowViewableHeight             250
 
 
-Madgwick filter;
-
-static cbuf accel_data_buffer(1);
-static cbuf gyro_data_buffer(1);
 static lv_obj_t *tileview;
 static lv_obj_t *chart;
 static lv_chart_series_t *ser1 ;
@@ -135,39 +129,6 @@ static void bindTouchButton()
     lv_group_set_default(g);
 }
 
-
-static void accel_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
-{
-    struct bhy2_data_xyz data;
-    bhy2_parse_xyz(data_ptr, &data);
-
-    // float scaling_factor = get_sensor_default_scaling(sensor_id);
-    // Serial.print(amoled.getSensorName(sensor_id));
-    // Serial.print(":");
-    // Serial.printf("x: %f, y: %f, z: %f;\r\n",
-    //               data.x * scaling_factor,
-    //               data.y * scaling_factor,
-    //               data.z * scaling_factor
-    //  );
-    accel_data_buffer.write((const char *)&data, sizeof(data));
-}
-
-
-static void gyro_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
-{
-    struct bhy2_data_xyz data;
-    bhy2_parse_xyz(data_ptr, &data);
-    // float scaling_factor = get_sensor_default_scaling(sensor_id);
-    // Serial.print(amoled.getSensorName(sensor_id));
-    // Serial.print(":");
-    // Serial.printf("x: %f, y: %f, z: %f;\r\n",
-    //               data.x * scaling_factor,
-    //               data.y * scaling_factor,
-    //               data.z * scaling_factor
-    //              );
-    gyro_data_buffer.write((const char *)&data, sizeof(data));
-}
-
 void orientation_process_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
 {
     uint8_t direction = *data_ptr;
@@ -212,25 +173,9 @@ void setup(void)
     amoled.setEventCallback(button_event_callback);
 
     // Initialize Sensor
-    accel_data_buffer.resize(sizeof(struct bhy2_data_xyz) * 2);
-    gyro_data_buffer.resize(sizeof(struct bhy2_data_xyz) * 2);
-
-    // initialize variables to pace updates to correct rate
-    filter.begin(100);
-
-    float sample_rate = 100.0;      /* Read out hintr_ctrl measured at 100Hz */
-    uint32_t report_latency_ms = 0; /* Report immediately */
-
-    // Enable acceleration
-    amoled.configure(SENSOR_ID_ACC_PASS, sample_rate, report_latency_ms);
-    // Enable gyroscope
-    amoled.configure(SENSOR_ID_GYRO_PASS, sample_rate, report_latency_ms);
-
-    // Set the acceleration sensor result callback function
-    amoled.onResultEvent(SENSOR_ID_ACC_PASS, accel_process_callback);
-
-    // Set the gyroscope sensor result callback function
-    amoled.onResultEvent(SENSOR_ID_GYRO_PASS, gyro_process_callback);
+    // The BHI260AP fuses accelerometer and gyroscope itself and reports a quaternion at 100Hz.
+    // ORIENTATION_HOST fuses the raw samples on the ESP32 instead
+    amoled.beginOrientation(ORIENTATION_GAME_RV, 100);
 
 
     // Set notification call-back function , After time synchronization is completed, synchronize the synchronized time to the hardware RTC
@@ -278,6 +223,9 @@ void loop()
     // Update 6-axis sensor and button state
     amoled.update();
 
+    // Drain the PPG FIFO, only touches the bus once a burst is due
+    updateParticleSensor();
+
     lv_timer_handler();
 
     delay(5);
@@ -446,7 +394,9 @@ static void lv_tileview_add_dummy_heart(lv_obj_t *parent)
         lv_chart_set_next_value(chart, ser1, val);
 
         lv_obj_t  *val_label = (lv_obj_t *)lv_obj_get_user_data(bpm_label);
-        lv_label_set_text_fmt(val_label, "IR:%u\nRED:%u\nTemp:%.2f", getParticleSensorIR(), getParticleSensorRed(), getParticleSensorTemp());
+        // Samples the sensor FIFO dropped because it was not read in time
+        lv_label_set_text_fmt(val_label, "IR:%u\nRED:%u\nTemp:%.2f\nLost:%u", getParticleSensorIR(), getParticleSensorRed(),
+                              getParticleSensorTemp(), getParticleSensorOverflows());
 
     }, 1000, bpm_label);
 }
@@ -542,29 +492,10 @@ static void lv_tileview_add_sensor(lv_obj_t *parent)
 
         float roll, pitch, heading;
 
-        // Read data from buffer
-        struct bhy2_data_xyz gyr;
-        gyro_data_buffer.read(( char *)&gyr, sizeof(gyr));
-
-        struct bhy2_data_xyz acc;
-        accel_data_buffer.read(( char *)&acc, sizeof(acc));
-
-        float accel_scaling_factor = get_sensor_default_scaling(BHY2_SENSOR_ID_ACC_PASS);
-        float gyro_scaling_factor = get_sensor_default_scaling(BHY2_SENSOR_ID_GYRO_PASS);
-
-        // update the filter, which computes orientation
-        filter.updateIMU(gyr.x * gyro_scaling_factor,
-                         gyr.y * gyro_scaling_factor,
-                         gyr.z * gyro_scaling_factor,
-                         acc.x * accel_scaling_factor,
-                         acc.y * accel_scaling_factor,
-                         acc.z * accel_scaling_factor
-                        );
-
-        // get the heading, pitch and roll
-        roll = filter.getRoll();
-        pitch = filter.getPitch();
-        heading = filter.getYaw();
+        // get the heading, pitch and roll of the latest fused sample
+        roll = amoled.orientation().getRoll();
+        pitch = amoled.orientation().getPitch();
+        heading = amoled.orientation().getYaw();
 
         lv_label_set_text_fmt(label, "Roll:\n\t% 3.2f\nPitch:\n\t% 3.2f\nHeading:\n\t% 3.2f\n", roll, pitch, heading);
 
@@ -9,8 +9,10 @@
 #include <Wire.h>
 #include <MAX30105.h>   //https://github.com/sparkfun/SparkFun_MAX3010x_Sensor_Library
 #include "spo2_algorithm.h"
+#include <ppgFifo.h>
 
 MAX30105 particleSensor;
+PpgFifo particleFifo;
 
 uint32_t irBuffer[100]; //infrared LED sensor data
 uint32_t redBuffer[100];  //red LED sensor data
@@ -21,12 +23,18 @@ int32_t heartRate; //heart rate value
 int8_t validHeartRate; //indicator to show if the heart rate calculation is valid
 
 static bool online = true;
+static uint32_t lastIR;
+static uint32_t lastRed;
 
 #define SENSOR_SDA      41
 #define SENSOR_SCL      40
+// Wire the INT output of the module to a GPIO and set it here, -1 reads on a timer
+#define SENSOR_INT      (-1)
 
 bool setupParticleSensor()
 {
+    // A whole sensor FIFO in one read, the buffer can only grow before begin()
+    Wire1.setBufferSize(PPG_FIFO_BURST_BYTES);
     Wire1.begin(SENSOR_SDA, SENSOR_SCL);
     // Initialize sensor
     if (!particleSensor.begin(Wire1, I2C_SPEED_FAST)) { //Use default I2C port, 400kHz speed
@@ -38,21 +46,42 @@ bool setupParticleSensor()
 
     particleSensor.setup(); //default configure
 
+    if (!particleFifo.begin(particleSensor, Wire1, SENSOR_INT)) {
+        Serial.println(F("MAX30105 FIFO could not be started."));
+        online = false;
+        return false;
+    }
     return true;
 }
 
+// Drain the sensor FIFO when due and keep the newest sample, never waits for one
+bool updateParticleSensor()
+{
+    if (!online)return false;
+    ppg_sample_t samples[16];
+    uint32_t count;
+    bool updated = false;
+    particleFifo.update();
+    while ((count = particleFifo.read(samples, 16)) > 0) {
+        lastRed = samples[count - 1].red;
+        lastIR = samples[count - 1].ir;
+        updated = true;
+    }
+    return updated;
+}
+
 
 uint32_t getParticleSensorIR()
 {
     if (!online)return 0;
-    return particleSensor.getIR();
+    return lastIR;
 }
 
 
 uint32_t getParticleSensorRed()
 {
     if (!online)return 0;
-    return particleSensor.getRed();
+    return lastRed;
 }
 
 float getParticleSensorTemp()
@@ -66,6 +95,12 @@ bool isParticleSensorOnline()
     return online;
 }
 
+uint32_t getParticleSensorOverflows()
+{
+    if (!online)return 0;
+    return particleFifo.getOverflows();
+}
+
 
 
 
@@ -15,8 +15,8 @@ uint32_t getParticleSensorIR();
 uint32_t getParticleSensorRed();
 float getParticleSensorTemp();
 bool isParticleSensorOnline();
-
-// bool updateParticleSensor();
+bool updateParticleSensor();
+uint32_t getParticleSensorOverflows();
 
 
 
@@ -11,13 +11,6 @@
 
 LilyGo_Class amoled;
 
-// Create a window into which all elements are loaded
-lv_obj_t *window;
-
-// The displayable area of Wristband is 126x250, which requires an offset of 44 pixels.
-#define WindowViewableWidth              126
-#define WindowViewableHeight             250
-
 void setup()
 {
     bool rslt = false;
@@ -42,23 +35,15 @@ void setup()
     // Brightness range : 0 ~ 255
     amoled.setBrightness(255);
 
+    // The displayable area of Wristband is 126x250, which requires an offset of 44 pixels.
+    // Only the viewport is rendered and sent to the screen
+    amoled.setViewport(WRISTBAND_VIEWPORT_X, WRISTBAND_VIEWPORT_Y, WRISTBAND_VIEWPORT_WIDTH, WRISTBAND_VIEWPORT_HEIGHT);
+
     // Initialize lvgl
     beginLvglHelper(amoled);
 
 
-    // Create a display window object
-    window = lv_obj_create(lv_scr_act());
-    // Set window pad all zero
-    lv_obj_set_style_pad_all(window, 0, 0);
-    // Set window border width zero
-    lv_obj_set_style_border_width(window, 0, 0);
-    // Set display window size
-    lv_obj_set_size(window, WindowViewableWidth, WindowViewableHeight);
-    // Set window position
-    lv_obj_align(window, LV_ALIGN_BOTTOM_MID, 0, 0);
-
-
-    lv_obj_t *label = lv_label_create(window);        /*Add a label the current screen*/
+    lv_obj_t *label = lv_label_create(lv_scr_act());        /*Add a label the current screen*/
     lv_label_set_text(label, "Hello World");          /*Set label text*/
     lv_obj_center(label);                             /*Set center alignment*/
 
@@ -0,0 +1,117 @@
+/**
+ * @file      WristbandSensorBatching.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Lets the BHI260AP batch accel and gyro samples in its wake up FIFO, so the host
+ *            is interrupted about twice a second instead of once per sample.
+ *            With USE_LIGHT_SLEEP the ESP32-S3 sleeps between batches and is woken by the
+ *            sensor interrupt. Serial will be invalid during light sleep, the counters are
+ *            shown on the screen instead. To re-upload the sketch, put the board into download mode.
+ */
+#include <LilyGo_Wristband.h>
+#include <LV_Helper.h>
+
+// #define USE_LIGHT_SLEEP
+
+LilyGo_Class amoled;
+
+#define SAMPLE_RATE_HZ          100.0
+// Longest time a sample waits in the sensor FIFO
+#define REPORT_LATENCY_MS       500
+// Also interrupt when the wake up FIFO holds this many bytes, accel and gyro records are 7 bytes
+#define FIFO_WATERMARK_BYTES    (7 * 2 * 64)
+// Upper bound of a light sleep, the screen is refreshed at least this often
+#define SLEEP_TIMEOUT_MS        1000
+
+uint32_t samples = 0;
+uint32_t report_interval = 0;
+lv_obj_t *label;
+
+static void sample_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
+{
+    samples++;
+}
+
+static void report()
+{
+    SensorTransportStats stats;
+    amoled.getTransportStats(stats);
+    uint32_t elapsed = millis() - report_interval + 1000;
+
+#ifdef USE_LIGHT_SLEEP
+    lv_label_set_text_fmt(label, "IRQ/s %lu\nDrain/s %lu\nSample/s %lu",
+                          stats.interrupts * 1000 / elapsed, stats.updates * 1000 / elapsed, samples * 1000 / elapsed);
+#else
+    Serial.printf("%lu interrupts/s, %lu drains/s, %lu samples/s, update %lu us average\n",
+                  stats.interrupts * 1000 / elapsed, stats.updates * 1000 / elapsed, samples * 1000 / elapsed,
+                  stats.updates ? (uint32_t)(stats.update_us / stats.updates) : 0);
+#endif
+
+    amoled.resetTransportStats();
+    samples = 0;
+    report_interval = millis() + 1000;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    bool rslt = amoled.begin();
+    if (!rslt) {
+        while (1) {
+            Serial.println("The board model cannot be detected, please raise the Core Debug Level to an error");
+            delay(1000);
+        }
+    }
+
+    // Only the 126x250 viewport of the wristband is rendered and sent to the screen
+    amoled.setViewport(WRISTBAND_VIEWPORT_X, WRISTBAND_VIEWPORT_Y, WRISTBAND_VIEWPORT_WIDTH, WRISTBAND_VIEWPORT_HEIGHT);
+    beginLvglHelper(amoled);
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
+    label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    lv_label_set_text(label, "Batching");
+    lv_obj_center(label);
+
+    // The wake up variants report through the wake up FIFO, which keeps interrupting the host
+    // while it is suspended. Subscribe with the ID that configureBatch returns
+    uint8_t acc_id = amoled.configureBatch(SENSOR_ID_ACC, SAMPLE_RATE_HZ, REPORT_LATENCY_MS, true);
+    uint8_t gyro_id = amoled.configureBatch(SENSOR_ID_GYRO, SAMPLE_RATE_HZ, REPORT_LATENCY_MS, true);
+    if (!acc_id || !gyro_id) {
+        Serial.println("Failed to configure the batched sensors");
+    }
+    amoled.onResultEvent(acc_id, sample_callback);
+    amoled.onResultEvent(gyro_id, sample_callback);
+
+    amoled.setFifoWatermark(FIFO_WATERMARK_BYTES, 0);
+
+#ifdef USE_LIGHT_SLEEP
+    // Nothing else may interrupt the host, the non wake up FIFO is read after the next wake up batch
+    amoled.setHostSuspended(true);
+    gpio_wakeup_enable((gpio_num_t)BOARD_BHI_IRQ, GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup(SLEEP_TIMEOUT_MS * 1000ULL);
+#endif
+
+    amoled.resetTransportStats();
+    report_interval = millis() + 1000;
+}
+
+void loop()
+{
+    // Reads the FIFO only if the sensor raised its interrupt
+    amoled.update();
+
+    if (millis() >= report_interval) {
+        report();
+    }
+
+#ifdef USE_LIGHT_SLEEP
+    lv_timer_handler();
+    esp_light_sleep_start();
+#else
+    delay(5);
+#endif
+}
@@ -0,0 +1,76 @@
+/**
+ * @file      WristbandSensorThroughput.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Measures how fast the BHI260AP FIFO is drained. Build once as is and once with
+ *            -DBOARD_BHI_SPI_DMA=0 to compare the DMA transport with the Arduino SPI class.
+ */
+#include <LilyGo_Wristband.h>
+
+LilyGo_Class amoled;
+
+// Accel, gyro and two fusion outputs at the highest rates the firmware reports
+#define SAMPLE_RATE_HZ          400.0
+#define FUSION_RATE_HZ          200.0
+// Let the FIFO fill up for a while to get bulk reads, 0 reports every sample at once
+#define REPORT_LATENCY_MS       0
+
+uint32_t samples = 0;
+uint32_t report_interval = 0;
+
+static void sample_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len)
+{
+    samples++;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    bool rslt = amoled.begin();
+    if (!rslt) {
+        while (1) {
+            Serial.println("The board model cannot be detected, please raise the Core Debug Level to an error");
+            delay(1000);
+        }
+    }
+
+    amoled.configure(SENSOR_ID_ACC_PASS, SAMPLE_RATE_HZ, REPORT_LATENCY_MS);
+    amoled.configure(SENSOR_ID_GYRO_PASS, SAMPLE_RATE_HZ, REPORT_LATENCY_MS);
+    amoled.configure(SENSOR_ID_RV, FUSION_RATE_HZ, REPORT_LATENCY_MS);
+    amoled.configure(SENSOR_ID_GAMERV, FUSION_RATE_HZ, REPORT_LATENCY_MS);
+
+    amoled.onResultEvent(SENSOR_ID_ACC_PASS, sample_callback);
+    amoled.onResultEvent(SENSOR_ID_GYRO_PASS, sample_callback);
+    amoled.onResultEvent(SENSOR_ID_RV, sample_callback);
+    amoled.onResultEvent(SENSOR_ID_GAMERV, sample_callback);
+
+    Serial.printf("Transport: %s\n", BOARD_BHI_SPI_DMA ? "ESP-IDF SPI DMA" : "Arduino SPI");
+    amoled.resetTransportStats();
+    report_interval = millis() + 1000;
+}
+
+void loop()
+{
+    amoled.update();
+
+    if (millis() >= report_interval) {
+        SensorTransportStats stats;
+        amoled.getTransportStats(stats);
+        uint32_t elapsed = millis() - report_interval + 1000;
+
+        Serial.printf("%lu bytes/s, %lu samples/s, %lu transactions/s, transfer %llu us/s, ",
+                      (uint32_t)(stats.read_bytes * 1000 / elapsed), samples * 1000 / elapsed,
+                      stats.transactions * 1000 / elapsed, stats.transfer_us * 1000 / elapsed);
+        Serial.printf("update %lu us average over %lu drains, CPU %.1f%%\n",
+                      stats.updates ? (uint32_t)(stats.update_us / stats.updates) : 0, stats.updates,
+                      stats.update_us / (elapsed * 10.0));
+
+        amoled.resetTransportStats();
+        samples = 0;
+        report_interval = millis() + 1000;
+    }
+    delay(1);
+}
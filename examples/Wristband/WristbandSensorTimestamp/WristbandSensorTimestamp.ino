@@ -0,0 +1,82 @@
+/**
+ * @file      WristbandSensorTimestamp.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Receives gyro samples with their BHI260AP timestamps, maps them to esp_timer
+ *            time and prints the sample interval, the delay from the sensor to the
+ *            application and the drift between the sensor and the ESP32-S3 clocks.
+ */
+#include <LilyGo_Wristband.h>
+
+LilyGo_Class amoled;
+
+#define SAMPLE_RATE_HZ          200.0
+#define REPORT_LATENCY_MS       0
+
+uint32_t samples = 0;
+uint64_t last_timestamp = 0;
+uint64_t max_interval_ns = 0;
+int64_t latency_sum_us = 0;
+int64_t latency_max_us = 0;
+uint32_t latency_count = 0;
+uint32_t report_interval = 0;
+
+static void gyro_callback(uint8_t sensor_id, uint8_t *data_ptr, uint32_t len, uint64_t timestamp_ns, void *user_data)
+{
+    // Interval of the sensor clock, independent of when the FIFO was read
+    if (last_timestamp && timestamp_ns - last_timestamp > max_interval_ns) {
+        max_interval_ns = timestamp_ns - last_timestamp;
+    }
+    last_timestamp = timestamp_ns;
+    samples++;
+
+    int64_t sample_us;
+    if (amoled.toHostTime(timestamp_ns, sample_us)) {
+        int64_t latency = esp_timer_get_time() - sample_us;
+        latency_sum_us += latency;
+        latency_count++;
+        if (latency > latency_max_us) {
+            latency_max_us = latency;
+        }
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    bool rslt = amoled.begin();
+    if (!rslt) {
+        while (1) {
+            Serial.println("The board model cannot be detected, please raise the Core Debug Level to an error");
+            delay(1000);
+        }
+    }
+
+    amoled.configure(SENSOR_ID_GYRO_PASS, SAMPLE_RATE_HZ, REPORT_LATENCY_MS);
+    amoled.onResultEvent(SENSOR_ID_GYRO_PASS, gyro_callback, NULL);
+    report_interval = millis() + 1000;
+}
+
+void loop()
+{
+    amoled.update();
+
+    if (millis() >= report_interval) {
+        const SensorClockSync &clock = amoled.getClockSync();
+        Serial.printf("%lu samples/s, max interval %.2f ms, latency %lld us average %lld us max, ",
+                      samples, max_interval_ns / 1000000.0,
+                      latency_count ? latency_sum_us / latency_count : 0, latency_max_us);
+        Serial.printf("drift %.2f ppm, resync error %ld us over %lu points\n",
+                      clock.driftPpb() / 1000.0, clock.lastErrorUs(), clock.points());
+
+        samples = 0;
+        max_interval_ns = 0;
+        latency_sum_us = latency_max_us = 0;
+        latency_count = 0;
+        report_interval = millis() + 1000;
+    }
+    delay(1);
+}
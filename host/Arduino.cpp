@@ -0,0 +1,255 @@
+/**
+ * @file      Arduino.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <chrono>
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+#include "esp_timer.h"
+
+#define HOST_GPIO_COUNT         64
+#define HOST_I2C_BUFFER_LENGTH  128
+
+HostSerial Serial;
+SPIClass SPI;
+TwoWire Wire;
+TwoWire Wire1;
+
+static uint64_t virtual_micros;
+
+uint32_t millis()
+{
+    return virtual_micros / 1000;
+}
+
+uint32_t micros()
+{
+    return virtual_micros;
+}
+
+void delay(uint32_t ms)
+{
+    virtual_micros += ms * 1000ULL;
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    virtual_micros += us;
+}
+
+void hostAdvanceMillis(uint32_t ms)
+{
+    virtual_micros += ms * 1000ULL;
+}
+
+void hostAdvanceMicros(uint32_t us)
+{
+    virtual_micros += us;
+}
+
+static struct {
+    int level;
+    int mode;
+    void (*handler)(void *);
+    void *arg;
+} host_gpio[HOST_GPIO_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    (void)pin;
+    (void)val;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < HOST_GPIO_COUNT ? host_gpio[pin].level : LOW;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode)
+{
+    if (pin < HOST_GPIO_COUNT) {
+        host_gpio[pin].handler = handler;
+        host_gpio[pin].arg = arg;
+        host_gpio[pin].mode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin < HOST_GPIO_COUNT) {
+        host_gpio[pin].handler = NULL;
+    }
+}
+
+void hostSetPin(uint8_t pin, int level)
+{
+    if (pin >= HOST_GPIO_COUNT || host_gpio[pin].level == level) {
+        return;
+    }
+    host_gpio[pin].level = level;
+    int edge = level == HIGH ? RISING : FALLING;
+    if (host_gpio[pin].handler && (host_gpio[pin].mode & edge)) {
+        host_gpio[pin].handler(host_gpio[pin].arg);
+    }
+}
+
+TwoWire::TwoWire() : hostTransactions(0), hostBytes(0), _bufferSize(HOST_I2C_BUFFER_LENGTH),
+    _txLength(0), _rxLength(0), _rxIndex(0), _address(0), _frequency(100000), _started(false)
+{
+    memset(_devices, 0, sizeof(_devices));
+    _txBuffer = (uint8_t *)malloc(_bufferSize);
+    _rxBuffer = (uint8_t *)malloc(_bufferSize);
+}
+
+TwoWire::~TwoWire()
+{
+    free(_txBuffer);
+    free(_rxBuffer);
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency)
+{
+    (void)sda;
+    (void)scl;
+    _started = true;
+    setClock(frequency);
+    return true;
+}
+
+bool TwoWire::end()
+{
+    _started = false;
+    return true;
+}
+
+void TwoWire::setClock(uint32_t frequency)
+{
+    if (frequency) {
+        _frequency = frequency;
+    }
+}
+
+size_t TwoWire::setBufferSize(size_t size)
+{
+    if (_started || !size) {
+        log_e("Can't set buffer size, I2C bus already initialized.");
+        return 0;
+    }
+    free(_txBuffer);
+    free(_rxBuffer);
+    _txBuffer = (uint8_t *)malloc(size);
+    _rxBuffer = (uint8_t *)malloc(size);
+    _bufferSize = size;
+    return size;
+}
+
+void TwoWire::beginTransmission(uint16_t address)
+{
+    _address = address & 0x7F;
+    _txLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    (void)sendStop;
+    HostI2CDevice *device = _devices[_address];
+    hostTransactions++;
+    busTime(device ? 1 + _txLength : 1);
+    size_t length = _txLength;
+    _txLength = 0;
+    if (!device) {
+        return 2;
+    }
+    device->i2cWrite(_txBuffer, length);
+    return 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLength >= _bufferSize) {
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size)
+{
+    size_t i = 0;
+    while (i < size && write(data[i])) {
+        i++;
+    }
+    return i;
+}
+
+size_t TwoWire::requestFrom(uint16_t address, size_t size, bool sendStop)
+{
+    (void)sendStop;
+    HostI2CDevice *device = _devices[address & 0x7F];
+    _rxIndex = _rxLength = 0;
+    if (size > _bufferSize) {
+        log_e("requestFrom: size %u is larger than the buffer %u", (unsigned)size, (unsigned)_bufferSize);
+        size = _bufferSize;
+    }
+    hostTransactions++;
+    if (device) {
+        _rxLength = device->i2cRead(_rxBuffer, size);
+    }
+    busTime(1 + _rxLength);
+    return _rxLength;
+}
+
+size_t TwoWire::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t count = std::min(length, _rxLength - _rxIndex);
+    memcpy(buffer, _rxBuffer + _rxIndex, count);
+    _rxIndex += count;
+    return count;
+}
+
+int TwoWire::available()
+{
+    return _rxLength - _rxIndex;
+}
+
+int TwoWire::read()
+{
+    return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1;
+}
+
+void TwoWire::hostAttach(uint8_t address, HostI2CDevice *device)
+{
+    _devices[address & 0x7F] = device;
+}
+
+// Eight data bits and the acknowledge of each byte at the bus clock
+void TwoWire::busTime(size_t bytes)
+{
+    hostBytes += bytes;
+    hostAdvanceMicros((bytes * 9 * 1000000ULL + _frequency / 2) / _frequency);
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return howsmall + rand() % (howbig - howsmall);
+}
+
+int64_t esp_timer_get_time()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,292 @@
+/**
+ * @file      LilyGo_HostDisplay.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arduino.h"
+#include "LilyGo_HostDisplay.h"
+#include "panelCmdList.h"
+
+// Same chunk size as the display SPI bus of LilyGo_Wristband
+#define HOST_DISPLAY_MAX_TRANSFER   (JD9613_HEIGHT * 80 * sizeof(uint16_t))
+
+LilyGo_HostDisplay::LilyGo_HostDisplay() :
+    _framebuffer(NULL), _driverBuffer(NULL), _fullRefresh(false)
+{
+    panel_io_mock_init(&_io, true, HOST_DISPLAY_MAX_TRANSFER);
+    panel_flush_init(&_flush, &_io.base, NULL, 16, true);
+    panel_cmd_list_clear(&_window);
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+LilyGo_HostDisplay::~LilyGo_HostDisplay()
+{
+    setDeltaFlush(false);
+    free(_framebuffer);
+    free(_driverBuffer);
+}
+
+bool LilyGo_HostDisplay::begin(uint8_t colorBits)
+{
+    if (colorBits != 16 && colorBits != 12) {
+        log_e("Unsupported color depth %u", colorBits);
+        return false;
+    }
+    if (!_framebuffer) {
+        _framebuffer = (uint16_t *)calloc(HOST_DISPLAY_RAM_WIDTH * JD9613_HEIGHT, sizeof(uint16_t));
+        _driverBuffer = (uint16_t *)calloc(JD9613_WIDTH * JD9613_HEIGHT, sizeof(uint16_t));
+    }
+    if (!_framebuffer || !_driverBuffer) {
+        return false;
+    }
+    _flush.frame_buffer = _driverBuffer;
+    _flush.bits_per_pixel = colorBits;
+    panel_io_mock_attach_memory(&_io, _framebuffer, HOST_DISPLAY_RAM_WIDTH, JD9613_HEIGHT, colorBits);
+    return true;
+}
+
+void LilyGo_HostDisplay::setRotation(uint8_t rotation)
+{
+    resetViewport();
+    panel_flush_set_rotation(&_flush, rotation % 4);
+}
+
+uint8_t LilyGo_HostDisplay::getRotation()
+{
+    return _flush.rotation;
+}
+
+void LilyGo_HostDisplay::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t w, uint16_t h)
+{
+    // Raw writes bypass the delta shadow
+    if (_flush.delta) {
+        scanline_delta_invalidate(_flush.delta);
+    }
+    panel_cmd_list_clear(&_window);
+    panel_cmd_list_add_window(&_window, xs, ys, xs + w, ys + h);
+}
+
+void LilyGo_HostDisplay::pushColors(uint16_t *data, uint32_t len)
+{
+    panel_flush_submit(&_flush, &_window, data, len, true);
+    panel_cmd_list_clear(&_window);
+    _stats.flushes++;
+    _stats.pixels += len / sizeof(uint16_t);
+}
+
+void LilyGo_HostDisplay::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+{
+    x += _offset_x;
+    y += _offset_y;
+    panel_flush_draw(&_flush, x, y, x + width, y + height, data);
+    _stats.flushes++;
+    _stats.pixels += width * height;
+}
+
+uint16_t LilyGo_HostDisplay::width()
+{
+    if (_viewport_width) {
+        return _viewport_width;
+    }
+    return (_flush.rotation == 1 || _flush.rotation == 3) ? JD9613_HEIGHT : JD9613_WIDTH;
+}
+
+uint16_t LilyGo_HostDisplay::height()
+{
+    if (_viewport_height) {
+        return _viewport_height;
+    }
+    return (_flush.rotation == 1 || _flush.rotation == 3) ? JD9613_WIDTH : JD9613_HEIGHT;
+}
+
+uint8_t LilyGo_HostDisplay::getPoint(int16_t *x, int16_t *y, uint8_t get_point)
+{
+    (void)x;
+    (void)y;
+    (void)get_point;
+    return 0;
+}
+
+bool LilyGo_HostDisplay::hasTouch()
+{
+    return false;
+}
+
+void LilyGo_HostDisplay::setFullRefresh(bool enable)
+{
+    _fullRefresh = enable;
+}
+
+bool LilyGo_HostDisplay::needFullRefresh()
+{
+    return _fullRefresh;
+}
+
+bool LilyGo_HostDisplay::setDeltaFlush(bool enable)
+{
+    return panel_flush_set_delta(&_flush, enable, malloc, malloc);
+}
+
+void LilyGo_HostDisplay::getStats(host_display_stats_t &stats)
+{
+    stats = _stats;
+    stats.panel_bytes = _io.base.stats.color_bytes;
+    stats.transactions = _io.base.stats.transactions;
+}
+
+void LilyGo_HostDisplay::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_io.base.stats, 0, sizeof(_io.base.stats));
+}
+
+const uint16_t *LilyGo_HostDisplay::framebuffer()
+{
+    return _framebuffer;
+}
+
+const panel_io_mock_t &LilyGo_HostDisplay::io()
+{
+    return _io;
+}
+
+// RGB888 of the panel memory as seen in the current rotation. Rotation 1 and 3 are turned
+// back, rotation 2 mirrors both axes in the panel, so its RAM holds the frame two columns on
+bool LilyGo_HostDisplay::getRGB(uint8_t *rgb, uint16_t &w, uint16_t &h)
+{
+    bool rotated = _flush.rotation == 1 || _flush.rotation == 3;
+    uint32_t offset = _flush.rotation == 2 ? 2 : 0;
+    w = rotated ? JD9613_HEIGHT : JD9613_WIDTH;
+    h = rotated ? JD9613_WIDTH : JD9613_HEIGHT;
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint32_t index = rotated ? x * HOST_DISPLAY_RAM_WIDTH + (JD9613_WIDTH - 1 - y) : y * HOST_DISPLAY_RAM_WIDTH + x + offset;
+            const uint8_t *p = (const uint8_t *)&_framebuffer[index];
+            uint16_t c = (p[0] << 8) | p[1];
+            *rgb++ = ((c >> 11) & 0x1F) * 255 / 31;
+            *rgb++ = ((c >> 5) & 0x3F) * 255 / 63;
+            *rgb++ = (c & 0x1F) * 255 / 31;
+        }
+    }
+    return true;
+}
+
+bool LilyGo_HostDisplay::writePPM(const char *path)
+{
+    uint16_t w, h;
+    uint8_t *rgb = (uint8_t *)malloc(JD9613_WIDTH * JD9613_HEIGHT * 3);
+    FILE *fp = fopen(path, "wb");
+    bool ok = rgb && fp && getRGB(rgb, w, h);
+    if (ok) {
+        fprintf(fp, "P6\n%u %u\n255\n", w, h);
+        ok = fwrite(rgb, 3, (size_t)w * h, fp) == (size_t)w * h;
+    }
+    if (fp) {
+        fclose(fp);
+    }
+    free(rgb);
+    return ok;
+}
+
+static uint32_t png_crc(uint32_t crc, const uint8_t *data, size_t size)
+{
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+    }
+    crc = ~crc;
+    while (size--) {
+        crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void png_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static bool png_chunk(FILE *fp, const char *type, const uint8_t *data, uint32_t size)
+{
+    uint8_t head[8];
+    uint8_t tail[4];
+    png_put32(head, size);
+    memcpy(head + 4, type, 4);
+    uint32_t crc = png_crc(png_crc(0, head + 4, 4), data, size);
+    png_put32(tail, crc);
+    return fwrite(head, 1, 8, fp) == 8 && fwrite(data, 1, size, fp) == size && fwrite(tail, 1, 4, fp) == 4;
+}
+
+// Uncompressed PNG, the image data is a zlib stream of stored deflate blocks, one per row
+bool LilyGo_HostDisplay::writePNG(const char *path)
+{
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint16_t w, h;
+    uint8_t *rgb = (uint8_t *)malloc(JD9613_WIDTH * JD9613_HEIGHT * 3);
+    if (!rgb || !getRGB(rgb, w, h)) {
+        free(rgb);
+        return false;
+    }
+
+    uint32_t row_size = 1 + w * 3;
+    uint32_t idat_size = 2 + h * (5 + row_size) + 4;
+    uint8_t *idat = (uint8_t *)malloc(idat_size);
+    FILE *fp = fopen(path, "wb");
+    bool ok = idat && fp;
+    if (ok) {
+        uint8_t *p = idat;
+        uint32_t s1 = 1, s2 = 0;
+        *p++ = 0x78;
+        *p++ = 0x01;
+        for (uint32_t y = 0; y < h; y++) {
+            *p++ = y == (uint32_t)h - 1 ? 1 : 0;
+            *p++ = row_size;
+            *p++ = row_size >> 8;
+            *p++ = ~row_size;
+            *p++ = ~row_size >> 8;
+            uint8_t *row = p;
+            *p++ = 0;   // filter none
+            memcpy(p, &rgb[y * w * 3], w * 3);
+            p += w * 3;
+            for (uint32_t i = 0; i < row_size; i++) {
+                s1 = (s1 + row[i]) % 65521;
+                s2 = (s2 + s1) % 65521;
+            }
+        }
+        png_put32(p, (s2 << 16) | s1);
+
+        uint8_t ihdr[13];
+        png_put32(ihdr, w);
+        png_put32(ihdr + 4, h);
+        ihdr[8] = 8;    // bit depth
+        ihdr[9] = 2;    // truecolor
+        ihdr[10] = 0;
+        ihdr[11] = 0;
+        ihdr[12] = 0;
+        ok = fwrite(signature, 1, 8, fp) == 8 &&
+             png_chunk(fp, "IHDR", ihdr, sizeof(ihdr)) &&
+             png_chunk(fp, "IDAT", idat, idat_size) &&
+             png_chunk(fp, "IEND", NULL, 0);
+    }
+    if (fp) {
+        fclose(fp);
+    }
+    free(idat);
+    free(rgb);
+    return ok;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file      LilyGo_HostDisplay.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "LilyGo_Display.h"
+#include "initSequence.h"
+#include "scanlineDelta.h"
+#include "panelIOMock.h"
+#include "panelFlush.h"
+
+// The controller RAM has two columns more than the panel shows, rotation 2 addresses them
+#define HOST_DISPLAY_RAM_WIDTH      (JD9613_WIDTH + 2)
+
+typedef struct {
+    uint32_t flushes;           // pushColors calls
+    uint64_t pixels;            // pixels flushed
+    uint64_t panel_bytes;       // pixel bytes that would be sent to the panel
+    uint32_t transactions;      // SPI transactions of the batched panel IO
+} host_display_stats_t;
+
+/*
+ * LilyGo_Display that renders into an in-memory copy of the JD9613 memory, for running
+ * lvgl on Linux. Flushes go through the flush path of the LilyGo_Wristband driver,
+ * panel_flush_t, on the mock panel IO: the memory holds what the driver sent.
+ */
+class LilyGo_HostDisplay : public LilyGo_Display
+{
+public:
+    LilyGo_HostDisplay();
+    ~LilyGo_HostDisplay();
+
+    // colorBits is 16 (RGB565) or 12 (RGB444), as LilyGo_Wristband::begin
+    bool begin(uint8_t colorBits = 16);
+
+    void setRotation(uint8_t rotation);
+    uint8_t getRotation();
+
+    // Panel coordinates, without software rotation
+    void setAddrWindow(uint16_t xs, uint16_t ys, uint16_t w, uint16_t h);
+    void pushColors(uint16_t *data, uint32_t len);
+
+    void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data);
+
+    uint16_t width();
+    uint16_t height();
+
+    uint8_t getPoint(int16_t *x, int16_t *y, uint8_t get_point);
+    bool hasTouch();
+
+    void setFullRefresh(bool enable);
+    bool needFullRefresh();
+
+    bool setDeltaFlush(bool enable);
+
+    void getStats(host_display_stats_t &stats);
+    void resetStats();
+
+    // Panel memory, HOST_DISPLAY_RAM_WIDTH x JD9613_HEIGHT pixels in panel byte order
+    const uint16_t *framebuffer();
+
+    // The IO the driver sends through, with the last window and the bus counters
+    const panel_io_mock_t &io();
+
+    // Write the panel content as seen in the current rotation
+    bool writePPM(const char *path);
+    bool writePNG(const char *path);
+
+private:
+    bool getRGB(uint8_t *rgb, uint16_t &w, uint16_t &h);
+
+    uint16_t *_framebuffer;
+    uint16_t *_driverBuffer;
+    panel_cmd_list_t _window;
+    bool _fullRefresh;
+    panel_io_mock_t _io;
+    panel_flush_t _flush;
+    host_display_stats_t _stats;
+};
@@ -0,0 +1,1102 @@
+/**
+ * @file      bhi260ap_emulator.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits>
+#include "Arduino.h"
+#include "bosch/bhy2_defs.h"
+#include "bosch/bhy2_head_tracker_defs.h"
+#include "bhi260ap_emulator.h"
+
+#define EMU_CHIP_ID                 0x70
+#define EMU_REVISION_ID             0x03
+#define EMU_ROM_VERSION             0x142E
+#define EMU_KERNEL_VERSION          0x1770
+
+// Error value of the bootloader when the image does not start with BHY2_FW_MAGIC
+#define EMU_ERROR_FW_HEADER         0x17
+
+#define EMU_FIFO_SIZE_WAKEUP        4096
+#define EMU_FIFO_SIZE_NON_WAKEUP    8192
+#define EMU_FIFO_SIZE_STATUS        1024
+
+// Room a sensor event takes in the FIFO, the worst case of the timestamp that precedes it
+#define EMU_EVENT_OVERHEAD          3
+
+// Erased state of the external flash
+#define EMU_FLASH_ERASED            0xFF
+
+#define EMU_NEVER                   std::numeric_limits<int64_t>::max()
+
+// Uncalibrated inputs gain one accuracy level per step while a fusion sensor runs
+#define EMU_CALIB_STEP_US           2000000
+
+// The head misalignment calibration gains one accuracy level per step
+#define EMU_HMC_STEP_US             500000
+
+// How the emulated glasses sit on the head, turned about z by this angle. Keeps the head
+// level like the sensor, so the accelerometer and gyroscope samples hold for both
+#define EMU_HEAD_MOUNT_DEG          30.0
+
+// Fusion inputs, a virtual sensor reports the lowest accuracy of its inputs
+#define EMU_SRC_ACC                 0x01
+#define EMU_SRC_GYRO                0x02
+#define EMU_SRC_MAG                 0x04
+
+// Physical sensors with a calibration state, in the order of the EMU_SRC_ bits
+static const uint8_t emu_calib_ids[] = {
+    BHY2_PHYS_SENSOR_ID_ACCELEROMETER, BHY2_PHYS_SENSOR_ID_GYROSCOPE, BHY2_PHYS_SENSOR_ID_MAGNETOMETER
+};
+// Size of the calibration state of each, more than one BSX state block
+static const uint16_t emu_calib_size[] = { 92, 112, 164 };
+
+typedef enum {
+    EMU_VECTOR,         // 3 x int16
+    EMU_ACCEL,          // 3 x int16, gravity at 4096 LSB/g
+    EMU_GYRO,           // 3 x int16, the turn rate at 32768 LSB/2000 deg/s
+    EMU_QUATERNION,     // 4 x int16 and the accuracy
+    EMU_EULER,          // heading, pitch and roll as int16
+    EMU_HEAD,           // head orientation, 4 x int16 and the accuracy byte
+    EMU_HEAD_MOUNT,     // head misalignment while it is calibrated, 4 x int16 and the progress
+    EMU_COUNTER,        // uint32
+    EMU_BYTES,          // opaque payload
+} emu_payload_t;
+
+// Virtual sensors the emulated firmware offers, event size with the sensor ID
+static const struct {
+    uint8_t id;
+    uint8_t size;
+    bool wakeup;
+    emu_payload_t payload;
+    float max_rate;
+    uint8_t sources;    // EMU_SRC_ bits, 0 for no sensor status events
+} emu_sensors[] = {
+    { BHY2_SENSOR_ID_ACC_PASS, 7, false, EMU_ACCEL, 1600, 0 },
+    { BHY2_SENSOR_ID_ACC, 7, false, EMU_ACCEL, 1600, EMU_SRC_ACC },
+    { BHY2_SENSOR_ID_ACC_WU, 7, true, EMU_ACCEL, 1600, EMU_SRC_ACC },
+    { BHY2_SENSOR_ID_GYRO_PASS, 7, false, EMU_GYRO, 1600, 0 },
+    { BHY2_SENSOR_ID_GYRO, 7, false, EMU_GYRO, 1600, EMU_SRC_GYRO },
+    { BHY2_SENSOR_ID_GYRO_WU, 7, true, EMU_GYRO, 1600, EMU_SRC_GYRO },
+    { BHY2_SENSOR_ID_MAG, 7, false, EMU_VECTOR, 100, EMU_SRC_MAG },
+    { BHY2_SENSOR_ID_MAG_WU, 7, true, EMU_VECTOR, 100, EMU_SRC_MAG },
+    { BHY2_SENSOR_ID_RV, 11, false, EMU_QUATERNION, 400, EMU_SRC_ACC | EMU_SRC_GYRO | EMU_SRC_MAG },
+    { BHY2_SENSOR_ID_RV_WU, 11, true, EMU_QUATERNION, 400, EMU_SRC_ACC | EMU_SRC_GYRO | EMU_SRC_MAG },
+    { BHY2_SENSOR_ID_GAMERV, 11, false, EMU_QUATERNION, 400, EMU_SRC_ACC | EMU_SRC_GYRO },
+    { BHY2_SENSOR_ID_GAMERV_WU, 11, true, EMU_QUATERNION, 400, EMU_SRC_ACC | EMU_SRC_GYRO },
+    { BHY2_SENSOR_ID_ORI, 7, false, EMU_EULER, 400, EMU_SRC_ACC | EMU_SRC_GYRO | EMU_SRC_MAG },
+    { BHY2_SENSOR_ID_ORI_WU, 7, true, EMU_EULER, 400, EMU_SRC_ACC | EMU_SRC_GYRO | EMU_SRC_MAG },
+    { BHY2_SENSOR_ID_STC, 5, false, EMU_COUNTER, 25, 0 },
+    { BHY2_SENSOR_ID_HEAD_ORI_MIS_ALG, 10, false, EMU_HEAD_MOUNT, 50, 0 },
+    { BHY2_SENSOR_ID_IMU_HEAD_ORI_Q, 10, false, EMU_HEAD, 400, EMU_SRC_ACC | EMU_SRC_GYRO },
+    { BHY2_SENSOR_ID_STC_WU, 5, true, EMU_COUNTER, 25, 0 },
+    // The other IDs of the fifo_parse_benchmark streams
+    { 92, 7, true, EMU_BYTES, 1600, 0 },
+    { 94, 7, true, EMU_BYTES, 1600, 0 },
+    { 160, 48, false, EMU_BYTES, 100, 0 },
+};
+
+static int find_sensor(uint8_t sensor_id)
+{
+    for (size_t i = 0; i < sizeof(emu_sensors) / sizeof(emu_sensors[0]); i++) {
+        if (emu_sensors[i].id == sensor_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int find_calib(uint16_t param)
+{
+    for (size_t i = 0; i < sizeof(emu_calib_ids); i++) {
+        if (param == (BHY2_PARAM_BSX_CALIB_STATE_BASE | emu_calib_ids[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = value >> (8 * i);
+    }
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// The emulated firmware reports a user version taken from its image, so different images
+// boot with different versions
+static uint16_t image_version(const uint8_t *image, size_t size)
+{
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ image[i]) * 16777619UL;
+    }
+    return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+static void put_float(uint8_t *p, float value)
+{
+    uint32_t reg;
+    memcpy(&reg, &value, sizeof(reg));
+    put_u32(p, reg);
+}
+
+Bhi260apEmulator::Bhi260apEmulator()
+{
+    __last_micros = micros();
+    __now_us = __last_micros;
+    setFifoSize(EMU_FIFO_SIZE_WAKEUP, EMU_FIFO_SIZE_NON_WAKEUP);
+    __fifo[BHY2_FIFO_TYPE_STATUS].capacity = EMU_FIFO_SIZE_STATUS;
+    memset(&__stats, 0, sizeof(__stats));
+    reset();
+}
+
+void Bhi260apEmulator::setIrqPin(int pin)
+{
+    __irq_pin = pin;
+}
+
+void Bhi260apEmulator::setClockDrift(int32_t ppm, uint64_t start_ticks)
+{
+    __drift_ppm = ppm;
+    __start_ticks = start_ticks;
+}
+
+void Bhi260apEmulator::setFifoSize(uint32_t wakeup_bytes, uint32_t nonwakeup_bytes)
+{
+    // A transfer length has 16 bits
+    __fifo[BHY2_FIFO_TYPE_WAKEUP].capacity = wakeup_bytes < UINT16_MAX ? wakeup_bytes : UINT16_MAX;
+    __fifo[BHY2_FIFO_TYPE_NON_WAKEUP].capacity = nonwakeup_bytes < UINT16_MAX ? nonwakeup_bytes : UINT16_MAX;
+}
+
+void Bhi260apEmulator::setFlashSize(uint32_t bytes)
+{
+    __flash.assign(bytes, EMU_FLASH_ERASED);
+    reset();
+}
+
+bool Bhi260apEmulator::loadRecording(const char *path, uint32_t interval_us)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+    __recording.clear();
+    uint8_t header[3];
+    while (fread(header, 1, 3, f) == 3) {
+        std::vector<uint8_t> data(header[1] | (header[2] << 8));
+        if (header[0] >= BHY2_FIFO_TYPE_MAX || fread(data.data(), 1, data.size(), f) != data.size()) {
+            fprintf(stderr, "%s is truncated\n", path);
+            fclose(f);
+            return false;
+        }
+        __recording.push_back(std::make_pair(header[0], data));
+    }
+    fclose(f);
+    __recording_next = 0;
+    __recording_interval_us = interval_us;
+    __recording_due_us = EMU_NEVER;
+    return true;
+}
+
+bool Bhi260apEmulator::recordingDone() const
+{
+    return __recording_next == __recording.size();
+}
+
+void Bhi260apEmulator::poll()
+{
+    uint32_t now = micros();
+    __now_us += (uint32_t)(now - __last_micros);
+    __last_micros = now;
+    if (__booted) {
+        generate();
+    }
+    updateIrq();
+}
+
+bool Bhi260apEmulator::booted() const
+{
+    return __booted;
+}
+
+float Bhi260apEmulator::getSampleRate(uint8_t sensor_id) const
+{
+    return __sensor[sensor_id].rate;
+}
+
+uint32_t Bhi260apEmulator::getGenerated(uint8_t sensor_id) const
+{
+    return __sensor[sensor_id].generated;
+}
+
+uint64_t Bhi260apEmulator::ticksAt(int64_t host_us) const
+{
+    return __start_ticks + host_us * (1000000 + __drift_ppm) / (1000000000LL / EMU_TICKS_PER_SECOND * 1000);
+}
+
+int64_t Bhi260apEmulator::ticksToHostUs(uint64_t ticks) const
+{
+    int64_t den = 1000000 + __drift_ppm;
+    return ((int64_t)(ticks - __start_ticks) * (1000000000LL / EMU_TICKS_PER_SECOND * 1000) + den / 2) / den;
+}
+
+const std::vector<uint8_t> &Bhi260apEmulator::getProgramRam() const
+{
+    return __program_ram;
+}
+
+const std::vector<uint8_t> &Bhi260apEmulator::getFlash() const
+{
+    return __flash;
+}
+
+bool Bhi260apEmulator::flashValid() const
+{
+    return __flash.size() >= 2 && (__flash[0] | (__flash[1] << 8)) == BHY2_FW_MAGIC;
+}
+
+const Bhi260apEmulator::Stats &Bhi260apEmulator::getStats() const
+{
+    return __stats;
+}
+
+// Power on state, the bootloader checks the flash and waits for the host. The flash
+// keeps its contents
+void Bhi260apEmulator::reset()
+{
+    memset(__regs, 0, sizeof(__regs));
+    __regs[BHY2_REG_PRODUCT_ID] = BHY2_PRODUCT_ID;
+    __regs[BHY2_REG_REVISION_ID] = EMU_REVISION_ID;
+    put_u16(&__regs[BHY2_REG_ROM_VERSION_0], EMU_ROM_VERSION);
+    __regs[BHY2_REG_CHIP_ID] = EMU_CHIP_ID;
+    __regs[BHY2_REG_BOOT_STATUS] = BHY2_BST_HOST_INTERFACE_READY;
+    if (__flash.empty()) {
+        __regs[BHY2_REG_BOOT_STATUS] |= BHY2_BST_NO_FLASH;
+    } else {
+        __regs[BHY2_REG_BOOT_STATUS] |= BHY2_BST_FLASH_DETECTED |
+                                        (flashValid() ? BHY2_BST_FLASH_VERIFY_DONE : BHY2_BST_FLASH_VERIFY_ERROR);
+    }
+
+    __booted = false;
+    __fw_verified = false;
+    __cmd_active = false;
+    __status.clear();
+    __status_pos = 0;
+    for (Fifo &fifo : __fifo) {
+        fifo.chunks.clear();
+        fifo.bytes = 0;
+        fifo.watermark = 0;
+        fifo.deadline_us = EMU_NEVER;
+        fifo.flush = false;
+        fifo.out.clear();
+        fifo.out_pos = 0;
+    }
+    memset(__sensor, 0, sizeof(__sensor));
+    memset(__calib_level, 0, sizeof(__calib_level));
+    __calib_due_us = EMU_NEVER;
+    __head_correction = false;
+    __head_start_us = 0;
+    __hmc_level = 0;
+    __hmc_done = false;
+    __hmc_due_us = EMU_NEVER;
+    for (int i = 0; i < 3; i++) {
+        __calib_out[i].clear();
+        __calib_out_pos[i] = 0;
+        __calib_in[i].clear();
+    }
+    __recording_next = 0;
+    __recording_due_us = EMU_NEVER;
+    updateIrq();
+}
+
+void Bhi260apEmulator::generate()
+{
+    while (__recording_next < __recording.size() && __recording_due_us <= __now_us) {
+        const std::vector<uint8_t> &data = __recording[__recording_next].second;
+        pushEvent(__recording[__recording_next].first, 0, __now_us, data.data(), data.size(), true);
+        __recording_next++;
+        __recording_due_us += __recording_interval_us;
+    }
+    if (!__recording.empty()) {
+        return;
+    }
+
+    // Samples of all sensors in time order, FIFO timestamps only count up
+    for (;;) {
+        int next = -1;
+        for (size_t i = 0; i < sizeof(emu_sensors) / sizeof(emu_sensors[0]); i++) {
+            const SensorState &state = __sensor[emu_sensors[i].id];
+            if (state.rate > 0 && state.next_us <= __now_us &&
+                    (next < 0 || state.next_us < __sensor[emu_sensors[next].id].next_us)) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        uint8_t id = emu_sensors[next].id;
+        SensorState &state = __sensor[id];
+        int64_t sample_us = llround(state.next_us);
+        uint8_t event[256];
+        event[0] = id;
+        samplePayload(id, state.generated, sample_us, &event[1]);
+        pushEvent(emu_sensors[next].wakeup ? BHY2_FIFO_TYPE_WAKEUP : BHY2_FIFO_TYPE_NON_WAKEUP,
+                  ticksAt(sample_us), sample_us + state.latency_ms * 1000LL,
+                  event, emu_sensors[next].size, false);
+        state.generated++;
+        state.next_us += 1000000.0 / state.rate;
+    }
+
+    // After the samples, FIFO timestamps only count up
+    while (__calib_due_us <= __now_us) {
+        bool done = true;
+        for (uint8_t &level : __calib_level) {
+            if (level < 3) {
+                level++;
+            }
+            done = done && level == 3;
+        }
+        __calib_due_us = done ? EMU_NEVER : __calib_due_us + EMU_CALIB_STEP_US;
+        reportAccuracy();
+    }
+
+    while (__hmc_due_us <= __now_us) {
+        __hmc_level++;
+        __hmc_done = __hmc_level == 3;
+        __hmc_due_us = __hmc_done ? EMU_NEVER : __hmc_due_us + EMU_HMC_STEP_US;
+    }
+}
+
+/*
+ * The head turns about z like the sensor. The heading counts from the time the sensor was
+ * enabled with the initial correction, and includes the mounting once it is calibrated
+ */
+void Bhi260apEmulator::getHeadOrientation(int64_t host_us, float q[4]) const
+{
+    double angle = 0.5 * (host_us - (__head_correction ? __head_start_us : 0)) / 1000000.0;
+    if (__hmc_done && !__head_correction) {
+        angle += EMU_HEAD_MOUNT_DEG * M_PI / 180;
+    }
+    q[0] = cos(angle / 2);
+    q[1] = 0;
+    q[2] = 0;
+    q[3] = sin(angle / 2);
+}
+
+// Sensor status meta event of every running sensor whose accuracy changed
+void Bhi260apEmulator::reportAccuracy()
+{
+    for (const auto &sensor : emu_sensors) {
+        SensorState &state = __sensor[sensor.id];
+        if (!sensor.sources || state.rate == 0) {
+            continue;
+        }
+        uint8_t accuracy = 3;
+        for (int i = 0; i < 3; i++) {
+            if ((sensor.sources & (1 << i)) && __calib_level[i] < accuracy) {
+                accuracy = __calib_level[i];
+            }
+        }
+        if (state.status != accuracy + 1) {
+            state.status = accuracy + 1;
+            pushMeta(sensor.wakeup ? BHY2_FIFO_TYPE_WAKEUP : BHY2_FIFO_TYPE_NON_WAKEUP,
+                     BHY2_META_EVENT_SENSOR_STATUS, sensor.id, accuracy);
+        }
+    }
+}
+
+// The state opens with the accuracy level, the rest stands for the offsets and scales
+std::vector<uint8_t> Bhi260apEmulator::calibState(int index) const
+{
+    std::vector<uint8_t> state(emu_calib_size[index]);
+    state[0] = __calib_level[index];
+    for (size_t i = 1; i < state.size(); i++) {
+        state[i] = (uint8_t)(i * 7 + index + __calib_level[index] * 13);
+    }
+    return state;
+}
+
+uint8_t Bhi260apEmulator::getCalibLevel(uint8_t phys_sensor_id) const
+{
+    for (size_t i = 0; i < sizeof(emu_calib_ids); i++) {
+        if (emu_calib_ids[i] == phys_sensor_id) {
+            return __calib_level[i];
+        }
+    }
+    return 0;
+}
+
+void Bhi260apEmulator::pushEvent(uint8_t fifo, uint64_t ticks, int64_t deadline_us, const uint8_t *bytes, uint32_t size, bool raw)
+{
+    Fifo &f = __fifo[fifo];
+    uint32_t cost = raw ? size : size + EMU_EVENT_OVERHEAD;
+    // A full FIFO overwrites its oldest events
+    while (!f.chunks.empty() && f.bytes + cost > f.capacity) {
+        const Chunk &oldest = f.chunks.front();
+        f.bytes -= oldest.raw ? oldest.bytes.size() : oldest.bytes.size() + EMU_EVENT_OVERHEAD;
+        f.chunks.pop_front();
+        __stats.dropped++;
+    }
+    Chunk chunk;
+    chunk.ticks = ticks;
+    chunk.raw = raw;
+    chunk.bytes.assign(bytes, bytes + size);
+    f.chunks.push_back(chunk);
+    f.bytes += cost;
+    if (deadline_us < f.deadline_us) {
+        f.deadline_us = deadline_us;
+    }
+    __stats.events++;
+}
+
+void Bhi260apEmulator::pushMeta(uint8_t fifo, uint8_t type, uint8_t byte1, uint8_t byte2)
+{
+    uint8_t event[4] = {
+        (uint8_t)(fifo == BHY2_FIFO_TYPE_WAKEUP ? BHY2_SYS_ID_META_EVENT_WU : BHY2_SYS_ID_META_EVENT),
+        type, byte1, byte2
+    };
+    pushEvent(fifo, ticksAt(__now_us), __now_us, event, sizeof(event), false);
+}
+
+// Slow motion around the z axis, the same for every run
+void Bhi260apEmulator::samplePayload(uint8_t sensor_id, uint32_t index, int64_t host_us, uint8_t *payload)
+{
+    int sensor = find_sensor(sensor_id);
+    double t = host_us / 1000000.0;
+    double angle = 0.5 * t;
+    switch (emu_sensors[sensor].payload) {
+    case EMU_ACCEL:
+        put_u16(&payload[0], 0);
+        put_u16(&payload[2], 0);
+        put_u16(&payload[4], 4096);
+        break;
+    case EMU_GYRO:
+        put_u16(&payload[0], 0);
+        put_u16(&payload[2], 0);
+        put_u16(&payload[4], (int16_t)lround(0.5 * 180 / M_PI * 32768 / 2000));
+        break;
+    case EMU_VECTOR:
+        put_u16(&payload[0], (int16_t)(2000 * sin(angle)));
+        put_u16(&payload[2], (int16_t)(2000 * cos(angle)));
+        put_u16(&payload[4], 4096);
+        break;
+    case EMU_QUATERNION:
+        put_u16(&payload[0], 0);
+        put_u16(&payload[2], 0);
+        put_u16(&payload[4], (int16_t)(16384 * sin(angle / 2)));
+        put_u16(&payload[6], (int16_t)(16384 * cos(angle / 2)));
+        put_u16(&payload[8], 0);
+        break;
+    case EMU_EULER:
+        put_u16(&payload[0], (int16_t)(fmod(angle * 180 / M_PI, 180) * 32768 / 360));
+        put_u16(&payload[2], 0);
+        put_u16(&payload[4], 0);
+        break;
+    case EMU_HEAD: {
+        float q[4];
+        getHeadOrientation(host_us, q);
+        put_u16(&payload[0], (int16_t)lround(16384 * q[1]));
+        put_u16(&payload[2], (int16_t)lround(16384 * q[2]));
+        put_u16(&payload[4], (int16_t)lround(16384 * q[3]));
+        put_u16(&payload[6], (int16_t)lround(16384 * q[0]));
+        payload[8] = 3;
+        break;
+    }
+    case EMU_HEAD_MOUNT: {
+        double mount = __hmc_done ? EMU_HEAD_MOUNT_DEG * M_PI / 180 : 0;
+        put_u16(&payload[0], 0);
+        put_u16(&payload[2], 0);
+        put_u16(&payload[4], (int16_t)lround(16384 * sin(mount / 2)));
+        put_u16(&payload[6], (int16_t)lround(16384 * cos(mount / 2)));
+        payload[8] = __hmc_level;
+        break;
+    }
+    case EMU_COUNTER:
+        put_u32(payload, index / 2);
+        break;
+    default:
+        for (uint8_t i = 0; i < emu_sensors[sensor].size - 1; i++) {
+            payload[i] = index + i;
+        }
+        break;
+    }
+}
+
+bool Bhi260apEmulator::pending(const Fifo &fifo) const
+{
+    if (fifo.chunks.empty()) {
+        return false;
+    }
+    return fifo.flush || fifo.deadline_us <= __now_us || (fifo.watermark && fifo.bytes >= fifo.watermark);
+}
+
+// The line is high while a FIFO has to be reported. Non wake up FIFO contents wait while
+// the host is suspended
+void Bhi260apEmulator::updateIrq()
+{
+    bool suspended = __regs[BHY2_REG_HOST_INTERFACE_CTRL] & BHY2_HIF_CTRL_AP_SUSPENDED;
+    bool level = pending(__fifo[BHY2_FIFO_TYPE_WAKEUP]) ||
+                 (!suspended && pending(__fifo[BHY2_FIFO_TYPE_NON_WAKEUP])) ||
+                 pending(__fifo[BHY2_FIFO_TYPE_STATUS]);
+    if (level == __irq_level) {
+        return;
+    }
+    __irq_level = level;
+    if (level) {
+        latchTime();
+        __stats.interrupts++;
+    }
+    if (__irq_pin >= 0) {
+        hostSetPin(__irq_pin, level ? HIGH : LOW);
+    }
+}
+
+void Bhi260apEmulator::latchTime()
+{
+    uint64_t ticks = ticksAt(__now_us);
+    for (int i = 0; i < 5; i++) {
+        __regs[BHY2_REG_HOST_INTR_TIME_0 + i] = ticks >> (8 * i);
+    }
+}
+
+uint8_t Bhi260apEmulator::interruptStatus() const
+{
+    uint8_t status = __irq_level ? BHY2_IST_MASK_ASSERTED : 0;
+    const Fifo &wakeup = __fifo[BHY2_FIFO_TYPE_WAKEUP];
+    const Fifo &nonwakeup = __fifo[BHY2_FIFO_TYPE_NON_WAKEUP];
+    if (pending(wakeup)) {
+        status |= (wakeup.watermark && wakeup.bytes >= wakeup.watermark) ? BHY2_IST_FIFO_W_WM : BHY2_IST_FIFO_W_DRDY;
+    }
+    if (pending(nonwakeup)) {
+        status |= (nonwakeup.watermark && nonwakeup.bytes >= nonwakeup.watermark) ? BHY2_IST_FIFO_NW_WM : BHY2_IST_FIFO_NW_DRDY;
+    }
+    if (!__status.empty()) {
+        status |= BHY2_IST_MASK_STATUS;
+    }
+    if (pending(__fifo[BHY2_FIFO_TYPE_STATUS])) {
+        status |= BHY2_IST_MASK_DEBUG;
+    }
+    return status;
+}
+
+// The first read of a transfer returns its length, the data follows
+void Bhi260apEmulator::readFifo(uint8_t fifo, uint8_t *data, uint32_t length)
+{
+    Fifo &f = __fifo[fifo];
+    memset(data, 0, length);
+    if (f.out_pos >= f.out.size()) {
+        encodeFifo(fifo);
+        uint16_t size = f.out.size();
+        data[0] = size & 0xFF;
+        if (length > 1) {
+            data[1] = size >> 8;
+        }
+        return;
+    }
+    uint32_t copy = f.out.size() - f.out_pos;
+    if (copy > length) {
+        copy = length;
+    }
+    memcpy(data, &f.out[f.out_pos], copy);
+    f.out_pos += copy;
+}
+
+// Move everything in the FIFO into one transfer, every transfer starts with a full timestamp
+void Bhi260apEmulator::encodeFifo(uint8_t fifo)
+{
+    Fifo &f = __fifo[fifo];
+    bool wakeup = fifo == BHY2_FIFO_TYPE_WAKEUP;
+    bool timed = false;
+    uint64_t last = 0;
+
+    f.out.clear();
+    f.out_pos = 0;
+    for (const Chunk &chunk : f.chunks) {
+        if (chunk.raw) {
+            f.out.insert(f.out.end(), chunk.bytes.begin(), chunk.bytes.end());
+            timed = false;
+            continue;
+        }
+        uint64_t delta = chunk.ticks - last;
+        if (!timed || delta > UINT16_MAX) {
+            f.out.push_back(wakeup ? BHY2_SYS_ID_TS_FULL_WU : BHY2_SYS_ID_TS_FULL);
+            for (int i = 0; i < 5; i++) {
+                f.out.push_back(chunk.ticks >> (8 * i));
+            }
+        } else if (delta > UINT8_MAX) {
+            f.out.push_back(wakeup ? BHY2_SYS_ID_TS_LARGE_DELTA_WU : BHY2_SYS_ID_TS_LARGE_DELTA);
+            f.out.push_back(delta & 0xFF);
+            f.out.push_back(delta >> 8);
+        } else if (delta) {
+            f.out.push_back(wakeup ? BHY2_SYS_ID_TS_SMALL_DELTA_WU : BHY2_SYS_ID_TS_SMALL_DELTA);
+            f.out.push_back(delta);
+        }
+        f.out.insert(f.out.end(), chunk.bytes.begin(), chunk.bytes.end());
+        last = chunk.ticks;
+        timed = true;
+    }
+    if (!f.out.empty()) {
+        __stats.transfers++;
+    }
+    f.chunks.clear();
+    f.bytes = 0;
+    f.deadline_us = EMU_NEVER;
+    f.flush = false;
+}
+
+/*
+ * Channel 0 carries commands as {uint16_t cmd, uint16_t length, payload}. The length of
+ * BHY2_CMD_UPLOAD_TO_PROGRAM_RAM counts words, and its payload spans many writes
+ */
+void Bhi260apEmulator::writeCommand(const uint8_t *data, uint32_t length)
+{
+    uint32_t pos = 0;
+    while (pos < length) {
+        if (!__cmd_active) {
+            // The rest of the write is padding
+            if (length - pos < BHY2_COMMAND_HEADER_LEN) {
+                break;
+            }
+            __cmd = data[pos] | (data[pos + 1] << 8);
+            uint32_t size = data[pos + 2] | (data[pos + 3] << 8);
+            if (!__cmd) {
+                break;
+            }
+            pos += BHY2_COMMAND_HEADER_LEN;
+            __cmd_remain = __cmd == BHY2_CMD_UPLOAD_TO_PROGRAM_RAM ? size * 4 : size;
+            __cmd_payload.clear();
+            __cmd_active = true;
+            if (__cmd == BHY2_CMD_UPLOAD_TO_PROGRAM_RAM) {
+                __program_ram.clear();
+                __fw_verified = false;
+                __regs[BHY2_REG_BOOT_STATUS] &= ~(BHY2_BST_HOST_FW_VERIFY_DONE | BHY2_BST_HOST_FW_VERIFY_ERROR);
+            }
+        }
+        uint32_t take = length - pos < __cmd_remain ? length - pos : __cmd_remain;
+        if (__cmd == BHY2_CMD_UPLOAD_TO_PROGRAM_RAM) {
+            __program_ram.insert(__program_ram.end(), data + pos, data + pos + take);
+        } else {
+            __cmd_payload.insert(__cmd_payload.end(), data + pos, data + pos + take);
+        }
+        pos += take;
+        __cmd_remain -= take;
+        if (!__cmd_remain) {
+            __cmd_active = false;
+            execCommand();
+        }
+    }
+}
+
+void Bhi260apEmulator::execCommand()
+{
+    const std::vector<uint8_t> &p = __cmd_payload;
+
+    switch (__cmd) {
+    case BHY2_CMD_UPLOAD_TO_PROGRAM_RAM:
+        if (__program_ram.size() >= 2 && (__program_ram[0] | (__program_ram[1] << 8)) == BHY2_FW_MAGIC) {
+            __fw_verified = true;
+            __regs[BHY2_REG_BOOT_STATUS] |= BHY2_BST_HOST_FW_VERIFY_DONE;
+        } else {
+            __regs[BHY2_REG_BOOT_STATUS] |= BHY2_BST_HOST_FW_VERIFY_DONE | BHY2_BST_HOST_FW_VERIFY_ERROR;
+            __regs[BHY2_REG_ERROR_VALUE] = EMU_ERROR_FW_HEADER;
+        }
+        break;
+
+    case BHY2_CMD_BOOT_PROGRAM_RAM:
+        if (__fw_verified && !__booted) {
+            boot(image_version(__program_ram.data(), __program_ram.size()));
+        }
+        break;
+
+    case BHY2_CMD_BOOT_FLASH:
+        __regs[BHY2_REG_BOOT_STATUS] &= ~(BHY2_BST_FLASH_VERIFY_DONE | BHY2_BST_FLASH_VERIFY_ERROR);
+        if (!flashValid()) {
+            __regs[BHY2_REG_BOOT_STATUS] |= BHY2_BST_FLASH_VERIFY_DONE | BHY2_BST_FLASH_VERIFY_ERROR;
+            __regs[BHY2_REG_ERROR_VALUE] = EMU_ERROR_FW_HEADER;
+        } else if (!__booted) {
+            __regs[BHY2_REG_BOOT_STATUS] |= BHY2_BST_FLASH_VERIFY_DONE;
+            boot(image_version(__flash.data(), __flash_image_size));
+        }
+        break;
+
+    // Addresses count from BHY2_FLASH_SECTOR_START_ADDR, the sectors below hold the bootloader
+    case BHY2_CMD_ERASE_FLASH:
+        if (!__booted && p.size() >= 8) {
+            uint32_t start = get_u32(&p[0]);
+            uint32_t end = get_u32(&p[4]);
+            if (start == BHY2_FLASH_BULK_ERASE) {
+                start = BHY2_FLASH_SECTOR_START_ADDR;
+                end = BHY2_FLASH_SECTOR_START_ADDR + __flash.size();
+            }
+            for (uint32_t addr = start; addr < end; addr++) {
+                if (addr >= BHY2_FLASH_SECTOR_START_ADDR && addr - BHY2_FLASH_SECTOR_START_ADDR < __flash.size()) {
+                    __flash[addr - BHY2_FLASH_SECTOR_START_ADDR] = EMU_FLASH_ERASED;
+                }
+            }
+            __flash_image_size = 0;
+            __stats.flash_erases++;
+            pushStatus(BHY2_STATUS_FLASH_ERASE_COMPLETE, NULL, 0);
+        }
+        break;
+
+    // NOR flash only clears bits, a write needs an erase before it
+    case BHY2_CMD_WRITE_FLASH:
+        if (!__booted && p.size() >= 4) {
+            uint32_t addr = get_u32(&p[0]);
+            for (size_t i = 4; i < p.size(); i++, addr++) {
+                if (addr >= BHY2_FLASH_SECTOR_START_ADDR && addr - BHY2_FLASH_SECTOR_START_ADDR < __flash.size()) {
+                    __flash[addr - BHY2_FLASH_SECTOR_START_ADDR] &= p[i];
+                    if (addr - BHY2_FLASH_SECTOR_START_ADDR >= __flash_image_size) {
+                        __flash_image_size = addr - BHY2_FLASH_SECTOR_START_ADDR + 1;
+                    }
+                }
+            }
+            __stats.flash_write_bytes += p.size() - 4;
+            pushStatus(BHY2_STATUS_FLASH_WRITE_COMPLETE, NULL, 0);
+        }
+        break;
+
+    case BHY2_CMD_CONFIG_SENSOR:
+        if (__booted && p.size() >= 8) {
+            float rate;
+            uint32_t reg = p[1] | (p[2] << 8) | (p[3] << 16) | ((uint32_t)p[4] << 24);
+            memcpy(&rate, &reg, sizeof(rate));
+            configureSensor(p[0], rate, p[5] | (p[6] << 8) | (p[7] << 16));
+        }
+        break;
+
+    case BHY2_CMD_FIFO_FLUSH:
+        if (__booted && p.size() >= 1) {
+            int sensor = find_sensor(p[0]);
+            for (uint8_t fifo = BHY2_FIFO_TYPE_WAKEUP; fifo <= BHY2_FIFO_TYPE_NON_WAKEUP; fifo++) {
+                bool wakeup = fifo == BHY2_FIFO_TYPE_WAKEUP;
+                if (sensor < 0 || emu_sensors[sensor].wakeup == wakeup) {
+                    pushMeta(fifo, BHY2_META_EVENT_FLUSH_COMPLETE, p[0], 0);
+                    __fifo[fifo].flush = true;
+                }
+            }
+        }
+        break;
+
+    // Only the accelerometer and the gyroscope support it, both end up calibrated
+    case BHY2_CMD_REQ_FOC:
+        if (__booted && p.size() >= 1) {
+            uint8_t resp[8] = { p[0], BHY2_FOC_FAILED };
+            if (p[0] == BHY2_PHYS_SENSOR_ID_ACCELEROMETER || p[0] == BHY2_PHYS_SENSOR_ID_GYROSCOPE) {
+                resp[1] = BHY2_FOC_PASS;
+                put_u16(&resp[2], (uint16_t) -12);
+                put_u16(&resp[4], 7);
+                put_u16(&resp[6], 30);
+                __calib_level[p[0] == BHY2_PHYS_SENSOR_ID_ACCELEROMETER ? 0 : 1] = 3;
+                reportAccuracy();
+            }
+            pushStatus(BHY2_STATUS_FOC_RES, resp, sizeof(resp));
+        }
+        break;
+
+    case BHY2_PARAM_FIFO_CTRL:
+        if (p.size() >= 12) {
+            __fifo[BHY2_FIFO_TYPE_WAKEUP].watermark = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+            __fifo[BHY2_FIFO_TYPE_NON_WAKEUP].watermark = p[8] | (p[9] << 8) | (p[10] << 16) | ((uint32_t)p[11] << 24);
+        }
+        break;
+
+    case BHY2_HEAD_ORI_PARAM(BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR):
+        if (__booted && p.size() >= 1) {
+            __head_correction = p[0] == BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR_ENABLE;
+        }
+        break;
+
+    case BHY2_HEAD_ORI_PARAM(BHY2_HEAD_ORI_HMC_TRIGGER_CALIB):
+        if (__booted && p.size() >= 1 && p[0] == BHY2_HEAD_ORI_HMC_TRIGGER_CALIB_SET) {
+            __hmc_level = 0;
+            __hmc_done = false;
+            __hmc_due_us = __now_us + EMU_HMC_STEP_US;
+        }
+        break;
+
+    default:
+        if (__booted && (__cmd & BHY2_PARAM_READ_MASK)) {
+            readParameter(__cmd & ~BHY2_PARAM_READ_MASK);
+        } else if (__booted && find_calib(__cmd) >= 0) {
+            writeCalibState(find_calib(__cmd));
+        }
+        break;
+    }
+}
+
+void Bhi260apEmulator::boot(uint16_t user_version)
+{
+    __booted = true;
+    put_u16(&__regs[BHY2_REG_KERNEL_VERSION_0], EMU_KERNEL_VERSION);
+    put_u16(&__regs[BHY2_REG_USER_VERSION_0], user_version);
+    pushMeta(BHY2_FIFO_TYPE_WAKEUP, BHY2_META_EVENT_INITIALIZED, EMU_KERNEL_VERSION & 0xFF, EMU_KERNEL_VERSION >> 8);
+}
+
+// A response waits in the status channel as {uint16_t code, uint16_t length, data}
+void Bhi260apEmulator::pushStatus(uint16_t code, const uint8_t *data, uint16_t size)
+{
+    __status.resize(4 + size);
+    put_u16(&__status[0], code);
+    put_u16(&__status[2], size);
+    if (size) {
+        memcpy(&__status[4], data, size);
+    }
+    __status_pos = 0;
+}
+
+/*
+ * The calibration state moves in blocks of {uint8_t block number | transfer complete flag,
+ * uint8_t block length, uint16_t state length, BHY2_BSX_STATE_BLOCK_LEN bytes}. Each read
+ * of the parameter returns the next block
+ */
+void Bhi260apEmulator::writeCalibState(int index)
+{
+    const std::vector<uint8_t> &p = __cmd_payload;
+    if (p.size() < BHY2_BSX_STATE_STRUCT_LEN) {
+        return;
+    }
+    uint8_t block = p[0] & BHY2_BSX_STATE_BLOCK_NUM_MSK;
+    if (block == 0) {
+        __calib_in[index].clear();
+    }
+    if (block * BHY2_BSX_STATE_BLOCK_LEN != __calib_in[index].size() || p[1] > BHY2_BSX_STATE_BLOCK_LEN) {
+        return;
+    }
+    __calib_in[index].insert(__calib_in[index].end(), &p[4], &p[4] + p[1]);
+    if (!(p[0] & BHY2_BSX_STATE_TRANSFER_COMPLETE)) {
+        return;
+    }
+    // A state of another size does not belong to this firmware
+    const std::vector<uint8_t> &state = __calib_in[index];
+    if (state.size() == emu_calib_size[index] && (size_t)(p[2] | (p[3] << 8)) == state.size() && state[0] <= 3) {
+        __calib_level[index] = state[0];
+        reportAccuracy();
+    }
+    __calib_in[index].clear();
+}
+
+void Bhi260apEmulator::readParameter(uint16_t param)
+{
+    uint8_t data[BHY2_BSX_STATE_STRUCT_LEN] = { 0 };
+    uint16_t size = 0;
+    int calib = find_calib(param);
+
+    if (calib >= 0) {
+        std::vector<uint8_t> &out = __calib_out[calib];
+        uint32_t &pos = __calib_out_pos[calib];
+        if (pos >= out.size()) {
+            out = calibState(calib);
+            pos = 0;
+        }
+        uint8_t length = out.size() - pos < BHY2_BSX_STATE_BLOCK_LEN ? out.size() - pos : BHY2_BSX_STATE_BLOCK_LEN;
+        data[0] = pos / BHY2_BSX_STATE_BLOCK_LEN;
+        if (pos + length >= out.size()) {
+            data[0] |= BHY2_BSX_STATE_TRANSFER_COMPLETE;
+        }
+        data[1] = length;
+        put_u16(&data[2], out.size());
+        memcpy(&data[4], &out[pos], length);
+        pos += length;
+        size = BHY2_BSX_STATE_STRUCT_LEN;
+    } else if (param == BHY2_PARAM_SYS_VIRT_SENSOR_PRESENT) {
+        for (const auto &sensor : emu_sensors) {
+            data[sensor.id / 8] |= 1 << (sensor.id % 8);
+        }
+        size = 32;
+    } else if (param == BHY2_PARAM_FIFO_CTRL) {
+        put_u32(&data[0], __fifo[BHY2_FIFO_TYPE_WAKEUP].watermark);
+        put_u32(&data[4], __fifo[BHY2_FIFO_TYPE_WAKEUP].capacity);
+        put_u32(&data[8], __fifo[BHY2_FIFO_TYPE_NON_WAKEUP].watermark);
+        put_u32(&data[12], __fifo[BHY2_FIFO_TYPE_NON_WAKEUP].capacity);
+        size = 20;
+    } else if (param >= BHY2_PARAM_SENSOR_INFO_0 && param < BHY2_PARAM_SENSOR_INFO_0 + 256) {
+        int sensor = find_sensor(param - BHY2_PARAM_SENSOR_INFO_0);
+        if (sensor >= 0) {
+            data[0] = emu_sensors[sensor].id;
+            data[3] = 1;                                        // power, mA
+            put_float(&data[8], emu_sensors[sensor].max_rate);
+            put_u32(&data[16], emu_sensors[sensor].wakeup ? EMU_FIFO_SIZE_WAKEUP : EMU_FIFO_SIZE_NON_WAKEUP);
+            data[20] = emu_sensors[sensor].size;
+            put_float(&data[21], 1.5625f);
+        }
+        size = 28;
+    } else if (param == BHY2_HEAD_ORI_PARAM(BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR)) {
+        data[0] = __head_correction;
+        size = BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR_LENGTH;
+    } else if (param == BHY2_HEAD_ORI_PARAM(BHY2_HEAD_ORI_HMC_QUAT_CALIB_CORR)) {
+        // x, y, z, w and the accuracy as int32, the quaternion in Q30
+        double mount = EMU_HEAD_MOUNT_DEG * M_PI / 180;
+        if (__hmc_done) {
+            put_u32(&data[8], (uint32_t)(int32_t)lround(1073741824.0 * sin(mount / 2)));
+            put_u32(&data[12], (uint32_t)(int32_t)lround(1073741824.0 * cos(mount / 2)));
+            put_u32(&data[16], 3);
+        }
+        size = BHY2_HEAD_ORI_HMC_QUAT_CALIB_CORR_RLENGTH;
+    } else if (param == BHY2_HEAD_ORI_PARAM(BHY2_HEAD_ORI_VERSION)) {
+        data[0] = 1;
+        size = BHY2_HEAD_ORI_VERSION_LENGTH;
+    } else if (param >= BHY2_PARAM_SENSOR_CONF_0 && param < BHY2_PARAM_SENSOR_CONF_0 + 256) {
+        const SensorState &state = __sensor[param - BHY2_PARAM_SENSOR_CONF_0];
+        put_float(&data[0], state.rate);
+        put_u32(&data[4], state.latency_ms);
+        size = 12;
+    }
+
+    pushStatus(param, data, size);
+}
+
+// Rates are rounded up to 1.5625 Hz times a power of two, like the BHI260AP firmware
+void Bhi260apEmulator::configureSensor(uint8_t sensor_id, float rate, uint32_t latency_ms)
+{
+    int sensor = find_sensor(sensor_id);
+    if (sensor < 0) {
+        return;
+    }
+    SensorState &state = __sensor[sensor_id];
+    float actual = 0;
+    if (rate > 0) {
+        actual = 1.5625f;
+        while (actual < rate && actual < emu_sensors[sensor].max_rate) {
+            actual *= 2;
+        }
+        if (actual > emu_sensors[sensor].max_rate) {
+            actual = emu_sensors[sensor].max_rate;
+        }
+    }
+    // A recording plays from the first enabled sensor on, the host knows the event sizes then
+    if (actual > 0 && __recording_due_us == EMU_NEVER) {
+        __recording_due_us = __now_us + __recording_interval_us;
+    }
+    // The first fusion sensor that runs starts the calibration
+    if (actual > 0 && emu_sensors[sensor].sources && __calib_due_us == EMU_NEVER && __recording.empty()) {
+        bool done = true;
+        for (uint8_t level : __calib_level) {
+            done = done && level == 3;
+        }
+        if (!done) {
+            __calib_due_us = __now_us + EMU_CALIB_STEP_US;
+        }
+    }
+    if (actual != state.rate) {
+        if (actual > 0) {
+            state.next_us = __now_us + 1000000.0 / actual;
+        }
+        if (actual > 0 && state.rate == 0 && sensor_id == BHY2_SENSOR_ID_IMU_HEAD_ORI_Q) {
+            __head_start_us = __now_us;
+        }
+        if (state.rate == 0) {
+            state.generated = 0;
+        }
+        state.rate = actual;
+        state.status = 0;
+        pushMeta(emu_sensors[sensor].wakeup ? BHY2_FIFO_TYPE_WAKEUP : BHY2_FIFO_TYPE_NON_WAKEUP,
+                 BHY2_META_EVENT_SAMPLE_RATE_CHANGED, sensor_id, 0);
+        if (__recording.empty()) {
+            reportAccuracy();
+        }
+    }
+    state.latency_ms = latency_ms;
+}
+
+int8_t Bhi260apEmulator::read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    Bhi260apEmulator *emu = (Bhi260apEmulator *)intf_ptr;
+    // The SPI transport sets the read bit
+    uint8_t reg = reg_addr & 0x7F;
+
+    emu->poll();
+    emu->__stats.read_bytes += length;
+    emu->__stats.transactions++;
+
+    switch (reg) {
+    case BHY2_REG_CHAN_FIFO_W:
+        emu->readFifo(BHY2_FIFO_TYPE_WAKEUP, reg_data, length);
+        break;
+    case BHY2_REG_CHAN_FIFO_NW:
+        emu->readFifo(BHY2_FIFO_TYPE_NON_WAKEUP, reg_data, length);
+        break;
+    case BHY2_REG_CHAN_STATUS:
+        if (emu->__status.empty()) {
+            emu->readFifo(BHY2_FIFO_TYPE_STATUS, reg_data, length);
+            break;
+        }
+        for (uint32_t i = 0; i < length; i++) {
+            reg_data[i] = emu->__status_pos < emu->__status.size() ? emu->__status[emu->__status_pos++] : 0;
+        }
+        if (emu->__status_pos >= emu->__status.size()) {
+            emu->__status.clear();
+        }
+        break;
+    default:
+        for (uint32_t i = 0; i < length; i++) {
+            uint8_t addr = reg + i;
+            if (addr == BHY2_REG_INT_STATUS) {
+                reg_data[i] = emu->interruptStatus();
+            } else {
+                reg_data[i] = addr < sizeof(emu->__regs) ? emu->__regs[addr] : 0;
+            }
+        }
+        break;
+    }
+    emu->updateIrq();
+    return BHY2_INTF_RET_SUCCESS;
+}
+
+int8_t Bhi260apEmulator::write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    Bhi260apEmulator *emu = (Bhi260apEmulator *)intf_ptr;
+    uint8_t reg = reg_addr & 0x7F;
+
+    emu->poll();
+    emu->__stats.write_bytes += length;
+    emu->__stats.transactions++;
+
+    if (reg == BHY2_REG_CHAN_CMD) {
+        emu->writeCommand(reg_data, length);
+    } else {
+        for (uint32_t i = 0; i < length; i++) {
+            uint8_t addr = reg + i;
+            switch (addr) {
+            case BHY2_REG_RESET_REQ:
+                if (reg_data[i] & BHY2_REQUEST_RESET) {
+                    emu->reset();
+                }
+                break;
+            case BHY2_REG_TIME_EV_REQ:
+                emu->latchTime();
+                break;
+            case BHY2_REG_CHIP_CTRL:
+            case BHY2_REG_HOST_INTERFACE_CTRL:
+            case BHY2_REG_HOST_INTERRUPT_CTRL:
+            case BHY2_REG_HOST_CTRL:
+                emu->__regs[addr] = reg_data[i];
+                break;
+            default:
+                // Read only
+                break;
+            }
+        }
+    }
+    emu->updateIrq();
+    return BHY2_INTF_RET_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file      bhi260ap_emulator.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      BHI260AP host interface emulation behind the bhy2 bus functions, so
+ *            SensorBHI260AP runs unchanged on the host. Covers the registers, the
+ *            firmware upload and boot, virtual sensor configuration and parameters, the
+ *            BSX calibration state and FOC, the head tracker module, and the wake up,
+ *            non wake up and status FIFOs, fed with synthetic samples of the configured
+ *            sensors or with recorded FIFO transfers
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+// Sensor ticks per second, the BHI260AP timestamp unit is 1/64000 s
+#define EMU_TICKS_PER_SECOND        64000
+
+class Bhi260apEmulator
+{
+public:
+    typedef struct {
+        uint64_t read_bytes;
+        uint64_t write_bytes;
+        uint32_t transactions;
+        uint32_t interrupts;        // rising edges of the interrupt line
+        uint32_t events;            // events put into the FIFOs
+        uint32_t dropped;           // events overwritten in a full FIFO
+        uint32_t transfers;         // FIFO transfers read by the host
+        uint32_t flash_erases;
+        uint64_t flash_write_bytes;
+    } Stats;
+
+    Bhi260apEmulator();
+
+    // Pin driven through hostSetPin(), -1 for none
+    void setIrqPin(int pin);
+
+    // The sensor clock runs ppm faster than micros() and reads start_ticks at host time 0
+    void setClockDrift(int32_t ppm, uint64_t start_ticks = 0);
+
+    void setFifoSize(uint32_t wakeup_bytes, uint32_t nonwakeup_bytes);
+
+    // Attach an erased external flash of this size, 0 for none, the default. Resets the sensor
+    void setFlashSize(uint32_t bytes);
+
+    /**
+     * @brief  Serve recorded FIFO transfers instead of synthetic samples, in the format of
+     *         fifo_parse_benchmark --record. Once the host enables a sensor, the next
+     *         transfer enters its FIFO every interval_us
+     */
+    bool loadRecording(const char *path, uint32_t interval_us);
+    bool recordingDone() const;
+
+    // Catch up with micros(): generate the samples that are due and update the interrupt line
+    void poll();
+
+    bool booted() const;
+    float getSampleRate(uint8_t sensor_id) const;
+    // Samples generated for a sensor since it was enabled
+    uint32_t getGenerated(uint8_t sensor_id) const;
+    // Calibration accuracy 0..3 of a physical sensor, BHY2_PHYS_SENSOR_ID_
+    uint8_t getCalibLevel(uint8_t phys_sensor_id) const;
+    // Head orientation the head tracker sensors report for a sample taken at host_us, w, x, y, z
+    void getHeadOrientation(int64_t host_us, float q[4]) const;
+    // micros() at which the sensor clock read ticks
+    int64_t ticksToHostUs(uint64_t ticks) const;
+    // Image of the last BHY2_CMD_UPLOAD_TO_PROGRAM_RAM, padded to whole words
+    const std::vector<uint8_t> &getProgramRam() const;
+    // Flash from BHY2_FLASH_SECTOR_START_ADDR on
+    const std::vector<uint8_t> &getFlash() const;
+    const Stats &getStats() const;
+
+    // bhy2_read_fptr_t and bhy2_write_fptr_t, intf_ptr is the emulator
+    static int8_t read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr);
+    static int8_t write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr);
+
+private:
+    // An event waiting in a FIFO. Sensor events get their timestamp when the FIFO is read,
+    // recorded transfers are copied as they are
+    typedef struct {
+        uint64_t ticks;
+        bool raw;
+        std::vector<uint8_t> bytes;
+    } Chunk;
+
+    typedef struct {
+        std::deque<Chunk> chunks;
+        uint32_t bytes;
+        uint32_t capacity;
+        uint32_t watermark;
+        int64_t deadline_us;        // the FIFO must be reported by then, report latency
+        bool flush;
+        std::vector<uint8_t> out;   // transfer being read by the host
+        uint32_t out_pos;
+    } Fifo;
+
+    typedef struct {
+        float rate;
+        uint32_t latency_ms;
+        double next_us;
+        uint32_t generated;
+        uint8_t status;             // accuracy + 1 of the last sensor status event, 0 for none
+    } SensorState;
+
+    void reset();
+    bool flashValid() const;
+    void boot(uint16_t user_version);
+    void pushStatus(uint16_t code, const uint8_t *data, uint16_t size);
+    uint64_t ticksAt(int64_t host_us) const;
+    void generate();
+    void pushEvent(uint8_t fifo, uint64_t ticks, int64_t deadline_us, const uint8_t *bytes, uint32_t size, bool raw);
+    void pushMeta(uint8_t fifo, uint8_t type, uint8_t byte1, uint8_t byte2);
+    void samplePayload(uint8_t sensor_id, uint32_t index, int64_t host_us, uint8_t *payload);
+    bool pending(const Fifo &fifo) const;
+    void updateIrq();
+    void latchTime();
+    uint8_t interruptStatus() const;
+    void readFifo(uint8_t fifo, uint8_t *data, uint32_t length);
+    void encodeFifo(uint8_t fifo);
+    void writeCommand(const uint8_t *data, uint32_t length);
+    void execCommand();
+    void readParameter(uint16_t param);
+    void configureSensor(uint8_t sensor_id, float rate, uint32_t latency_ms);
+    void reportAccuracy();
+    std::vector<uint8_t> calibState(int index) const;
+    void writeCalibState(int index);
+
+    uint8_t __regs[0x40];
+    int __irq_pin = -1;
+    bool __irq_level = false;
+    int32_t __drift_ppm = 0;
+    uint64_t __start_ticks = 0;
+    int64_t __now_us = 0;
+    uint32_t __last_micros = 0;
+    bool __booted = false;
+    bool __fw_verified = false;
+
+    // Command channel
+    uint16_t __cmd = 0;
+    uint32_t __cmd_remain = 0;
+    bool __cmd_active = false;
+    std::vector<uint8_t> __cmd_payload;
+    std::vector<uint8_t> __program_ram;
+    std::vector<uint8_t> __flash;
+    uint32_t __flash_image_size = 0;    // end of the last write since the erase
+
+    // Synchronous status channel, parameter responses
+    std::vector<uint8_t> __status;
+    uint32_t __status_pos = 0;
+
+    Fifo __fifo[3];
+    SensorState __sensor[256];
+
+    // Calibration of the accelerometer, gyroscope and magnetometer, lost on reset
+    uint8_t __calib_level[3];
+    int64_t __calib_due_us = 0;
+    std::vector<uint8_t> __calib_out[3];    // state being read by the host
+    uint32_t __calib_out_pos[3];
+    std::vector<uint8_t> __calib_in[3];     // blocks written by the host
+
+    // Head tracker module, lost on reset
+    bool __head_correction = false;
+    int64_t __head_start_us = 0;            // the head orientation was enabled
+    uint8_t __hmc_level = 0;                // progress of the misalignment calibration
+    bool __hmc_done = false;
+    int64_t __hmc_due_us = 0;
+
+    std::vector<std::pair<uint8_t, std::vector<uint8_t> > > __recording;
+    size_t __recording_next = 0;
+    uint32_t __recording_interval_us = 0;
+    int64_t __recording_due_us = 0;
+
+    Stats __stats;
+};
@@ -0,0 +1,185 @@
+/**
+ * @file      calibration_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Boots the emulated BHI260AP twice. The first boot calibrates from scratch, runs
+ *            an FOC and saves the calibration state, the second restores it before the
+ *            sensors start. Reports the time until the fusion reports full accuracy, and the
+ *            size and bus cost of the state. Exits with 1 on a failure
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "SensorBHI260AP.hpp"
+#include "bhi260ap_emulator.h"
+
+#define EMU_IRQ_PIN     21
+
+typedef struct {
+    bool ok;
+    int64_t accurate_us;        // from enabling the sensors until full accuracy, -1 for never
+    uint64_t restore_bytes;
+    uint64_t save_bytes;
+    std::vector<uint8_t> state;
+} run_result_t;
+
+static Bhi260apEmulator emu;
+
+static uint64_t bus_bytes()
+{
+    const Bhi260apEmulator::Stats &stats = emu.getStats();
+    return stats.read_bytes + stats.write_bytes;
+}
+
+static run_result_t run(const std::vector<uint8_t> *restore, uint32_t rw_len, uint32_t step_us, uint32_t timeout_s)
+{
+    run_result_t result = {};
+    result.accurate_us = -1;
+    SensorBHI260AP bhy;
+
+    bhy.setPins(SENSOR_PIN_NONE, EMU_IRQ_PIN);
+    if (!bhy.init(Bhi260apEmulator::read, Bhi260apEmulator::write, &emu, rw_len)) {
+        fprintf(stderr, "init failed: %s\n", bhy.getError().c_str());
+        return result;
+    }
+
+    if (restore) {
+        uint64_t start = bus_bytes();
+        if (!bhy.restoreCalibration(restore->data(), restore->size())) {
+            fprintf(stderr, "restoreCalibration failed\n");
+            return result;
+        }
+        result.restore_bytes = bus_bytes() - start;
+
+        // Neither a state of another kernel nor a cut one may reach the firmware
+        std::vector<uint8_t> other = *restore;
+        other[4] ^= 1;
+        if (bhy.restoreCalibration(other.data(), other.size()) ||
+                bhy.restoreCalibration(restore->data(), restore->size() - 1)) {
+            fprintf(stderr, "invalid calibration state accepted\n");
+            return result;
+        }
+    }
+
+    if (!bhy.configure(SENSOR_ID_RV, 50, 0) || !bhy.configure(SENSOR_ID_GAMERV, 50, 0)) {
+        fprintf(stderr, "configure failed\n");
+        return result;
+    }
+    uint32_t start_us = micros();
+    for (uint64_t t = 0; t < (uint64_t)timeout_s * 1000000; t += step_us) {
+        hostAdvanceMicros(step_us);
+        emu.poll();
+        bhy.update();
+        if (bhy.getAccuracy(SENSOR_ID_RV) == 3 && bhy.getAccuracy(SENSOR_ID_GAMERV) == 3) {
+            result.accurate_us = micros() - start_us;
+            break;
+        }
+    }
+    if (result.accurate_us < 0) {
+        fprintf(stderr, "rotation vector accuracy stuck at %u\n", bhy.getAccuracy(SENSOR_ID_RV));
+        return result;
+    }
+    if (!bhy.calibrationDue()) {
+        fprintf(stderr, "full accuracy did not make a save due\n");
+        return result;
+    }
+
+    if (!restore) {
+        struct bhy2_foc_resp foc;
+        if (!bhy.performFOC(BHY2_PHYS_SENSOR_ID_ACCELEROMETER, foc) ||
+                bhy.performFOC(BHY2_PHYS_SENSOR_ID_MAGNETOMETER, foc)) {
+            fprintf(stderr, "FOC result unexpected\n");
+            return result;
+        }
+    }
+
+    uint64_t start = bus_bytes();
+    result.state.resize(SENSOR_CALIB_STATE_MAX);
+    size_t size = bhy.saveCalibration(result.state.data(), result.state.size());
+    result.save_bytes = bus_bytes() - start;
+    result.state.resize(size);
+    if (!size || bhy.calibrationDue()) {
+        fprintf(stderr, "saveCalibration failed, %u bytes\n", (unsigned)size);
+        return result;
+    }
+    result.ok = true;
+    return result;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --rw-len BYTES      largest single bus transfer, default 256\n");
+    printf("  --step-us N         host loop period, default 1000\n");
+    printf("  --timeout-s N       longest wait for full accuracy, default 30\n");
+    printf("  --spi-hz N          bus clock for the transfer time, default 20000000\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rw_len = 256;
+    uint32_t step_us = 1000;
+    uint32_t timeout_s = 30;
+    uint32_t spi_hz = 20000000;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--rw-len") && has_value) {
+            rw_len = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--step-us") && has_value) {
+            step_us = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--timeout-s") && has_value) {
+            timeout_s = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--spi-hz") && has_value) {
+            spi_hz = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!rw_len || !step_us || !timeout_s || !spi_hz) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    emu.setIrqPin(EMU_IRQ_PIN);
+
+    run_result_t cold = run(NULL, rw_len, step_us, timeout_s);
+    if (!cold.ok) {
+        printf("FAIL\n");
+        return 1;
+    }
+    run_result_t warm = run(&cold.state, rw_len, step_us, timeout_s);
+    if (!warm.ok) {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    bool ok = true;
+    // The restored firmware holds what was saved, and the FOC left the accelerometer calibrated
+    if (warm.state != cold.state) {
+        fprintf(stderr, "restored state differs from the saved one\n");
+        ok = false;
+    }
+    if (emu.getCalibLevel(BHY2_PHYS_SENSOR_ID_ACCELEROMETER) != 3) {
+        fprintf(stderr, "accelerometer calibration lost\n");
+        ok = false;
+    }
+    if (warm.accurate_us > 2 * step_us) {
+        fprintf(stderr, "restored fusion took %lld us to full accuracy\n", (long long)warm.accurate_us);
+        ok = false;
+    }
+
+    printf("%-10s %16s %11s %11s\n", "boot", "full accuracy ms", "save bytes", "restore bytes");
+    printf("%-10s %16.1f %11llu %11s\n", "cold", cold.accurate_us / 1000.0, (unsigned long long)cold.save_bytes, "-");
+    printf("%-10s %16.1f %11llu %11llu\n", "restored", warm.accurate_us / 1000.0,
+           (unsigned long long)warm.save_bytes, (unsigned long long)warm.restore_bytes);
+    printf("\ncalibration state: %u bytes, restore moves %.2f ms of bus time at %u Hz\n",
+           (unsigned)cold.state.size(), warm.restore_bytes * 8 * 1000.0 / spi_hz, spi_hz);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file      color_pack_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-17
+ * @note      Checks color_pack_rgb444 against a per pixel reference for every RGB565 value,
+ *            in place and out of place, for odd and even counts, checks that the driver caps
+ *            a packed transfer at the frame buffer, and reports the throughput
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "colorPack.h"
+#include "panelFlush.h"
+#include "panelIOMock.h"
+#include "initSequence.h"
+
+#define FRAME_PIXELS        (JD9613_WIDTH * JD9613_HEIGHT)
+#define GUARD_BYTES         8
+#define GUARD_VALUE         0xA5
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --iterations N  frames packed for the throughput, default 2000\n");
+}
+
+// One nibble at a time: R, G and B of each pixel keep their upper four bits
+static size_t reference_pack(uint8_t *dst, const uint16_t *src, size_t count)
+{
+    const uint8_t *s = (const uint8_t *)src;
+    size_t nibbles = 0;
+    memset(dst, 0, COLOR_PACK_RGB444_SIZE(count));
+    for (size_t i = 0; i < count; i++) {
+        uint32_t rgb565 = ((uint32_t)s[i * 2] << 8) | s[i * 2 + 1];
+        uint8_t channels[3] = {
+            (uint8_t)((rgb565 >> 11) >> 1),
+            (uint8_t)(((rgb565 >> 5) & 0x3F) >> 2),
+            (uint8_t)((rgb565 & 0x1F) >> 1),
+        };
+        for (int c = 0; c < 3; c++, nibbles++) {
+            dst[nibbles / 2] |= (nibbles & 1) ? channels[c] : channels[c] << 4;
+        }
+    }
+    return (nibbles + 1) / 2;
+}
+
+static bool check(const uint16_t *src, size_t count, bool in_place)
+{
+    const size_t size = COLOR_PACK_RGB444_SIZE(count);
+    std::vector<uint8_t> expected(size + 1);
+    std::vector<uint16_t> buffer(count + GUARD_BYTES);
+    uint8_t *dst = (uint8_t *)buffer.data();
+
+    size_t expected_size = reference_pack(expected.data(), src, count);
+    memset(dst, GUARD_VALUE, buffer.size() * sizeof(uint16_t));
+    if (in_place) {
+        memcpy(buffer.data(), src, count * sizeof(uint16_t));
+    }
+
+    size_t written = color_pack_rgb444(dst, in_place ? buffer.data() : src, count);
+    if (written != expected_size || written != size) {
+        printf("  %u pixels%s: %u bytes written, expected %u\n", (unsigned)count,
+               in_place ? " in place" : "", (unsigned)written, (unsigned)expected_size);
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        if (dst[i] != expected[i]) {
+            printf("  %u pixels%s: byte %u is 0x%02X, expected 0x%02X\n", (unsigned)count,
+                   in_place ? " in place" : "", (unsigned)i, dst[i], expected[i]);
+            return false;
+        }
+    }
+    // In place the bytes after the output still hold source pixels
+    for (size_t i = 0; !in_place && i < GUARD_BYTES; i++) {
+        if (dst[size + i] != GUARD_VALUE) {
+            printf("  %u pixels: wrote past %u bytes\n", (unsigned)count, (unsigned)size);
+            return false;
+        }
+    }
+    return true;
+}
+
+// A 12-bit transfer from outside the driver buffers is packed into the frame buffer, at most all of it
+static bool check_cap(const uint16_t *src)
+{
+    std::vector<uint16_t> frame_buffer(FRAME_PIXELS);
+    std::vector<uint8_t> expected(COLOR_PACK_RGB444_SIZE(FRAME_PIXELS));
+    panel_io_mock_t io;
+    panel_flush_t flush;
+    panel_cmd_list_t list;
+
+    panel_io_mock_init(&io, true, 0);
+    panel_flush_init(&flush, &io.base, frame_buffer.data(), 12, false);
+    panel_cmd_list_clear(&list);
+    panel_flush_submit(&flush, &list, src, (FRAME_PIXELS + 64) * sizeof(uint16_t), true);
+
+    reference_pack(expected.data(), src, FRAME_PIXELS);
+    if (io.base.stats.color_bytes != expected.size()) {
+        printf("  oversized transfer sent %llu bytes, expected %u\n",
+               (unsigned long long)io.base.stats.color_bytes, (unsigned)expected.size());
+        return false;
+    }
+    if (memcmp(frame_buffer.data(), expected.data(), expected.size())) {
+        printf("  oversized transfer packed wrong pixels\n");
+        return false;
+    }
+    return true;
+}
+
+// Mpixel/s of packing the panel frame
+static double throughput(size_t (*pack)(uint8_t *, const uint16_t *, size_t), bool in_place, uint32_t iterations)
+{
+    std::vector<uint16_t> src(FRAME_PIXELS);
+    std::vector<uint16_t> dst(FRAME_PIXELS);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = rand();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (in_place) {
+            // The driver packs the frame buffer it just rotated or rendered into
+            memcpy(dst.data(), src.data(), FRAME_PIXELS * sizeof(uint16_t));
+            pack((uint8_t *)dst.data(), dst.data(), FRAME_PIXELS);
+        } else {
+            pack((uint8_t *)dst.data(), src.data(), FRAME_PIXELS);
+        }
+        src[i % FRAME_PIXELS] ^= dst[(i * 7) % FRAME_PIXELS];
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0 ? (double)FRAME_PIXELS * iterations / seconds / 1e6 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--iterations") && has_value) {
+            iterations = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    srand(1);
+    uint32_t failures = 0;
+
+    // Every RGB565 value, each one at an even and an odd pixel position
+    std::vector<uint16_t> all(65536);
+    for (uint32_t i = 0; i < all.size(); i++) {
+        all[i] = i;
+    }
+    failures += !check(all.data(), all.size(), false);
+    failures += !check(all.data(), all.size(), true);
+    failures += !check(all.data() + 1, all.size() - 1, false);
+    printf("all 65536 values: %s\n", failures ? "FAILED" : "match");
+
+    uint32_t count_failures = 0;
+    std::vector<uint16_t> pixels(FRAME_PIXELS + 64);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = rand();
+    }
+    for (size_t count = 0; count <= 67; count++) {
+        count_failures += !check(pixels.data(), count, false);
+        count_failures += !check(pixels.data(), count, true);
+    }
+    for (size_t count = FRAME_PIXELS - 3; count <= FRAME_PIXELS; count++) {
+        count_failures += !check(pixels.data(), count, false);
+        count_failures += !check(pixels.data(), count, true);
+    }
+    printf("counts 0..67 and %u..%u: %s\n", FRAME_PIXELS - 3, FRAME_PIXELS, count_failures ? "FAILED" : "match");
+    failures += count_failures;
+
+    bool cap = check_cap(pixels.data());
+    printf("transfer capped at the frame buffer: %s\n", cap ? "yes" : "FAILED");
+    failures += !cap;
+
+    printf("%ux%u frame        color_pack_rgb444    per pixel\n", JD9613_WIDTH, JD9613_HEIGHT);
+    printf("  out of place   %9.1f Mpx/s  %9.1f Mpx/s\n",
+           throughput(color_pack_rgb444, false, iterations), throughput(reference_pack, false, iterations));
+    // The reference clears its output first, it cannot run in place
+    printf("  in place       %9.1f Mpx/s\n", throughput(color_pack_rgb444, true, iterations));
+
+    if (failures) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
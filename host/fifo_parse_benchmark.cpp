@@ -0,0 +1,425 @@
+/**
+ * @file      fifo_parse_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Feeds BHI260AP FIFO transfers through bhy2_get_and_process_fifo and
+ *            bhy2_get_and_process_fifo_ring, checks that both deliver the same events
+ *            and reports the cost of each
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "bosch/bhy2.h"
+
+/*
+ * A transfer is what one FIFO holds when the host reads it. Recordings are a sequence of
+ *   uint8_t fifo (BHY2_FIFO_TYPE_*), uint16_t length (little endian), length bytes
+ */
+typedef struct {
+    uint8_t fifo;
+    std::vector<uint8_t> data;
+} fifo_transfer_t;
+
+// Virtual sensors of the generated stream and their event sizes, sensor ID included
+static const struct {
+    uint8_t id;
+    uint8_t size;
+} stream_sensors[] = {
+    { 1, 7 },       // accelerometer passthrough
+    { 10, 7 },      // gyroscope passthrough
+    { 34, 11 },     // rotation vector
+    { 37, 11 },     // game rotation vector
+    { 160, 48 },    // larger than the first copy of an event that wraps
+    { 92, 7 },      // accelerometer corrected wake up
+    { 94, 7 },      // gyroscope corrected wake up
+};
+
+/* Emulated host interface, serves one transfer per FIFO and drain */
+typedef struct {
+    const std::vector<fifo_transfer_t> *transfers;
+    size_t next;
+    const fifo_transfer_t *pending[BHY2_FIFO_TYPE_MAX];
+    const fifo_transfer_t *active;
+    uint32_t pos;
+} fifo_mock_t;
+
+static uint8_t fifo_channel(uint8_t fifo)
+{
+    switch (fifo) {
+    case BHY2_FIFO_TYPE_WAKEUP:
+        return BHY2_REG_CHAN_FIFO_W;
+    case BHY2_FIFO_TYPE_NON_WAKEUP:
+        return BHY2_REG_CHAN_FIFO_NW;
+    default:
+        return BHY2_REG_CHAN_STATUS;
+    }
+}
+
+// Queue the transfers of the next drain, at most one per FIFO
+static bool mock_load(fifo_mock_t *mock)
+{
+    memset(mock->pending, 0, sizeof(mock->pending));
+    bool loaded = false;
+    while (mock->next < mock->transfers->size()) {
+        const fifo_transfer_t *transfer = &(*mock->transfers)[mock->next];
+        if (mock->pending[transfer->fifo]) {
+            break;
+        }
+        mock->pending[transfer->fifo] = transfer;
+        mock->next++;
+        loaded = true;
+    }
+    return loaded;
+}
+
+static int8_t mock_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    fifo_mock_t *mock = (fifo_mock_t *)intf_ptr;
+
+    if (reg_addr == BHY2_REG_INT_STATUS) {
+        reg_data[0] = 0;
+        if (mock->pending[BHY2_FIFO_TYPE_WAKEUP]) {
+            reg_data[0] |= BHY2_IST_FIFO_W_DRDY;
+        }
+        if (mock->pending[BHY2_FIFO_TYPE_NON_WAKEUP]) {
+            reg_data[0] |= BHY2_IST_FIFO_NW_DRDY;
+        }
+        if (mock->pending[BHY2_FIFO_TYPE_STATUS]) {
+            reg_data[0] |= BHY2_IST_MASK_DEBUG;
+        }
+        return BHY2_INTF_RET_SUCCESS;
+    }
+
+    for (uint8_t fifo = 0; fifo < BHY2_FIFO_TYPE_MAX; fifo++) {
+        if (reg_addr != fifo_channel(fifo)) {
+            continue;
+        }
+        // The first read of a transfer returns its length
+        if (!mock->active || mock->active->fifo != fifo || mock->pos == mock->active->data.size()) {
+            mock->active = mock->pending[fifo];
+            mock->pending[fifo] = NULL;
+            mock->pos = 0;
+            uint16_t size = mock->active ? mock->active->data.size() : 0;
+            reg_data[0] = size & 0xFF;
+            reg_data[1] = size >> 8;
+            return BHY2_INTF_RET_SUCCESS;
+        }
+        if (mock->pos + length > mock->active->data.size()) {
+            return -1;
+        }
+        memcpy(reg_data, &mock->active->data[mock->pos], length);
+        mock->pos += length;
+        return BHY2_INTF_RET_SUCCESS;
+    }
+    return -1;
+}
+
+static int8_t mock_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    (void)reg_addr;
+    (void)reg_data;
+    (void)length;
+    (void)intf_ptr;
+    return BHY2_INTF_RET_SUCCESS;
+}
+
+static void mock_delay_us(uint32_t period_us, void *intf_ptr)
+{
+    (void)period_us;
+    (void)intf_ptr;
+}
+
+/* Event sinks */
+typedef struct {
+    uint32_t events;
+    uint64_t hash;
+    std::vector<uint8_t> *log;      // every event in order, for the comparison
+} event_sink_t;
+
+static void hash_bytes(uint64_t &hash, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ p[i]) * UINT64_C(1099511628211);
+    }
+}
+
+static void sink_event(const struct bhy2_fifo_parse_data_info *info, void *ref)
+{
+    event_sink_t *sink = (event_sink_t *)ref;
+    sink->events++;
+    hash_bytes(sink->hash, &info->sensor_id, 1);
+    hash_bytes(sink->hash, info->time_stamp, sizeof(uint64_t));
+    hash_bytes(sink->hash, info->data_ptr, info->data_size - 1);
+    if (sink->log) {
+        sink->log->push_back(info->fifo_type);
+        sink->log->push_back(info->sensor_id);
+        sink->log->insert(sink->log->end(), (const uint8_t *)info->time_stamp, (const uint8_t *)info->time_stamp + 8);
+        sink->log->insert(sink->log->end(), info->data_ptr, info->data_ptr + info->data_size - 1);
+    }
+}
+
+/* Stream generation */
+static uint32_t rng_state = 1;
+
+static uint32_t rng()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void put_event(std::vector<uint8_t> &data, uint8_t id, uint8_t size)
+{
+    data.push_back(id);
+    for (uint8_t i = 1; i < size; i++) {
+        data.push_back(rng());
+    }
+}
+
+static void generate(std::vector<fifo_transfer_t> &transfers, uint32_t count, uint32_t max_events)
+{
+    uint64_t ticks[BHY2_FIFO_TYPE_MAX] = { 64000, 64000, 64000 };
+    for (uint32_t n = 0; n < count; n++) {
+        fifo_transfer_t transfer;
+        transfer.fifo = (rng() % 8) ? (rng() & 1 ? BHY2_FIFO_TYPE_NON_WAKEUP : BHY2_FIFO_TYPE_WAKEUP) : BHY2_FIFO_TYPE_STATUS;
+        std::vector<uint8_t> &data = transfer.data;
+        bool wakeup = transfer.fifo == BHY2_FIFO_TYPE_WAKEUP;
+
+        if (transfer.fifo == BHY2_FIFO_TYPE_STATUS) {
+            put_event(data, BHY2_SYS_ID_DEBUG_MSG, 18);
+            transfers.push_back(transfer);
+            continue;
+        }
+
+        // Every transfer starts with a full timestamp
+        ticks[transfer.fifo] += rng() % 1000;
+        data.push_back(wakeup ? BHY2_SYS_ID_TS_FULL_WU : BHY2_SYS_ID_TS_FULL);
+        for (int i = 0; i < 5; i++) {
+            data.push_back(ticks[transfer.fifo] >> (8 * i));
+        }
+
+        uint32_t events = 1 + rng() % max_events;
+        for (uint32_t i = 0; i < events; i++) {
+            uint32_t kind = rng() % 32;
+            if (kind == 0) {
+                data.push_back(wakeup ? BHY2_SYS_ID_TS_LARGE_DELTA_WU : BHY2_SYS_ID_TS_LARGE_DELTA);
+                data.push_back(rng());
+                data.push_back(rng());
+            } else if (kind == 1) {
+                put_event(data, wakeup ? BHY2_SYS_ID_META_EVENT_WU : BHY2_SYS_ID_META_EVENT, 4);
+                data[data.size() - 3] = BHY2_META_EVENT_FIFO_WATERMARK;
+            } else if (kind == 2) {
+                data.push_back(BHY2_SYS_ID_FILLER);
+            } else {
+                data.push_back(wakeup ? BHY2_SYS_ID_TS_SMALL_DELTA_WU : BHY2_SYS_ID_TS_SMALL_DELTA);
+                data.push_back(rng());
+                uint32_t s = wakeup ? 5 + rng() % 2 : rng() % 5;
+                put_event(data, stream_sensors[s].id, stream_sensors[s].size);
+            }
+        }
+        // The FIFO is padded to whole words
+        while (data.size() & 3) {
+            data.push_back(BHY2_SYS_ID_PADDING);
+        }
+        transfers.push_back(transfer);
+    }
+}
+
+static bool load(const char *path, std::vector<fifo_transfer_t> &transfers)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+    uint8_t header[3];
+    while (fread(header, 1, 3, f) == 3) {
+        fifo_transfer_t transfer;
+        transfer.fifo = header[0];
+        transfer.data.resize(header[1] | (header[2] << 8));
+        if (transfer.fifo >= BHY2_FIFO_TYPE_MAX ||
+                fread(transfer.data.data(), 1, transfer.data.size(), f) != transfer.data.size()) {
+            fprintf(stderr, "%s is truncated\n", path);
+            fclose(f);
+            return false;
+        }
+        transfers.push_back(transfer);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool save(const char *path, const std::vector<fifo_transfer_t> &transfers)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Failed to create %s\n", path);
+        return false;
+    }
+    for (const fifo_transfer_t &transfer : transfers) {
+        uint8_t header[3] = { transfer.fifo, (uint8_t)(transfer.data.size() & 0xFF), (uint8_t)(transfer.data.size() >> 8) };
+        fwrite(header, 1, 3, f);
+        fwrite(transfer.data.data(), 1, transfer.data.size(), f);
+    }
+    fclose(f);
+    return true;
+}
+
+/* Parser runs */
+typedef struct {
+    uint32_t events;
+    uint64_t hash;
+    uint64_t elapsed_ns;
+} run_result_t;
+
+static bool run(bool ring_mode, const std::vector<fifo_transfer_t> &transfers, uint32_t buffer_size,
+                uint32_t read_write_len, uint32_t iterations, std::vector<uint8_t> *log, run_result_t &result)
+{
+    fifo_mock_t mock = {};
+    mock.transfers = &transfers;
+
+    struct bhy2_dev dev;
+    if (bhy2_init(BHY2_I2C_INTERFACE, mock_read, mock_write, mock_delay_us, read_write_len, &mock, &dev) != BHY2_OK) {
+        return false;
+    }
+
+    event_sink_t sink = { 0, UINT64_C(14695981039346656037), log };
+    for (const auto &sensor : stream_sensors) {
+        dev.event_size[sensor.id] = sensor.size;
+        bhy2_register_fifo_parse_callback(sensor.id, sink_event, &sink, &dev);
+    }
+    bhy2_register_fifo_parse_callback(BHY2_SYS_ID_META_EVENT, sink_event, &sink, &dev);
+    bhy2_register_fifo_parse_callback(BHY2_SYS_ID_META_EVENT_WU, sink_event, &sink, &dev);
+    bhy2_register_fifo_parse_callback(BHY2_SYS_ID_DEBUG_MSG, sink_event, &sink, &dev);
+
+    // The ring gets the same power of two as the plain buffer, plus the slack
+    std::vector<uint8_t> buffer(ring_mode ? buffer_size + BHY2_FIFO_RING_SLACK : buffer_size);
+    struct bhy2_fifo_ring ring;
+    if (ring_mode && bhy2_fifo_ring_init(&ring, buffer.data(), buffer.size()) != BHY2_OK) {
+        fprintf(stderr, "Buffer size %u is too small for the ring parser\n", buffer_size);
+        return false;
+    }
+
+    uint64_t elapsed = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        mock.next = 0;
+        memset(dev.last_time_stamp, 0, sizeof(dev.last_time_stamp));
+        auto start = std::chrono::steady_clock::now();
+        while (mock_load(&mock)) {
+            int8_t rslt = ring_mode ? bhy2_get_and_process_fifo_ring(&ring, &dev)
+                          : bhy2_get_and_process_fifo(buffer.data(), buffer.size(), &dev);
+            if (rslt != BHY2_OK) {
+                fprintf(stderr, "%s parser failed with %d\n", ring_mode ? "Ring" : "Linear", rslt);
+                return false;
+            }
+        }
+        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        // Only the first pass is logged
+        sink.log = NULL;
+    }
+
+    result.events = sink.events;
+    result.hash = sink.hash;
+    result.elapsed_ns = elapsed;
+    return true;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --buffer BYTES      work buffer, a power of two, default 512\n");
+    printf("  --rw-len BYTES      largest single bus read, default 4096\n");
+    printf("  --transfers N       generated FIFO transfers, default 2000\n");
+    printf("  --events N          most events per generated transfer, default 400\n");
+    printf("  --iterations N      timed passes over all transfers, default 20\n");
+    printf("  --seed N            generator seed, default 1\n");
+    printf("  --replay FILE       parse recorded transfers instead of generated ones\n");
+    printf("  --record FILE       save the generated transfers\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t buffer_size = 512;
+    uint32_t read_write_len = 4096;
+    uint32_t count = 2000;
+    uint32_t max_events = 400;
+    uint32_t iterations = 20;
+    const char *replay = NULL;
+    const char *record = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--buffer") && has_value) {
+            buffer_size = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--rw-len") && has_value) {
+            read_write_len = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--transfers") && has_value) {
+            count = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--events") && has_value) {
+            max_events = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--iterations") && has_value) {
+            iterations = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--seed") && has_value) {
+            rng_state = atoi(argv[++i]) | 1;
+        } else if (!strcmp(arg, "--replay") && has_value) {
+            replay = argv[++i];
+        } else if (!strcmp(arg, "--record") && has_value) {
+            record = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!buffer_size || (buffer_size & (buffer_size - 1)) || !read_write_len || !iterations) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<fifo_transfer_t> transfers;
+    if (replay) {
+        if (!load(replay, transfers)) {
+            return 1;
+        }
+    } else {
+        generate(transfers, count, max_events);
+        if (record && !save(record, transfers)) {
+            return 1;
+        }
+    }
+
+    uint64_t bytes = 0;
+    for (const fifo_transfer_t &transfer : transfers) {
+        bytes += transfer.data.size();
+    }
+
+    std::vector<uint8_t> linear_log, ring_log;
+    run_result_t linear, ring;
+    if (!run(false, transfers, buffer_size, read_write_len, iterations, &linear_log, linear) ||
+            !run(true, transfers, buffer_size, read_write_len, iterations, &ring_log, ring)) {
+        return 1;
+    }
+
+    printf("%zu transfers, %llu bytes, %u byte buffer, %u byte reads\n", transfers.size(),
+           (unsigned long long)bytes, buffer_size, read_write_len);
+    const run_result_t *results[] = { &linear, &ring };
+    const char *names[] = { "linear", "ring" };
+    for (int i = 0; i < 2; i++) {
+        uint64_t total = bytes * iterations;
+        printf("%-8s %u events, %.2f ns/byte, %.1f ns/event\n", names[i], results[i]->events / iterations,
+               (double)results[i]->elapsed_ns / total, (double)results[i]->elapsed_ns / results[i]->events);
+    }
+
+    if (linear_log != ring_log || linear.hash != ring.hash || linear.events != ring.events) {
+        printf("MISMATCH: the parsers delivered different events\n");
+        return 1;
+    }
+    printf("events match, speedup %.2fx\n", (double)linear.elapsed_ns / ring.elapsed_ns);
+    return 0;
+}
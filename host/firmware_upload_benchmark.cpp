@@ -0,0 +1,324 @@
+/**
+ * @file      firmware_upload_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Compresses the BHI260AP firmware in the heatshrink format, checks that the
+ *            embedded compressed image matches BHI260AP.fw.h, and boots the emulated BHI260AP
+ *            through SensorBHI260AP: both images uploaded to RAM, then through the sensor flash,
+ *            written once and booted from on later boots. Reports the flash each image takes
+ *            and the time of every boot. --write-header regenerates BHI260AP.fw.hs.h
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "SensorBHI260AP.hpp"
+#include "bosch/firmware/BHI260AP.fw.h"
+#include "bhi260ap_emulator.h"
+
+#define EMU_IRQ_PIN     21
+
+typedef std::vector<uint8_t> bytes_t;
+
+class BitWriter
+{
+public:
+    bytes_t out;
+
+    void put(uint32_t value, uint8_t count)
+    {
+        for (int i = count - 1; i >= 0; i--) {
+            if (!__bits) {
+                out.push_back(0);
+            }
+            if ((value >> i) & 1) {
+                out.back() |= 0x80 >> __bits;
+            }
+            __bits = (__bits + 1) & 7;
+        }
+    }
+
+private:
+    uint8_t __bits = 0;
+};
+
+// Shortest heatshrink stream for the data: the longest match at every position, then the
+// cheapest mix of literals and back references from the end backwards
+static bytes_t compress(const uint8_t *data, uint32_t size, uint8_t window_bits, uint8_t lookahead_bits)
+{
+    const uint32_t window = 1UL << window_bits;
+    const uint32_t max_len = 1UL << lookahead_bits;
+    const uint32_t literal_bits = 9;
+    const uint32_t backref_bits = 1 + window_bits + lookahead_bits;
+
+    std::vector<uint32_t> match_len(size, 0), match_off(size, 0);
+    std::vector<int32_t> head(65536, -1), prev(size, -1);
+    for (uint32_t i = 0; i + 1 < size; i++) {
+        uint16_t key = data[i] | (data[i + 1] << 8);
+        for (int32_t j = head[key]; j >= 0 && i - j <= window; j = prev[j]) {
+            uint32_t len = 0;
+            while (len < max_len && i + len < size && data[j + len] == data[i + len]) {
+                len++;
+            }
+            if (len > match_len[i]) {
+                match_len[i] = len;
+                match_off[i] = i - j;
+                if (len == max_len) {
+                    break;
+                }
+            }
+        }
+        prev[i] = head[key];
+        head[key] = i;
+    }
+
+    std::vector<uint64_t> cost(size + 1, 0);
+    std::vector<uint32_t> step(size, 1);
+    for (int64_t i = (int64_t)size - 1; i >= 0; i--) {
+        cost[i] = literal_bits + cost[i + 1];
+        for (uint32_t len = 2; len <= match_len[i]; len++) {
+            if (backref_bits + cost[i + len] < cost[i]) {
+                cost[i] = backref_bits + cost[i + len];
+                step[i] = len;
+            }
+        }
+    }
+
+    BitWriter writer;
+    for (uint32_t i = 0; i < size; i += step[i]) {
+        if (step[i] == 1) {
+            writer.put(1, 1);
+            writer.put(data[i], 8);
+        } else {
+            writer.put(0, 1);
+            writer.put(match_off[i] - 1, window_bits);
+            writer.put(step[i] - 1, lookahead_bits);
+        }
+    }
+    return writer.out;
+}
+
+static bool decompress(const uint8_t *image, uint32_t image_len, uint8_t window_bits, uint8_t lookahead_bits,
+                       uint32_t chunk, bytes_t &out)
+{
+    SensorFirmwareStream stream;
+    if (!stream.begin(image, image_len, window_bits, lookahead_bits)) {
+        return false;
+    }
+    out.clear();
+    bytes_t buffer(chunk);
+    uint32_t got;
+    while ((got = stream.read(buffer.data(), chunk)) > 0) {
+        out.insert(out.end(), buffer.begin(), buffer.begin() + got);
+    }
+    return true;
+}
+
+static bool write_header(const char *path, const bytes_t &image, uint8_t window_bits, uint8_t lookahead_bits)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+    fprintf(f, "// BHI260AP.fw.h in the heatshrink format, decompressed by SensorFirmwareStream.\n");
+    fprintf(f, "// Generated by host/firmware_upload_benchmark --write-header\n");
+    fprintf(f, "#pragma once\n\n");
+    fprintf(f, "#define BHY2_FIRMWARE_HS_WINDOW_BITS        %u\n", window_bits);
+    fprintf(f, "#define BHY2_FIRMWARE_HS_LOOKAHEAD_BITS     %u\n", lookahead_bits);
+    fprintf(f, "#define BHY2_FIRMWARE_HS_IMAGE_SIZE         %u\n\n", (unsigned)sizeof(bhy2_firmware_image));
+    fprintf(f, "const unsigned char bhy2_firmware_image_hs[] = {\n");
+    for (size_t i = 0; i < image.size(); i++) {
+        fprintf(f, "%s0x%02x,%s", i % 12 ? "" : "  ", image[i], i % 12 == 11 || i + 1 == image.size() ? " \n" : " ");
+    }
+    fprintf(f, "};\n");
+    fclose(f);
+    return true;
+}
+
+typedef struct {
+    bool ok;
+    SensorBootPath path;
+    uint64_t bus_bytes;
+    uint32_t transactions;
+    uint32_t boot_us;           // SensorBHI260AP::getBootTime(), the delays of the driver on the virtual clock
+    double cpu_ms;              // host time spent in init(), decompression included
+} boot_result_t;
+
+/*
+ * One power cycle of the host against the sensor emu stands for. With a record the image
+ * goes through the sensor flash, known is what an earlier boot stored
+ */
+static boot_result_t boot(Bhi260apEmulator &emu, uint32_t rw_len, bool compressed,
+                          SensorFlashRecord *record, const SensorFlashRecord *known)
+{
+    boot_result_t result = {};
+    SensorBHI260AP bhy;
+    Bhi260apEmulator::Stats before = emu.getStats();
+
+    emu.setIrqPin(EMU_IRQ_PIN);
+    bhy.setPins(SENSOR_PIN_NONE, EMU_IRQ_PIN);
+    if (compressed) {
+        bhy.setCompressedFirmware(bhy2_firmware_image_hs, sizeof(bhy2_firmware_image_hs), BHY2_FIRMWARE_HS_IMAGE_SIZE,
+                                  BHY2_FIRMWARE_HS_WINDOW_BITS, BHY2_FIRMWARE_HS_LOOKAHEAD_BITS, record != NULL);
+    } else {
+        bhy.setFirmware(bhy2_firmware_image, sizeof(bhy2_firmware_image), record != NULL);
+    }
+    if (known) {
+        bhy.setFlashRecord(*known);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = bhy.init(Bhi260apEmulator::read, Bhi260apEmulator::write, &emu, rw_len);
+    result.cpu_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.boot_us = bhy.getBootTime();
+    result.path = bhy.getBootPath();
+    if (record) {
+        *record = bhy.getFlashRecord();
+    }
+
+    // The sensor must hold exactly the plain image, uploads pad it to whole words
+    const bytes_t &image = record ? emu.getFlash() : emu.getProgramRam();
+    result.ok = ok && emu.booted() && image.size() >= sizeof(bhy2_firmware_image) &&
+                !memcmp(image.data(), bhy2_firmware_image, sizeof(bhy2_firmware_image));
+    if (!result.ok) {
+        fprintf(stderr, "boot failed: %s\n", bhy.getError().c_str());
+    }
+    const Bhi260apEmulator::Stats &stats = emu.getStats();
+    result.bus_bytes = stats.read_bytes + stats.write_bytes - before.read_bytes - before.write_bytes;
+    result.transactions = stats.transactions - before.transactions;
+    return result;
+}
+
+static bool print_boot(const char *name, const boot_result_t &result, SensorBootPath expected, uint32_t spi_hz)
+{
+    static const char *paths[] = { "none", "RAM", "flash write", "flash" };
+    // One address byte per transaction
+    double bus_ms = (result.bus_bytes + result.transactions) * 8 * 1000.0 / spi_hz;
+    printf("%-22s %-11s %10llu %12u %8.1f %9.1f %9.2f\n", name, paths[result.path],
+           (unsigned long long)result.bus_bytes, result.transactions, bus_ms, result.boot_us / 1000.0, result.cpu_ms);
+    if (result.path != expected) {
+        fprintf(stderr, "%s took the %s path instead of %s\n", name, paths[result.path], paths[expected]);
+        return false;
+    }
+    return result.ok;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --rw-len BYTES       largest single bus transfer, default 256\n");
+    printf("  --spi-hz N           bus clock for the transfer time, default 20000000\n");
+    printf("  --window BITS        heatshrink window, default %u\n", BHY2_FIRMWARE_HS_WINDOW_BITS);
+    printf("  --lookahead BITS     heatshrink lookahead, default %u\n", BHY2_FIRMWARE_HS_LOOKAHEAD_BITS);
+    printf("  --iterations N       decompression passes timed, default 20\n");
+    printf("  --write-header FILE  write the compressed image as BHI260AP.fw.hs.h\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rw_len = 256;
+    uint32_t spi_hz = 20000000;
+    uint32_t window_bits = BHY2_FIRMWARE_HS_WINDOW_BITS;
+    uint32_t lookahead_bits = BHY2_FIRMWARE_HS_LOOKAHEAD_BITS;
+    uint32_t iterations = 20;
+    const char *header = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--rw-len") && has_value) {
+            rw_len = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--spi-hz") && has_value) {
+            spi_hz = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--window") && has_value) {
+            window_bits = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--lookahead") && has_value) {
+            lookahead_bits = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--iterations") && has_value) {
+            iterations = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--write-header") && has_value) {
+            header = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!rw_len || !spi_hz || !iterations) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const uint32_t plain_size = sizeof(bhy2_firmware_image);
+    bool ok = true;
+    bytes_t decoded;
+
+    // Round trip with the requested parameters
+    bytes_t packed = compress(bhy2_firmware_image, plain_size, window_bits, lookahead_bits);
+    if (!decompress(packed.data(), packed.size(), window_bits, lookahead_bits, 257, decoded) ||
+            decoded.size() != plain_size || memcmp(decoded.data(), bhy2_firmware_image, plain_size)) {
+        fprintf(stderr, "-w %u -l %u does not decompress to the firmware\n", window_bits, lookahead_bits);
+        return 1;
+    }
+    printf("heatshrink -w %u -l %u: %u of %u bytes\n", window_bits, lookahead_bits, (unsigned)packed.size(), plain_size);
+    if (header) {
+        if (!write_header(header, packed, window_bits, lookahead_bits)) {
+            return 1;
+        }
+        printf("wrote %s\n", header);
+        return 0;
+    }
+
+    // The embedded image must follow BHI260AP.fw.h
+    if (!decompress(bhy2_firmware_image_hs, sizeof(bhy2_firmware_image_hs), BHY2_FIRMWARE_HS_WINDOW_BITS,
+                    BHY2_FIRMWARE_HS_LOOKAHEAD_BITS, rw_len, decoded) || decoded.size() != BHY2_FIRMWARE_HS_IMAGE_SIZE ||
+            BHY2_FIRMWARE_HS_IMAGE_SIZE != plain_size || memcmp(decoded.data(), bhy2_firmware_image, plain_size)) {
+        fprintf(stderr, "BHI260AP.fw.hs.h is out of date, regenerate it with --write-header\n");
+        ok = false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        decompress(bhy2_firmware_image_hs, sizeof(bhy2_firmware_image_hs), BHY2_FIRMWARE_HS_WINDOW_BITS,
+                   BHY2_FIRMWARE_HS_LOOKAHEAD_BITS, rw_len, decoded);
+    }
+    double decode_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const uint32_t packed_size = sizeof(bhy2_firmware_image_hs);
+    printf("\nflash: %u bytes plain, %u bytes compressed, %u bytes (%.1f%%) saved\n", plain_size, packed_size,
+           plain_size - packed_size, 100.0 * (plain_size - packed_size) / plain_size);
+    printf("RAM while uploading: %u bytes of window, %u bytes of transfer\n",
+           1U << BHY2_FIRMWARE_HS_WINDOW_BITS, rw_len & ~3U);
+    printf("decompression: %.1f MB/s on this host\n\n", decode_s > 0 ? plain_size * iterations / decode_s / 1e6 : 0.0);
+
+    printf("%-22s %-11s %10s %12s %8s %9s %9s\n", "boot", "path", "bus bytes", "transactions", "bus ms", "waits ms", "host ms");
+    Bhi260apEmulator ram_sensor;
+    ok &= print_boot("plain to RAM", boot(ram_sensor, rw_len, false, NULL, NULL), SENSOR_BOOT_RAM, spi_hz);
+    ok &= print_boot("compressed to RAM", boot(ram_sensor, rw_len, true, NULL, NULL), SENSOR_BOOT_RAM, spi_hz);
+
+    // The sensor flash outlives the host boots, the record is what the host keeps in NVS
+    Bhi260apEmulator flash_sensor;
+    flash_sensor.setFlashSize(1024 * 1024);
+    SensorFlashRecord stored, record;
+    ok &= print_boot("first boot", boot(flash_sensor, rw_len, true, &stored, NULL), SENSOR_BOOT_FLASH_WRITE, spi_hz);
+    ok &= print_boot("later boot", boot(flash_sensor, rw_len, true, &record, &stored), SENSOR_BOOT_FLASH, spi_hz);
+    ok &= !memcmp(&record, &stored, sizeof(record));
+
+    // Another image in the application, then another image in the flash
+    SensorFlashRecord stale = stored;
+    stale.hash ^= 1;
+    ok &= print_boot("new image", boot(flash_sensor, rw_len, true, &record, &stale), SENSOR_BOOT_FLASH_WRITE, spi_hz);
+    stale = stored;
+    stale.user_version ^= 1;
+    ok &= print_boot("flash changed", boot(flash_sensor, rw_len, true, &record, &stale), SENSOR_BOOT_FLASH_WRITE, spi_hz);
+    ok &= !memcmp(&record, &stored, sizeof(record));
+    if (flash_sensor.getStats().flash_erases != 3) {
+        fprintf(stderr, "flash erased %u times instead of 3\n", flash_sensor.getStats().flash_erases);
+        ok = false;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
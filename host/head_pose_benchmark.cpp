@@ -0,0 +1,244 @@
+/**
+ * @file      head_pose_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Runs HeadPose on the emulated BHI260AP with its head tracker module and draws a
+ *            HUD that follows the head through LV_Helper on LilyGo_HostDisplay. The panel
+ *            transfer takes virtual time per pixel. Reports the motion to photon latency
+ *            histogram, and the error of the predicted and of the latest pose against the
+ *            emulated head at the time each frame reached the panel. Then runs the head
+ *            misalignment calibration. Exits with 1 on a failure
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "SensorBHI260AP.hpp"
+#include "LV_Helper.h"
+#include "LilyGo_HostDisplay.h"
+#include "headPose.h"
+#include "bhi260ap_emulator.h"
+
+#define EMU_IRQ_PIN     21
+
+// The panel takes this long per pixel once LVGL hands an area over
+class TimedDisplay : public LilyGo_HostDisplay
+{
+public:
+    using LilyGo_HostDisplay::pushColors;
+
+    void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+    {
+        LilyGo_HostDisplay::pushColors(x, y, width, height, data);
+        hostAdvanceMicros((uint32_t)width * height * pixel_ns / 1000);
+    }
+
+    uint32_t pixel_ns = 100;
+};
+
+typedef struct {
+    uint32_t frames;
+    double predicted_sum;
+    double predicted_max;
+    double latest_sum;
+    double latest_max;
+} pose_error_t;
+
+static Bhi260apEmulator emu;
+static HeadPose head;
+static pose_error_t errors;
+static bool measuring;
+static float predicted[4], latest[4];
+
+// Angle of the rotation between a and b, from the parts of a' * b so small ones keep their precision
+static double angle_deg(const float a[4], const float b[4])
+{
+    double w = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    double x = a[0] * b[1] - a[1] * b[0] - a[2] * b[3] + a[3] * b[2];
+    double y = a[0] * b[2] + a[1] * b[3] - a[2] * b[0] - a[3] * b[1];
+    double z = a[0] * b[3] - a[1] * b[2] + a[2] * b[1] - a[3] * b[0];
+    return 2 * atan2(sqrt(x * x + y * y + z * z), fabs(w)) * 180 / M_PI;
+}
+
+// The poses the frame was drawn with against the head when it reached the panel
+static void frame_done(void *user_data)
+{
+    (void)user_data;
+    HeadPose::onFrameDone(&head);
+    if (!measuring) {
+        return;
+    }
+    float truth[4];
+    emu.getHeadOrientation(micros(), truth);
+    double p = angle_deg(predicted, truth);
+    double l = angle_deg(latest, truth);
+    errors.predicted_sum += p;
+    errors.predicted_max = p > errors.predicted_max ? p : errors.predicted_max;
+    errors.latest_sum += l;
+    errors.latest_max = l > errors.latest_max ? l : errors.latest_max;
+    errors.frames++;
+}
+
+// One millisecond of the loop of a Glass sketch: drain the sensor, move the HUD, run LVGL
+static void step(SensorBHI260AP &bhy, lv_obj_t *marker, uint32_t step_us)
+{
+    hostAdvanceMicros(step_us);
+    emu.poll();
+    bhy.update();
+
+    float q[4];
+    if (head.predict(q)) {
+        memcpy(predicted, q, sizeof(predicted));
+        head.getPose(latest);
+        float yaw = atan2f(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3])) * 180 / M_PI;
+        int32_t width = lv_obj_get_width(lv_scr_act());
+        int32_t x = (int32_t)(yaw * 2) % width;
+        lv_obj_set_x(marker, x < 0 ? x + width : x);
+        // A HUD redraws its whole layer
+        lv_obj_invalidate(lv_scr_act());
+    }
+    lv_timer_handler();
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --seconds N         simulated run time, default 10\n");
+    printf("  --rate-hz N         head orientation and gyroscope rate, default 200\n");
+    printf("  --step-us N         sketch loop period, default 1000\n");
+    printf("  --pixel-ns N        panel transfer time per pixel, default 100\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 10;
+    float rate_hz = 200;
+    uint32_t step_us = 1000;
+    uint32_t pixel_ns = 100;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--seconds") && has_value) {
+            seconds = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--rate-hz") && has_value) {
+            rate_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--step-us") && has_value) {
+            step_us = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--pixel-ns") && has_value) {
+            pixel_ns = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (seconds < 2 || rate_hz <= 0 || !step_us) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    emu.setIrqPin(EMU_IRQ_PIN);
+    SensorBHI260AP bhy;
+    bhy.setPins(SENSOR_PIN_NONE, EMU_IRQ_PIN);
+    if (!bhy.init(Bhi260apEmulator::read, Bhi260apEmulator::write, &emu)) {
+        fprintf(stderr, "init failed: %s\n", bhy.getError().c_str());
+        printf("FAIL\n");
+        return 1;
+    }
+
+    TimedDisplay display;
+    display.pixel_ns = pixel_ns;
+    if (!display.begin()) {
+        printf("FAIL\n");
+        return 1;
+    }
+    beginLvglHelper(display);
+    setLvglHelperFrameCallback(frame_done);
+    lv_obj_t *marker = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(marker, 20, 20);
+    lv_obj_set_y(marker, lv_obj_get_height(lv_scr_act()) / 2);
+
+    bool ok = true;
+    if (!head.begin(bhy, rate_hz)) {
+        fprintf(stderr, "begin failed\n");
+        printf("FAIL\n");
+        return 1;
+    }
+
+    // The first second lets the clock sync and the photon delay settle
+    for (uint64_t t = 0; t < 1000000; t += step_us) {
+        step(bhy, marker, step_us);
+    }
+    head.resetLatency();
+    measuring = true;
+    uint64_t start = micros();
+    while (micros() - start < (seconds - 1) * 1000000ULL) {
+        step(bhy, marker, step_us);
+    }
+    measuring = false;
+
+    head_pose_latency_t latency;
+    head.getLatency(latency);
+    uint32_t counted = 0;
+    for (uint32_t count : latency.buckets) {
+        counted += count;
+    }
+    if (!latency.frames || counted != latency.frames || errors.frames != latency.frames) {
+        fprintf(stderr, "%u frames, %u in the histogram and %u checked\n", latency.frames, counted, errors.frames);
+        ok = false;
+    }
+    double predicted_mean = errors.frames ? errors.predicted_sum / errors.frames : 0;
+    double latest_mean = errors.frames ? errors.latest_sum / errors.frames : 0;
+    if (!(predicted_mean < latest_mean / 4)) {
+        fprintf(stderr, "prediction error %.3f deg, without prediction %.3f deg\n", predicted_mean, latest_mean);
+        ok = false;
+    }
+
+    printf("motion to photon latency over %u frames, %u us photon delay learned\n", latency.frames, head.getPhotonDelayUs());
+    printf("  min %u us, mean %.0f us, p50 %u us, p95 %u us, p99 %u us, max %u us\n",
+           latency.min_us, latency.frames ? (double)latency.total_us / latency.frames : 0,
+           HeadPose::getPercentile(latency, 50), HeadPose::getPercentile(latency, 95),
+           HeadPose::getPercentile(latency, 99), latency.max_us);
+    for (uint32_t i = 0; i < HEAD_POSE_LATENCY_BUCKETS; i++) {
+        if (latency.buckets[i]) {
+            printf("  %3u ms %s %6u\n", i * HEAD_POSE_BUCKET_US / 1000,
+                   i == HEAD_POSE_LATENCY_BUCKETS - 1 ? "+" : " ", latency.buckets[i]);
+        }
+    }
+    printf("%-12s %10s %10s\n", "pose", "mean deg", "max deg");
+    printf("%-12s %10.3f %10.3f\n", "predicted", predicted_mean, errors.predicted_max);
+    printf("%-12s %10.3f %10.3f\n", "latest", latest_mean, errors.latest_max);
+
+    // The misalignment calibration reports its progress, then stops its sensor
+    if (head.isCalibrated() || !head.calibrate()) {
+        fprintf(stderr, "calibration did not start\n");
+        ok = false;
+    }
+    for (uint32_t t = 0; t < 5000000 && head.isCalibrating(); t += step_us) {
+        step(bhy, marker, step_us);
+    }
+    float mount[4];
+    if (!head.isCalibrated() || !bhy.getHeadMisalignment(mount)) {
+        fprintf(stderr, "calibration did not finish\n");
+        ok = false;
+    } else {
+        printf("misalignment %.1f deg about z\n", 2 * atan2(mount[3], mount[0]) * 180 / M_PI);
+    }
+    if (emu.getSampleRate(SENSOR_ID_HEAD_ORI_MIS_ALG) != 0) {
+        fprintf(stderr, "misalignment sensor still running\n");
+        ok = false;
+    }
+
+    // end() leaves no stream running
+    head.end();
+    for (uint8_t id : { SENSOR_ID_IMU_HEAD_ORI_Q, SENSOR_ID_GYRO, SENSOR_ID_HEAD_ORI_MIS_ALG }) {
+        if (emu.getSampleRate(id) != 0) {
+            fprintf(stderr, "sensor %u still running\n", id);
+            ok = false;
+        }
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
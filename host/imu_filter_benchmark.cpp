@@ -0,0 +1,229 @@
+/**
+ * @file      imu_filter_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Steps every filter kernel with the same accelerometer and gyroscope trace and
+ *            compares the cost of one update and the orientation error against the
+ *            reference. The fixed point filter runs once from floats and once from raw
+ *            BHI260AP samples. The trace is synthetic unless --trace gives a recorded one.
+ *            Exits with 1 on a failure
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC    1
+#endif
+#include "imuFilter.h"
+#include "imu_trace.h"
+
+// BHI260AP default ranges of the pass through sensors
+#define GYRO_LSB_PER_DPS    (32768.0f / 2000.0f)
+#define ACC_LSB_PER_G       4096.0f
+
+typedef struct {
+    float g[3];
+    float a[3];
+    float dt;
+    int16_t graw[3];
+    int16_t araw[3];
+    uint32_t dt_ticks;
+    double t_s;
+    const float *ref;
+} step_t;
+
+typedef struct {
+    const char *name;
+    double ns;
+    double tsc;
+    trace_error_t err;
+} result_t;
+
+static int16_t to_raw(float v, float lsb)
+{
+    float r = roundf(v * lsb);
+    return r > 32767 ? 32767 : (r < -32768 ? -32768 : (int16_t)r);
+}
+
+// One step per gyroscope sample after the first, with the latest accelerometer sample
+static std::vector<step_t> make_steps(const trace_t &trace)
+{
+    std::vector<step_t> steps;
+    const trace_item_t *acc = NULL, *gyro = NULL;
+    uint64_t start = trace.front().t;
+    for (const trace_item_t &item : trace) {
+        if (item.kind == 'A') {
+            acc = &item;
+        } else if (item.kind == 'G') {
+            const trace_item_t *prev = gyro;
+            gyro = &item;
+            if (!prev || !acc) {
+                continue;
+            }
+            step_t step = {};
+            for (int i = 0; i < 3; i++) {
+                step.g[i] = gyro->v[i];
+                step.a[i] = acc->v[i];
+                step.graw[i] = to_raw(gyro->v[i], GYRO_LSB_PER_DPS);
+                step.araw[i] = to_raw(acc->v[i], ACC_LSB_PER_G);
+            }
+            step.dt = (gyro->t - prev->t) * 1e-9f;
+            step.dt_ticks = (uint32_t)((gyro->t - prev->t) / TRACE_TICK_NS);
+            step.t_s = (gyro->t - start) * 1e-9;
+            steps.push_back(step);
+        } else if (!steps.empty() && gyro && item.t == gyro->t) {
+            steps.back().ref = item.v;
+        }
+    }
+    return steps;
+}
+
+template <class Kernel>
+static void step_float(Kernel &kernel, const step_t &step)
+{
+    kernel.update(step.g[0], step.g[1], step.g[2], step.a[0], step.a[1], step.a[2], step.dt);
+}
+
+static void step_raw(ComplementaryFixed &kernel, const step_t &step)
+{
+    kernel.updateRaw(step.graw, step.araw, step.dt_ticks);
+}
+
+/*
+ * The kernel type is a template argument, so the updates are direct calls the way a
+ * sketch that picks one kernel would make them. The fastest of the repeats counts
+ */
+template <class Kernel, void (*Step)(Kernel &, const step_t &)>
+static result_t run(const char *name, const std::vector<step_t> &steps, uint32_t repeat, double warmup_s)
+{
+    result_t result = {};
+    result.name = name;
+    result.ns = result.tsc = 1e30;
+    for (uint32_t r = 0; r < repeat; r++) {
+        Kernel kernel;
+        kernel.reset();
+        auto t0 = std::chrono::steady_clock::now();
+#ifdef HAVE_TSC
+        uint64_t c0 = __rdtsc();
+#endif
+        for (const step_t &step : steps) {
+            Step(kernel, step);
+        }
+#ifdef HAVE_TSC
+        double tsc = (double)(__rdtsc() - c0) / steps.size();
+        result.tsc = tsc < result.tsc ? tsc : result.tsc;
+#endif
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count() / steps.size();
+        result.ns = ns < result.ns ? ns : result.ns;
+    }
+
+    Kernel kernel;
+    kernel.reset();
+    for (const step_t &step : steps) {
+        Step(kernel, step);
+        if (step.ref && step.t_s >= warmup_s) {
+            float q[4];
+            kernel.getQuaternion(q);
+            trace_check(result.err, q, step.ref);
+        }
+    }
+    trace_finish(result.err);
+    return result;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --seconds N         synthetic trace length, default 60\n");
+    printf("  --acc-hz N          synthetic accelerometer rate, default 100\n");
+    printf("  --gyro-hz N         synthetic gyroscope rate, default 100\n");
+    printf("  --noise N           synthetic sensor noise scale, default 1\n");
+    printf("  --trace FILE        replay a recorded trace instead, lines of\n");
+    printf("                      A,t_ns,x,y,z  G,t_ns,x,y,z  R,t_ns,w,x,y,z\n");
+    printf("  --repeat N          timed passes over the trace per kernel, default 5\n");
+    printf("  --max-tilt DEG      largest mean tilt error that passes, default 3\n");
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = 60;
+    double acc_hz = 100;
+    double gyro_hz = 100;
+    double noise = 1;
+    const char *trace_path = NULL;
+    uint32_t repeat = 5;
+    double max_tilt = 3;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--seconds") && has_value) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(arg, "--acc-hz") && has_value) {
+            acc_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--gyro-hz") && has_value) {
+            gyro_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--noise") && has_value) {
+            noise = atof(argv[++i]);
+        } else if (!strcmp(arg, "--trace") && has_value) {
+            trace_path = argv[++i];
+        } else if (!strcmp(arg, "--repeat") && has_value) {
+            repeat = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--max-tilt") && has_value) {
+            max_tilt = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (seconds <= 0 || acc_hz <= 0 || gyro_hz <= 0 || !repeat) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    trace_t trace;
+    if (trace_path) {
+        if (!load_trace(trace_path, trace)) {
+            fprintf(stderr, "no samples in %s\n", trace_path);
+            return 1;
+        }
+    } else {
+        trace = make_trace(seconds, acc_hz, gyro_hz, noise);
+    }
+    std::vector<step_t> steps = make_steps(trace);
+    if (steps.empty()) {
+        fprintf(stderr, "no gyroscope samples with an accelerometer sample before them\n");
+        return 1;
+    }
+
+    const double warmup_s = 1;
+    std::vector<result_t> results;
+    results.push_back(run<MadgwickKernel, step_float<MadgwickKernel> >("Madgwick", steps, repeat, warmup_s));
+    results.push_back(run<MahonyKernel, step_float<MahonyKernel> >("Mahony", steps, repeat, warmup_s));
+    results.push_back(run<ComplementaryFixed, step_float<ComplementaryFixed> >("Fixed", steps, repeat, warmup_s));
+    results.push_back(run<ComplementaryFixed, step_raw>("Fixed raw", steps, repeat, warmup_s));
+
+    printf("%-10s %10s %10s %9s %9s %10s %10s\n", "kernel", "ns/update", "tsc/update", "mean deg", "max deg", "mean tilt", "max tilt");
+    bool ok = true;
+    for (const result_t &r : results) {
+#ifdef HAVE_TSC
+        printf("%-10s %10.1f %10.1f", r.name, r.ns, r.tsc);
+#else
+        printf("%-10s %10.1f %10s", r.name, r.ns, "-");
+#endif
+        printf(" %9.2f %9.2f %10.2f %10.2f\n", r.err.mean_err, r.err.max_err, r.err.mean_tilt, r.err.max_tilt);
+        if (!r.err.checks || !(r.err.mean_tilt <= max_tilt)) {
+            fprintf(stderr, "%s: mean tilt error %.2f deg, more than %.2f\n", r.name, r.err.mean_tilt, max_tilt);
+            ok = false;
+        }
+    }
+    printf("\n%u updates per pass\n", (unsigned)steps.size());
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file      imu_fusion_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Replays an accelerometer and gyroscope trace with a reference orientation
+ *            through ImuFusion, batch by batch like the BHI260AP FIFO delivers it, and
+ *            through the old factory page loop that stepped Madgwick every 15 ms with the
+ *            last sample and a fixed 10 ms step. Reports the orientation error of both and
+ *            the cost per sample. The trace is synthetic unless --trace gives a recorded one.
+ *            Exits with 1 on a failure
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "imuFusion.h"
+#include "imu_trace.h"
+
+// Every batch_ns the FIFO hands over what was sampled meanwhile
+static trace_error_t run_fusion(const trace_t &trace, uint64_t batch_ns, double warmup_s, double &ns_per_sample, imu_fusion_stats_t &stats)
+{
+    MadgwickFilter filter;
+    ImuFusion fusion;
+    trace_error_t err = {};
+    fusion.begin(&filter);
+
+    uint64_t start = trace.front().t;
+    uint64_t samples = 0, busy_ns = 0;
+    size_t pos = 0;
+    std::vector<const trace_item_t *> refs;
+    while (pos < trace.size()) {
+        uint64_t batch_end = trace[pos].t - (trace[pos].t - start) % batch_ns + batch_ns;
+        size_t first = pos;
+        while (pos < trace.size() && trace[pos].t < batch_end) {
+            pos++;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = first; i < pos; i++) {
+            const trace_item_t &item = trace[i];
+            if (item.kind == 'A') {
+                fusion.addAccel(item.v[0], item.v[1], item.v[2], item.t);
+                samples++;
+            } else if (item.kind == 'G') {
+                fusion.addGyro(item.v[0], item.v[1], item.v[2], item.t);
+                samples++;
+            }
+        }
+        busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+
+        // The published orientation against the reference of its gyroscope sample
+        for (size_t i = first; i < pos; i++) {
+            if (trace[i].kind == 'R') {
+                refs.push_back(&trace[i]);
+            }
+        }
+        float q[4];
+        uint64_t q_ns;
+        if (fusion.getQuaternion(q, &q_ns) && (q_ns - start) * 1e-9 >= warmup_s) {
+            for (const trace_item_t *ref : refs) {
+                if (ref->t == q_ns) {
+                    trace_check(err, q, ref->v);
+                    break;
+                }
+            }
+        }
+        while (refs.size() > 1 && refs.front()->t < q_ns) {
+            refs.erase(refs.begin());
+        }
+    }
+    fusion.getStats(stats);
+    ns_per_sample = samples ? (double)busy_ns / samples : 0;
+    trace_finish(err);
+    return err;
+}
+
+// The factory page before: a 15 ms timer, two sample buffers, begin(100)
+static trace_error_t run_legacy(const trace_t &trace, double warmup_s)
+{
+    Madgwick filter;
+    trace_error_t err = {};
+    filter.begin(100);
+
+    uint64_t start = trace.front().t;
+    const trace_item_t *acc = NULL, *gyro = NULL, *ref = NULL;
+    uint64_t next_tick = start + 15000000ULL;
+    for (const trace_item_t &item : trace) {
+        while (item.t >= next_tick) {
+            if (acc && gyro) {
+                filter.updateIMU(gyro->v[0], gyro->v[1], gyro->v[2], acc->v[0], acc->v[1], acc->v[2]);
+                float q[4];
+                filter.getQuaternion(&q[0], &q[1], &q[2], &q[3]);
+                if (ref && (next_tick - start) * 1e-9 >= warmup_s) {
+                    trace_check(err, q, ref->v);
+                }
+            }
+            next_tick += 15000000ULL;
+        }
+        if (item.kind == 'A') {
+            acc = &item;
+        } else if (item.kind == 'G') {
+            gyro = &item;
+        } else {
+            ref = &item;
+        }
+    }
+    trace_finish(err);
+    return err;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --seconds N         synthetic trace length, default 60\n");
+    printf("  --acc-hz N          synthetic accelerometer rate, default 100\n");
+    printf("  --gyro-hz N         synthetic gyroscope rate, default 100\n");
+    printf("  --noise N           synthetic sensor noise scale, default 1\n");
+    printf("  --batch-ms N        time between two FIFO transfers, default 20\n");
+    printf("  --trace FILE        replay a recorded trace instead, lines of\n");
+    printf("                      A,t_ns,x,y,z  G,t_ns,x,y,z  R,t_ns,w,x,y,z\n");
+    printf("  --write-trace FILE  save the synthetic trace\n");
+    printf("  --max-tilt DEG      largest mean tilt error of ImuFusion that passes, default 2\n");
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = 60;
+    double acc_hz = 100;
+    double gyro_hz = 100;
+    double noise = 1;
+    uint32_t batch_ms = 20;
+    const char *trace_path = NULL;
+    const char *write_path = NULL;
+    double max_tilt = 2;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--seconds") && has_value) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(arg, "--acc-hz") && has_value) {
+            acc_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--gyro-hz") && has_value) {
+            gyro_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--noise") && has_value) {
+            noise = atof(argv[++i]);
+        } else if (!strcmp(arg, "--batch-ms") && has_value) {
+            batch_ms = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--trace") && has_value) {
+            trace_path = argv[++i];
+        } else if (!strcmp(arg, "--write-trace") && has_value) {
+            write_path = argv[++i];
+        } else if (!strcmp(arg, "--max-tilt") && has_value) {
+            max_tilt = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (seconds <= 0 || acc_hz <= 0 || gyro_hz <= 0 || !batch_ms) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    trace_t trace;
+    if (trace_path) {
+        if (!load_trace(trace_path, trace)) {
+            fprintf(stderr, "no samples in %s\n", trace_path);
+            return 1;
+        }
+    } else {
+        trace = make_trace(seconds, acc_hz, gyro_hz, noise);
+        if (write_path && !write_trace(write_path, trace)) {
+            return 1;
+        }
+    }
+
+    // Both start from the reference orientation, skip the first second all the same
+    const double warmup_s = 1;
+    double ns_per_sample;
+    imu_fusion_stats_t stats;
+    trace_error_t fused = run_fusion(trace, batch_ms * 1000000ULL, warmup_s, ns_per_sample, stats);
+    trace_error_t legacy = run_legacy(trace, warmup_s);
+
+    // Gyroscope samples after the last accelerometer one wait for their partner
+    uint64_t last_acc = 0;
+    uint32_t gyro_samples = 0, paired = 0;
+    for (const trace_item_t &item : trace) {
+        last_acc = item.kind == 'A' ? item.t : last_acc;
+    }
+    for (const trace_item_t &item : trace) {
+        gyro_samples += item.kind == 'G';
+        paired += item.kind == 'G' && item.t <= last_acc;
+    }
+
+    printf("%-10s %9s %9s %10s %10s %8s\n", "loop", "mean deg", "max deg", "mean tilt", "max tilt", "checks");
+    printf("%-10s %9.2f %9.2f %10.2f %10.2f %8u\n", "ImuFusion", fused.mean_err, fused.max_err, fused.mean_tilt, fused.max_tilt, fused.checks);
+    printf("%-10s %9.2f %9.2f %10.2f %10.2f %8u\n", "15 ms loop", legacy.mean_err, legacy.max_err, legacy.mean_tilt, legacy.max_tilt, legacy.checks);
+    printf("\n%u filter steps for %u gyroscope samples, %u interpolated, %u held, %u dropped, %u restarts, largest step %.2f ms\n",
+           stats.steps, gyro_samples, stats.interpolated, stats.held, stats.dropped, stats.restarts, stats.max_dt * 1000);
+    printf("ImuFusion: %.3f us per sample\n", ns_per_sample / 1000);
+
+    bool ok = true;
+    // Every paired gyroscope sample but the first steps the filter
+    if (stats.steps + 1 != paired || stats.dropped || stats.restarts) {
+        fprintf(stderr, "samples were not all consumed\n");
+        ok = false;
+    }
+    if (!fused.checks || fused.mean_tilt > max_tilt) {
+        fprintf(stderr, "mean tilt error %.2f deg, more than %.2f\n", fused.mean_tilt, max_tilt);
+        ok = false;
+    }
+    if (!trace_path && fused.mean_err >= legacy.mean_err) {
+        fprintf(stderr, "ImuFusion is not better than the 15 ms loop\n");
+        ok = false;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file      imu_trace.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "imu_trace.h"
+
+#define DEG             (M_PI / 180.0)
+
+static void quat_mul(const double a[4], const double b[4], double out[4])
+{
+    double r[4] = {
+        a[0] *b[0] - a[1] *b[1] - a[2] *b[2] - a[3] *b[3],
+        a[0] *b[1] + a[1] *b[0] + a[2] *b[3] - a[3] *b[2],
+        a[0] *b[2] - a[1] *b[3] + a[2] *b[0] + a[3] *b[1],
+        a[0] *b[3] + a[1] *b[2] - a[2] *b[1] + a[3] *b[0],
+    };
+    memcpy(out, r, sizeof(r));
+}
+
+// Earth z, the direction the accelerometer measures at rest, seen from the sensor
+static void gravity_in_body(const double q[4], double g[3])
+{
+    g[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    g[1] = 2 * (q[2] * q[3] + q[0] * q[1]);
+    g[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+static double gauss(uint32_t &seed)
+{
+    double u1, u2;
+    seed = seed * 1664525 + 1013904223;
+    u1 = ((seed >> 8) + 1.0) / 16777217.0;
+    seed = seed * 1664525 + 1013904223;
+    u2 = (seed >> 8) / 16777216.0;
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+trace_t make_trace(double seconds, double acc_hz, double gyro_hz, double noise)
+{
+    trace_t trace;
+    uint32_t seed = 12345;
+    double q[4] = { 1, 0, 0, 0 };
+    const double sub_dt = 1.0 / 8000;
+    uint64_t acc_period = llround(1e9 / acc_hz / TRACE_TICK_NS) * TRACE_TICK_NS;
+    uint64_t gyro_period = llround(1e9 / gyro_hz / TRACE_TICK_NS) * TRACE_TICK_NS;
+    uint64_t start = 1000 * TRACE_TICK_NS;
+    uint64_t next_acc = start, next_gyro = start;
+    uint64_t end = start + (uint64_t)(seconds * 1e9);
+
+    for (uint64_t t = start; t < end; t += 125000) {
+        double s = (t - start) * 1e-9;
+        double w[3] = {
+            60 * sin(0.7 * s) + 20 * sin(3.1 * s),
+            45 * sin(1.1 * s + 1),
+            90 * sin(0.3 * s) + 30 * cos(2.3 * s),
+        };
+        while (next_acc <= t || next_gyro <= t) {
+            trace_item_t item = {};
+            if (next_acc <= next_gyro) {
+                double g[3];
+                gravity_in_body(q, g);
+                item.kind = 'A';
+                item.t = next_acc;
+                for (int i = 0; i < 3; i++) {
+                    item.v[i] = g[i] + 0.02 * sin(7.0 * s + i) + noise * 0.01 * gauss(seed);
+                }
+                next_acc += acc_period;
+            } else {
+                item.kind = 'G';
+                item.t = next_gyro;
+                for (int i = 0; i < 3; i++) {
+                    item.v[i] = w[i] + noise * 0.1 * gauss(seed);
+                }
+                trace.push_back(item);
+                item.kind = 'R';
+                for (int i = 0; i < 4; i++) {
+                    item.v[i] = q[i];
+                }
+                next_gyro += gyro_period;
+            }
+            trace.push_back(item);
+        }
+        // q' = q * exp(w dt / 2), body rates
+        double rate = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+        if (rate > 0) {
+            double angle = rate * DEG * sub_dt;
+            double k = sin(angle / 2) / rate;
+            double dq[4] = { cos(angle / 2), w[0] * k, w[1] * k, w[2] * k };
+            quat_mul(q, dq, q);
+        }
+    }
+    return trace;
+}
+
+bool load_trace(const char *path, trace_t &trace)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        trace_item_t item = {};
+        unsigned long long t;
+        int n = sscanf(line, "%c,%llu,%f,%f,%f,%f", &item.kind, &t, &item.v[0], &item.v[1], &item.v[2], &item.v[3]);
+        if (n < 5 || (item.kind == 'R' && n < 6) || !strchr("AGR", item.kind)) {
+            continue;
+        }
+        item.t = t;
+        trace.push_back(item);
+    }
+    fclose(fp);
+    return !trace.empty();
+}
+
+bool write_trace(const char *path, const trace_t &trace)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    for (const trace_item_t &item : trace) {
+        fprintf(fp, "%c,%llu,%.6f,%.6f,%.6f", item.kind, (unsigned long long)item.t, item.v[0], item.v[1], item.v[2]);
+        if (item.kind == 'R') {
+            fprintf(fp, ",%.6f", item.v[3]);
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+    return true;
+}
+
+void trace_check(trace_error_t &err, const float est[4], const float ref[4])
+{
+    double dot = fabs(est[0] * ref[0] + est[1] * ref[1] + est[2] * ref[2] + est[3] * ref[3]);
+    double total = 2 * acos(dot > 1 ? 1 : dot) / DEG;
+
+    double qe[4] = { est[0], est[1], est[2], est[3] };
+    double qr[4] = { ref[0], ref[1], ref[2], ref[3] };
+    double ge[3], gr[3];
+    gravity_in_body(qe, ge);
+    gravity_in_body(qr, gr);
+    double c = (ge[0] * gr[0] + ge[1] * gr[1] + ge[2] * gr[2]) /
+               sqrt((ge[0] * ge[0] + ge[1] * ge[1] + ge[2] * ge[2]) * (gr[0] * gr[0] + gr[1] * gr[1] + gr[2] * gr[2]));
+    double tilt = acos(c > 1 ? 1 : c) / DEG;
+
+    err.mean_err += total;
+    err.mean_tilt += tilt;
+    err.max_err = total > err.max_err ? total : err.max_err;
+    err.max_tilt = tilt > err.max_tilt ? tilt : err.max_tilt;
+    err.checks++;
+}
+
+void trace_finish(trace_error_t &err)
+{
+    if (err.checks) {
+        err.mean_err /= err.checks;
+        err.mean_tilt /= err.checks;
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file      imu_trace.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Accelerometer and gyroscope traces with a reference orientation for the
+ *            orientation benchmarks: a synthetic motion, CSV recordings and the error of
+ *            an estimated quaternion against the reference
+ */
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// BHI260AP timestamps count in 1/64000 s
+#define TRACE_TICK_NS       15625ULL
+
+typedef struct {
+    char kind;          // 'A' accelerometer in g, 'G' gyroscope in deg/s, 'R' reference w x y z
+    uint64_t t;
+    float v[4];
+} trace_item_t;
+
+typedef std::vector<trace_item_t> trace_t;
+
+typedef struct {
+    double mean_err;
+    double max_err;
+    double mean_tilt;
+    double max_tilt;
+    uint32_t checks;
+} trace_error_t;
+
+/*
+ * The device turns about all axes with changing rates and shakes a little. The reference
+ * is integrated at 8 kHz, both sensors sample it on the 64 kHz sensor clock. Every
+ * gyroscope sample is followed by the reference at its timestamp
+ */
+trace_t make_trace(double seconds, double acc_hz, double gyro_hz, double noise);
+
+// Lines of A,t_ns,x,y,z  G,t_ns,x,y,z  R,t_ns,w,x,y,z
+bool load_trace(const char *path, trace_t &trace);
+bool write_trace(const char *path, const trace_t &trace);
+
+// Adds the total and the tilt angle between est and ref, both w x y z
+void trace_check(trace_error_t &err, const float est[4], const float ref[4]);
+// Turns the sums into means
+void trace_finish(trace_error_t &err);
@@ -0,0 +1,154 @@
+/**
+ * @file      Arduino.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      The part of the Arduino-ESP32 API used by LV_Helper, lv_conf.h and SensorLib,
+ *            for host builds
+ */
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp32-hal-psram.h"
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <string>
+using std::max;
+using std::min;
+extern "C" {
+#endif
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH                    0x1
+#define LOW                     0x0
+
+#define INPUT                   0x01
+#define OUTPUT                  0x03
+#define INPUT_PULLUP            0x05
+#define INPUT_PULLDOWN          0x09
+
+#define RISING                  0x01
+#define FALLING                 0x02
+#define CHANGE                  0x03
+
+// Default bus pins of the ESP32-S3 variant
+#define SDA                     8
+#define SCL                     9
+#define MOSI                    11
+#define SCK                     12
+#define MISO                    13
+
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+#define IRAM_ATTR
+
+#define log_e(format, ...)      fprintf(stderr, "[E] " format "\n", ##__VA_ARGS__)
+#define log_w(format, ...)      fprintf(stderr, "[W] " format "\n", ##__VA_ARGS__)
+// Not printed, but the arguments are still checked and count as used
+#define log_i(format, ...)      do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+#define log_d(format, ...)      do { if (0) fprintf(stderr, format, ##__VA_ARGS__); } while (0)
+
+// millis() and micros() follow a virtual clock, so lvgl timers and animations advance the
+// same way on every run no matter how fast the host renders
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void hostAdvanceMillis(uint32_t ms);
+void hostAdvanceMicros(uint32_t us);
+
+// GPIO levels are only changed by hostSetPin(), which runs the interrupt handlers of the pin
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode);
+void detachInterrupt(uint8_t pin);
+void hostSetPin(uint8_t pin, int level);
+
+#ifdef __cplusplus
+}
+
+long random(long howsmall, long howbig);
+
+class String : public std::string
+{
+public:
+    String(const char *str = "") : std::string(str) {}
+    String(const std::string &str) : std::string(str) {}
+    explicit String(int value) : std::string(std::to_string(value)) {}
+};
+
+class Stream
+{
+public:
+    size_t print(const char *str)
+    {
+        return ::printf("%s", str);
+    }
+    size_t print(long value)
+    {
+        return ::printf("%ld", value);
+    }
+    size_t print(unsigned long value)
+    {
+        return ::printf("%lu", value);
+    }
+    size_t print(int value)
+    {
+        return print((long)value);
+    }
+    size_t print(unsigned int value)
+    {
+        return print((unsigned long)value);
+    }
+    size_t print(double value)
+    {
+        return ::printf("%.2f", value);
+    }
+    size_t println()
+    {
+        return ::printf("\n");
+    }
+    template <typename T>
+    size_t println(T value)
+    {
+        return print(value) + println();
+    }
+    template <typename... Args>
+    int printf(const char *format, Args... args)
+    {
+        return ::printf(format, args...);
+    }
+    void flush()
+    {
+        fflush(stdout);
+    }
+};
+
+class HostSerial : public Stream
+{
+public:
+    void begin(unsigned long baud)
+    {
+        (void)baud;
+    }
+};
+
+extern HostSerial Serial;
+#endif
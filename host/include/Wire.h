@@ -0,0 +1,68 @@
+/**
+ * @file      Wire.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Host replacement. Addresses without a device attached by hostAttach() are
+ *            NACKed. Like Arduino-ESP32, a read is limited to the buffer, whose size can
+ *            only change before begin(), and every byte takes nine clocks of virtual time
+ */
+#pragma once
+
+#include "Arduino.h"
+
+// A device on a host bus
+class HostI2CDevice
+{
+public:
+    virtual ~HostI2CDevice() {}
+    // The bytes of one write transaction
+    virtual void i2cWrite(const uint8_t *data, size_t size) = 0;
+    // Fills one read transaction, returns the bytes sent
+    virtual size_t i2cRead(uint8_t *data, size_t size) = 0;
+};
+
+class TwoWire
+{
+public:
+    TwoWire();
+    ~TwoWire();
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end();
+    void setClock(uint32_t frequency);
+    size_t setBufferSize(size_t size);
+    void beginTransmission(uint16_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    size_t requestFrom(uint16_t address, size_t size, bool sendStop = true);
+    size_t readBytes(uint8_t *buffer, size_t length);
+    int available();
+    int read();
+
+    // Host side, device answers address from now on, NULL detaches it
+    void hostAttach(uint8_t address, HostI2CDevice *device);
+
+    // Transactions on the bus and the bytes they moved, address bytes included
+    uint32_t hostTransactions;
+    uint64_t hostBytes;
+
+private:
+    void busTime(size_t bytes);
+
+    HostI2CDevice *_devices[128];
+    uint8_t *_txBuffer;
+    uint8_t *_rxBuffer;
+    size_t _bufferSize;
+    size_t _txLength;
+    size_t _rxLength;
+    size_t _rxIndex;
+    uint16_t _address;
+    uint32_t _frequency;
+    bool _started;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
@@ -0,0 +1,21 @@
+/**
+ * @file      esp32-hal-psram.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Host replacement, PSRAM allocations come from the heap
+ */
+#pragma once
+
+#include <stdlib.h>
+
+static inline void *ps_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static inline void *ps_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
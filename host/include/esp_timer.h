@@ -0,0 +1,13 @@
+/**
+ * @file      esp_timer.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Host replacement, microseconds of the monotonic host clock
+ */
+#pragma once
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();
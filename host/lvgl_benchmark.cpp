@@ -0,0 +1,178 @@
+/**
+ * @file      lvgl_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Runs a factory screen on LilyGo_HostDisplay and reports the cost of every frame
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "Arduino.h"
+#include "LV_Helper.h"
+#include "LilyGo_HostDisplay.h"
+#include "scenes.h"
+
+// Virtual time between two lv_timer_handler calls, as the loop() of the examples
+#define BENCHMARK_STEP_MS       5
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options] [scene]\n", name);
+    printf("  scene           ");
+    for (uint32_t i = 0; i < host_scene_count; i++) {
+        printf("%s%s", i ? ", " : "", host_scenes[i].name);
+    }
+    printf(" (default %s)\n", host_scenes[0].name);
+    printf("  --duration MS   virtual run time, default 10000\n");
+    printf("  --interval MS   time between tile changes, default 1500\n");
+    printf("  --bits 16|12    panel pixel format, default 16\n");
+    printf("  --viewport      render only the area visible through the shell or lens\n");
+    printf("  --delta         send only changed line spans\n");
+    printf("  --full          full refresh instead of partial refresh\n");
+    printf("  --csv           print one line per frame\n");
+    printf("  --dump DIR      write DIR/frame_NNNN.png for every frame\n");
+}
+
+static bool writeFrame(LilyGo_HostDisplay &display, const char *dir, uint32_t frame)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/frame_%04lu.png", dir, (unsigned long)frame);
+    if (!display.writePNG(path)) {
+        fprintf(stderr, "Failed to write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const host_scene_t *scene = &host_scenes[0];
+    uint32_t duration = 10000;
+    uint32_t interval = 1500;
+    uint8_t bits = 16;
+    bool viewport = false;
+    bool delta = false;
+    bool full = false;
+    bool csv = false;
+    const char *dump = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--duration") && has_value) {
+            duration = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--interval") && has_value) {
+            interval = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--bits") && has_value) {
+            bits = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--dump") && has_value) {
+            dump = argv[++i];
+        } else if (!strcmp(arg, "--viewport")) {
+            viewport = true;
+        } else if (!strcmp(arg, "--delta")) {
+            delta = true;
+        } else if (!strcmp(arg, "--full")) {
+            full = true;
+        } else if (!strcmp(arg, "--csv")) {
+            csv = true;
+        } else {
+            scene = NULL;
+            for (uint32_t n = 0; n < host_scene_count; n++) {
+                if (!strcmp(arg, host_scenes[n].name)) {
+                    scene = &host_scenes[n];
+                }
+            }
+            if (!scene) {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    }
+
+    LilyGo_HostDisplay display;
+    if (!display.begin(bits)) {
+        usage(argv[0]);
+        return 1;
+    }
+    display.setFullRefresh(full);
+    if (delta && !display.setDeltaFlush(true)) {
+        return 1;
+    }
+    scene->setup(display, viewport);
+
+    beginLvglHelper(display);
+    scene->create();
+
+    // The first refresh draws the whole screen, count it separately
+    hostAdvanceMillis(BENCHMARK_STEP_MS);
+    lv_timer_handler();
+    host_display_stats_t first;
+    display.getStats(first);
+    display.resetStats();
+    if (!first.pixels || !first.panel_bytes) {
+        printf("FAIL: the first frame was not flushed\n");
+        return 1;
+    }
+    if (dump && !writeFrame(display, dump, 0)) {
+        return 1;
+    }
+
+    if (csv) {
+        printf("frame,time_ms,render_us,flushes,pixels,panel_bytes,transactions\n");
+    }
+
+    uint32_t frames = 0;
+    uint64_t total_us = 0, max_us = 0;
+    host_display_stats_t last;
+    memset(&last, 0, sizeof(last));
+    uint32_t next_action = interval;
+
+    for (uint32_t time = 0; time < duration; time += BENCHMARK_STEP_MS) {
+        if (interval && time >= next_action) {
+            next_action += interval;
+            scene->next();
+        }
+
+        hostAdvanceMillis(BENCHMARK_STEP_MS);
+        auto start = std::chrono::steady_clock::now();
+        lv_timer_handler();
+        uint64_t render_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        host_display_stats_t now;
+        display.getStats(now);
+        if (now.flushes == last.flushes) {
+            continue;
+        }
+
+        frames++;
+        total_us += render_us;
+        if (render_us > max_us) {
+            max_us = render_us;
+        }
+        if (csv) {
+            printf("%lu,%lu,%llu,%lu,%llu,%llu,%lu\n", (unsigned long)frames, (unsigned long)time, (unsigned long long)render_us,
+                   (unsigned long)(now.flushes - last.flushes), (unsigned long long)(now.pixels - last.pixels),
+                   (unsigned long long)(now.panel_bytes - last.panel_bytes), (unsigned long)(now.transactions - last.transactions));
+        }
+        if (dump && !writeFrame(display, dump, frames)) {
+            return 1;
+        }
+        last = now;
+    }
+
+    printf("scene %s, %ux%u, %u bit%s%s%s\n", scene->name, display.width(), display.height(), bits,
+           viewport ? ", viewport" : "", delta ? ", delta" : "", full ? ", full refresh" : "");
+    printf("first frame: %llu pixels, %llu panel bytes, %lu transactions\n",
+           (unsigned long long)first.pixels, (unsigned long long)first.panel_bytes, (unsigned long)first.transactions);
+    printf("%lu frames in %lu ms\n", (unsigned long)frames, (unsigned long)duration);
+    if (frames) {
+        printf("render:       %.1f us average, %llu us max\n", (double)total_us / frames, (unsigned long long)max_us);
+        printf("pixels:       %.0f per frame\n", (double)last.pixels / frames);
+        printf("panel bytes:  %.0f per frame\n", (double)last.panel_bytes / frames);
+        printf("transactions: %.1f per frame\n", (double)last.transactions / frames);
+    }
+    return 0;
+}
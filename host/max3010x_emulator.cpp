@@ -0,0 +1,308 @@
+/**
+ * @file      max3010x_emulator.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <string.h>
+#include "Arduino.h"
+#include "max3010x_emulator.h"
+
+#define EMU_REG_INTSTAT1            0x00
+#define EMU_REG_INTSTAT2            0x01
+#define EMU_REG_INTENABLE1          0x02
+#define EMU_REG_INTENABLE2          0x03
+#define EMU_REG_FIFO_WR_PTR         0x04
+#define EMU_REG_FIFO_OVF            0x05
+#define EMU_REG_FIFO_RD_PTR         0x06
+#define EMU_REG_FIFO_DATA           0x07
+#define EMU_REG_FIFO_CONFIG         0x08
+#define EMU_REG_MODE_CONFIG         0x09
+#define EMU_REG_SPO2_CONFIG         0x0A
+#define EMU_REG_MULTI_LED1          0x11
+#define EMU_REG_MULTI_LED2          0x12
+#define EMU_REG_TEMP_INT            0x1F
+#define EMU_REG_TEMP_FRAC           0x20
+#define EMU_REG_TEMP_CONFIG         0x21
+#define EMU_REG_REVISION_ID         0xFE
+#define EMU_REG_PART_ID             0xFF
+
+#define EMU_INT_A_FULL              0x80
+#define EMU_INT_PPG_RDY             0x40
+#define EMU_INT_PWR_RDY             0x01
+#define EMU_INT_DIE_TEMP_RDY        0x02
+
+#define EMU_MODE_SHDN               0x80
+#define EMU_MODE_RESET              0x40
+#define EMU_FIFO_ROLLOVER           0x10
+
+static const uint16_t emu_sample_rates[] = { 50, 100, 200, 400, 800, 1000, 1600, 3200 };
+
+Max3010xEmulator::Max3010xEmulator()
+{
+    memset(&__stats, 0, sizeof(__stats));
+    reset();
+}
+
+void Max3010xEmulator::setIrqPin(int pin)
+{
+    __irq_pin = pin;
+    __irq_low = false;
+    if (pin >= 0) {
+        hostSetPin(pin, HIGH);
+    }
+    updateIrq();
+}
+
+void Max3010xEmulator::poll()
+{
+    if (__period_us > 0) {
+        double now = micros();
+        while (__start_us + (__index + 1) * __period_us <= now) {
+            push();
+        }
+    }
+    updateIrq();
+}
+
+float Max3010xEmulator::getSampleRate() const
+{
+    if ((__regs[EMU_REG_MODE_CONFIG] & EMU_MODE_SHDN) || !getActiveLeds()) {
+        return 0;
+    }
+    uint8_t average = (__regs[EMU_REG_FIFO_CONFIG] >> 5) & 0x07;
+    return emu_sample_rates[(__regs[EMU_REG_SPO2_CONFIG] >> 2) & 0x07] / (float)(1 << (average > 5 ? 5 : average));
+}
+
+// Red only, red and IR, or the slots up to the first disabled one
+uint8_t Max3010xEmulator::getActiveLeds() const
+{
+    switch (__regs[EMU_REG_MODE_CONFIG] & 0x07) {
+    case 2:
+        return 1;
+    case 3:
+        return 2;
+    case 7: {
+        uint8_t slots[4] = {
+            (uint8_t)(__regs[EMU_REG_MULTI_LED1] & 0x07), (uint8_t)((__regs[EMU_REG_MULTI_LED1] >> 4) & 0x07),
+            (uint8_t)(__regs[EMU_REG_MULTI_LED2] & 0x07), (uint8_t)((__regs[EMU_REG_MULTI_LED2] >> 4) & 0x07),
+        };
+        uint8_t count = 0;
+        while (count < 4 && slots[count]) {
+            count++;
+        }
+        return count;
+    }
+    default:
+        return 0;
+    }
+}
+
+uint32_t Max3010xEmulator::getSamplesTaken() const
+{
+    return __index;
+}
+
+double Max3010xEmulator::getSampleTimeUs(uint32_t index) const
+{
+    return __start_us + (index + 1) * __period_us;
+}
+
+uint32_t Max3010xEmulator::getSampleValue(uint32_t index, uint8_t channel)
+{
+    return ((index << 2) | channel) & 0x3FFFF;
+}
+
+const Max3010xEmulator::Stats &Max3010xEmulator::getStats() const
+{
+    return __stats;
+}
+
+void Max3010xEmulator::i2cWrite(const uint8_t *data, size_t size)
+{
+    poll();
+    if (!size) {
+        return;
+    }
+    __pointer = data[0];
+    for (size_t i = 1; i < size; i++) {
+        writeRegister(__pointer, data[i]);
+        // FIFO_DATA is the one register the address does not move past
+        if (__pointer != EMU_REG_FIFO_DATA) {
+            __pointer++;
+        }
+    }
+    updateIrq();
+}
+
+size_t Max3010xEmulator::i2cRead(uint8_t *data, size_t size)
+{
+    poll();
+    for (size_t i = 0; i < size; i++) {
+        data[i] = readRegister(__pointer);
+        if (__pointer != EMU_REG_FIFO_DATA) {
+            __pointer++;
+        }
+    }
+    updateIrq();
+    return size;
+}
+
+void Max3010xEmulator::reset()
+{
+    memset(__regs, 0, sizeof(__regs));
+    __regs[EMU_REG_INTSTAT1] = EMU_INT_PWR_RDY;
+    __regs[EMU_REG_REVISION_ID] = 0x03;
+    __regs[EMU_REG_PART_ID] = 0x15;
+    __unread = 0;
+    __byte = 0;
+    __period_us = 0;
+}
+
+// The sample clock restarts with each change of the configuration
+void Max3010xEmulator::restart()
+{
+    float rate = getSampleRate();
+    __period_us = rate > 0 ? 1000000.0 / rate : 0;
+    __start_us = micros() - __index * __period_us;
+}
+
+void Max3010xEmulator::push()
+{
+    if (__unread == EMU_MAX3010X_FIFO_DEPTH) {
+        uint8_t ovf = __regs[EMU_REG_FIFO_OVF];
+        __regs[EMU_REG_FIFO_OVF] = ovf < 0x1F ? ovf + 1 : ovf;
+        __stats.overwritten++;
+        if (!(__regs[EMU_REG_FIFO_CONFIG] & EMU_FIFO_ROLLOVER)) {
+            // The FIFO keeps its samples and the new one is lost
+            __index++;
+            return;
+        }
+        __regs[EMU_REG_FIFO_RD_PTR] = (__regs[EMU_REG_FIFO_RD_PTR] + 1) & 0x1F;
+        __unread--;
+        __byte = 0;
+    }
+    uint8_t *record = __fifo[__regs[EMU_REG_FIFO_WR_PTR]];
+    for (uint8_t c = 0; c < getActiveLeds(); c++) {
+        uint32_t value = getSampleValue(__index, c);
+        record[c * 3] = (value >> 16) & 0x03;
+        record[c * 3 + 1] = value >> 8;
+        record[c * 3 + 2] = value;
+    }
+    __regs[EMU_REG_FIFO_WR_PTR] = (__regs[EMU_REG_FIFO_WR_PTR] + 1) & 0x1F;
+    __unread++;
+    __index++;
+    __stats.samples++;
+
+    __regs[EMU_REG_INTSTAT1] |= EMU_INT_PPG_RDY;
+    if (__unread == EMU_MAX3010X_FIFO_DEPTH - (__regs[EMU_REG_FIFO_CONFIG] & 0x0F)) {
+        __regs[EMU_REG_INTSTAT1] |= EMU_INT_A_FULL;
+    }
+}
+
+// INT is low while an enabled interrupt, or the power ready one, is pending
+void Max3010xEmulator::updateIrq()
+{
+    bool low = (__regs[EMU_REG_INTSTAT1] & ((__regs[EMU_REG_INTENABLE1] & 0xF0) | EMU_INT_PWR_RDY)) ||
+               (__regs[EMU_REG_INTSTAT2] & __regs[EMU_REG_INTENABLE2] & EMU_INT_DIE_TEMP_RDY);
+    if (low == __irq_low) {
+        return;
+    }
+    __irq_low = low;
+    if (low) {
+        __stats.interrupts++;
+    }
+    if (__irq_pin >= 0) {
+        hostSetPin(__irq_pin, low ? LOW : HIGH);
+    }
+}
+
+void Max3010xEmulator::writeRegister(uint8_t reg, uint8_t value)
+{
+    switch (reg) {
+    case EMU_REG_INTSTAT1:
+    case EMU_REG_INTSTAT2:
+    case EMU_REG_FIFO_DATA:
+    case EMU_REG_REVISION_ID:
+    case EMU_REG_PART_ID:
+        break;
+    case EMU_REG_FIFO_WR_PTR:
+    case EMU_REG_FIFO_RD_PTR:
+        __regs[reg] = value & 0x1F;
+        __unread = (__regs[EMU_REG_FIFO_WR_PTR] - __regs[EMU_REG_FIFO_RD_PTR]) & 0x1F;
+        __byte = 0;
+        break;
+    case EMU_REG_FIFO_OVF:
+        __regs[reg] = value & 0x1F;
+        break;
+    case EMU_REG_MODE_CONFIG:
+        if (value & EMU_MODE_RESET) {
+            reset();
+            break;
+        }
+        __regs[reg] = value;
+        restart();
+        break;
+    case EMU_REG_FIFO_CONFIG:
+    case EMU_REG_SPO2_CONFIG:
+    case EMU_REG_MULTI_LED1:
+    case EMU_REG_MULTI_LED2:
+        __regs[reg] = value;
+        restart();
+        break;
+    case EMU_REG_TEMP_CONFIG:
+        // The conversion completes at once, 30.25 degrees
+        if (value & 0x01) {
+            __regs[EMU_REG_TEMP_INT] = 30;
+            __regs[EMU_REG_TEMP_FRAC] = 4;
+            __regs[EMU_REG_INTSTAT2] |= EMU_INT_DIE_TEMP_RDY;
+        }
+        break;
+    default:
+        __regs[reg] = value;
+        break;
+    }
+}
+
+uint8_t Max3010xEmulator::readRegister(uint8_t reg)
+{
+    uint8_t value = __regs[reg];
+    switch (reg) {
+    case EMU_REG_INTSTAT1:
+    case EMU_REG_INTSTAT2:
+        // Reading a status register clears it
+        __regs[reg] = 0;
+        break;
+    case EMU_REG_TEMP_FRAC:
+        __regs[EMU_REG_INTSTAT2] &= ~EMU_INT_DIE_TEMP_RDY;
+        break;
+    case EMU_REG_FIFO_DATA:
+        value = readFifo();
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+// The read pointer moves on once the last byte of a sample is read, which also clears
+// the overflow counter
+uint8_t Max3010xEmulator::readFifo()
+{
+    uint8_t leds = getActiveLeds();
+    if (!__unread || !leds) {
+        return 0;
+    }
+    uint8_t value = __fifo[__regs[EMU_REG_FIFO_RD_PTR]][__byte++];
+    __stats.fifo_bytes++;
+    if (__byte >= leds * 3) {
+        __byte = 0;
+        __regs[EMU_REG_FIFO_RD_PTR] = (__regs[EMU_REG_FIFO_RD_PTR] + 1) & 0x1F;
+        __unread--;
+        __regs[EMU_REG_FIFO_OVF] = 0;
+        __regs[EMU_REG_INTSTAT1] &= ~EMU_INT_PPG_RDY;
+    }
+    return value;
+}
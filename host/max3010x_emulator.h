@@ -0,0 +1,72 @@
+/**
+ * @file      max3010x_emulator.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      MAX30105 / MAX30102 emulation on a host TwoWire, so the SparkFun library and
+ *            PpgFifo run unchanged. Covers the registers, the 32 sample FIFO with its
+ *            pointers, rollover and overflow counter, sample averaging, the almost full and
+ *            data ready interrupts on an active low INT line, and the die temperature.
+ *            Each channel of sample n reads (n << 2 | channel) in 18 bits
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Wire.h"
+
+#define EMU_MAX3010X_FIFO_DEPTH     32
+
+class Max3010xEmulator : public HostI2CDevice
+{
+public:
+    typedef struct {
+        uint32_t samples;           // samples written to the FIFO
+        uint32_t overwritten;       // samples lost to a full FIFO
+        uint32_t interrupts;        // falling edges of INT
+        uint32_t fifo_bytes;        // FIFO_DATA bytes read
+    } Stats;
+
+    Max3010xEmulator();
+
+    // Pin driven through hostSetPin(), -1 for none
+    void setIrqPin(int pin);
+
+    // Catch up with micros(): put the samples that are due into the FIFO and update INT
+    void poll();
+
+    // FIFO records per second, after averaging, 0 while shut down
+    float getSampleRate() const;
+    uint8_t getActiveLeds() const;
+    // Samples taken since the emulator was created, the index of the next one
+    uint32_t getSamplesTaken() const;
+    // micros() at which sample n entered the FIFO
+    double getSampleTimeUs(uint32_t index) const;
+    static uint32_t getSampleValue(uint32_t index, uint8_t channel);
+    const Stats &getStats() const;
+
+    void i2cWrite(const uint8_t *data, size_t size);
+    size_t i2cRead(uint8_t *data, size_t size);
+
+private:
+    void reset();
+    void restart();
+    void push();
+    void updateIrq();
+    void writeRegister(uint8_t reg, uint8_t value);
+    uint8_t readRegister(uint8_t reg);
+    uint8_t readFifo();
+
+    uint8_t __regs[256];
+    uint8_t __fifo[EMU_MAX3010X_FIFO_DEPTH][12];
+    uint8_t __unread = 0;
+    uint8_t __pointer = 0;
+    uint8_t __byte = 0;             // position within the sample being read
+    int __irq_pin = -1;
+    bool __irq_low = false;
+    double __start_us = 0;
+    double __period_us = 0;
+    uint32_t __index = 0;
+    Stats __stats;
+};
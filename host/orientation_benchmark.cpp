@@ -0,0 +1,207 @@
+/**
+ * @file      orientation_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Runs OrientationProvider on the emulated BHI260AP with every backend in turn,
+ *            switching on the same sensor the way the UI would. The emulated device turns
+ *            about z at 0.5 rad/s. Reports the host CPU time per second of update() without
+ *            the emulator itself, the FIFO traffic, and the tilt and turn rate the UI reads.
+ *            Exits with 1 on a failure
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "SensorBHI260AP.hpp"
+#include "orientationProvider.h"
+#include "bhi260ap_emulator.h"
+
+#define EMU_IRQ_PIN     21
+#define EMU_TURN_DPS    (0.5 * 180 / M_PI)
+
+typedef struct {
+    const char *name;
+    orientation_backend_t backend;
+    double cpu_us_per_s;
+    double bus_bytes_per_s;
+    double events_per_s;
+    double max_tilt;
+    double turn_dps;
+    bool ok;
+} backend_result_t;
+
+static backend_result_t backend_result(const char *name, orientation_backend_t backend)
+{
+    backend_result_t r;
+    memset(&r, 0, sizeof(r));
+    r.name = name;
+    r.backend = backend;
+    return r;
+}
+
+static Bhi260apEmulator emu;
+static uint64_t emu_ns;
+
+// The emulator runs inside the bus functions, its time is taken out of the host cost
+static int8_t timed_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    int8_t rslt = Bhi260apEmulator::read(reg_addr, reg_data, length, intf_ptr);
+    emu_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    return rslt;
+}
+
+static int8_t timed_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    int8_t rslt = Bhi260apEmulator::write(reg_addr, reg_data, length, intf_ptr);
+    emu_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    return rslt;
+}
+
+static void run(SensorBHI260AP &bhy, OrientationProvider &provider, backend_result_t &result,
+                float rate_hz, uint32_t seconds, uint32_t step_us, uint32_t ui_ms)
+{
+    result.ok = false;
+    if (!provider.begin(bhy, result.backend, rate_hz)) {
+        fprintf(stderr, "%s: begin failed\n", result.name);
+        return;
+    }
+
+    const Bhi260apEmulator::Stats &stats = emu.getStats();
+    uint64_t bytes0 = stats.read_bytes + stats.write_bytes;
+    uint32_t events0 = stats.events;
+    uint64_t busy_ns = 0;
+    emu_ns = 0;
+
+    // The UI reads the angles every ui_ms, the first second lets the backend settle
+    double last_yaw = 0, turned = 0;
+    uint32_t reads = 0;
+    uint64_t next_ui = ui_ms * 1000ULL, settle = 1000000ULL;
+    for (uint64_t t = 0; t < (uint64_t)seconds * 1000000; t += step_us) {
+        hostAdvanceMicros(step_us);
+        emu.poll();
+        auto t0 = std::chrono::steady_clock::now();
+        bhy.update();
+        busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+
+        if (t + step_us < next_ui) {
+            continue;
+        }
+        next_ui += ui_ms * 1000ULL;
+        float q[4];
+        if (!provider.getQuaternion(q) || t < settle) {
+            continue;
+        }
+        double tilt = fabs(provider.getRoll()) > fabs(provider.getPitch()) ? fabs(provider.getRoll()) : fabs(provider.getPitch());
+        result.max_tilt = tilt > result.max_tilt ? tilt : result.max_tilt;
+        double yaw = provider.getYaw();
+        if (reads) {
+            double step = yaw - last_yaw;
+            turned += step > 180 ? step - 360 : (step < -180 ? step + 360 : step);
+        }
+        last_yaw = yaw;
+        reads++;
+    }
+    provider.end();
+
+    double span_s = reads > 1 ? (reads - 1) * ui_ms / 1000.0 : 0;
+    result.cpu_us_per_s = (busy_ns - emu_ns) / 1000.0 / seconds;
+    result.bus_bytes_per_s = (double)(stats.read_bytes + stats.write_bytes - bytes0) / seconds;
+    result.events_per_s = (double)(stats.events - events0) / seconds;
+    result.turn_dps = span_s > 0 ? turned / span_s : 0;
+    result.ok = reads > 1;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --seconds N         simulated run time per backend, default 10\n");
+    printf("  --rate-hz N         orientation or raw sensor rate, default 100\n");
+    printf("  --step-us N         host loop period, default 1000\n");
+    printf("  --ui-ms N           period of the angle reads, default 20\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 10;
+    float rate_hz = 100;
+    uint32_t step_us = 1000;
+    uint32_t ui_ms = 20;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--seconds") && has_value) {
+            seconds = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--rate-hz") && has_value) {
+            rate_hz = atof(argv[++i]);
+        } else if (!strcmp(arg, "--step-us") && has_value) {
+            step_us = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--ui-ms") && has_value) {
+            ui_ms = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (seconds < 2 || rate_hz <= 0 || !step_us || !ui_ms) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    emu.setIrqPin(EMU_IRQ_PIN);
+    SensorBHI260AP bhy;
+    bhy.setPins(SENSOR_PIN_NONE, EMU_IRQ_PIN);
+    if (!bhy.init(timed_read, timed_write, &emu)) {
+        fprintf(stderr, "init failed: %s\n", bhy.getError().c_str());
+        printf("FAIL\n");
+        return 1;
+    }
+
+    backend_result_t results[] = {
+        backend_result("game rv", ORIENTATION_GAME_RV),
+        backend_result("rv", ORIENTATION_RV),
+        backend_result("host", ORIENTATION_HOST),
+    };
+    const size_t count = sizeof(results) / sizeof(results[0]);
+    OrientationProvider provider;
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        backend_result_t &r = results[i];
+        run(bhy, provider, r, rate_hz, seconds, step_us, ui_ms);
+        if (!r.ok) {
+            fprintf(stderr, "%s: no orientation\n", r.name);
+            ok = false;
+            continue;
+        }
+        // end() leaves no stream of the backend running
+        for (uint8_t id : { SENSOR_ID_RV, SENSOR_ID_GAMERV, SENSOR_ID_ACC_PASS, SENSOR_ID_GYRO_PASS }) {
+            if (emu.getSampleRate(id) != 0) {
+                fprintf(stderr, "%s: sensor %u still running\n", r.name, id);
+                ok = false;
+            }
+        }
+        if (r.max_tilt > 2 || fabs(r.turn_dps - EMU_TURN_DPS) > EMU_TURN_DPS * 0.05) {
+            fprintf(stderr, "%s: tilt %.2f deg, turn %.2f deg/s, expected 0 and %.2f\n",
+                    r.name, r.max_tilt, r.turn_dps, EMU_TURN_DPS);
+            ok = false;
+        }
+    }
+    // One stream instead of two
+    if (results[0].bus_bytes_per_s >= results[2].bus_bytes_per_s) {
+        fprintf(stderr, "on chip fusion moves no fewer bytes than the raw streams\n");
+        ok = false;
+    }
+
+    printf("%-8s %12s %12s %10s %10s %10s\n", "backend", "host us/s", "bus bytes/s", "events/s", "max tilt", "turn dps");
+    for (size_t i = 0; i < count; i++) {
+        const backend_result_t &r = results[i];
+        printf("%-8s %12.1f %12.0f %10.0f %10.2f %10.2f\n", r.name, r.cpu_us_per_s, r.bus_bytes_per_s, r.events_per_s, r.max_tilt, r.turn_dps);
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file      panel_flush_test.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-17
+ * @note      Draws random areas, aligned by the lvgl rounder of LV_Helper, through the
+ *            flush path of the driver in every rotation. Checks the CASET and RASET
+ *            bytes on the mock panel IO and the pixels that land in the panel memory
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "Arduino.h"
+#include "LV_Helper.h"
+#include "LilyGo_HostDisplay.h"
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --areas N       random areas per rotation, default 200\n");
+    printf("  --seed N        random seed, default 1\n");
+    printf("  --bits 16|12    panel pixel format, default 16\n");
+    printf("  --delta         send only changed line spans, windows are not checked\n");
+}
+
+// What the panel memory holds after a pixel went over the bus
+static uint16_t panel_pixel(uint16_t value, uint8_t bits)
+{
+    if (bits != 12) {
+        return value;
+    }
+    uint16_t rgb565 = (value >> 8) | (value << 8);
+    uint32_t r = rgb565 >> 12, g = (rgb565 >> 7) & 0x0F, b = (rgb565 >> 1) & 0x0F;
+    rgb565 = ((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3);
+    return (rgb565 >> 8) | (rgb565 << 8);
+}
+
+// Panel memory position of a pixel in the coordinates of the rotation
+static uint32_t panel_offset(uint8_t rotation, uint32_t x, uint32_t y)
+{
+    switch (rotation) {
+    case 1:
+    case 3:
+        return x * HOST_DISPLAY_RAM_WIDTH + (JD9613_WIDTH - 1 - y);
+    case 2:
+        return y * HOST_DISPLAY_RAM_WIDTH + x + 2;
+    default:
+        return y * HOST_DISPLAY_RAM_WIDTH + x;
+    }
+}
+
+static bool check_param(const char *name, const uint8_t *param, uint32_t start, uint32_t end)
+{
+    uint32_t s = (param[0] << 8) | param[1];
+    uint32_t e = (param[2] << 8) | param[3];
+    if (s != start || e != end || (s & 1) || !(e & 1)) {
+        printf("  %s %u..%u, expected %u..%u starting even and ending odd\n",
+               name, (unsigned)s, (unsigned)e, (unsigned)start, (unsigned)end);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t areas = 200;
+    uint32_t seed = 1;
+    uint8_t bits = 16;
+    bool delta = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--areas") && has_value) {
+            areas = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--seed") && has_value) {
+            seed = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--bits") && has_value) {
+            bits = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--delta")) {
+            delta = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    LilyGo_HostDisplay display;
+    if (!display.begin(bits)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (delta && !display.setDeltaFlush(true)) {
+        return 1;
+    }
+    // The rounder lvgl applies to every area it flushes
+    beginLvglHelper(display);
+    lv_disp_drv_t *disp_drv = lv_disp_get_default()->driver;
+    if (!disp_drv->rounder_cb) {
+        printf("FAIL: no rounder installed\n");
+        return 1;
+    }
+
+    srand(seed);
+    std::vector<uint16_t> expected(display.framebuffer(), display.framebuffer() + HOST_DISPLAY_RAM_WIDTH * JD9613_HEIGHT);
+    std::vector<uint16_t> pixels;
+    uint32_t failures = 0;
+
+    for (uint8_t rotation = 0; rotation < 4; rotation++) {
+        display.setRotation(rotation);
+        const uint32_t width = display.width();
+        const uint32_t height = display.height();
+        uint32_t rotation_failures = 0;
+
+        for (uint32_t n = 0; n < areas && !rotation_failures; n++) {
+            lv_area_t area;
+            area.x1 = rand() % width;
+            area.y1 = rand() % height;
+            area.x2 = area.x1 + rand() % (width - area.x1);
+            area.y2 = area.y1 + rand() % (height - area.y1);
+            disp_drv->rounder_cb(disp_drv, &area);
+
+            const uint32_t w = area.x2 - area.x1 + 1;
+            const uint32_t h = area.y2 - area.y1 + 1;
+            pixels.resize(w * h);
+            for (uint32_t i = 0; i < w * h; i++) {
+                pixels[i] = rand();
+            }
+
+            const uint32_t windows = display.io().windows;
+            const uint32_t notifies = display.io().notifies;
+            const uint64_t color_bytes = display.io().base.stats.color_bytes;
+            display.pushColors(area.x1, area.y1, w, h, pixels.data());
+
+            for (uint32_t y = 0; y < h; y++) {
+                for (uint32_t x = 0; x < w; x++) {
+                    expected[panel_offset(rotation, area.x1 + x, area.y1 + y)] = panel_pixel(pixels[y * w + x], bits);
+                }
+            }
+
+            // Random pixels always differ, so every area ends with exactly one transfer-done callback
+            if (display.io().notifies != notifies + 1) {
+                printf("  %u transfer-done callbacks, expected 1\n", (unsigned)(display.io().notifies - notifies));
+                rotation_failures++;
+            }
+
+            if (!delta) {
+                const panel_io_mock_t &io = display.io();
+                uint32_t xs = area.x1, xe = area.x2, ys = area.y1, ye = area.y2;
+                if (rotation == 1 || rotation == 3) {
+                    xs = JD9613_WIDTH - 1 - area.y2;
+                    xe = JD9613_WIDTH - 1 - area.y1;
+                    ys = area.x1;
+                    ye = area.x2;
+                } else if (rotation == 2) {
+                    xs += 2;
+                    xe += 2;
+                }
+                const uint64_t sent = bits == 12 ? w * h * 3 / 2 : w * h * 2;
+                if (io.windows != windows + 1 || io.base.stats.color_bytes - color_bytes != sent) {
+                    printf("  %u windows and %llu bytes sent, expected 1 and %llu\n",
+                           (unsigned)(io.windows - windows), (unsigned long long)(io.base.stats.color_bytes - color_bytes),
+                           (unsigned long long)sent);
+                    rotation_failures++;
+                }
+                if (!check_param("CASET", io.caset, xs, xe) || !check_param("RASET", io.raset, ys, ye)) {
+                    rotation_failures++;
+                }
+            }
+
+            if (memcmp(display.framebuffer(), expected.data(), expected.size() * sizeof(uint16_t))) {
+                printf("  panel memory differs\n");
+                rotation_failures++;
+            }
+            if (rotation_failures) {
+                printf("  rotation %u area %u: (%d, %d) - (%d, %d)\n",
+                       rotation, (unsigned)n, area.x1, area.y1, area.x2, area.y2);
+            }
+        }
+        printf("rotation %u: %ux%u, %u areas%s\n", rotation, (unsigned)width, (unsigned)height,
+               (unsigned)areas, rotation_failures ? ", FAILED" : "");
+        failures += rotation_failures;
+    }
+
+    if (failures) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file      ppg_fifo_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Reads the emulated MAX3010x on Wire1 the ways the firmware can: getIR() and
+ *            getRed() as particleSensor.cpp does, check() with the library ring, and
+ *            PpgFifo on the interrupt and on its timer. The caller loop runs every step and
+ *            takes samples every UI period. Reports the samples the caller got and lost,
+ *            the overflows the reader reported, the bus traffic, the longest call and the
+ *            timestamp error. Exits with 1 if PpgFifo loses a sample it does not report
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "Arduino.h"
+#include "Wire.h"
+#include "MAX30105.h"
+#include "ppgFifo.h"
+#include "max3010x_emulator.h"
+
+#define EMU_IRQ_PIN     22
+
+typedef enum {
+    READ_GET_IR,
+    READ_CHECK,
+    READ_FIFO_IRQ,
+    READ_FIFO_TIMER,
+} read_mode_t;
+
+typedef struct {
+    const char *name;
+    read_mode_t mode;
+    uint32_t produced;          // samples taken from the first one the caller got
+    uint32_t seen;
+    uint32_t lost;              // gaps in the sample sequence the caller got
+    uint32_t corrupt;           // channels that do not belong to their sample
+    uint32_t reported;          // overflows the reader counted
+    uint32_t interrupts;
+    double transactions_per_s;
+    double bus_bytes_per_s;
+    uint32_t max_call_us;
+    double mean_ts_error_us;
+    double max_ts_error_us;
+    bool ok;
+} run_result_t;
+
+static run_result_t run_result(const char *name, read_mode_t mode)
+{
+    run_result_t r;
+    memset(&r, 0, sizeof(r));
+    r.name = name;
+    r.mode = mode;
+    return r;
+}
+
+typedef struct {
+    uint32_t seconds;
+    uint32_t rate;
+    uint8_t average;
+    uint8_t leds;
+    uint32_t ui_ms;
+    uint32_t step_us;
+    uint32_t depth;
+    uint8_t almost_full;
+} run_config_t;
+
+static Max3010xEmulator emu;
+
+// Follows the sample sequence the caller got, the red channel carries the index
+class SequenceCheck
+{
+public:
+    SequenceCheck(uint8_t leds) : _leds(leds) {}
+
+    void add(uint32_t red, uint32_t ir, uint32_t green, int64_t timestamp_us, bool timed, run_result_t &r)
+    {
+        uint32_t low = red >> 2;
+        uint32_t index;
+        if (!_started) {
+            // The newest sample with these low bits
+            uint32_t newest = emu.getSamplesTaken() - 1;
+            index = newest - ((newest - low) & 0xFFFF);
+            _first = index;
+            _started = true;
+        } else {
+            uint32_t step = (low - (_last & 0xFFFF)) & 0xFFFF;
+            if (!step) {
+                return;
+            }
+            r.lost += step - 1;
+            index = _last + step;
+        }
+        _last = index;
+        r.seen++;
+        if ((red & 0x03) != 0 || (_leds > 1 && ir != Max3010xEmulator::getSampleValue(index, 1)) ||
+                (_leds > 2 && green != Max3010xEmulator::getSampleValue(index, 2))) {
+            r.corrupt++;
+        }
+        if (timed) {
+            double error = fabs(timestamp_us - emu.getSampleTimeUs(index));
+            _errorSum += error;
+            r.max_ts_error_us = error > r.max_ts_error_us ? error : r.max_ts_error_us;
+        }
+    }
+
+    void finish(run_result_t &r)
+    {
+        r.produced = _started ? emu.getSamplesTaken() - _first : 0;
+        r.mean_ts_error_us = r.seen ? _errorSum / r.seen : 0;
+    }
+
+private:
+    uint8_t _leds;
+    bool _started = false;
+    uint32_t _first = 0;
+    uint32_t _last = 0;
+    double _errorSum = 0;
+};
+
+static void run(MAX30105 &sensor, const run_config_t &cfg, run_result_t &r)
+{
+    r.ok = false;
+    sensor.setup(0x1F, cfg.average, cfg.leds, cfg.rate, 411, 4096);
+
+    PpgFifo fifo;
+    if (r.mode == READ_FIFO_IRQ || r.mode == READ_FIFO_TIMER) {
+        int pin = r.mode == READ_FIFO_IRQ ? EMU_IRQ_PIN : -1;
+        if (!fifo.begin(sensor, Wire1, pin, cfg.depth, cfg.almost_full)) {
+            fprintf(stderr, "%s: begin failed\n", r.name);
+            return;
+        }
+    }
+
+    SequenceCheck check(cfg.leds);
+    std::vector<ppg_sample_t> samples(cfg.depth);
+    uint32_t transactions0 = Wire1.hostTransactions;
+    uint64_t bytes0 = Wire1.hostBytes;
+    uint32_t interrupts0 = emu.getStats().interrupts;
+    uint64_t start = micros();
+    uint64_t next_ui = start + cfg.ui_ms * 1000ULL;
+
+    while (micros() - start < cfg.seconds * 1000000ULL) {
+        hostAdvanceMicros(cfg.step_us);
+        emu.poll();
+
+        uint32_t t0 = micros();
+        if (r.mode == READ_FIFO_IRQ || r.mode == READ_FIFO_TIMER) {
+            fifo.update();
+        }
+        if (micros() >= next_ui) {
+            next_ui += cfg.ui_ms * 1000ULL;
+            switch (r.mode) {
+            case READ_GET_IR: {
+                uint32_t ir = sensor.getIR();
+                uint32_t red = sensor.getRed();
+                check.add(red, ir, 0, 0, false, r);
+                break;
+            }
+            case READ_CHECK:
+                sensor.check();
+                while (sensor.available()) {
+                    check.add(sensor.getFIFORed(), sensor.getFIFOIR(), sensor.getFIFOGreen(), 0, false, r);
+                    sensor.nextSample();
+                }
+                break;
+            default: {
+                uint32_t count = fifo.read(samples.data(), samples.size());
+                for (uint32_t i = 0; i < count; i++) {
+                    const ppg_sample_t &s = samples[i];
+                    check.add(s.red, s.ir, s.green, s.timestamp_us, true, r);
+                }
+                break;
+            }
+            }
+        }
+        uint32_t call_us = micros() - t0;
+        r.max_call_us = call_us > r.max_call_us ? call_us : r.max_call_us;
+    }
+
+    r.interrupts = emu.getStats().interrupts - interrupts0;
+    r.transactions_per_s = (double)(Wire1.hostTransactions - transactions0) / cfg.seconds;
+    r.bus_bytes_per_s = (double)(Wire1.hostBytes - bytes0) / cfg.seconds;
+
+    // Samples the ring dropped show as a gap once a later one arrives
+    if (r.mode == READ_FIFO_IRQ || r.mode == READ_FIFO_TIMER) {
+        bool drained = false;
+        for (uint32_t t = 0; t < 1000000; t += cfg.step_us) {
+            uint32_t count = fifo.read(samples.data(), samples.size());
+            for (uint32_t i = 0; i < count; i++) {
+                const ppg_sample_t &s = samples[i];
+                check.add(s.red, s.ir, s.green, s.timestamp_us, true, r);
+            }
+            if (drained) {
+                break;
+            }
+            hostAdvanceMicros(cfg.step_us);
+            emu.poll();
+            drained = fifo.update() > 0;
+        }
+    }
+    check.finish(r);
+    r.reported = fifo.getOverflows();
+    fifo.end();
+    r.ok = r.seen > 0;
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --seconds N         simulated run time per reader, default 10\n");
+    printf("  --rate N            sensor sample rate, 50 to 3200, default 400\n");
+    printf("  --average N         samples averaged per FIFO sample, default 1\n");
+    printf("  --leds N            1 red, 2 red and IR, 3 with green, default 2\n");
+    printf("  --ui-ms N           period the caller takes samples, default 20\n");
+    printf("  --step-us N         caller loop period, default 100\n");
+    printf("  --depth N           PpgFifo ring depth, default %u\n", PPG_FIFO_DEPTH);
+    printf("  --almost-full N     unread samples that raise the interrupt, default %u\n", PPG_FIFO_ALMOST_FULL);
+    printf("  --buffer N          Wire1 buffer size, default %u\n", PPG_FIFO_BURST_BYTES);
+    printf("  --expect-loss       the ring is too small, PpgFifo must report what it loses\n");
+}
+
+int main(int argc, char **argv)
+{
+    run_config_t cfg = { 10, 400, 1, 2, 20, 100, PPG_FIFO_DEPTH, PPG_FIFO_ALMOST_FULL };
+    uint32_t buffer = PPG_FIFO_BURST_BYTES;
+    bool expect_loss = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--seconds") && has_value) {
+            cfg.seconds = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--rate") && has_value) {
+            cfg.rate = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--average") && has_value) {
+            cfg.average = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--leds") && has_value) {
+            cfg.leds = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--ui-ms") && has_value) {
+            cfg.ui_ms = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--step-us") && has_value) {
+            cfg.step_us = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--depth") && has_value) {
+            cfg.depth = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--almost-full") && has_value) {
+            cfg.almost_full = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--buffer") && has_value) {
+            buffer = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--expect-loss")) {
+            expect_loss = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!cfg.seconds || !cfg.ui_ms || !cfg.step_us || !cfg.depth || cfg.leds < 1 || cfg.leds > 3) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    emu.setIrqPin(EMU_IRQ_PIN);
+    Wire1.hostAttach(MAX30105_ADDRESS, &emu);
+    Wire1.setBufferSize(buffer);
+    Wire1.begin();
+    MAX30105 sensor;
+    if (!sensor.begin(Wire1, I2C_SPEED_FAST)) {
+        fprintf(stderr, "MAX3010x not found\n");
+        printf("FAIL\n");
+        return 1;
+    }
+
+    run_result_t results[] = {
+        run_result("getIR", READ_GET_IR),
+        run_result("check", READ_CHECK),
+        run_result("fifo irq", READ_FIFO_IRQ),
+        run_result("fifo timer", READ_FIFO_TIMER),
+    };
+    const size_t count = sizeof(results) / sizeof(results[0]);
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        run_result_t &r = results[i];
+        run(sensor, cfg, r);
+        // The library readers are the baseline
+        if (r.mode != READ_FIFO_IRQ && r.mode != READ_FIFO_TIMER) {
+            continue;
+        }
+        if (!r.ok) {
+            fprintf(stderr, "%s: no samples\n", r.name);
+            ok = false;
+            continue;
+        }
+        // Every sample is delivered or reported, apart from those still in the sensor FIFO
+        float period_us = 1000000.0f * cfg.average / cfg.rate;
+        if (r.corrupt || r.lost != r.reported || r.produced - r.seen - r.lost > cfg.almost_full) {
+            fprintf(stderr, "%s: %u samples, %u seen, %u lost, %u reported, %u corrupt\n",
+                    r.name, r.produced, r.seen, r.lost, r.reported, r.corrupt);
+            ok = false;
+        }
+        if (expect_loss ? !r.lost : r.lost) {
+            fprintf(stderr, "%s: %u samples lost\n", r.name, r.lost);
+            ok = false;
+        }
+        if (r.max_ts_error_us > period_us) {
+            fprintf(stderr, "%s: timestamp off by up to %.0f us, the period is %.0f us\n", r.name, r.max_ts_error_us, period_us);
+            ok = false;
+        }
+    }
+    if (!expect_loss && results[2].interrupts * cfg.almost_full > results[2].seen) {
+        fprintf(stderr, "more interrupts than almost full levels\n");
+        ok = false;
+    }
+
+    printf("%u Hz / %u, %u LEDs, samples taken every %u ms\n", cfg.rate, cfg.average, cfg.leds, cfg.ui_ms);
+    printf("%-11s %8s %8s %8s %8s %8s %9s %11s %9s %9s %9s\n", "reader", "samples", "seen", "lost", "reported",
+           "irqs", "xfers/s", "bus bytes/s", "max call", "ts mean", "ts max");
+    for (size_t i = 0; i < count; i++) {
+        const run_result_t &r = results[i];
+        bool timed = r.mode == READ_FIFO_IRQ || r.mode == READ_FIFO_TIMER;
+        printf("%-11s %8u %8u %8u %8u %8u %9.0f %11.0f %6u us", r.name, r.produced, r.seen, r.lost, r.reported,
+               r.mode == READ_FIFO_IRQ ? r.interrupts : 0, r.transactions_per_s, r.bus_bytes_per_s, r.max_call_us);
+        if (timed) {
+            printf(" %6.0f us %6.0f us\n", r.mean_ts_error_us, r.max_ts_error_us);
+        } else {
+            printf(" %9s %9s\n", "-", "-");
+        }
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
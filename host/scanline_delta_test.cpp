@@ -0,0 +1,254 @@
+/**
+ * @file      scanline_delta_test.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-17
+ * @note      Feeds known frame pairs through scanline_delta_encode and scanline_delta_pack,
+ *            writes the spans into a simulated panel memory and checks the spans and
+ *            that the memory ends up holding the frame
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "scanlineDelta.h"
+#include "panelFlush.h"
+#include "initSequence.h"
+
+#define PANEL_WIDTH     JD9613_WIDTH
+#define PANEL_HEIGHT    JD9613_HEIGHT
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --frames N      random frames after the fixed cases, default 500\n");
+    printf("  --seed N        random seed, default 1\n");
+}
+
+typedef struct {
+    scanline_delta_t delta;
+    std::vector<uint16_t> frame;    // what the application drew
+    std::vector<uint16_t> panel;    // what the panel memory holds
+    std::vector<scanline_span_t> spans;
+    std::vector<uint16_t> buffer;
+    uint32_t failures;
+} delta_test_t;
+
+// Window of the frame, row major with a stride of the window width
+static std::vector<uint16_t> window_pixels(const delta_test_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    std::vector<uint16_t> pixels(w * h);
+    for (uint16_t row = 0; row < h; row++) {
+        memcpy(&pixels[row * w], &t->frame[(y + row) * PANEL_WIDTH + x], w * sizeof(uint16_t));
+    }
+    return pixels;
+}
+
+// Write pixels into the panel memory like RAMWR into a CASET/RASET window
+static void panel_write(delta_test_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels)
+{
+    for (uint16_t row = 0; row < h; row++) {
+        memcpy(&t->panel[(y + row) * PANEL_WIDTH + x], pixels + row * w, w * sizeof(uint16_t));
+    }
+}
+
+// Encode a window of the frame, send the result to the panel memory, returns the encode result
+static int32_t flush(delta_test_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t max_spans)
+{
+    std::vector<uint16_t> pixels = window_pixels(t, x, y, w, h);
+    int32_t count = scanline_delta_encode(&t->delta, x, y, w, h, pixels.data(), t->spans.data(), max_spans);
+    if (count < 0) {
+        panel_write(t, x, y, w, h, pixels.data());
+        return count;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        const scanline_span_t *span = &t->spans[i];
+        if ((span->x & 1) || (span->y & 1) || (span->width & 1) || !span->width ||
+                span->x < x || span->x + span->width > x + w || span->y < y || span->y + 2 > y + h) {
+            printf("  span %d at (%u, %u) width %u is not an aligned part of the window\n",
+                   (int)i, span->x, span->y, span->width);
+            t->failures++;
+            continue;
+        }
+        uint32_t written = scanline_delta_pack(span, x, y, w, pixels.data(), t->buffer.data());
+        if (written != span->width * 2u) {
+            printf("  span %d packed %u pixels, expected %u\n", (int)i, (unsigned)written, span->width * 2u);
+            t->failures++;
+        }
+        panel_write(t, span->x, span->y, span->width, 2, t->buffer.data());
+    }
+    return count;
+}
+
+static void set_pixel(delta_test_t *t, uint16_t x, uint16_t y)
+{
+    t->frame[y * PANEL_WIDTH + x] ^= 0x5A5A;
+}
+
+static void expect(delta_test_t *t, const char *name, int32_t count, int32_t expected_count,
+                   const scanline_span_t *expected_spans = NULL)
+{
+    uint32_t failures = t->failures;
+    if (count != expected_count) {
+        printf("  %d spans, expected %d\n", (int)count, (int)expected_count);
+        t->failures++;
+    } else if (expected_spans) {
+        for (int32_t i = 0; i < count; i++) {
+            const scanline_span_t &a = t->spans[i];
+            const scanline_span_t &b = expected_spans[i];
+            if (a.x != b.x || a.y != b.y || a.width != b.width) {
+                printf("  span %d at (%u, %u) width %u, expected (%u, %u) width %u\n",
+                       (int)i, a.x, a.y, a.width, b.x, b.y, b.width);
+                t->failures++;
+            }
+        }
+    }
+    if (t->panel != t->frame) {
+        printf("  panel memory differs from the frame\n");
+        t->failures++;
+    }
+    printf("%-28s %4d%s\n", name, (int)count, t->failures != failures ? "  FAILED" : "");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = 500;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--frames") && has_value) {
+            frames = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--seed") && has_value) {
+            seed = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    delta_test_t t;
+    if (!scanline_delta_init(&t.delta, PANEL_WIDTH, PANEL_HEIGHT, malloc)) {
+        return 1;
+    }
+    t.frame.assign(PANEL_WIDTH * PANEL_HEIGHT, 0);
+    t.panel.assign(PANEL_WIDTH * PANEL_HEIGHT, 0xFFFF);
+    t.spans.resize(PANEL_WIDTH * PANEL_HEIGHT / 4);
+    t.buffer.resize(PANEL_WIDTH * 2);
+    t.failures = 0;
+    srand(seed);
+
+    printf("case                        spans\n");
+    for (uint32_t i = 0; i < t.frame.size(); i++) {
+        t.frame[i] = rand();
+    }
+    // Nothing is known about the panel memory yet
+    expect(&t, "first frame", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), -1);
+    expect(&t, "no change", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), 0);
+
+    set_pixel(&t, 37, 101);
+    {
+        const scanline_span_t spans[] = { { 36, 100, 2 } };
+        expect(&t, "single pixel", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), 1, spans);
+    }
+
+    // Changes closer than a transaction are merged into one span
+    set_pixel(&t, 10, 20);
+    set_pixel(&t, 21, 21);
+    {
+        const scanline_span_t spans[] = { { 10, 20, 12 } };
+        expect(&t, "nearby pixels", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), 1, spans);
+    }
+
+    for (uint16_t x = 0; x < PANEL_WIDTH; x++) {
+        set_pixel(&t, x, 51);
+    }
+    {
+        const scanline_span_t spans[] = { { 0, 50, PANEL_WIDTH } };
+        expect(&t, "whole row", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), 1, spans);
+    }
+
+    set_pixel(&t, 0, 0);
+    set_pixel(&t, PANEL_WIDTH - 1, 0);
+    set_pixel(&t, 0, PANEL_HEIGHT - 1);
+    set_pixel(&t, PANEL_WIDTH - 1, PANEL_HEIGHT - 1);
+    {
+        const scanline_span_t spans[] = {
+            { 0, 0, 2 },
+            { PANEL_WIDTH - 2, 0, 2 },
+            { 0, PANEL_HEIGHT - 2, 2 },
+            { PANEL_WIDTH - 2, PANEL_HEIGHT - 2, 2 },
+        };
+        expect(&t, "corners", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), 4, spans);
+    }
+
+    // A window in the corner, the span is relative to the panel and packed from the window
+    set_pixel(&t, PANEL_WIDTH - 1, PANEL_HEIGHT - 2);
+    {
+        const scanline_span_t spans[] = { { PANEL_WIDTH - 2, PANEL_HEIGHT - 2, 2 } };
+        expect(&t, "corner window", flush(&t, PANEL_WIDTH - 16, PANEL_HEIGHT - 16, 16, 16, JD9613_DELTA_MAX_SPANS), 1, spans);
+    }
+
+    // Two distant changes in every line pair are more spans than the driver keeps
+    for (uint16_t y = 0; y < PANEL_HEIGHT; y += 2) {
+        set_pixel(&t, 0, y);
+        set_pixel(&t, PANEL_WIDTH - 1, y + 1);
+    }
+    expect(&t, "over the span cap", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), -1);
+    for (uint16_t y = 0; y < PANEL_HEIGHT; y += 2) {
+        set_pixel(&t, 0, y);
+        set_pixel(&t, PANEL_WIDTH - 1, y + 1);
+    }
+    expect(&t, "same without the cap", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, t.spans.size()), PANEL_HEIGHT);
+
+    // Not aligned to line pairs, sent whole
+    set_pixel(&t, 5, 5);
+    expect(&t, "odd window", flush(&t, 1, 1, 9, 9, JD9613_DELTA_MAX_SPANS), -1);
+
+    scanline_delta_invalidate(&t.delta);
+    expect(&t, "after invalidate", flush(&t, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, JD9613_DELTA_MAX_SPANS), -1);
+
+    // Random sparse changes in random aligned windows
+    uint32_t failures = t.failures;
+    uint32_t sent_spans = 0, sent_whole = 0, skipped = 0;
+    for (uint32_t n = 0; n < frames; n++) {
+        uint32_t changes = rand() % 64;
+        for (uint32_t i = 0; i < changes; i++) {
+            set_pixel(&t, rand() % PANEL_WIDTH, rand() % PANEL_HEIGHT);
+        }
+        uint16_t x = (rand() % PANEL_WIDTH) & ~1;
+        uint16_t y = (rand() % PANEL_HEIGHT) & ~1;
+        uint16_t w = ((rand() % (PANEL_WIDTH - x)) & ~1) + 2;
+        uint16_t h = ((rand() % (PANEL_HEIGHT - y)) & ~1) + 2;
+        w = x + w > PANEL_WIDTH ? PANEL_WIDTH - x : w;
+        h = y + h > PANEL_HEIGHT ? PANEL_HEIGHT - y : h;
+        int32_t count = flush(&t, x, y, w, h, JD9613_DELTA_MAX_SPANS);
+        if (count < 0) {
+            sent_whole++;
+        } else if (count == 0) {
+            skipped++;
+        } else {
+            sent_spans++;
+        }
+        // Changes outside the window are still pending, compare only the window
+        for (uint16_t row = y; row < y + h; row++) {
+            if (memcmp(&t.panel[row * PANEL_WIDTH + x], &t.frame[row * PANEL_WIDTH + x], w * sizeof(uint16_t))) {
+                printf("  frame %u: panel memory differs in line %u\n", (unsigned)n, row);
+                t.failures++;
+                break;
+            }
+        }
+    }
+    printf("%u random frames: %u as spans, %u whole, %u skipped%s\n", (unsigned)frames,
+           (unsigned)sent_spans, (unsigned)sent_whole, (unsigned)skipped, t.failures != failures ? "  FAILED" : "");
+
+    scanline_delta_deinit(&t.delta);
+    if (t.failures) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file      scenes.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <math.h>
+#include <lvgl.h>
+#include "Arduino.h"
+#include "scenes.h"
+
+LV_IMG_DECLARE(wallpaper_7);
+LV_IMG_DECLARE(img_down);
+LV_IMG_DECLARE(img_left);
+LV_IMG_DECLARE(img_right);
+LV_IMG_DECLARE(img_up);
+
+static lv_obj_t *tileview;
+static uint32_t tile_count;
+
+static void select_next_tile()
+{
+    static uint32_t next = 0;
+    next = (next + 1) % tile_count;
+    lv_obj_set_tile_id(tileview, next, 0, LV_ANIM_ON);
+}
+
+static lv_obj_t *add_label(lv_obj_t *parent, const lv_font_t *font, const char *text)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, font, LV_PART_MAIN);
+    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
+    lv_label_set_text(label, text);
+    return label;
+}
+
+static void add_datetime(lv_obj_t *parent, const lv_font_t *font, lv_coord_t y)
+{
+    lv_obj_t *time_label = add_label(parent, font, "12:34");
+    lv_obj_align(time_label, LV_ALIGN_TOP_MID, 0, y);
+    lv_obj_t *month_label = add_label(parent, &lv_font_montserrat_16, "Jan");
+    lv_obj_align(month_label, LV_ALIGN_TOP_MID, 0, LV_PCT(40));
+    lv_obj_set_user_data(time_label, month_label);
+
+    lv_timer_create([](lv_timer_t *t) {
+        static const char *month_char[] = LV_CALENDAR_DEFAULT_MONTH_NAMES;
+        lv_obj_t *time_label = (lv_obj_t *)t->user_data;
+        uint32_t seconds = millis() / 1000;
+        lv_label_set_text_fmt(time_label, "%02lu:%02lu", (unsigned long)(seconds / 60 % 24), (unsigned long)(seconds % 60));
+        lv_label_set_text(((lv_obj_t *)lv_obj_get_user_data(time_label)), month_char[seconds / 60 % 12]);
+    }, 1000, time_label);
+}
+
+static void add_attitude(lv_obj_t *parent)
+{
+    lv_obj_t *attitude = add_label(parent, &lv_font_montserrat_14, "");
+    lv_label_set_long_mode(attitude, LV_LABEL_LONG_WRAP);
+    lv_obj_align(attitude, LV_ALIGN_CENTER, 0, 0);
+
+    // Same rate as the fusion output of the examples
+    lv_timer_create([](lv_timer_t *t) {
+        float time = millis() / 1000.0f;
+        lv_label_set_text_fmt((lv_obj_t *)t->user_data, "Roll:\n\t% 3.2f\nPitch:\n\t% 3.2f\nHeading:\n\t% 3.2f\n",
+                              30 * sinf(time), 20 * cosf(time * 0.7f), fmodf(time * 10, 360));
+    }, 15, attitude);
+}
+
+static void add_meter(lv_obj_t *parent, lv_coord_t w, lv_coord_t h, lv_color_t color, const char *unit)
+{
+    lv_obj_t *meter = lv_meter_create(parent);
+    lv_obj_remove_style(meter, NULL, LV_PART_MAIN);
+    lv_obj_remove_style(meter, NULL, LV_PART_INDICATOR);
+    lv_obj_set_size(meter, w, h);
+    lv_obj_align(meter, LV_ALIGN_CENTER, 0, -20);
+
+    lv_meter_scale_t *scale = lv_meter_add_scale(meter);
+    lv_meter_set_scale_ticks(meter, scale, 0, 0, 0, lv_color_black());
+    lv_meter_set_scale_range(meter, scale, 0, 100, 280, 130);
+
+    lv_meter_indicator_t *indic1 = lv_meter_add_arc(meter, scale, 25, lv_palette_main(LV_PALETTE_GREY), 0);
+    lv_meter_set_indicator_start_value(meter, indic1, 0);
+    lv_meter_set_indicator_end_value(meter, indic1, 100);
+    lv_meter_indicator_t *indic2 = lv_meter_add_arc(meter, scale, 25, color, 0);
+    lv_meter_set_indicator_start_value(meter, indic2, 0);
+    lv_meter_set_indicator_end_value(meter, indic2, 90);
+
+    lv_obj_t *value = add_label(parent, &lv_font_montserrat_36, "0");
+    lv_obj_align_to(value, meter, LV_ALIGN_OUT_BOTTOM_MID, 0, 0);
+    lv_obj_t *label = add_label(parent, &lv_font_montserrat_24, unit);
+    lv_obj_align_to(label, value, LV_ALIGN_OUT_BOTTOM_MID, 0, 0);
+
+    lv_obj_set_user_data(value, indic2);
+    lv_obj_set_user_data(meter, value);
+    lv_timer_create([](lv_timer_t *t) {
+        lv_obj_t *meter = (lv_obj_t *)t->user_data;
+        lv_obj_t *value = (lv_obj_t *)lv_obj_get_user_data(meter);
+        int32_t level = random(40, 100);
+        lv_label_set_text_fmt(value, "%d", (int)level);
+        lv_meter_set_indicator_end_value(meter, (lv_meter_indicator_t *)lv_obj_get_user_data(value), level);
+    }, 1000, meter);
+}
+
+// WristbandFactory: 126x250 window at the bottom of the portrait panel
+static void wristband_setup(LilyGo_HostDisplay &display, bool viewport)
+{
+    display.setRotation(0);
+    if (viewport) {
+        // WRISTBAND_VIEWPORT_*
+        display.setViewport(0, 44, 126, 250);
+    }
+}
+
+static void wristband_create()
+{
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
+    lv_obj_t *window = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_bg_color(window, lv_color_black(), 0);
+    lv_obj_set_style_pad_all(window, 0, 0);
+    lv_obj_set_style_border_width(window, 0, 0);
+    lv_obj_set_size(window, 126, 250);
+    lv_obj_align(window, LV_ALIGN_BOTTOM_MID, 0, 0);
+
+    tileview = lv_tileview_create(window);
+    lv_obj_set_size(tileview, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(tileview, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_scrollbar_mode(tileview, LV_SCROLLBAR_MODE_OFF);
+    tile_count = 4;
+
+    lv_obj_t *t1 = lv_tileview_add_tile(tileview, 0, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t2 = lv_tileview_add_tile(tileview, 1, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t3 = lv_tileview_add_tile(tileview, 2, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t4 = lv_tileview_add_tile(tileview, 3, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+
+    lv_obj_set_style_bg_img_src(t1, &wallpaper_7, LV_PART_MAIN);
+    add_datetime(t1, &lv_font_montserrat_44, 55);
+    lv_obj_t *batt = add_label(t1, &lv_font_montserrat_24, "100%");
+    lv_obj_align(batt, LV_ALIGN_BOTTOM_MID, 0, -60);
+
+    lv_obj_t *cont = lv_obj_create(t2);
+    lv_obj_set_style_border_opa(cont, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(cont, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_size(cont, LV_PCT(100), LV_PCT(90));
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_scrollbar_mode(cont, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_align(cont, LV_ALIGN_CENTER, 0, 20);
+    static const char *probe[] = {"CPU:", "RTC", "MAX3010x", "BHI260AP", "FLASH:", "PSRAM:", "VOLTAGE:"};
+    for (const char *name : probe) {
+        lv_obj_t *label = add_label(cont, &lv_font_montserrat_12, name);
+        lv_label_set_recolor(label, true);
+        lv_label_set_text_fmt(label, "%s #00ff00 PASS#", name);
+    }
+
+    add_attitude(t3);
+
+    add_meter(t4, LV_PCT(90), LV_PCT(45), lv_palette_main(LV_PALETTE_BLUE), "RSSI");
+}
+
+// GlassFactory: 126x126 tileview at the right end of the landscape panel
+static void glass_setup(LilyGo_HostDisplay &display, bool viewport)
+{
+    display.setRotation(1);
+    if (viewport) {
+        // GLASS_VIEWPORT_*
+        display.setViewport(168, 0, 126, 126);
+    }
+}
+
+static void glass_create()
+{
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
+    tileview = lv_tileview_create(lv_scr_act());
+    lv_obj_set_style_bg_color(tileview, lv_color_black(), 0);
+    lv_obj_set_scrollbar_mode(tileview, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_size(tileview, 126, 126);
+    lv_obj_align(tileview, LV_ALIGN_RIGHT_MID, 0, 0);
+    tile_count = 5;
+
+    lv_obj_t *t1 = lv_tileview_add_tile(tileview, 0, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t2 = lv_tileview_add_tile(tileview, 1, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t3 = lv_tileview_add_tile(tileview, 2, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t4 = lv_tileview_add_tile(tileview, 3, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+    lv_obj_t *t5 = lv_tileview_add_tile(tileview, 4, 0, LV_DIR_HOR | LV_DIR_BOTTOM);
+
+    add_datetime(t1, &lv_font_montserrat_32, 6);
+    add_attitude(t2);
+    add_meter(t3, LV_PCT(100), LV_PCT(100), lv_palette_main(LV_PALETTE_GREEN), "Volts");
+    add_meter(t4, LV_PCT(90), LV_PCT(45), lv_palette_main(LV_PALETTE_BLUE), "RSSI");
+
+    lv_obj_t *img = lv_img_create(t5);
+    lv_img_set_src(img, &img_down);
+    lv_obj_center(img);
+    lv_timer_create([](lv_timer_t *t) {
+        static const lv_img_dsc_t *images[] = {&img_down, &img_left, &img_right, &img_up};
+        static uint32_t i = 0;
+        i = (i + 1) % 4;
+        lv_img_set_src((lv_obj_t *)t->user_data, images[i]);
+        lv_obj_center((lv_obj_t *)t->user_data);
+    }, 3000, img);
+}
+
+const host_scene_t host_scenes[] = {
+    {"wristband", wristband_setup, wristband_create, select_next_tile},
+    {"glass", glass_setup, glass_create, select_next_tile},
+};
+
+const uint32_t host_scene_count = sizeof(host_scenes) / sizeof(host_scenes[0]);
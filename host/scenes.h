@@ -0,0 +1,28 @@
+/**
+ * @file      scenes.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include "LilyGo_HostDisplay.h"
+
+/*
+ * Scripted copies of the factory example screens. Hardware readings are replaced by
+ * generated values, timers and layouts are the same as in the examples.
+ */
+typedef struct {
+    const char *name;
+    // Before beginLvglHelper, sets rotation and optionally the visible area as viewport
+    void (*setup)(LilyGo_HostDisplay &display, bool viewport);
+    // After beginLvglHelper, builds the screen
+    void (*create)();
+    // Scripted user input, a click that moves to the next tile
+    void (*next)();
+} host_scene_t;
+
+extern const host_scene_t host_scenes[];
+extern const uint32_t host_scene_count;
@@ -0,0 +1,262 @@
+/**
+ * @file      sensor_pipeline_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ * @note      Runs SensorBHI260AP init(), configure() and update() against the emulated
+ *            BHI260AP on a virtual clock, checks that every sample arrives in order and on
+ *            time, and reports the host cost of the whole pipeline. Exits with 1 on a failure
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "SensorBHI260AP.hpp"
+#include "bhi260ap_emulator.h"
+
+#define EMU_IRQ_PIN     21
+
+typedef struct {
+    BhySensorID id;
+    float rate;
+    uint32_t latency_ms;
+    uint32_t received;
+    uint64_t last_ns;
+    bool ordered;
+    uint64_t latency_sum_us;
+    int64_t latency_max_us;
+    int64_t sync_error_max_us;
+    uint32_t synced;
+} sensor_check_t;
+
+static sensor_check_t sensor_check(BhySensorID id, float rate, uint32_t latency_ms)
+{
+    sensor_check_t check;
+    memset(&check, 0, sizeof(check));
+    check.id = id;
+    check.rate = rate;
+    check.latency_ms = latency_ms;
+    return check;
+}
+
+static Bhi260apEmulator emu;
+static SensorBHI260AP bhy;
+
+static void on_sample(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data)
+{
+    (void)sensor_id;
+    (void)data;
+    (void)size;
+    sensor_check_t *check = (sensor_check_t *)user_data;
+    if (check->received && timestamp_ns <= check->last_ns) {
+        check->ordered = false;
+    }
+    check->received++;
+    check->last_ns = timestamp_ns;
+
+    // Time between the sample and its callback
+    int64_t sample_us = emu.ticksToHostUs(timestamp_ns / 15625);
+    int64_t latency = (int64_t)micros() - sample_us;
+    check->latency_sum_us += latency;
+    if (latency > check->latency_max_us) {
+        check->latency_max_us = latency;
+    }
+
+    // The drift is known from the second resync point on
+    int64_t host_us;
+    if (bhy.getClockSync().points() >= 2 && bhy.toHostTime(timestamp_ns, host_us)) {
+        int64_t error = llabs(host_us - sample_us);
+        if (error > check->sync_error_max_us) {
+            check->sync_error_max_us = error;
+        }
+        check->synced++;
+    }
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --seconds N         simulated run time, default 20\n");
+    printf("  --step-us N         host loop period, default 1000\n");
+    printf("  --drift-ppm N       sensor clock error, default 40\n");
+    printf("  --latency-ms N      report latency of the batched sensor, default 500\n");
+    printf("  --rw-len BYTES      largest single bus transfer, default 256\n");
+    printf("  --linear            plain FIFO parser instead of the ring parser\n");
+    printf("  --replay FILE       serve recorded FIFO transfers (fifo_parse_benchmark --record)\n");
+    printf("  --interval-us N     time between recorded transfers, default 10000\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 20;
+    uint32_t step_us = 1000;
+    int32_t drift_ppm = 40;
+    uint32_t batch_latency_ms = 500;
+    uint32_t rw_len = 256;
+    bool linear = false;
+    const char *replay = NULL;
+    uint32_t interval_us = 10000;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--seconds") && has_value) {
+            seconds = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--step-us") && has_value) {
+            step_us = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--drift-ppm") && has_value) {
+            drift_ppm = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--latency-ms") && has_value) {
+            batch_latency_ms = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--rw-len") && has_value) {
+            rw_len = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--linear")) {
+            linear = true;
+        } else if (!strcmp(arg, "--replay") && has_value) {
+            replay = argv[++i];
+        } else if (!strcmp(arg, "--interval-us") && has_value) {
+            interval_us = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!seconds || !step_us || !rw_len || !interval_us) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    sensor_check_t checks[] = {
+        sensor_check(SENSOR_ID_ACC, 100, 0),
+        sensor_check(SENSOR_ID_GYRO, 200, 0),
+        sensor_check(SENSOR_ID_GAMERV, 50, 0),
+        sensor_check(SENSOR_ID_STC, 25, 0),
+        // Alone in the wake up FIFO, the streaming sensors would report it early
+        sensor_check(SENSOR_ID_ACC_WU, 50, batch_latency_ms),
+    };
+    // Recorded streams carry the sensors of the fifo_parse_benchmark generator
+    sensor_check_t replay_checks[] = {
+        sensor_check((BhySensorID)1, 100, 0), sensor_check((BhySensorID)10, 100, 0),
+        sensor_check((BhySensorID)34, 100, 0), sensor_check((BhySensorID)37, 100, 0),
+        sensor_check((BhySensorID)160, 100, 0), sensor_check((BhySensorID)92, 100, 0),
+        sensor_check((BhySensorID)94, 100, 0),
+    };
+    sensor_check_t *sensors = replay ? replay_checks : checks;
+    size_t count = replay ? SENSORLIB_COUNT(replay_checks) : SENSORLIB_COUNT(checks);
+
+    emu.setIrqPin(EMU_IRQ_PIN);
+    emu.setClockDrift(drift_ppm, 0x123456789ULL);
+    if (replay && !emu.loadRecording(replay, interval_us)) {
+        return 1;
+    }
+
+    bhy.setPins(SENSOR_PIN_NONE, EMU_IRQ_PIN);
+    bhy.setFifoRingParser(!linear);
+    for (size_t i = 0; i < count; i++) {
+        sensors[i].ordered = true;
+        bhy.onResultEvent(sensors[i].id, on_sample, &sensors[i]);
+    }
+
+    if (!bhy.init(Bhi260apEmulator::read, Bhi260apEmulator::write, &emu, rw_len)) {
+        fprintf(stderr, "init failed: %s\n", bhy.getError().c_str());
+        return 1;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        if (!bhy.configure(sensors[i].id, sensors[i].rate, sensors[i].latency_ms)) {
+            fprintf(stderr, "configure %s failed\n", bhy.getSensorName(sensors[i].id));
+            return 1;
+        }
+        if (replay) {
+            continue;
+        }
+        struct bhy2_virt_sensor_conf conf = bhy.getConfigure(sensors[i].id);
+        if (conf.sample_rate != emu.getSampleRate(sensors[i].id) || conf.latency != sensors[i].latency_ms) {
+            fprintf(stderr, "%s reads back %.2f Hz %u ms\n", bhy.getSensorName(sensors[i].id), conf.sample_rate, conf.latency);
+            ok = false;
+        }
+    }
+    bhy.resetTransportStats();
+
+    uint64_t update_ns = 0;
+    uint64_t steps = (uint64_t)seconds * 1000000 / step_us;
+    for (uint64_t n = 0; n < steps; n++) {
+        hostAdvanceMicros(step_us);
+        emu.poll();
+        auto start = std::chrono::steady_clock::now();
+        bhy.update();
+        update_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Collect the batch still waiting in the sensor
+    bhy.flushFifo();
+    for (int i = 0; i < 10; i++) {
+        hostAdvanceMicros(step_us);
+        emu.poll();
+        bhy.update();
+    }
+
+    const Bhi260apEmulator::Stats &emu_stats = emu.getStats();
+    SensorTransportStats stats;
+    bhy.getTransportStats(stats);
+
+    uint32_t events = 0;
+    printf("%-28s %8s %9s %11s %11s %10s\n", "sensor", "samples", "expected", "mean lat us", "max lat us", "sync err us");
+    for (size_t i = 0; i < count; i++) {
+        const sensor_check_t &s = sensors[i];
+        uint32_t expected = replay ? s.received : emu.getGenerated(s.id);
+        events += s.received;
+        printf("%-28s %8u %9u %11.0f %11lld %10lld\n", bhy.getSensorName(s.id), s.received, expected,
+               s.received ? (double)s.latency_sum_us / s.received : 0.0,
+               (long long)s.latency_max_us, (long long)s.sync_error_max_us);
+
+        // Recorded timestamps come from the generator, not from the emulated sensor clock
+        if (replay) {
+            continue;
+        }
+        if (!s.ordered) {
+            fprintf(stderr, "%s timestamps go backwards\n", bhy.getSensorName(s.id));
+            ok = false;
+        }
+        if (s.received != expected || !expected) {
+            fprintf(stderr, "%s received %u of %u samples\n", bhy.getSensorName(s.id), s.received, expected);
+            ok = false;
+        }
+        // A sample waits for its report latency and the next pass of the host loop
+        int64_t latency_limit = s.latency_ms * 1000LL + 2 * step_us;
+        if (s.latency_max_us > latency_limit) {
+            fprintf(stderr, "%s waited %lld us, more than %lld us\n", bhy.getSensorName(s.id),
+                    (long long)s.latency_max_us, (long long)latency_limit);
+            ok = false;
+        }
+        if (s.latency_ms && s.latency_max_us < s.latency_ms * 1000LL / 2) {
+            fprintf(stderr, "%s was not batched\n", bhy.getSensorName(s.id));
+            ok = false;
+        }
+        // The timestamp resolution is 15.625 us
+        if (!s.synced || s.sync_error_max_us > 50) {
+            fprintf(stderr, "%s host time is off by %lld us\n", bhy.getSensorName(s.id), (long long)s.sync_error_max_us);
+            ok = false;
+        }
+    }
+    if (replay && (!emu.recordingDone() || !events)) {
+        fprintf(stderr, "recording was not consumed, %u events\n", events);
+        ok = false;
+    }
+
+    const SensorClockSync &clock = bhy.getClockSync();
+    printf("\n%u events in %u simulated seconds, %u dropped by the sensor\n", events, seconds, emu_stats.dropped);
+    printf("update(): %u drains, %u interrupts, %.1f us per drain, %.0f events per host second\n",
+           stats.updates, stats.interrupts,
+           stats.updates ? update_ns / 1000.0 / stats.updates : 0.0,
+           update_ns ? events * 1e9 / update_ns : 0.0);
+    printf("bus: %llu bytes read, %llu bytes written, %u transactions, %u FIFO transfers\n",
+           (unsigned long long)emu_stats.read_bytes, (unsigned long long)emu_stats.write_bytes,
+           emu_stats.transactions, emu_stats.transfers);
+    printf("clock: host runs %lld ppb against the sensor (emulated %d ppm), %u sync points\n",
+           (long long)clock.driftPpb(), drift_ppm, clock.points());
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
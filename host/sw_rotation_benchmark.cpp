@@ -0,0 +1,182 @@
+/**
+ * @file      sw_rotation_benchmark.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-17
+ * @note      Compares every output pixel of sw_rotation_copy with a per pixel loop for all
+ *            rotations, on even, odd and unaligned images, and reports the throughput of both
+ *            on the panel frame. Built once per SW_ROTATION_TILE_SIZE
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "swRotation.h"
+#include "initSequence.h"
+
+// Guard pixels around the destination, written outside the image they show an overrun
+#define GUARD_PIXELS        8
+#define GUARD_VALUE         0xA55A
+
+static const struct {
+    uint32_t width;
+    uint32_t height;
+} sizes[] = {
+    { JD9613_WIDTH, JD9613_HEIGHT },
+    { JD9613_HEIGHT, JD9613_WIDTH },
+    { 2, 2 },
+    { 2, 64 },
+    { 64, 2 },
+    { 30, 18 },     // partial tiles in both directions
+    { 1, 1 },
+    { 1, 7 },
+    { 7, 1 },
+    { 33, 17 },
+    { 125, 293 },
+    { 126, 293 },   // odd height only
+    { 125, 294 },   // odd width only
+};
+
+static const char *rotation_names[] = { "0", "90", "180", "270" };
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  --iterations N  frames rotated for the throughput, default 2000\n");
+}
+
+// Straight from the mapping documented in swRotation.h
+static void reference_copy(uint16_t *dst, const uint16_t *src, uint32_t width, uint32_t height, uint8_t rotation)
+{
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t offset;
+            switch (rotation) {
+            case SW_ROTATION_90:
+                offset = x * height + (height - 1 - y);
+                break;
+            case SW_ROTATION_180:
+                offset = (height - 1 - y) * width + (width - 1 - x);
+                break;
+            case SW_ROTATION_270:
+                offset = (width - 1 - x) * height + y;
+                break;
+            default:
+                offset = y * width + x;
+                break;
+            }
+            dst[offset] = src[y * width + x];
+        }
+    }
+}
+
+// misalign shifts both buffers by one pixel, which takes the per pixel path
+static bool check(uint32_t width, uint32_t height, uint8_t rotation, bool misalign)
+{
+    const uint32_t pixels = width * height;
+    std::vector<uint32_t> src_words(pixels / 2 + 2);
+    std::vector<uint32_t> dst_words((pixels + 2 * GUARD_PIXELS) / 2 + 2);
+    uint16_t *src = (uint16_t *)src_words.data() + misalign;
+    uint16_t *out = (uint16_t *)dst_words.data() + misalign;
+    uint16_t *dst = out + GUARD_PIXELS;
+    std::vector<uint16_t> expected(pixels);
+
+    for (uint32_t i = 0; i < pixels; i++) {
+        src[i] = rand();
+    }
+    for (uint32_t i = 0; i < pixels + 2 * GUARD_PIXELS; i++) {
+        out[i] = GUARD_VALUE;
+    }
+
+    reference_copy(expected.data(), src, width, height, rotation);
+    sw_rotation_copy(dst, src, width, height, rotation);
+
+    for (uint32_t i = 0; i < GUARD_PIXELS; i++) {
+        if (out[i] != GUARD_VALUE || dst[pixels + i] != GUARD_VALUE) {
+            printf("  %ux%u rotation %s%s: wrote outside the destination\n",
+                   (unsigned)width, (unsigned)height, rotation_names[rotation], misalign ? " unaligned" : "");
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < pixels; i++) {
+        if (dst[i] != expected[i]) {
+            printf("  %ux%u rotation %s%s: pixel %u is 0x%04X, expected 0x%04X\n",
+                   (unsigned)width, (unsigned)height, rotation_names[rotation], misalign ? " unaligned" : "",
+                   (unsigned)i, dst[i], expected[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mpixel/s of rotating the panel frame
+static double throughput(void (*copy)(uint16_t *, const uint16_t *, uint32_t, uint32_t, uint8_t),
+                         uint8_t rotation, uint32_t iterations)
+{
+    const uint32_t pixels = JD9613_WIDTH * JD9613_HEIGHT;
+    std::vector<uint32_t> src_words(pixels / 2);
+    std::vector<uint32_t> dst_words(pixels / 2);
+    uint16_t *src = (uint16_t *)src_words.data();
+    uint16_t *dst = (uint16_t *)dst_words.data();
+    for (uint32_t i = 0; i < pixels; i++) {
+        src[i] = rand();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        copy(dst, src, JD9613_HEIGHT, JD9613_WIDTH, rotation);
+        // Keep the compiler from dropping the copies
+        src[i % pixels] ^= dst[(i * 7) % pixels];
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0 ? (double)pixels * iterations / seconds / 1e6 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (!strcmp(arg, "--iterations") && has_value) {
+            iterations = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    srand(1);
+    printf("tile size %u\n", (unsigned)SW_ROTATION_TILE_SIZE);
+
+    uint32_t checks = 0, failures = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (uint8_t rotation = SW_ROTATION_0; rotation <= SW_ROTATION_270; rotation++) {
+            for (int misalign = 0; misalign < 2; misalign++) {
+                checks++;
+                if (!check(sizes[s].width, sizes[s].height, rotation, misalign)) {
+                    failures++;
+                }
+            }
+        }
+    }
+    printf("%u images compared, %u differ\n", (unsigned)checks, (unsigned)failures);
+
+    printf("%ux%u frame    sw_rotation_copy    per pixel\n", (unsigned)JD9613_HEIGHT, (unsigned)JD9613_WIDTH);
+    for (uint8_t rotation = SW_ROTATION_90; rotation <= SW_ROTATION_270; rotation++) {
+        double fast = throughput(sw_rotation_copy, rotation, iterations);
+        double slow = throughput(reference_copy, rotation, iterations);
+        printf("  rotation %-3s  %9.1f Mpx/s  %9.1f Mpx/s\n", rotation_names[rotation], fast, slow);
+    }
+
+    if (failures) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -17,6 +17,7 @@
 #ifndef MadgwickAHRS_h
 #define MadgwickAHRS_h
 #include <math.h>
+#include <stdint.h>
 
 //--------------------------------------------------------------------------------------------
 // Variable declaration
@@ -40,6 +41,14 @@ private:
 public:
     Madgwick(void);
     void begin(float sampleFrequency) { invSampleFreq = 1.0f / sampleFrequency; }
+    // Time step of the next update, for samples that do not arrive at a fixed rate
+    void setSamplePeriod(float seconds) { invSampleFreq = seconds; }
+    void getQuaternion(float *w, float *x, float *y, float *z) {
+        *w = q0;
+        *x = q1;
+        *y = q2;
+        *z = q3;
+    }
     void update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
     void updateIMU(float gx, float gy, float gz, float ax, float ay, float az);
     //float getPitch(){return atan2f(2.0f * q2 * q3 - 2.0f * q0 * q1, 2.0f * q0 * q0 + 2.0f * q3 * q3 - 1.0f);};
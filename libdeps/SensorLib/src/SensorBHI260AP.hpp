@@ -28,15 +28,49 @@
  * @note      Most source code references come from the https://github.com/boschsensortec/BHY2-Sensor-API
  *            Simplification for Arduino
  */
+#pragma once
 
+#include <math.h>
 #include "bosch/BoschParse.h"
 #include "bosch/SensorBhy2Define.h"
-#include "bosch/firmware/BHI260AP.fw.h"
+#include "bosch/bhy2_head_tracker.h"
+#include "bosch/common/bosch_firmware_stream.h"
+#include "bosch/firmware/BHI260AP.fw.hs.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#endif
 
 
 
 #if defined(ARDUINO)
 
+// Firmware the sensor flash was last written with. The application keeps it across power
+// cycles, e.g. in NVS, and hands it back with setFlashRecord()
+typedef struct {
+    uint32_t hash;              // FNV-1a of the image given to setFirmware()
+    uint16_t kernel_version;
+    uint16_t user_version;
+} SensorFlashRecord;
+
+// State of saveCalibration(): a header of {uint32_t magic, uint16_t kernel_version, uint8_t count,
+// uint8_t reserved}, then per physical sensor {uint8_t id, uint8_t reserved, uint16_t length, profile}
+#define SENSOR_CALIB_MAGIC          0x43585342UL
+#define SENSOR_CALIB_HEADER_LEN     8
+#ifndef SENSOR_CALIB_PROFILE_MAX
+#define SENSOR_CALIB_PROFILE_MAX    512
+#endif
+// Buffer that always holds the state of the accelerometer, gyroscope and magnetometer
+#define SENSOR_CALIB_STATE_MAX      (SENSOR_CALIB_HEADER_LEN + 3 * (4 + SENSOR_CALIB_PROFILE_MAX))
+
+// How init() got the firmware running
+typedef enum {
+    SENSOR_BOOT_NONE,           // it was running already
+    SENSOR_BOOT_RAM,            // uploaded to RAM
+    SENSOR_BOOT_FLASH_WRITE,    // written to flash, then booted from there
+    SENSOR_BOOT_FLASH,          // booted from flash that held it already
+} SensorBootPath;
+
 class SensorBHI260AP
 {
     friend class BoschParse;
@@ -107,6 +141,25 @@ public:
         return initImpl();
     }
 
+    /**
+     * @brief  Talk to the sensor through bus functions of the application instead of the
+     *         SPI or I2C drivers, e.g. a bridge or the host side device emulator
+     * @param  intf_ptr: passed to read and write
+     * @param  max_rw_length: largest single read or write the functions accept
+     * @param  intf: BHY2_SPI_INTERFACE sets the read bit of the register address
+     */
+    bool init(bhy2_read_fptr_t read, bhy2_write_fptr_t write, void *intf_ptr,
+              uint16_t max_rw_length = 256, enum bhy2_intf intf = BHY2_SPI_INTERFACE)
+    {
+        __custom_read = read;
+        __custom_write = write;
+        __custom_intf_ptr = intf_ptr;
+        __custom_intf = intf;
+        __max_rw_lenght = max_rw_length;
+        __handler.intf = SENSORLIB_CUSTOM_INTERFACE;
+        return initImpl();
+    }
+
     void deinit()
     {
         if (processBuffer) {
@@ -119,6 +172,14 @@ public:
             bhy2 = NULL;
         }
 
+#if defined(ARDUINO_ARCH_ESP32)
+        stopDrainTask();
+        SensorInterfaces::close_spi_dma(&__spi_dma);
+#endif
+
+        __parse_table.clear();
+        __ring_count = 0;
+
         if (__handler.irq != SENSOR_PIN_NONE) {
             detachInterrupt(__handler.irq);
         }
@@ -135,6 +196,8 @@ public:
             digitalWrite(__handler.rst, HIGH);
             delay(5);
         }
+        // The sensor clock restarts from zero
+        __clock.reset();
     }
 
     void update()
@@ -142,13 +205,186 @@ public:
         if (!processBuffer) {
             return;
         }
-        if (__handler.irq != SENSOR_PIN_NONE) {
-            if (__data_available) {
-                bhy2_get_and_process_fifo(processBuffer, processBufferSize, bhy2);
+#if defined(ARDUINO_ARCH_ESP32)
+        // The drain task owns the FIFO
+        if (__drain_task) {
+            return;
+        }
+#endif
+        // The level check catches an edge lost while interrupts were off, e.g. in light sleep
+        if (__handler.irq != SENSOR_PIN_NONE && !__data_available && digitalRead(__handler.irq) != HIGH) {
+            return;
+        }
+        // Serialized with removeResultEvent() called from another task
+        lockBus();
+        drainFifo();
+        unlockBus();
+    }
+
+    /**
+     * @brief  Keep the samples of a sensor in a lock-free ring, in addition to the
+     *         onResultEvent callbacks
+     * @param  sensor_id: virtual sensor
+     * @param  depth: samples the ring can hold, rounded up to a power of two
+     */
+    bool enableSampleRing(uint8_t sensor_id, uint32_t depth)
+    {
+        if (sensor_id >= BHY2_SENSOR_ID_MAX || getRing(sensor_id)) {
+            return false;
+        }
+        SensorSampleRing *ring = new SensorSampleRing();
+        if (!ring || !ring->begin(depth) || !__parse_table.setRing(sensor_id, ring)) {
+            delete ring;
+            return false;
+        }
+        __ring_ids[__ring_count++] = sensor_id;
+        lockBus();
+        bool rslt = updateParseCallback(sensor_id);
+        unlockBus();
+        return rslt;
+    }
+
+    // Samples dropped because the consumer did not keep up
+    uint32_t getSampleOverflows(uint8_t sensor_id)
+    {
+        SensorSampleRing *ring = getRing(sensor_id);
+        return ring ? ring->overflows() : 0;
+    }
+
+    uint32_t getSampleAvailable(uint8_t sensor_id)
+    {
+        SensorSampleRing *ring = getRing(sensor_id);
+        return ring ? ring->available() : 0;
+    }
+
+    /**
+     * @brief  Read a batch of samples from the ring of a sensor, one consumer per sensor
+     * @param  timeout_ms: with the drain task running, wait up to this long for the next
+     *         drain if the ring is empty. Without it the call never blocks
+     * @retval Number of samples copied to samples
+     */
+    uint32_t readSamples(uint8_t sensor_id, SensorSample *samples, uint32_t max, uint32_t timeout_ms = 0)
+    {
+        SensorSampleRing *ring = getRing(sensor_id);
+        if (!ring) {
+            return 0;
+        }
+        uint32_t count = ring->read(samples, max);
+#if defined(ARDUINO_ARCH_ESP32)
+        if (!count && timeout_ms && __drain_task) {
+            ring->consumer = xTaskGetCurrentTaskHandle();
+            // Samples may have arrived before the consumer was visible to the drain task
+            count = ring->read(samples, max);
+            if (!count) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+                count = ring->read(samples, max);
             }
-        } else {
-            bhy2_get_and_process_fifo(processBuffer, processBufferSize, bhy2);
+            ring->consumer = NULL;
+        }
+#else
+        (void)timeout_ms;
+#endif
+        return count;
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    /**
+     * @brief  Drain the FIFO from a dedicated task that sleeps until the BHI260AP interrupt,
+     *         instead of polling update(). Result callbacks run in this task and samples
+     *         are published to the rings of enableSampleRing(). Needs the IRQ pin.
+     *         While it runs, other calls that access the sensor are serialized with the
+     *         drain through lockBus()/unlockBus()
+     * @param  core: tskNO_AFFINITY, 0 or 1
+     */
+    bool startDrainTask(uint32_t stack_size = 4096, UBaseType_t priority = 5, BaseType_t core = tskNO_AFFINITY)
+    {
+        if (__drain_task || !processBuffer || !__bus_lock || __handler.irq == SENSOR_PIN_NONE) {
+            return false;
+        }
+        if (xTaskCreatePinnedToCore(drainTask, "bhi260", stack_size, this, priority, &__drain_task, core) != pdPASS) {
+            __drain_task = NULL;
+            log_e("drain task create failed!");
+            return false;
+        }
+        // Data that arrived before the task existed raised no notification
+        xTaskNotifyGive(__drain_task);
+        return true;
+    }
+
+    void stopDrainTask()
+    {
+        if (!__drain_task) {
+            return;
         }
+        lockBus();
+        TaskHandle_t task = __drain_task;
+        __drain_task = NULL;
+        vTaskDelete(task);
+        unlockBus();
+    }
+
+#endif
+
+    void lockBus()
+    {
+#if defined(ARDUINO_ARCH_ESP32)
+        if (__bus_lock) {
+            xSemaphoreTakeRecursive(__bus_lock, portMAX_DELAY);
+        }
+#endif
+    }
+
+    void unlockBus()
+    {
+#if defined(ARDUINO_ARCH_ESP32)
+        if (__bus_lock) {
+            xSemaphoreGiveRecursive(__bus_lock);
+        }
+#endif
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    /**
+     * @brief  Use ESP-IDF spi_device DMA transactions instead of the Arduino SPI class,
+     *         must be called before the SPI init(). The pins given to init() are routed to host.
+     * @param  host: SPI peripheral, must not be used by the Arduino SPI class at the same time
+     * @param  freq: SPI clock, limited to SENSORLIB_BHY2_SPI_MAX_FREQ
+     * @param  max_transfer: largest single transfer in bytes, multiple of 4. FIFO reads and
+     *         firmware upload are split into chunks of this size instead of 256 bytes
+     */
+    void setSpiDma(spi_host_device_t host, uint32_t freq = 20000000, uint32_t max_transfer = 4096)
+    {
+        __spi_dma.host = host;
+        __spi_dma.freq = freq;
+        __spi_dma.max_transfer = max_transfer;
+        __use_spi_dma = true;
+    }
+#endif
+
+    // Bytes moved over the host interface and the time update() spent draining the FIFO
+    void getTransportStats(SensorTransportStats &stats)
+    {
+        memset(&stats, 0, sizeof(stats));
+        if (__handler.intf == SENSORLIB_SPI_INTERFACE) {
+            stats = SensorInterfaces::spi_stats;
+#if defined(ARDUINO_ARCH_ESP32)
+            if (__use_spi_dma) {
+                stats = __spi_dma.stats;
+            }
+#endif
+        }
+        stats.interrupts = __update_stats.interrupts;
+        stats.updates = __update_stats.updates;
+        stats.update_us = __update_stats.update_us;
+    }
+
+    void resetTransportStats()
+    {
+        memset(&SensorInterfaces::spi_stats, 0, sizeof(SensorTransportStats));
+#if defined(ARDUINO_ARCH_ESP32)
+        memset(&__spi_dma.stats, 0, sizeof(SensorTransportStats));
+#endif
+        memset(&__update_stats, 0, sizeof(SensorTransportStats));
     }
 
     bool enablePowerSave()
@@ -396,40 +632,165 @@ public:
     }
 
 
-    void onResultEvent(BhySensorID sensor_id, BhyParseDataCallback callback)
+    // Up to BHY2_PARSE_MAX_SUBSCRIBERS callbacks per sensor, only subscribed sensors are parsed
+    bool onResultEvent(BhySensorID sensor_id, BhyParseDataCallback callback)
     {
-        ParseCallBackList_t newEventHandler;
-        newEventHandler.cb = callback;
-        newEventHandler.id = sensor_id;
-        BoschParse::bhyParseEventVector.push_back(newEventHandler);
+        BhyParseSubscriber subscriber = {callback, NULL, NULL, NULL};
+        return addSubscriber(sensor_id, subscriber);
+    }
+
+    bool onResultEvent(BhySensorID sensor_id, BhyParseDataUserCallback callback, void *user_data)
+    {
+        BhyParseSubscriber subscriber = {NULL, callback, NULL, user_data};
+        return addSubscriber(sensor_id, subscriber);
+    }
+
+    // The callback also receives the BHI260AP timestamp of every sample
+    bool onResultEvent(BhySensorID sensor_id, BhyParseDataTimeCallback callback, void *user_data)
+    {
+        BhyParseSubscriber subscriber = {NULL, NULL, callback, user_data};
+        return addSubscriber(sensor_id, subscriber);
     }
 
     void removeResultEvent(BhySensorID sensor_id, BhyParseDataCallback callback)
     {
-        if (!callback) {
-            return;
-        }
-        for (uint32_t i = 0; i < BoschParse::bhyParseEventVector.size(); i++) {
-            ParseCallBackList_t entry = BoschParse::bhyParseEventVector[i];
-            if (entry.cb == callback && entry.id == sensor_id) {
-                BoschParse::bhyParseEventVector.erase(BoschParse::bhyParseEventVector.begin() + i);
-            }
-        }
+        BhyParseSubscriber subscriber = {callback, NULL, NULL, NULL};
+        removeSubscriber(sensor_id, subscriber);
     }
 
+    void removeResultEvent(BhySensorID sensor_id, BhyParseDataUserCallback callback, void *user_data)
+    {
+        BhyParseSubscriber subscriber = {NULL, callback, NULL, user_data};
+        removeSubscriber(sensor_id, subscriber);
+    }
+
+    void removeResultEvent(BhySensorID sensor_id, BhyParseDataTimeCallback callback, void *user_data)
+    {
+        BhyParseSubscriber subscriber = {NULL, NULL, callback, user_data};
+        removeSubscriber(sensor_id, subscriber);
+    }
+
+    /**
+     * @brief  Host time of a BHI260AP timestamp, in micros() on most platforms and in
+     *         esp_timer_get_time() on ESP32. Needs the interrupt pin: the clocks are
+     *         resynchronized at most every SENSOR_CLOCK_SYNC_INTERVAL_MS, from the
+     *         timestamp the sensor latches when it raises the interrupt
+     * @retval false until the first resync point
+     */
+    bool toHostTime(uint64_t timestamp_ns, int64_t &host_us)
+    {
+        return __clock.toHost(timestamp_ns, host_us);
+    }
+
+    // Offset and drift between the BHI260AP and the host clock
+    const SensorClockSync &getClockSync()
+    {
+        return __clock;
+    }
+
+    // In ring mode the size is rounded up to a power of two, plus BHY2_FIFO_RING_SLACK bytes
     void setProcessBufferSize(uint32_t size)
     {
         processBufferSize = size;
     }
 
+    /**
+     * @brief  Parse the FIFO in a ring buffer in internal RAM, the default. The buffer is
+     *         neither cleared before every read nor compacted after every parse pass.
+     *         false selects bhy2_get_and_process_fifo with a plain buffer. Call before init()
+     */
+    void setFifoRingParser(bool enable)
+    {
+        __use_fifo_ring = enable;
+    }
+
 
     bool uploadFirmware(const uint8_t *firmware, uint32_t length, bool write2Flash = false)
     {
-        uint8_t sensor_error;
-        uint8_t boot_status;
+        uint32_t start_ms = millis();
 
         log_i("Upload Firmware ...");
 
+        if (!prepareUpload(length, write2Flash)) {
+            return false;
+        }
+
+        if (write2Flash) {
+            printf("Loading firmware into FLASH.\r\n");
+            __error_code = bhy2_upload_firmware_to_flash(firmware, length, bhy2);
+            BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_upload_firmware_to_flash failed!", false);
+        } else {
+            log_i("Loading firmware into RAM.\r\n");
+            log_i("upload size = %u", length);
+            __error_code = bhy2_upload_firmware_to_ram(firmware, length, bhy2);
+            BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_upload_firmware_to_ram failed!", false);
+        }
+
+        return bootFirmware(write2Flash, start_ms);
+    }
+
+    /**
+     * @brief  Upload a heatshrink compressed image, decompressed by SensorFirmwareStream in
+     *         pieces of the bus transfer size straight into the sensor. Only the window
+     *         and one transfer are held in RAM
+     * @param  image: compressed image
+     * @param  image_len: size of the compressed image
+     * @param  length: size of the decompressed firmware
+     */
+    bool uploadCompressedFirmware(const uint8_t *image, uint32_t image_len, uint32_t length,
+                                  uint8_t window_bits, uint8_t lookahead_bits, bool write2Flash = false)
+    {
+        uint32_t start_ms = millis();
+        SensorFirmwareStream stream;
+
+        log_i("Upload compressed firmware ...");
+
+        if (!prepareUpload(length, write2Flash)) {
+            return false;
+        }
+
+        // Whole words, the first transfer also carries the command header
+        uint32_t chunk_size = __max_rw_lenght & ~3UL;
+        if (chunk_size < 4) {
+            chunk_size = 4;
+        }
+        uint8_t *chunk = (uint8_t *)malloc(chunk_size);
+        if (!chunk || !stream.begin(image, image_len, window_bits, lookahead_bits)) {
+            log_e("No memory for the firmware stream");
+            free(chunk);
+            return false;
+        }
+
+        log_i("Loading %u bytes of firmware from %u compressed bytes", length, image_len);
+        __error_code = BHY2_OK;
+        for (uint32_t pos = 0; pos < length && __error_code == BHY2_OK;) {
+            uint32_t want = length - pos < chunk_size ? length - pos : chunk_size;
+            uint32_t got = stream.read(chunk, want);
+            if (got != want) {
+                log_e("Compressed firmware ends after %u bytes", pos + got);
+                __error_code = BHY2_E_INVALID_PARAM;
+                break;
+            }
+            uint32_t packet_len = (got + 3) & ~3UL;
+            memset(chunk + got, 0, packet_len - got);
+            if (write2Flash) {
+                __error_code = bhy2_upload_firmware_to_flash_partly(chunk, pos, packet_len, bhy2);
+            } else {
+                __error_code = bhy2_upload_firmware_to_ram_partly(chunk, length, pos, packet_len, bhy2);
+            }
+            pos += got;
+        }
+        free(chunk);
+        BHY2_RLST_CHECK(__error_code != BHY2_OK, "compressed firmware upload failed!", false);
+
+        return bootFirmware(write2Flash, start_ms);
+    }
+
+private:
+    bool prepareUpload(uint32_t length, bool write2Flash)
+    {
+        uint8_t boot_status;
+
         __error_code = bhy2_get_boot_status(&boot_status, bhy2);
         BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_get_boot_status failed!", false);
 
@@ -444,17 +805,60 @@ public:
                 log_e("Flash not detected\r\n");
                 return false;
             }
-            printf("Loading firmware into FLASH.\r\n");
-            __error_code = bhy2_upload_firmware_to_flash(firmware, length, bhy2);
-            BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_upload_firmware_to_flash failed!", false);
-        } else {
-            log_i("Loading firmware into RAM.\r\n");
-            log_i("upload size = %u", length);
-            __error_code = bhy2_upload_firmware_to_ram(firmware, length, bhy2);
-            BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_upload_firmware_to_ram failed!", false);
         }
+        return true;
+    }
+
+    uint32_t firmwareHash()
+    {
+        uint32_t hash = 2166136261UL;
+        for (size_t i = 0; i < __firmware_size; i++) {
+            hash = (hash ^ __firmware[i]) * 16777619UL;
+        }
+        return hash;
+    }
+
+    // Boots the image in the sensor flash if it is the one given to setFirmware()
+    bool bootFromFlash(uint32_t hash)
+    {
+        uint8_t boot_status = 0;
+        uint16_t kernel_version = 0;
+        uint16_t user_version = 0;
+
+        if (!__flash_record_valid || __flash_record.hash != hash) {
+            log_i("Flash does not hold this firmware");
+            return false;
+        }
+        __error_code = bhy2_get_boot_status(&boot_status, bhy2);
+        if (__error_code != BHY2_OK || !(boot_status & BHY2_BST_FLASH_VERIFY_DONE) ||
+                (boot_status & BHY2_BST_FLASH_VERIFY_ERROR)) {
+            log_i("Flash image not verified, boot status 0x%x", boot_status);
+            return false;
+        }
+
+        __error_code = bhy2_boot_from_flash(bhy2);
+        if (__error_code == BHY2_OK) {
+            __error_code = bhy2_get_kernel_version(&kernel_version, bhy2);
+        }
+        if (__error_code == BHY2_OK) {
+            __error_code = bhy2_get_user_version(&user_version, bhy2);
+        }
+        if (__error_code != BHY2_OK || kernel_version != __flash_record.kernel_version ||
+                user_version != __flash_record.user_version) {
+            log_i("Flash booted kernel %u user %u, expected %u %u", kernel_version, user_version,
+                  __flash_record.kernel_version, __flash_record.user_version);
+            // Back to the bootloader to write the flash again
+            __error_code = bhy2_soft_reset(bhy2);
+            return false;
+        }
+        return true;
+    }
 
-        log_i("Loading firmware into RAM Done\r\n");
+    bool bootFirmware(bool write2Flash, uint32_t start_ms)
+    {
+        uint8_t sensor_error;
+
+        log_i("Loading firmware Done, took %lu ms\r\n", (unsigned long)(millis() - start_ms));
         __error_code = bhy2_get_error_value(&sensor_error, bhy2);
         BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_get_error_value failed!", false);
         if (sensor_error != BHY2_OK) {
@@ -481,6 +885,7 @@ public:
         return sensor_error == BHY2_OK;
     }
 
+public:
     String getError()
     {
         String err = get_api_error(__error_code);
@@ -490,12 +895,94 @@ public:
 
     bool configure(uint8_t sensor_id, float sample_rate, uint32_t report_latency_ms)
     {
+        lockBus();
         __error_code = bhy2_set_virt_sensor_cfg(sensor_id, sample_rate, report_latency_ms, bhy2);
+        unlockBus();
         BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_set_virt_sensor_cfg failed!", false);
         log_i("Enable %s at %.2fHz.\r\n", get_sensor_name(sensor_id), sample_rate);
         return true;
     }
 
+    /**
+     * @brief  Let the BHI260AP collect samples in its FIFO and interrupt the host once per
+     *         batch instead of once per sample
+     * @param  sensor_id: non wake up virtual sensor
+     * @param  report_latency_ms: longest time a sample may wait in the FIFO
+     * @param  wakeup: use the wake up variant of the sensor, whose samples go to the wake up
+     *         FIFO and interrupt the host even while setHostSuspended(true). Non wake up
+     *         samples are then only collected, and the oldest are overwritten when the FIFO is full
+     * @retval Sensor ID the samples are reported with, subscribe to this one. 0 on failure
+     */
+    uint8_t configureBatch(uint8_t sensor_id, float sample_rate, uint32_t report_latency_ms, bool wakeup = false)
+    {
+        if (wakeup) {
+            uint8_t wakeup_id = get_sensor_wakeup_id(sensor_id);
+            if (!wakeup_id) {
+                log_e("%s has no wake up variant", get_sensor_name(sensor_id));
+                return 0;
+            }
+            sensor_id = wakeup_id;
+        }
+        return configure(sensor_id, sample_rate, report_latency_ms) ? sensor_id : 0;
+    }
+
+    /**
+     * @brief  Interrupt the host when a FIFO holds this many bytes, even if no report
+     *         latency has expired yet. 0 disables the watermark of that FIFO
+     */
+    bool setFifoWatermark(uint32_t wakeup_bytes, uint32_t nonwakeup_bytes)
+    {
+        lockBus();
+        __error_code = bhy2_set_fifo_wmark_wkup(wakeup_bytes, bhy2);
+        if (__error_code == BHY2_OK) {
+            __error_code = bhy2_set_fifo_wmark_nonwkup(nonwakeup_bytes, bhy2);
+        }
+        unlockBus();
+        BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_set_fifo_wmark failed!", false);
+        return true;
+    }
+
+    bool getFifoWatermark(uint32_t &wakeup_bytes, uint32_t &nonwakeup_bytes)
+    {
+        lockBus();
+        __error_code = bhy2_get_fifo_wmark_wkup(&wakeup_bytes, bhy2);
+        if (__error_code == BHY2_OK) {
+            __error_code = bhy2_get_fifo_wmark_nonwkup(&nonwakeup_bytes, bhy2);
+        }
+        unlockBus();
+        return __error_code == BHY2_OK;
+    }
+
+    // Report the batched samples of a sensor now, SENSOR_FLUSH_ALL for every sensor
+    bool flushFifo(uint8_t sensor_id = SENSOR_FLUSH_ALL)
+    {
+        lockBus();
+        __error_code = bhy2_flush_fifo(sensor_id, bhy2);
+        unlockBus();
+        return __error_code == BHY2_OK;
+    }
+
+    /**
+     * @brief  Tell the BHI260AP that the host is asleep. Only the wake up FIFO raises the
+     *         interrupt then, non wake up samples wait until the host is awake again
+     */
+    bool setHostSuspended(bool suspended)
+    {
+        uint8_t ctrl = 0;
+        lockBus();
+        __error_code = bhy2_get_host_intf_ctrl(&ctrl, bhy2);
+        if (__error_code == BHY2_OK) {
+            if (suspended) {
+                ctrl |= BHY2_HIF_CTRL_AP_SUSPENDED;
+            } else {
+                ctrl &= ~BHY2_HIF_CTRL_AP_SUSPENDED;
+            }
+            __error_code = bhy2_set_host_intf_ctrl(ctrl, bhy2);
+        }
+        unlockBus();
+        return __error_code == BHY2_OK;
+    }
+
     struct bhy2_virt_sensor_conf getConfigure(uint8_t sensor_id)
     {
         bhy2_virt_sensor_conf conf;
@@ -514,6 +1001,262 @@ public:
         __firmware = image;
         __firmware_size = image_len;
         __write_flash = write_flash;
+        __firmware_compressed = false;
+    }
+
+    /**
+     * @brief  Firmware the sensor flash holds, from getFlashRecord() of an earlier boot. With
+     *         setFirmware(..., true) init() then boots from flash without any upload when the
+     *         hash of the image matches and the flash boots with the recorded versions.
+     *         Otherwise the image is written to flash again
+     */
+    void setFlashRecord(const SensorFlashRecord &record)
+    {
+        __flash_record = record;
+        __flash_record_valid = true;
+    }
+
+    // What the flash holds after init(), to be stored when it differs from setFlashRecord()
+    const SensorFlashRecord &getFlashRecord()
+    {
+        return __flash_record;
+    }
+
+    SensorBootPath getBootPath()
+    {
+        return __boot_path;
+    }
+
+    // Time init() took from the reset of the sensor until its firmware ran, in microseconds
+    uint32_t getBootTime()
+    {
+        return __boot_us;
+    }
+
+    // Last accuracy the firmware reported for a virtual sensor, 0 (unreliable) to 3 (high)
+    uint8_t getAccuracy(uint8_t sensor_id)
+    {
+        return sensor_id < BHY2_SENSOR_ID_MAX ? __parse_table.accuracy[sensor_id] : 0;
+    }
+
+    /**
+     * @brief  Fast offset calibration of BHY2_PHYS_SENSOR_ID_ACCELEROMETER or
+     *         BHY2_PHYS_SENSOR_ID_GYROSCOPE. The device has to lie still, for the
+     *         accelerometer flat with z up. The offsets become part of the calibration
+     *         state that saveCalibration() stores
+     */
+    bool performFOC(uint8_t phys_sensor_id, struct bhy2_foc_resp &result)
+    {
+        memset(&result, 0, sizeof(result));
+        result.foc_status = BHY2_FOC_UNKNOWN_FAILURE;
+        lockBus();
+        __error_code = bhy2_perform_foc(phys_sensor_id, &result, bhy2);
+        unlockBus();
+        if (__error_code != BHY2_OK || result.foc_status != BHY2_FOC_PASS) {
+            log_e("FOC of sensor %u failed, status 0x%02X", phys_sensor_id, result.foc_status);
+            return false;
+        }
+        log_i("FOC of sensor %u: %d %d %d", phys_sensor_id, result.x_offset, result.y_offset, result.z_offset);
+        __calib_foc_done = true;
+        return true;
+    }
+
+    /**
+     * @brief  Copy the BSX calibration state of the accelerometer, gyroscope and magnetometer
+     *         to buffer. Kept across power cycles, e.g. in NVS, and given to
+     *         restoreCalibration() after the next init() the fusion starts calibrated.
+     *         SENSOR_CALIB_STATE_MAX bytes always suffice
+     * @return Bytes used, 0 on failure
+     */
+    size_t saveCalibration(uint8_t *buffer, size_t size)
+    {
+        static const uint8_t phys_ids[] = {
+            BHY2_PHYS_SENSOR_ID_ACCELEROMETER, BHY2_PHYS_SENSOR_ID_GYROSCOPE, BHY2_PHYS_SENSOR_ID_MAGNETOMETER
+        };
+        uint16_t version = 0;
+        if (!buffer || size <= SENSOR_CALIB_HEADER_LEN + 4) {
+            return 0;
+        }
+        // Read before the profiles, a report that arrives meanwhile makes the next save due
+        uint32_t calibrated = __parse_table.calibrated;
+        size_t pos = SENSOR_CALIB_HEADER_LEN;
+        uint8_t count = 0;
+        lockBus();
+        bhy2_get_kernel_version(&version, bhy2);
+        for (uint8_t id : phys_ids) {
+            if (size - pos <= 4) {
+                break;
+            }
+            size_t room = size - pos - 4;
+            uint32_t actual = 0;
+            __error_code = bhy2_get_calibration_profile(id, &buffer[pos + 4], room > 0xFFFF ? 0xFFFF : room, &actual, bhy2);
+            if (__error_code == BHY2_E_BUFFER) {
+                break;
+            }
+            // Not fitted
+            if (__error_code != BHY2_OK || !actual) {
+                continue;
+            }
+            buffer[pos] = id;
+            buffer[pos + 1] = 0;
+            buffer[pos + 2] = actual & 0xFF;
+            buffer[pos + 3] = actual >> 8;
+            pos += 4 + actual;
+            count++;
+        }
+        unlockBus();
+        if (__error_code == BHY2_E_BUFFER || !count || !version) {
+            log_e("Calibration state not saved, error %d", __error_code);
+            return 0;
+        }
+        for (int i = 0; i < 4; i++) {
+            buffer[i] = SENSOR_CALIB_MAGIC >> (8 * i);
+        }
+        buffer[4] = version & 0xFF;
+        buffer[5] = version >> 8;
+        buffer[6] = count;
+        buffer[7] = 0;
+        __calib_saved = calibrated;
+        __calib_saved_ms = millis();
+        __calib_foc_done = false;
+        return pos;
+    }
+
+    /**
+     * @brief  Hand a state of saveCalibration() back to the firmware, after init() and before
+     *         the sensors are enabled. A state of another kernel version is rejected, its
+     *         layout may differ
+     */
+    bool restoreCalibration(const uint8_t *buffer, size_t size)
+    {
+        if (!buffer || size < SENSOR_CALIB_HEADER_LEN ||
+                (buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((uint32_t)buffer[3] << 24)) != SENSOR_CALIB_MAGIC) {
+            log_e("Not a calibration state");
+            return false;
+        }
+        uint16_t version = buffer[4] | (buffer[5] << 8);
+        uint16_t kernel_version = 0;
+        lockBus();
+        bhy2_get_kernel_version(&kernel_version, bhy2);
+        unlockBus();
+        if (version != kernel_version) {
+            log_w("Calibration state of kernel %u ignored", version);
+            return false;
+        }
+        // Check the whole state before any of it reaches the firmware
+        size_t pos = SENSOR_CALIB_HEADER_LEN;
+        for (uint8_t i = 0; i < buffer[6]; i++) {
+            if (size - pos < 4 || size - pos - 4 < (size_t)(buffer[pos + 2] | (buffer[pos + 3] << 8))) {
+                log_e("Calibration state truncated");
+                return false;
+            }
+            pos += 4 + (buffer[pos + 2] | (buffer[pos + 3] << 8));
+        }
+        bool ok = true;
+        pos = SENSOR_CALIB_HEADER_LEN;
+        lockBus();
+        for (uint8_t i = 0; i < buffer[6]; i++) {
+            uint16_t length = buffer[pos + 2] | (buffer[pos + 3] << 8);
+            __error_code = bhy2_set_calibration_profile(buffer[pos], &buffer[pos + 4], length, bhy2);
+            if (__error_code != BHY2_OK) {
+                log_e("Calibration profile of sensor %u not restored", buffer[pos]);
+                ok = false;
+            }
+            pos += 4 + length;
+        }
+        unlockBus();
+        return ok;
+    }
+
+    /**
+     * @brief  True when the calibration state is worth saving: a sensor reached full
+     *         accuracy or an FOC passed since the last saveCalibration(), or period_ms went
+     *         by since then with a sensor at full accuracy. 0 disables the periodic save
+     */
+    bool calibrationDue(uint32_t period_ms = 0)
+    {
+        if (__calib_foc_done || __parse_table.calibrated != __calib_saved) {
+            return true;
+        }
+        if (!period_ms || millis() - __calib_saved_ms < period_ms) {
+            return false;
+        }
+        for (uint8_t i = 0; i < BHY2_SENSOR_ID_MAX; i++) {
+            if (__parse_table.accuracy[i] == 3) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief  Let the head orientation quaternions start facing forward: the heading at the
+     *         time the sensor is enabled becomes zero. Needs a firmware image with the head
+     *         tracker module, the default image has none and fails
+     */
+    bool setHeadInitialCorrection(bool enable)
+    {
+        uint8_t buffer[BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR_LENGTH] = {
+            (uint8_t)(enable ? BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR_ENABLE : BHY2_HEAD_ORI_QUAT_INITIAL_HEAD_CORR_DISABLE)
+        };
+        lockBus();
+        __error_code = bhy2_head_tracker_set_quat_initial_head_correction(buffer, bhy2);
+        unlockBus();
+        BHY2_RLST_CHECK(__error_code != BHY2_OK, "head initial correction failed!", false);
+        return true;
+    }
+
+    /**
+     * @brief  Start the head misalignment calibration, which finds how the sensor sits on
+     *         the head while the wearer looks ahead and nods. SENSOR_ID_HEAD_ORI_MIS_ALG
+     *         reports its progress as accuracy, 3 when done
+     */
+    bool triggerHeadCalibration()
+    {
+        uint8_t buffer[BHY2_HEAD_ORI_HMC_TRIGGER_CALIB_LENGTH] = { BHY2_HEAD_ORI_HMC_TRIGGER_CALIB_SET };
+        lockBus();
+        __error_code = bhy2_head_tracker_trigger_hmc_calibration(buffer, bhy2);
+        unlockBus();
+        BHY2_RLST_CHECK(__error_code != BHY2_OK, "head calibration trigger failed!", false);
+        return true;
+    }
+
+    /**
+     * @brief  Misalignment the head orientation is corrected by, from the last head
+     *         calibration: q_head = q_sensor * q, as w, x, y, z
+     * @retval false without a calibration or head tracker firmware
+     */
+    bool getHeadMisalignment(float q[4])
+    {
+        uint8_t buffer[BHY2_HEAD_ORI_HMC_QUAT_CALIB_CORR_RLENGTH] = { 0 };
+        lockBus();
+        __error_code = bhy2_head_tracker_get_hmc_quat_calib_corr_config(buffer, bhy2);
+        unlockBus();
+        BHY2_RLST_CHECK(__error_code != BHY2_OK, "head misalignment read failed!", false);
+        struct bhy2_head_tracker_misalignment_quat_corr corr;
+        memcpy(&corr, buffer, sizeof(corr));
+        // The fixed point format is not documented, the components are normalized instead
+        double w = corr.quaternion_w, x = corr.quaternion_x, y = corr.quaternion_y, z = corr.quaternion_z;
+        double norm = sqrt(w * w + x * x + y * y + z * z);
+        if (corr.accuracy <= 0 || norm == 0) {
+            return false;
+        }
+        q[0] = w / norm;
+        q[1] = x / norm;
+        q[2] = y / norm;
+        q[3] = z / norm;
+        return true;
+    }
+
+    // Image for uploadCompressedFirmware(), the default is bhy2_firmware_image_hs
+    void setCompressedFirmware(const uint8_t *image, size_t image_len, size_t firmware_size,
+                               uint8_t window_bits, uint8_t lookahead_bits, bool write_flash)
+    {
+        setFirmware(image, image_len, write_flash);
+        __firmware_compressed = true;
+        __firmware_length = firmware_size;
+        __firmware_window_bits = window_bits;
+        __firmware_lookahead_bits = lookahead_bits;
     }
 
     static const char *getSensorName(uint8_t sensor_id)
@@ -523,11 +1266,144 @@ public:
 
 private:
 
-    static void IRAM_ATTR handleISR(void *available)
+    static void IRAM_ATTR handleISR(void *arg)
     {
-        *(bool *)(available) = true;
+        SensorBHI260AP *self = (SensorBHI260AP *)arg;
+        self->__irq_time_us = hostTimeUs();
+        self->__irq_time_valid = true;
+        self->__data_available = true;
+        self->__update_stats.interrupts++;
+#if defined(ARDUINO_ARCH_ESP32)
+        if (self->__drain_task) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(self->__drain_task, &woken);
+            if (woken) {
+                portYIELD_FROM_ISR();
+            }
+        }
+#endif
     }
 
+    static int64_t IRAM_ATTR hostTimeUs()
+    {
+#if defined(ARDUINO_ARCH_ESP32)
+        return esp_timer_get_time();
+#else
+        return micros();
+#endif
+    }
+
+    // Pair the timestamp the sensor latched at its last interrupt with the host time of
+    // that interrupt. Called before the FIFO is read, while the interrupt is still raised
+    void syncClock()
+    {
+        if (!__irq_time_valid) {
+            return;
+        }
+        __irq_time_valid = false;
+        int64_t irq_time_us = __irq_time_us;
+        if (__clock.valid() && irq_time_us - __clock_sync_us < SENSOR_CLOCK_SYNC_INTERVAL_MS * 1000LL) {
+            return;
+        }
+        uint64_t timestamp_ns;
+        if (bhy2_get_hw_timestamp_ns(&timestamp_ns, bhy2) == BHY2_OK) {
+            __clock.update(timestamp_ns, irq_time_us);
+            __clock_sync_us = irq_time_us;
+        }
+    }
+
+    bool addSubscriber(uint8_t sensor_id, const BhyParseSubscriber &subscriber)
+    {
+        lockBus();
+        bool rslt = __parse_table.subscribe(sensor_id, subscriber) && updateParseCallback(sensor_id);
+        unlockBus();
+        return rslt;
+    }
+
+    void removeSubscriber(uint8_t sensor_id, const BhyParseSubscriber &subscriber)
+    {
+        lockBus();
+        if (__parse_table.unsubscribe(sensor_id, subscriber)) {
+            updateParseCallback(sensor_id);
+        }
+        unlockBus();
+    }
+
+    SensorSampleRing *getRing(uint8_t sensor_id)
+    {
+        BhyParseSlot *slot = __parse_table.get(sensor_id);
+        return slot ? slot->ring : NULL;
+    }
+
+    // Register the FIFO parser for a sensor with subscribers, remove it for one without.
+    // Called with the bus lock held
+    bool updateParseCallback(uint8_t sensor_id)
+    {
+        // Before init() the table is applied by initImpl
+        if (!processBuffer) {
+            return true;
+        }
+        if (__parse_table.used(sensor_id)) {
+            __error_code = bhy2_register_fifo_parse_callback(sensor_id, BoschParse::parseData, &__parse_table, bhy2);
+        } else {
+            __error_code = bhy2_deregister_fifo_parse_callback(sensor_id, bhy2);
+        }
+        BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_register_fifo_parse_callback failed!", false);
+        return true;
+    }
+
+    int8_t processFifo()
+    {
+        if (__use_fifo_ring) {
+            return bhy2_get_and_process_fifo_ring(&__fifo_ring, bhy2);
+        }
+        return bhy2_get_and_process_fifo(processBuffer, processBufferSize, bhy2);
+    }
+
+    void drainFifo()
+    {
+        uint32_t start = micros();
+        // Cleared before reading, an interrupt raised during the drain is kept
+        __data_available = false;
+        syncClock();
+        processFifo();
+        // The line stays high if the FIFO was refilled while it was read, and then
+        // no new rising edge arrives
+        if (__handler.irq != SENSOR_PIN_NONE && digitalRead(__handler.irq) == HIGH) {
+            __data_available = true;
+        }
+        __update_stats.updates++;
+        __update_stats.update_us += micros() - start;
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    static void drainTask(void *arg)
+    {
+        SensorBHI260AP *self = (SensorBHI260AP *)arg;
+        for (;;) {
+            // The timeout only guards against a lost edge
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SENSOR_DRAIN_TASK_TIMEOUT_MS));
+
+            self->lockBus();
+            for (int i = 0; i < SENSOR_DRAIN_TASK_MAX_PASSES; i++) {
+                self->drainFifo();
+                if (!self->__data_available) {
+                    break;
+                }
+            }
+            self->unlockBus();
+
+            for (uint8_t i = 0; i < self->__ring_count; i++) {
+                SensorSampleRing *ring = self->getRing(self->__ring_ids[i]);
+                TaskHandle_t consumer = (TaskHandle_t)ring->consumer;
+                if (consumer && ring->available()) {
+                    xTaskNotifyGive(consumer);
+                }
+            }
+        }
+    }
+#endif
+
 
     bool initImpl()
     {
@@ -542,6 +1418,14 @@ private:
         bhy2 = (struct bhy2_dev *)malloc(sizeof(struct bhy2_dev ));
         BHY2_RLST_CHECK(!bhy2, " Device handler malloc failed!", false);
 
+#if defined(ARDUINO_ARCH_ESP32)
+        // Subscribers may be removed from another task than the one that drains the FIFO
+        if (!__bus_lock) {
+            __bus_lock = xSemaphoreCreateRecursiveMutex();
+            BHY2_RLST_CHECK(!__bus_lock, "bus lock create failed!", false);
+        }
+#endif
+
         switch (__handler.intf) {
         case BHY2_I2C_INTERFACE:
             // esp32s3 test I2C maximum read and write is 64 bytes
@@ -562,6 +1446,28 @@ private:
             break;
 
         case BHY2_SPI_INTERFACE:
+#if defined(ARDUINO_ARCH_ESP32)
+            if (__use_spi_dma) {
+                if (!SensorInterfaces::setup_spi_dma(__handler, &__spi_dma)) {
+                    log_e("setup_spi_dma failed");
+                    return false;
+                }
+                __max_rw_lenght = __spi_dma.max_transfer;
+                // FIFO reads are limited by the process buffer as well
+                if (processBufferSize < __max_rw_lenght) {
+                    processBufferSize = __max_rw_lenght;
+                }
+                __error_code = bhy2_init(BHY2_SPI_INTERFACE,
+                                         SensorInterfaces::bhy2_spi_dma_read,
+                                         SensorInterfaces::bhy2_spi_dma_write,
+                                         SensorInterfaces::bhy2_delay_us,
+                                         __max_rw_lenght,
+                                         &__spi_dma,
+                                         bhy2);
+                BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_init failed!", false);
+                break;
+            }
+#endif
             // esp32s3 test SPI maximum read and write is 256 bytes
             __max_rw_lenght = 256;
             BHY2_RLST_CHECK(!__handler.u.spi_dev.spi, "SPI ptr NULL", false);
@@ -580,6 +1486,20 @@ private:
             // __error_code = bhy2_set_host_intf_ctrl(BHY2_SPI_INTERFACE, bhy2);
             // BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_set_host_intf_ctrl failed!", false);
             break;
+        case SENSORLIB_CUSTOM_INTERFACE:
+            BHY2_RLST_CHECK(!__custom_read || !__custom_write, "Bus functions NULL", false);
+            if (__handler.irq != SENSOR_PIN_NONE) {
+                pinMode(__handler.irq, INPUT);
+            }
+            __error_code = bhy2_init(__custom_intf,
+                                     __custom_read,
+                                     __custom_write,
+                                     SensorInterfaces::bhy2_delay_us,
+                                     __max_rw_lenght,
+                                     __custom_intf_ptr,
+                                     bhy2);
+            BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_init failed!", false);
+            break;
         default:
             return false;
         }
@@ -603,39 +1523,94 @@ private:
 
         if (!__firmware) {
             // Default write to ram
-            setFirmware(bhy2_firmware_image, sizeof(bhy2_firmware_image), false);
+            setCompressedFirmware(bhy2_firmware_image_hs, sizeof(bhy2_firmware_image_hs), BHY2_FIRMWARE_HS_IMAGE_SIZE,
+                                  BHY2_FIRMWARE_HS_WINDOW_BITS, BHY2_FIRMWARE_HS_LOOKAHEAD_BITS, false);
         }
 
+        uint32_t boot_start_us = micros();
+        __boot_path = SENSOR_BOOT_NONE;
         if (!isReady()) {
-            if (!uploadFirmware(__firmware, __firmware_size, __write_flash)) {
-                log_e("uploadFirmware failed!");
-                return false;
+            uint32_t hash = __write_flash ? firmwareHash() : 0;
+            if (__write_flash && bootFromFlash(hash)) {
+                __boot_path = SENSOR_BOOT_FLASH;
+            } else {
+                // The record is stale until the new image booted from flash
+                __flash_record_valid = false;
+                memset(&__flash_record, 0, sizeof(__flash_record));
+                bool uploaded = __firmware_compressed ?
+                                uploadCompressedFirmware(__firmware, __firmware_size, __firmware_length,
+                                        __firmware_window_bits, __firmware_lookahead_bits, __write_flash) :
+                                uploadFirmware(__firmware, __firmware_size, __write_flash);
+                if (!uploaded) {
+                    log_e("uploadFirmware failed!");
+                    return false;
+                }
+                __boot_path = __write_flash ? SENSOR_BOOT_FLASH_WRITE : SENSOR_BOOT_RAM;
+                if (__write_flash) {
+                    __flash_record.hash = hash;
+                    bhy2_get_kernel_version(&__flash_record.kernel_version, bhy2);
+                    bhy2_get_user_version(&__flash_record.user_version, bhy2);
+                    __flash_record_valid = true;
+                }
             }
         }
+        __boot_us = micros() - boot_start_us;
+        log_i("Firmware running after %lu us, boot path %d", (unsigned long)__boot_us, __boot_path);
 
         uint16_t version = getKernelVersion();
         BHY2_RLST_CHECK(!version, "getKernelVersion failed!", false);
         log_i("Boot successful. Kernel version %u.\r\n", version);
 
-        //Set event callback
-        __error_code = bhy2_register_fifo_parse_callback(BHY2_SYS_ID_META_EVENT, BoschParse::parseMetaEvent, NULL, bhy2);
+        // The fusion starts uncalibrated, until restoreCalibration()
+        memset((void *)__parse_table.accuracy, 0, sizeof(__parse_table.accuracy));
+        __calib_saved = __parse_table.calibrated;
+        __calib_saved_ms = millis();
+        __calib_foc_done = false;
+
+        //Set event callback, the table keeps the accuracy of the sensor status events
+        __error_code = bhy2_register_fifo_parse_callback(BHY2_SYS_ID_META_EVENT, BoschParse::parseMetaEvent, &__parse_table, bhy2);
         BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_register_fifo_parse_callback failed!", false);
 
-        __error_code = bhy2_register_fifo_parse_callback(BHY2_SYS_ID_META_EVENT_WU, BoschParse::parseMetaEvent, NULL, bhy2);
+        __error_code = bhy2_register_fifo_parse_callback(BHY2_SYS_ID_META_EVENT_WU, BoschParse::parseMetaEvent, &__parse_table, bhy2);
         BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_register_fifo_parse_callback failed!", false);
 
         // __error_code = bhy2_register_fifo_parse_callback(BHY2_SYS_ID_DEBUG_MSG, BoschParse::parseDebugMessage, NULL, bhy2);
         // BHY2_RLST_CHECK(__error_code != BHY2_OK, "bhy2_register_fifo_parse_callback parseDebugMessage failed!", false);
 
         //Set process buffer
-#if     defined(ESP32) && defined(BOARD_HAS_PSRAM)
-        processBuffer = (uint8_t *)ps_malloc(processBufferSize);
+        if (__use_fifo_ring) {
+            size_t ring_size = BHY2_FIFO_RING_SLACK;
+            while (ring_size < processBufferSize) {
+                ring_size <<= 1;
+            }
+#if     defined(ARDUINO_ARCH_ESP32)
+            // Touched on every event, keep it out of PSRAM. DMA capable for the SPI DMA transport
+            processBuffer = (uint8_t *)heap_caps_malloc(ring_size + BHY2_FIFO_RING_SLACK, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+#else
+            processBuffer = (uint8_t *)malloc(ring_size + BHY2_FIFO_RING_SLACK);
+#endif
+            bhy2_fifo_ring_init(&__fifo_ring, processBuffer, ring_size + BHY2_FIFO_RING_SLACK);
+        } else {
+#if     defined(ARDUINO_ARCH_ESP32)
+            if (__use_spi_dma) {
+                // Word aligned FIFO chunks are received straight into the buffer
+                processBuffer = (uint8_t *)heap_caps_malloc(processBufferSize, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            } else {
+#if     defined(BOARD_HAS_PSRAM)
+                processBuffer = (uint8_t *)ps_malloc(processBufferSize);
 #else
-        processBuffer = (uint8_t *)malloc(processBufferSize);
+                processBuffer = (uint8_t *)malloc(processBufferSize);
 #endif
+            }
+#elif   defined(ESP32) && defined(BOARD_HAS_PSRAM)
+            processBuffer = (uint8_t *)ps_malloc(processBufferSize);
+#else
+            processBuffer = (uint8_t *)malloc(processBufferSize);
+#endif
+        }
         BHY2_RLST_CHECK(!processBuffer, "process buffer malloc failed!", false);
 
-        __error_code = bhy2_get_and_process_fifo(processBuffer, processBufferSize, bhy2);
+        __error_code = processFifo();
         if (__error_code != BHY2_OK) {
             log_e("bhy2_get_and_process_fifo failed");
             free(processBuffer);
@@ -648,18 +1623,18 @@ private:
         /* Get present virtual sensor */
         bhy2_get_virt_sensor_list(bhy2);
 
-        // Only register valid sensor IDs
+        // Only parse sensors that have a subscriber, events of the others are skipped
         for (uint8_t i = 0; i < BHY2_SENSOR_ID_MAX; i++) {
-            if (bhy2_is_sensor_available(i, bhy2)) {
-                bhy2_register_fifo_parse_callback(i, BoschParse::parseData, NULL, bhy2);
+            if (bhy2_is_sensor_available(i, bhy2) && __parse_table.used(i)) {
+                bhy2_register_fifo_parse_callback(i, BoschParse::parseData, &__parse_table, bhy2);
             }
         }
 
         if (__handler.irq != SENSOR_PIN_NONE) {
 #if defined(ARDUINO_ARCH_RP2040)
-            attachInterruptParam((pin_size_t)(__handler.irq), handleISR, (PinStatus )RISING, (void *)&__data_available);
+            attachInterruptParam((pin_size_t)(__handler.irq), handleISR, (PinStatus )RISING, (void *)this);
 #else
-            attachInterruptArg(__handler.irq, handleISR, (void *)&__data_available, RISING);
+            attachInterruptArg(__handler.irq, handleISR, (void *)this, RISING);
 #endif
         }
 
@@ -673,10 +1648,41 @@ protected:
     volatile bool    __data_available;
     uint8_t          *processBuffer = NULL;
     size_t           processBufferSize = BHY_PROCESS_BUFFER_SZIE;
-    const uint8_t    *__firmware;
+    const uint8_t    *__firmware = NULL;
     size_t          __firmware_size;
-    bool            __write_flash;
-    uint16_t        __max_rw_lenght;
+    bool            __write_flash = false;
+    bool            __firmware_compressed = false;
+    size_t          __firmware_length = 0;
+    uint8_t         __firmware_window_bits = 0;
+    uint8_t         __firmware_lookahead_bits = 0;
+    SensorFlashRecord __flash_record = {};
+    bool            __flash_record_valid = false;
+    SensorBootPath  __boot_path = SENSOR_BOOT_NONE;
+    uint32_t        __boot_us = 0;
+    uint32_t        __calib_saved = 0;
+    uint32_t        __calib_saved_ms = 0;
+    bool            __calib_foc_done = false;
+    uint32_t        __max_rw_lenght;
+    SensorTransportStats __update_stats = {};
+    bool            __use_fifo_ring = true;
+    struct bhy2_fifo_ring __fifo_ring = {};
+    SensorClockSync __clock;
+    volatile int64_t __irq_time_us = 0;
+    volatile bool   __irq_time_valid = false;
+    int64_t         __clock_sync_us = 0;
+    BoschParseTable __parse_table;
+    bhy2_read_fptr_t __custom_read = NULL;
+    bhy2_write_fptr_t __custom_write = NULL;
+    void            *__custom_intf_ptr = NULL;
+    enum bhy2_intf  __custom_intf = BHY2_SPI_INTERFACE;
+    uint8_t         __ring_ids[BHY2_SENSOR_ID_MAX];
+    uint8_t         __ring_count = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+    bool            __use_spi_dma = false;
+    SensorSpiDmaDevice __spi_dma = {};
+    TaskHandle_t    __drain_task = NULL;
+    SemaphoreHandle_t __bus_lock = NULL;
+#endif
 };
 
 
@@ -91,7 +91,8 @@
 
 enum SensorLibInterface {
     SENSORLIB_SPI_INTERFACE = 1,
-    SENSORLIB_I2C_INTERFACE
+    SENSORLIB_I2C_INTERFACE,
+    SENSORLIB_CUSTOM_INTERFACE,     // bus functions supplied by the application
 };
 
 typedef struct __SensorLibPins {
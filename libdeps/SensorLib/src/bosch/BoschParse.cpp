@@ -30,9 +30,111 @@
 #include "BoschParse.h"
 
 std::vector<SensorEventCbList_t> BoschParse::bhyEventVector;
-std::vector<ParseCallBackList_t> BoschParse::bhyParseEventVector;
 uint8_t SensorEventCbList::current_id = 1;
-uint8_t ParseCallBackList::current_id = 1;
+
+BoschParseTable::BoschParseTable()
+{
+    memset(slots, 0, sizeof(slots));
+    memset((void *)accuracy, 0, sizeof(accuracy));
+    calibrated = 0;
+}
+
+BoschParseTable::~BoschParseTable()
+{
+    clear();
+}
+
+BhyParseSlot *BoschParseTable::acquire(uint8_t sensor_id)
+{
+    if (sensor_id >= BHY2_SENSOR_ID_MAX) {
+        return NULL;
+    }
+    if (!slots[sensor_id]) {
+        BhyParseSlot *slot = (BhyParseSlot *)calloc(1, sizeof(BhyParseSlot));
+        if (!slot) {
+            return NULL;
+        }
+        // Published complete, the parser may run in another task
+        __atomic_store_n(&slots[sensor_id], slot, __ATOMIC_RELEASE);
+    }
+    return slots[sensor_id];
+}
+
+static bool same_subscriber(const BhyParseSubscriber &a, const BhyParseSubscriber &b)
+{
+    return a.cb == b.cb && a.user_cb == b.user_cb && a.time_cb == b.time_cb && a.user_data == b.user_data;
+}
+
+bool BoschParseTable::subscribe(uint8_t sensor_id, const BhyParseSubscriber &subscriber)
+{
+    if (!subscriber.cb && !subscriber.user_cb && !subscriber.time_cb) {
+        return false;
+    }
+    BhyParseSlot *slot = acquire(sensor_id);
+    if (!slot || slot->count >= BHY2_PARSE_MAX_SUBSCRIBERS) {
+        return false;
+    }
+    slot->subscribers[slot->count] = subscriber;
+    __atomic_store_n(&slot->count, slot->count + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool BoschParseTable::unsubscribe(uint8_t sensor_id, const BhyParseSubscriber &subscriber)
+{
+    BhyParseSlot *slot = get(sensor_id);
+    if (!slot) {
+        return false;
+    }
+    bool removed = false;
+    for (uint8_t i = 0; i < slot->count;) {
+        if (same_subscriber(slot->subscribers[i], subscriber)) {
+            memmove(&slot->subscribers[i], &slot->subscribers[i + 1], (slot->count - i - 1) * sizeof(BhyParseSubscriber));
+            __atomic_store_n(&slot->count, slot->count - 1, __ATOMIC_RELEASE);
+            removed = true;
+        } else {
+            i++;
+        }
+    }
+    return removed;
+}
+
+bool BoschParseTable::setRing(uint8_t sensor_id, SensorSampleRing *ring)
+{
+    BhyParseSlot *slot = acquire(sensor_id);
+    if (!slot) {
+        return false;
+    }
+    __atomic_store_n(&slot->ring, ring, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool BoschParseTable::used(uint8_t sensor_id)
+{
+    BhyParseSlot *slot = get(sensor_id);
+    return slot && (slot->count || slot->ring);
+}
+
+void BoschParseTable::clear()
+{
+    for (int i = 0; i < BHY2_SENSOR_ID_MAX; i++) {
+        if (slots[i]) {
+            delete slots[i]->ring;
+            free(slots[i]);
+            slots[i] = NULL;
+        }
+    }
+}
+
+void BoschParseTable::setAccuracy(uint8_t sensor_id, uint8_t value)
+{
+    if (sensor_id >= BHY2_SENSOR_ID_MAX) {
+        return;
+    }
+    if (value == 3 && accuracy[sensor_id] != 3) {
+        calibrated = calibrated + 1;
+    }
+    accuracy[sensor_id] = value;
+}
 
 void BoschParse::parseData(const struct bhy2_fifo_parse_data_info *fifo, void *user_data)
 {
@@ -51,22 +153,31 @@ void BoschParse::parseData(const struct bhy2_fifo_parse_data_info *fifo, void *u
     LOG_PORT.println();
 #endif
 
-    for (uint32_t i = 0; i < bhyParseEventVector.size(); i++) {
-        ParseCallBackList_t entry = bhyParseEventVector[i];
-        if (entry.cb ) {
-            if (entry.id == fifo->sensor_id) {
-                if (entry.cb) {
-                    entry.cb(fifo->sensor_id, fifo->data_ptr, size);
-                }
-            }
+    BhyParseSlot *slot = user_data ? ((BoschParseTable *)user_data)->get(fifo->sensor_id) : NULL;
+    if (!slot) {
+        return;
+    }
+
+    uint64_t timestamp_ns = SENSOR_TICKS_TO_NS(*fifo->time_stamp);
+    if (slot->ring) {
+        slot->ring->push(fifo->sensor_id, fifo->data_ptr, size, timestamp_ns);
+    }
+
+    // A callback may remove subscribers, the count is read again after every call
+    for (uint8_t i = 0; i < __atomic_load_n(&slot->count, __ATOMIC_ACQUIRE); i++) {
+        const BhyParseSubscriber subscriber = slot->subscribers[i];
+        if (subscriber.time_cb) {
+            subscriber.time_cb(fifo->sensor_id, fifo->data_ptr, size, timestamp_ns, subscriber.user_data);
+        } else if (subscriber.user_cb) {
+            subscriber.user_cb(fifo->sensor_id, fifo->data_ptr, size, subscriber.user_data);
+        } else if (subscriber.cb) {
+            subscriber.cb(fifo->sensor_id, fifo->data_ptr, size);
         }
     }
 }
 
 void BoschParse::parseMetaEvent(const struct bhy2_fifo_parse_data_info *callback_info, void *user_data)
 {
-    (void)user_data;
-
     uint8_t meta_event_type = callback_info->data_ptr[0];
     uint8_t byte1 = callback_info->data_ptr[1];
     uint8_t byte2 = callback_info->data_ptr[2];
@@ -99,6 +210,9 @@ void BoschParse::parseMetaEvent(const struct bhy2_fifo_parse_data_info *callback
         break;
     case BHY2_META_EVENT_SENSOR_STATUS:
         log_i("%s Accuracy for sensor id %u changed to %u\r\n", event_text, byte1, byte2);
+        if (user_data) {
+            ((BoschParseTable *)user_data)->setAccuracy(byte1, byte2);
+        }
         break;
     case BHY2_META_EVENT_BSX_DO_STEPS_MAIN:
         log_i("%s BSX event (do steps main)\r\n", event_text);
@@ -173,5 +287,5 @@ void BoschParse::parseDebugMessage(const struct bhy2_fifo_parse_data_info *callb
     memcpy(debug_msg, &callback_info->data_ptr[1], msg_length);
     debug_msg[msg_length] = '\0'; /* Terminate the string */
 
-    log_i("[DEBUG MSG]; T: %lu.%09lu; %s\r\n", s, ns, debug_msg);
+    log_i("[DEBUG MSG]; T: %lu.%09lu; %s\r\n", (unsigned long)s, (unsigned long)ns, debug_msg);
 }
\ No newline at end of file
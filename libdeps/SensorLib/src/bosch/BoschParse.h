@@ -33,6 +33,8 @@
 #include "SensorBhy2Define.h"
 #include "bosch/bhy2_parse.h"
 #include "bosch/common/common.h"
+#include "bosch/common/bosch_sample_ring.h"
+#include "bosch/common/bosch_clock_sync.h"
 #include <vector>
 #include <functional>
 
@@ -44,14 +46,72 @@ enum BoschOrientation {
     BHY2_DIRECTION_BOTTOM_RIGHT,
 };
 
+// Result callbacks per sensor ID
+#ifndef BHY2_PARSE_MAX_SUBSCRIBERS
+#define BHY2_PARSE_MAX_SUBSCRIBERS      4
+#endif
+
+// One of the callbacks is set
+typedef struct {
+    BhyParseDataCallback cb;
+    BhyParseDataUserCallback user_cb;
+    BhyParseDataTimeCallback time_cb;
+    void *user_data;
+} BhyParseSubscriber;
+
+typedef struct {
+    uint8_t count;
+    BhyParseSubscriber subscribers[BHY2_PARSE_MAX_SUBSCRIBERS];
+    SensorSampleRing *ring;
+} BhyParseSlot;
+
+/*
+ * Subscribers of every sensor ID, indexed directly by the ID so dispatching an event
+ * does not depend on how many sensors are subscribed. Slots are only allocated for
+ * IDs that have a subscriber or a sample ring.
+ */
+class BoschParseTable
+{
+public:
+    BoschParseTable();
+    ~BoschParseTable();
+
+    BhyParseSlot *get(uint8_t sensor_id)
+    {
+        return sensor_id < BHY2_SENSOR_ID_MAX ? slots[sensor_id] : NULL;
+    }
+
+    bool subscribe(uint8_t sensor_id, const BhyParseSubscriber &subscriber);
+    // Shifts the list down, called with the bus lock held that the FIFO is parsed under
+    bool unsubscribe(uint8_t sensor_id, const BhyParseSubscriber &subscriber);
+    bool setRing(uint8_t sensor_id, SensorSampleRing *ring);
+
+    // True if events of the ID have to be parsed
+    bool used(uint8_t sensor_id);
+    void clear();
+
+    // Sensor status meta event, accuracy 0 (unreliable) to 3 (high)
+    void setAccuracy(uint8_t sensor_id, uint8_t accuracy);
+
+    BhyParseSlot *slots[BHY2_SENSOR_ID_MAX];
+    // Last accuracy reported per sensor ID
+    volatile uint8_t accuracy[BHY2_SENSOR_ID_MAX];
+    // Reports of full accuracy by a sensor that was below it
+    volatile uint32_t calibrated;
+
+private:
+    BhyParseSlot *acquire(uint8_t sensor_id);
+};
+
 class BoschParse
 {
 public:
     static std::vector<SensorEventCbList_t> bhyEventVector;
-    static std::vector<ParseCallBackList_t> bhyParseEventVector;
 
+    // user_data is the BoschParseTable of the device
     static void parseData(const struct bhy2_fifo_parse_data_info *fifo, void *user_data);
 
+    // user_data is the BoschParseTable of the device, or NULL
     static void parseMetaEvent(const struct bhy2_fifo_parse_data_info *callback_info, void *user_data);
 
     static void parseDebugMessage(const struct bhy2_fifo_parse_data_info *callback_info, void *callback_ref);
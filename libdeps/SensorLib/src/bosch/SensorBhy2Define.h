@@ -35,6 +35,15 @@
 #define BHI260AP_SLAVE_ADDRESS_L          0x28
 #define BHI260AP_SLAVE_ADDRESS_H          0x29
 #define BHY_PROCESS_BUFFER_SZIE         512
+// Longest sleep of the drain task without an interrupt, and drains per wake-up
+#define SENSOR_DRAIN_TASK_TIMEOUT_MS    1000
+#define SENSOR_DRAIN_TASK_MAX_PASSES    4
+
+// Sensor ID of the FIFO flush command that flushes every sensor
+#define SENSOR_FLUSH_ALL                0xFE
+
+// Shortest time between two clock resync points, each costs one 5 byte register read
+#define SENSOR_CLOCK_SYNC_INTERVAL_MS   1000
 
 #define BHY2_RLST_CHECK(ret, str, val) \
     do                                 \
@@ -48,6 +57,9 @@
 
 typedef void (*BhyEventCb)(uint8_t event, uint8_t *data, uint32_t size);
 typedef void (*BhyParseDataCallback)(uint8_t sensor_id, uint8_t *data, uint32_t size);
+typedef void (*BhyParseDataUserCallback)(uint8_t sensor_id, uint8_t *data, uint32_t size, void *user_data);
+// timestamp_ns is the BHI260AP time of the sample, SensorBHI260AP::toHostTime maps it to the host clock
+typedef void (*BhyParseDataTimeCallback)(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data);
 
 
 
@@ -63,16 +75,6 @@ typedef struct SensorEventCbList {
 } SensorEventCbList_t;
 
 
-typedef struct ParseCallBackList {
-    static uint8_t current_id;
-    uint8_t id;
-    BhyParseDataCallback cb;
-    uint32_t data_length;
-    uint8_t *data;
-    ParseCallBackList() : id(current_id++), cb(NULL),  data_length(0), data(NULL)
-    {
-    }
-} ParseCallBackList_t;
 
 enum BhySensorEvent {
     BHY2_EVENT_FLUSH_COMPLETE           = 1,
@@ -144,6 +146,11 @@ enum BhySensorID {
     SENSOR_ID_MAG_BIAS_WU              = 93,  /* Magnetometer offset wake up */
     SENSOR_ID_STD_WU                   = 94,  /* Step detector wake up */
     SENSOR_ID_BSEC                     = 115, /* BSEC 1.x output */
+    SENSOR_ID_HEAD_ORI_MIS_ALG         = 120, /* Head orientation misalignment, head tracker firmware */
+    SENSOR_ID_IMU_HEAD_ORI_Q           = 121, /* IMU head orientation quaternion, head tracker firmware */
+    SENSOR_ID_NDOF_HEAD_ORI_Q          = 122, /* NDOF head orientation quaternion, head tracker firmware */
+    SENSOR_ID_IMU_HEAD_ORI_E           = 123, /* IMU head orientation Euler, head tracker firmware */
+    SENSOR_ID_NDOF_HEAD_ORI_E          = 124, /* NDOF head orientation Euler, head tracker firmware */
     SENSOR_ID_TEMP                     = 128, /* Temperature */
     SENSOR_ID_BARO                     = 129, /* Barometer */
     SENSOR_ID_HUM                      = 130, /* Humidity */
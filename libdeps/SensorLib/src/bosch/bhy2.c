@@ -64,6 +64,7 @@ union bhy2_float_u32
 static const uint8_t bhy2_sysid_event_size[11] = { 2, 3, 6, 4, 0, 18, 2, 3, 6, 4, 1 };
 
 static int8_t parse_fifo(enum bhy2_fifo_type source, struct bhy2_fifo_buffer *fifo_p, struct bhy2_dev *dev);
+static int8_t parse_fifo_events(enum bhy2_fifo_type source, struct bhy2_fifo_buffer *fifo_p, struct bhy2_dev *dev);
 static int8_t get_buffer_status(const struct bhy2_fifo_buffer *fifo_p, uint8_t event_size, buffer_status_t *status);
 static int8_t get_time_stamp(enum bhy2_fifo_type source, uint64_t **time_stamp, struct bhy2_dev *dev);
 static int8_t get_callback_info(uint8_t sensor_id, struct bhy2_fifo_parse_callback_table *info, struct bhy2_dev *dev);
@@ -251,6 +252,218 @@ int8_t bhy2_get_and_process_fifo(uint8_t *work_buffer, uint32_t buffer_size, str
     return rslt;
 }
 
+int8_t bhy2_fifo_ring_init(struct bhy2_fifo_ring *ring, uint8_t *work_buffer, uint32_t buffer_size)
+{
+    uint32_t size = 1;
+
+    if ((ring == NULL) || (work_buffer == NULL))
+    {
+        return BHY2_E_NULL_PTR;
+    }
+
+    if (buffer_size < (2 * BHY2_FIFO_RING_SLACK))
+    {
+        return BHY2_E_BUFFER;
+    }
+
+    while ((size << 1) <= (buffer_size - BHY2_FIFO_RING_SLACK))
+    {
+        size <<= 1;
+    }
+
+    ring->buffer = work_buffer;
+    ring->size = size;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->remain_length = 0;
+
+    return BHY2_OK;
+}
+
+/* Parse length bytes from the tail, returns the number of bytes parsed */
+static uint32_t parse_fifo_view(enum bhy2_fifo_type source,
+                                struct bhy2_fifo_ring *ring,
+                                uint32_t length,
+                                int8_t *rslt,
+                                struct bhy2_dev *dev)
+{
+    struct bhy2_fifo_buffer view;
+
+    view.buffer = &ring->buffer[ring->tail & ring->mask];
+    view.buffer_size = length;
+    view.read_length = length;
+    view.read_pos = 0;
+    view.remain_length = 0;
+    *rslt = parse_fifo_events(source, &view, dev);
+    ring->tail += view.read_pos;
+
+    return view.read_pos;
+}
+
+/* Parse the bytes between tail and head. The one event that wraps around the end of the ring
+ * is completed by copying its start in the slack behind the ring */
+static int8_t parse_fifo_ring(enum bhy2_fifo_type source, struct bhy2_fifo_ring *ring, struct bhy2_dev *dev)
+{
+    int8_t rslt = BHY2_OK;
+    uint32_t offset, available, length, wrapped, copy, limit, tail;
+
+    while ((ring->head != ring->tail) && (rslt == BHY2_OK))
+    {
+        offset = ring->tail & ring->mask;
+        available = ring->head - ring->tail;
+        length = ring->size - offset;
+        if (available <= length)
+        {
+            /* Contiguous, anything left is a partial event */
+            (void)parse_fifo_view(source, ring, available, &rslt, dev);
+            break;
+        }
+
+        if (parse_fifo_view(source, ring, length, &rslt, dev) == length)
+        {
+            continue;
+        }
+
+        /* An event crosses the end, most events are shorter than the first copy */
+        tail = ring->tail;
+        length = ring->size - (ring->tail & ring->mask);
+        wrapped = ring->head - ring->tail - length;
+        limit = (wrapped < BHY2_FIFO_RING_SLACK) ? wrapped : BHY2_FIFO_RING_SLACK;
+        copy = (limit < UINT32_C(32)) ? limit : UINT32_C(32);
+        for (;;)
+        {
+            memcpy(&ring->buffer[ring->size], ring->buffer, copy);
+            if (parse_fifo_view(source, ring, length + copy, &rslt, dev) || (copy == limit) || (rslt != BHY2_OK))
+            {
+                break;
+            }
+
+            copy = ((copy * 2) < limit) ? (copy * 2) : limit;
+        }
+
+        /* The rest of the event has not been read yet */
+        if (ring->tail == tail)
+        {
+            break;
+        }
+    }
+
+    return rslt;
+}
+
+static int8_t get_and_process_fifo_ring(enum bhy2_fifo_type source,
+                                        uint8_t int_flag,
+                                        struct bhy2_fifo_ring *ring,
+                                        struct bhy2_dev *dev)
+{
+    int8_t rslt = BHY2_OK;
+    uint32_t bytes_read, space;
+
+    while ((int_flag || ring->remain_length) && (rslt == BHY2_OK))
+    {
+        /* Up to the end of the ring, the next read continues at its start */
+        space = ring->size - (ring->head - ring->tail);
+        if (space > (ring->size - (ring->head & ring->mask)))
+        {
+            space = ring->size - (ring->head & ring->mask);
+        }
+
+        if (space == 0)
+        {
+            return BHY2_E_BUFFER;
+        }
+
+        bytes_read = 0;
+        switch (source)
+        {
+            case BHY2_FIFO_TYPE_WAKEUP:
+                rslt = bhy2_hif_get_wakeup_fifo(&ring->buffer[ring->head & ring->mask],
+                                                space,
+                                                &bytes_read,
+                                                &ring->remain_length,
+                                                &dev->hif);
+                break;
+            case BHY2_FIFO_TYPE_NON_WAKEUP:
+                rslt = bhy2_hif_get_nonwakeup_fifo(&ring->buffer[ring->head & ring->mask],
+                                                   space,
+                                                   &bytes_read,
+                                                   &ring->remain_length,
+                                                   &dev->hif);
+                break;
+            default:
+                rslt = bhy2_hif_get_status_fifo_async(&ring->buffer[ring->head & ring->mask],
+                                                      space,
+                                                      &bytes_read,
+                                                      &ring->remain_length,
+                                                      &dev->hif);
+                break;
+        }
+
+        if (rslt != BHY2_OK)
+        {
+            break;
+        }
+
+        ring->head += bytes_read;
+        rslt = parse_fifo_ring(source, ring, dev);
+        int_flag = 0;
+    }
+
+    /* The FIFO ends with a complete event, anything left over is dropped as by bhy2_get_and_process_fifo */
+    ring->tail = ring->head;
+    ring->remain_length = 0;
+
+    return rslt;
+}
+
+int8_t bhy2_get_and_process_fifo_ring(struct bhy2_fifo_ring *ring, struct bhy2_dev *dev)
+{
+    uint8_t int_status;
+    int8_t rslt;
+
+    if ((dev == NULL) || (ring == NULL) || (ring->buffer == NULL))
+    {
+        return BHY2_E_NULL_PTR;
+    }
+
+    rslt = bhy2_hif_get_interrupt_status(&int_status, &dev->hif);
+    if (rslt != BHY2_OK)
+    {
+        return rslt;
+    }
+
+    ring->tail = ring->head;
+    ring->remain_length = 0;
+
+    rslt = get_and_process_fifo_ring(BHY2_FIFO_TYPE_WAKEUP,
+                                     ((BHY2_IS_INT_FIFO_W(int_status)) == BHY2_IST_FIFO_W_DRDY) ||
+                                     ((BHY2_IS_INT_FIFO_W(int_status)) == BHY2_IST_FIFO_W_LTCY) ||
+                                     ((BHY2_IS_INT_FIFO_W(int_status)) == BHY2_IST_FIFO_W_WM),
+                                     ring,
+                                     dev);
+    if (rslt != BHY2_OK)
+    {
+        return rslt;
+    }
+
+    rslt = get_and_process_fifo_ring(BHY2_FIFO_TYPE_NON_WAKEUP,
+                                     ((BHY2_IS_INT_FIFO_NW(int_status)) == BHY2_IST_FIFO_NW_DRDY) ||
+                                     ((BHY2_IS_INT_FIFO_NW(int_status)) == BHY2_IST_FIFO_NW_LTCY) ||
+                                     ((BHY2_IS_INT_FIFO_NW(int_status)) == BHY2_IST_FIFO_NW_WM),
+                                     ring,
+                                     dev);
+    if (rslt != BHY2_OK)
+    {
+        return rslt;
+    }
+
+    return get_and_process_fifo_ring(BHY2_FIFO_TYPE_STATUS,
+                                     (BHY2_IS_INT_ASYNC_STATUS(int_status)) == BHY2_IST_MASK_DEBUG,
+                                     ring,
+                                     dev);
+}
+
 int8_t bhy2_get_virt_sensor_cfg(uint8_t sensor_id, struct bhy2_virt_sensor_conf *virt_sensor_conf, struct bhy2_dev *dev)
 {
     int8_t rslt = BHY2_OK;
@@ -1258,6 +1471,13 @@ int8_t bhy2_register_fifo_parse_callback(uint8_t sensor_id,
     {
         rslt = BHY2_E_NULL_PTR;
     }
+    else if (dev->table_index[sensor_id] != 0)
+    {
+        /* Already registered, replace the callback */
+        i = dev->table_index[sensor_id] - 1;
+        dev->table[i].callback = callback;
+        dev->table[i].callback_ref = callback_ref;
+    }
     else
     {
         for (i = 0; i < BHY2_MAX_SIMUL_SENSORS; i++)
@@ -1267,6 +1487,7 @@ int8_t bhy2_register_fifo_parse_callback(uint8_t sensor_id,
                 dev->table[i].sensor_id = sensor_id;
                 dev->table[i].callback = callback;
                 dev->table[i].callback_ref = callback_ref;
+                dev->table_index[sensor_id] = i + 1;
                 break;
             }
         }
@@ -1289,18 +1510,13 @@ int8_t bhy2_deregister_fifo_parse_callback(uint8_t sensor_id, struct bhy2_dev *d
     {
         rslt = BHY2_E_NULL_PTR;
     }
-    else
+    else if (dev->table_index[sensor_id] != 0)
     {
-        for (i = 0; i < BHY2_MAX_SIMUL_SENSORS; i++)
-        {
-            if (dev->table[i].sensor_id == sensor_id)
-            {
-                dev->table[i].sensor_id = 0;
-                dev->table[i].callback = NULL;
-                dev->table[i].callback_ref = NULL;
-                break;
-            }
-        }
+        i = dev->table_index[sensor_id] - 1;
+        dev->table[i].sensor_id = 0;
+        dev->table[i].callback = NULL;
+        dev->table[i].callback_ref = NULL;
+        dev->table_index[sensor_id] = 0;
     }
 
     return rslt;
@@ -1541,35 +1757,30 @@ static int8_t get_callback_info(uint8_t sensor_id, struct bhy2_fifo_parse_callba
 {
 
     int8_t rslt = BHY2_OK;
-    uint8_t i = 0, j;
 
     if ((dev != NULL) && (info != NULL))
     {
-        for (j = 0; j < BHY2_MAX_SIMUL_SENSORS; j++)
+        /* Direct lookup, called for every event in the FIFO */
+        if (dev->table_index[sensor_id] != 0)
         {
-            if (sensor_id == dev->table[j].sensor_id)
-            {
-                *info = dev->table[j];
-                i = j;
-                break;
-            }
+            *info = dev->table[dev->table_index[sensor_id] - 1];
         }
-
-        if (i == BHY2_MAX_SIMUL_SENSORS)
+        else
         {
-            rslt = BHy2_E_INSUFFICIENT_MAX_SIMUL_SENSORS;
+            /* No callback, the event is skipped */
+            info->sensor_id = sensor_id;
+            info->callback = NULL;
+            info->callback_ref = NULL;
         }
-        else
+
+        if ((sensor_id >= BHY2_SPECIAL_SENSOR_ID_OFFSET) && (dev->event_size[sensor_id] == 0))
         {
-            if ((sensor_id >= BHY2_SPECIAL_SENSOR_ID_OFFSET) && (dev->event_size[sensor_id] == 0))
-            {
-                dev->event_size[sensor_id] = bhy2_sysid_event_size[sensor_id - BHY2_SPECIAL_SENSOR_ID_OFFSET];
-            }
+            dev->event_size[sensor_id] = bhy2_sysid_event_size[sensor_id - BHY2_SPECIAL_SENSOR_ID_OFFSET];
+        }
 
-            if ((sensor_id == 0) && (dev->event_size[sensor_id] == 0))
-            {
-                dev->event_size[sensor_id] = 1;
-            }
+        if ((sensor_id == 0) && (dev->event_size[sensor_id] == 0))
+        {
+            dev->event_size[sensor_id] = 1;
         }
     }
     else
@@ -1635,6 +1846,19 @@ static int8_t parse_fifo_support(struct bhy2_fifo_buffer *fifo_buf)
 }
 
 static int8_t parse_fifo(enum bhy2_fifo_type source, struct bhy2_fifo_buffer *fifo_p, struct bhy2_dev *dev)
+{
+    int8_t rslt;
+
+    rslt = parse_fifo_events(source, fifo_p, dev);
+    (void)rslt;
+
+    rslt = parse_fifo_support(fifo_p);
+
+    return rslt;
+}
+
+/* Parse the complete events in front of read_pos, a partial event is left for the next read */
+static int8_t parse_fifo_events(enum bhy2_fifo_type source, struct bhy2_fifo_buffer *fifo_p, struct bhy2_dev *dev)
 {
     uint8_t tmp_sensor_id = 0;
     int8_t rslt = BHY2_OK;
@@ -1735,8 +1959,6 @@ static int8_t parse_fifo(enum bhy2_fifo_type source, struct bhy2_fifo_buffer *fi
         }
     }
 
-    rslt = parse_fifo_support(fifo_p);
-
     return rslt;
 }
 
@@ -202,6 +202,24 @@ int8_t bhy2_set_virt_sensor_range(uint8_t sensor_id, uint16_t range, struct bhy2
  */
 int8_t bhy2_get_and_process_fifo(uint8_t *work_buffer, uint32_t buffer_size, struct bhy2_dev *dev);
 
+/**
+ * @brief Function to set up the work buffer of bhy2_get_and_process_fifo_ring
+ * @param[out] ring         : Ring to initialize
+ * @param[in] work_buffer   : Data buffer, holds a power of two ring plus BHY2_FIFO_RING_SLACK bytes
+ * @param[in] buffer_size   : Size of the data buffer, the ring uses the largest power of two that fits
+ * @return API error codes
+ */
+int8_t bhy2_fifo_ring_init(struct bhy2_fifo_ring *ring, uint8_t *work_buffer, uint32_t buffer_size);
+
+/**
+ * @brief Function to get and process the FIFOs like bhy2_get_and_process_fifo, without clearing
+ * the work buffer and without moving a partial event to its start after every read
+ * @param[in] ring          : Ring set up by bhy2_fifo_ring_init
+ * @param[in] dev           : Device reference
+ * @return API error codes
+ */
+int8_t bhy2_get_and_process_fifo_ring(struct bhy2_fifo_ring *ring, struct bhy2_dev *dev);
+
 /**
  * @brief Function get the FIFO control register
  * @param[out] fifo_ctrl    : Reference to the data buffer to store the FIFO control
@@ -636,6 +636,7 @@ struct BHY2_PACKED bhy2_fifo_parse_callback_table {
 struct bhy2_dev {
     struct bhy2_hif_dev hif;
     struct bhy2_fifo_parse_callback_table table[BHY2_MAX_SIMUL_SENSORS];
+    uint8_t table_index[BHY2_N_VIRTUAL_SENSOR_MAX]; /* table slot + 1 of every sensor id, 0 if not registered */
     uint8_t event_size[BHY2_N_VIRTUAL_SENSOR_MAX];
     uint64_t last_time_stamp[BHY2_FIFO_TYPE_MAX];
     uint8_t present_buff[32];
@@ -649,6 +650,22 @@ struct bhy2_fifo_buffer {
     uint8_t *buffer;
 };
 
+/* Bytes behind the ring that an event wrapping around its end is completed in, the largest event size */
+#define BHY2_FIFO_RING_SLACK                      UINT32_C(256)
+
+/*
+ * Work buffer of bhy2_get_and_process_fifo_ring. Head and tail count bytes and are
+ * only masked when the buffer is accessed, a partial event stays where it was read
+ */
+struct bhy2_fifo_ring {
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t remain_length;
+};
+
 typedef int16_t (*bhy2_frame_parse_func_t)(struct bhy2_fifo_buffer *p_fifo_buffer, struct bhy2_dev *bhy2_p);
 
 struct bhy2_virt_sensor_conf {
@@ -0,0 +1,147 @@
+/**
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2026 lewis he
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      bosch_clock_sync.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @date      2026-10-16
+ *
+ */
+#include "bosch_clock_sync.h"
+
+// sensor_ns * (1 + drift_ppb / 1e9), split so it cannot overflow for any realistic span
+static int64_t apply_drift(int64_t sensor_ns, int32_t drift_ppb)
+{
+    int64_t ms = sensor_ns / 1000000;
+    int64_t rest = sensor_ns % 1000000;
+    return sensor_ns + ms * drift_ppb / 1000 + rest * drift_ppb / 1000000000;
+}
+
+SensorClockSync::SensorClockSync() : __seq(0)
+{
+    reset();
+}
+
+void SensorClockSync::reset()
+{
+    __atomic_fetch_add(&__seq, 1, __ATOMIC_ACQ_REL);
+    __points = 0;
+    __outliers = 0;
+    __anchor_sensor_ns = 0;
+    __anchor_host_us = 0;
+    __drift_ppb = 0;
+    __last_error_us = 0;
+    __atomic_fetch_add(&__seq, 1, __ATOMIC_RELEASE);
+}
+
+bool SensorClockSync::update(uint64_t sensor_ns, int64_t host_us)
+{
+    if (__points) {
+        uint32_t last = (__points - 1) % SENSOR_CLOCK_SYNC_WINDOW;
+        int64_t predicted = 0;
+        toHost(sensor_ns, predicted);
+        int64_t error = host_us - predicted;
+        // The sensor clock restarts from zero when the sensor is reset
+        bool broken = sensor_ns <= __sensor_ns[last];
+        if (!broken && (error > SENSOR_CLOCK_SYNC_MAX_ERROR_US || error < -SENSOR_CLOCK_SYNC_MAX_ERROR_US)) {
+            // A late interrupt is only seen late by the host, accept it once the fit itself is off
+            if (++__outliers < SENSOR_CLOCK_SYNC_MAX_OUTLIERS) {
+                return false;
+            }
+            broken = true;
+        }
+        if (broken) {
+            reset();
+        } else {
+            __last_error_us = error;
+        }
+    }
+    __outliers = 0;
+
+    uint32_t index = __points % SENSOR_CLOCK_SYNC_WINDOW;
+    __sensor_ns[index] = sensor_ns;
+    __host_us[index] = host_us;
+    __points++;
+    fit();
+    return true;
+}
+
+void SensorClockSync::fit()
+{
+    uint32_t count = __points < SENSOR_CLOCK_SYNC_WINDOW ? __points : SENSOR_CLOCK_SYNC_WINDOW;
+    uint32_t last = (__points - 1) % SENSOR_CLOCK_SYNC_WINDOW;
+    int32_t drift_ppb = __drift_ppb;
+    int64_t anchor_host_us = __host_us[last];
+
+    if (count >= 2) {
+        // Relative to the newest point, keeps the values small enough for double precision
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            double x = (double)(int64_t)(__sensor_ns[i] - __sensor_ns[last]);
+            double y = (double)(__host_us[i] - __host_us[last]) * 1000.0;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        double var = count * sxx - sx * sx;
+        if (var > 0) {
+            double slope = (count * sxy - sx * sy) / var;
+            double drift = (slope - 1.0) * 1e9;
+            if (drift < SENSOR_CLOCK_SYNC_MAX_DRIFT_PPB && drift > -SENSOR_CLOCK_SYNC_MAX_DRIFT_PPB) {
+                drift_ppb = (int32_t)drift;
+                // Fitted host time at the newest point, averages out interrupt latency jitter
+                double intercept = (sy - slope * sx) / count;
+                anchor_host_us += (int64_t)(intercept / 1000.0);
+            }
+        }
+    }
+
+    __atomic_fetch_add(&__seq, 1, __ATOMIC_ACQ_REL);
+    __anchor_sensor_ns = __sensor_ns[last];
+    __anchor_host_us = anchor_host_us;
+    __drift_ppb = drift_ppb;
+    __atomic_fetch_add(&__seq, 1, __ATOMIC_RELEASE);
+}
+
+bool SensorClockSync::toHost(uint64_t sensor_ns, int64_t &host_us) const
+{
+    uint32_t seq;
+    uint64_t anchor_sensor_ns;
+    int64_t anchor_host_us;
+    int32_t drift_ppb;
+    do {
+        seq = __atomic_load_n(&__seq, __ATOMIC_ACQUIRE);
+        anchor_sensor_ns = __anchor_sensor_ns;
+        anchor_host_us = __anchor_host_us;
+        drift_ppb = __drift_ppb;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&__seq, __ATOMIC_RELAXED));
+
+    if (!__atomic_load_n(&__points, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    int64_t span_ns = (int64_t)(sensor_ns - anchor_sensor_ns);
+    host_us = anchor_host_us + apply_drift(span_ns, drift_ppb) / 1000;
+    return true;
+}
@@ -0,0 +1,104 @@
+/**
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2026 lewis he
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      bosch_clock_sync.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Resync points the clock fit is computed over
+#ifndef SENSOR_CLOCK_SYNC_WINDOW
+#define SENSOR_CLOCK_SYNC_WINDOW            16
+#endif
+
+// A point further than this from the fit is a late interrupt and is skipped
+#ifndef SENSOR_CLOCK_SYNC_MAX_ERROR_US
+#define SENSOR_CLOCK_SYNC_MAX_ERROR_US      2000
+#endif
+
+// Consecutive skipped points after which the fit is restarted, e.g. after a sensor reset
+#define SENSOR_CLOCK_SYNC_MAX_OUTLIERS      3
+
+// Larger rate differences are treated as a broken fit
+#define SENSOR_CLOCK_SYNC_MAX_DRIFT_PPB     50000000
+
+/*
+ * Maps BHI260AP timestamps to host time. Every resync point pairs the hardware timestamp
+ * latched by the sensor when it raised its interrupt with the host time the interrupt
+ * was seen at. A least squares line through the last SENSOR_CLOCK_SYNC_WINDOW points
+ * gives the offset and the drift between the two oscillators.
+ * update() and toHost() may run in different tasks, the fit is published with a sequence
+ * counter so toHost() never takes a lock.
+ */
+class SensorClockSync
+{
+public:
+    SensorClockSync();
+
+    void reset();
+
+    // Add a resync point, returns false if it was rejected as an outlier
+    bool update(uint64_t sensor_ns, int64_t host_us);
+
+    // Host time of a sensor timestamp, false until the first resync point
+    bool toHost(uint64_t sensor_ns, int64_t &host_us) const;
+
+    bool valid() const
+    {
+        return __points != 0;
+    }
+    uint32_t points() const
+    {
+        return __points;
+    }
+    // Host clock rate relative to the sensor clock, in parts per billion
+    int32_t driftPpb() const
+    {
+        return __drift_ppb;
+    }
+    // Distance of the last resync point from the previous fit
+    int32_t lastErrorUs() const
+    {
+        return __last_error_us;
+    }
+
+private:
+    void fit();
+
+    uint64_t __sensor_ns[SENSOR_CLOCK_SYNC_WINDOW];
+    int64_t __host_us[SENSOR_CLOCK_SYNC_WINDOW];
+    uint32_t __points;
+    uint32_t __outliers;
+
+    // Published fit, written between two increments of __seq
+    uint32_t __seq;
+    uint64_t __anchor_sensor_ns;
+    int64_t __anchor_host_us;
+    int32_t __drift_ppb;
+    int32_t __last_error_us;
+};
@@ -0,0 +1,130 @@
+/**
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2026 lewis he
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      bosch_firmware_stream.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @date      2026-10-16
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bosch_firmware_stream.h"
+
+SensorFirmwareStream::SensorFirmwareStream() :
+    __src(NULL), __src_len(0), __src_pos(0), __bit_mask(0), __window(NULL), __window_mask(0),
+    __window_pos(0), __window_bits(0), __lookahead_bits(0), __copy_offset(0), __copy_remain(0)
+{
+}
+
+SensorFirmwareStream::~SensorFirmwareStream()
+{
+    end();
+}
+
+bool SensorFirmwareStream::begin(const uint8_t *src, size_t src_len, uint8_t window_bits, uint8_t lookahead_bits)
+{
+    if (!src || window_bits < 4 || window_bits > 15 || lookahead_bits < 3 || lookahead_bits >= window_bits) {
+        return false;
+    }
+    end();
+    // heatshrink starts from a zeroed window
+    __window = (uint8_t *)calloc(1, 1UL << window_bits);
+    if (!__window) {
+        return false;
+    }
+    __src = src;
+    __src_len = src_len;
+    __src_pos = 0;
+    __bit_mask = 0;
+    __window_mask = (1UL << window_bits) - 1;
+    __window_pos = 0;
+    __window_bits = window_bits;
+    __lookahead_bits = lookahead_bits;
+    __copy_remain = 0;
+    return true;
+}
+
+void SensorFirmwareStream::end()
+{
+    free(__window);
+    __window = NULL;
+    __src = NULL;
+}
+
+int32_t SensorFirmwareStream::getBits(uint8_t count)
+{
+    int32_t value = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!__bit_mask) {
+            if (__src_pos >= __src_len) {
+                return -1;
+            }
+            __src_pos++;
+            __bit_mask = 0x80;
+        }
+        value = (value << 1) | ((__src[__src_pos - 1] & __bit_mask) ? 1 : 0);
+        __bit_mask >>= 1;
+    }
+    return value;
+}
+
+uint32_t SensorFirmwareStream::read(uint8_t *dst, uint32_t len)
+{
+    uint32_t written = 0;
+    if (!__window) {
+        return 0;
+    }
+    while (written < len) {
+        uint8_t c;
+        if (__copy_remain) {
+            c = __window[(__window_pos - __copy_offset) & __window_mask];
+            __copy_remain--;
+        } else {
+            int32_t tag = getBits(1);
+            if (tag < 0) {
+                break;
+            }
+            if (tag) {
+                int32_t literal = getBits(8);
+                if (literal < 0) {
+                    break;
+                }
+                c = literal;
+            } else {
+                // The padding of the last byte is too short for a back reference
+                int32_t index = getBits(__window_bits);
+                int32_t count = index < 0 ? -1 : getBits(__lookahead_bits);
+                if (count < 0) {
+                    break;
+                }
+                __copy_offset = index + 1;
+                __copy_remain = count + 1;
+                continue;
+            }
+        }
+        __window[__window_pos++ & __window_mask] = c;
+        dst[written++] = c;
+    }
+    return written;
+}
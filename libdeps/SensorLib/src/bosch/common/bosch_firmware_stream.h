@@ -0,0 +1,71 @@
+/**
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2026 lewis he
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      bosch_firmware_stream.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Streaming decoder for firmware images compressed in the heatshrink format
+ * (heatshrink -e -w <window_bits> -l <lookahead_bits>). The output comes out in pieces of
+ * any size and only the last 2^window_bits bytes are kept in RAM, so an image can go to
+ * the sensor chunk by chunk without a decompressed copy.
+ *
+ * The stream is a sequence of bits, most significant first: 1 and 8 bits is a literal
+ * byte, 0, window_bits and lookahead_bits copy (count + 1) bytes from (index + 1) bytes back.
+ */
+class SensorFirmwareStream
+{
+public:
+    SensorFirmwareStream();
+    ~SensorFirmwareStream();
+
+    bool begin(const uint8_t *src, size_t src_len, uint8_t window_bits, uint8_t lookahead_bits);
+    void end();
+
+    // Decompresses up to len bytes into dst, returns the number written, 0 once the input is used up
+    uint32_t read(uint8_t *dst, uint32_t len);
+
+private:
+    // Next count bits of the input, -1 at its end
+    int32_t getBits(uint8_t count);
+
+    const uint8_t *__src;
+    size_t __src_len;
+    size_t __src_pos;
+    uint8_t __bit_mask;
+    uint8_t *__window;
+    uint32_t __window_mask;
+    uint32_t __window_pos;
+    uint8_t __window_bits;
+    uint8_t __lookahead_bits;
+    uint32_t __copy_offset;
+    uint32_t __copy_remain;
+};
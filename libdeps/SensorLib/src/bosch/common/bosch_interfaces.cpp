@@ -28,6 +28,20 @@
  *
  */
 #include "bosch_interfaces.h"
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)
+#include <esp_memory_utils.h>
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+#endif
+
+// Reads and writes up to this size are polled instead of waiting for the transfer interrupt
+#define SENSORLIB_SPI_POLLING_SIZE      32
+
+SensorTransportStats SensorInterfaces::spi_stats;
 
 #if defined(ARDUINO_ARCH_RP2040)
 SPISettings  SensorInterfaces::__spiSetting = SPISettings();
@@ -94,6 +108,7 @@ int8_t SensorInterfaces::bhy2_spi_read(uint8_t reg_addr, uint8_t *reg_data, uint
     if (!pConfig) {
         return DEV_WIRE_ERR;
     }
+    uint32_t start = micros();
     digitalWrite(pConfig->u.spi_dev.cs, LOW);
     pConfig->u.spi_dev.spi->beginTransaction(__spiSetting);
     pConfig->u.spi_dev.spi->transfer((reg_addr));
@@ -102,6 +117,9 @@ int8_t SensorInterfaces::bhy2_spi_read(uint8_t reg_addr, uint8_t *reg_data, uint
     }
     pConfig->u.spi_dev.spi->endTransaction();
     digitalWrite(pConfig->u.spi_dev.cs, HIGH);
+    spi_stats.read_bytes += length;
+    spi_stats.transactions++;
+    spi_stats.transfer_us += micros() - start;
 
     return DEV_WIRE_NONE;
 }
@@ -112,14 +130,166 @@ int8_t SensorInterfaces::bhy2_spi_write(uint8_t reg_addr, const uint8_t *reg_dat
     if (!pConfig) {
         return DEV_WIRE_ERR;
     }
+    uint32_t start = micros();
     digitalWrite(pConfig->u.spi_dev.cs, LOW);
     pConfig->u.spi_dev.spi->beginTransaction(__spiSetting);
     pConfig->u.spi_dev.spi->transfer(reg_addr);
     pConfig->u.spi_dev.spi->transfer((uint8_t *)reg_data, length);
     pConfig->u.spi_dev.spi->endTransaction();
     digitalWrite(pConfig->u.spi_dev.cs, HIGH);
+    spi_stats.write_bytes += length;
+    spi_stats.transactions++;
+    spi_stats.transfer_us += micros() - start;
+    return DEV_WIRE_NONE;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool SensorInterfaces::setup_spi_dma(SensorLibConfigure config, SensorSpiDmaDevice *device)
+{
+    if (!device->max_transfer || (device->max_transfer % 4)) {
+        log_e("max_transfer must be a non-zero multiple of 4");
+        return false;
+    }
+    if (device->freq > SENSORLIB_BHY2_SPI_MAX_FREQ) {
+        device->freq = SENSORLIB_BHY2_SPI_MAX_FREQ;
+    }
+
+    spi_bus_config_t buscfg;
+    memset(&buscfg, 0, sizeof(buscfg));
+    buscfg.mosi_io_num = config.u.spi_dev.mosi;
+    buscfg.miso_io_num = config.u.spi_dev.miso;
+    buscfg.sclk_io_num = config.u.spi_dev.sck;
+    buscfg.quadwp_io_num = -1;
+    buscfg.quadhd_io_num = -1;
+    buscfg.max_transfer_sz = device->max_transfer;
+    esp_err_t err = spi_bus_initialize(device->host, &buscfg, SPI_DMA_CH_AUTO);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        log_e("spi_bus_initialize failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    // ESP_ERR_INVALID_STATE: the bus is shared with other devices, leave it running on close
+    device->bus_owner = err == ESP_OK;
+
+    // The register address is sent in the address phase, half duplex lets the whole
+    // transaction run as one DMA transfer in either direction
+    spi_device_interface_config_t devcfg;
+    memset(&devcfg, 0, sizeof(devcfg));
+    devcfg.address_bits = 8;
+    devcfg.mode = 0;
+    devcfg.clock_speed_hz = device->freq;
+    devcfg.spics_io_num = config.u.spi_dev.cs;
+    devcfg.flags = SPI_DEVICE_HALFDUPLEX;
+    devcfg.queue_size = 1;
+    err = spi_bus_add_device(device->host, &devcfg, &device->dev);
+    if (err != ESP_OK) {
+        log_e("spi_bus_add_device failed: %s", esp_err_to_name(err));
+        close_spi_dma(device);
+        return false;
+    }
+
+    device->dma_buffer = (uint8_t *)heap_caps_malloc(device->max_transfer, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!device->dma_buffer) {
+        log_e("DMA buffer malloc failed");
+        close_spi_dma(device);
+        return false;
+    }
+    memset(&device->stats, 0, sizeof(device->stats));
+    return true;
+}
+
+void SensorInterfaces::close_spi_dma(SensorSpiDmaDevice *device)
+{
+    if (device->dev) {
+        spi_bus_remove_device(device->dev);
+        device->dev = NULL;
+    }
+    if (device->bus_owner) {
+        spi_bus_free(device->host);
+        device->bus_owner = false;
+    }
+    if (device->dma_buffer) {
+        heap_caps_free(device->dma_buffer);
+        device->dma_buffer = NULL;
+    }
+}
+
+static bool spi_dma_reachable(const void *ptr, uint32_t length)
+{
+    return esp_ptr_dma_capable(ptr) && !((uintptr_t)ptr & 3) && !(length & 3);
+}
+
+static esp_err_t spi_dma_transmit(SensorSpiDmaDevice *device, spi_transaction_t *t, uint32_t length)
+{
+    // Short register accesses are faster busy-waited than through the interrupt, long
+    // ones block this task and leave the core to others until the DMA has finished
+    if (length <= SENSORLIB_SPI_POLLING_SIZE) {
+        return spi_device_polling_transmit(device->dev, t);
+    }
+    return spi_device_transmit(device->dev, t);
+}
+
+int8_t SensorInterfaces::bhy2_spi_dma_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    SensorSpiDmaDevice *device = (SensorSpiDmaDevice *)intf_ptr;
+    if (!device || !device->dev || length > device->max_transfer) {
+        return DEV_WIRE_ERR;
+    }
+    uint32_t start = micros();
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.addr = reg_addr;
+    t.rxlength = length * 8;
+    bool direct = false;
+    if (length <= 4) {
+        t.flags = SPI_TRANS_USE_RXDATA;
+    } else {
+        direct = spi_dma_reachable(reg_data, length);
+        t.rx_buffer = direct ? reg_data : device->dma_buffer;
+    }
+    if (spi_dma_transmit(device, &t, length) != ESP_OK) {
+        return DEV_WIRE_ERR;
+    }
+    if (length <= 4) {
+        memcpy(reg_data, t.rx_data, length);
+    } else if (!direct) {
+        memcpy(reg_data, device->dma_buffer, length);
+    }
+    device->stats.read_bytes += length;
+    device->stats.transactions++;
+    device->stats.transfer_us += micros() - start;
+    return DEV_WIRE_NONE;
+}
+
+int8_t SensorInterfaces::bhy2_spi_dma_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    SensorSpiDmaDevice *device = (SensorSpiDmaDevice *)intf_ptr;
+    if (!device || !device->dev || length > device->max_transfer) {
+        return DEV_WIRE_ERR;
+    }
+    uint32_t start = micros();
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.addr = reg_addr;
+    t.length = length * 8;
+    if (length <= 4) {
+        t.flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t.tx_data, reg_data, length);
+    } else if (spi_dma_reachable(reg_data, length)) {
+        t.tx_buffer = reg_data;
+    } else {
+        // Firmware images are in flash, which the DMA cannot read
+        memcpy(device->dma_buffer, reg_data, length);
+        t.tx_buffer = device->dma_buffer;
+    }
+    if (spi_dma_transmit(device, &t, length) != ESP_OK) {
+        return DEV_WIRE_ERR;
+    }
+    device->stats.write_bytes += length;
+    device->stats.transactions++;
+    device->stats.transfer_us += micros() - start;
     return DEV_WIRE_NONE;
 }
+#endif
 
 int8_t SensorInterfaces::bhy2_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
 {
@@ -31,6 +31,35 @@
 
 #include "SensorLib.h"
 
+#if defined(ARDUINO_ARCH_ESP32)
+#include <driver/spi_master.h>
+
+// Highest SPI clock of the BHI260AP host interface
+#define SENSORLIB_BHY2_SPI_MAX_FREQ     (50 * 1000 * 1000)
+#endif
+
+typedef struct {
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    uint32_t transactions;
+    uint64_t transfer_us;       // time spent inside the read and write callbacks
+    uint32_t interrupts;        // rising edges of the interrupt pin
+    uint32_t updates;           // update() calls that drained the FIFO
+    uint64_t update_us;         // time spent draining and parsing the FIFO
+} SensorTransportStats;
+
+#if defined(ARDUINO_ARCH_ESP32)
+typedef struct {
+    spi_device_handle_t dev;
+    spi_host_device_t host;
+    uint32_t freq;
+    uint32_t max_transfer;
+    uint8_t *dma_buffer;        // word aligned internal RAM, for buffers the DMA cannot reach
+    bool bus_owner;
+    SensorTransportStats stats;
+} SensorSpiDmaDevice;
+#endif
+
 class SensorInterfaces
 {
 public:
@@ -42,19 +71,18 @@ public:
     static int8_t bhy2_i2c_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr);
     static void bhy2_delay_us(uint32_t us, void *private_data);
 
+    // Transfer counters of bhy2_spi_read and bhy2_spi_write
+    static SensorTransportStats spi_stats;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // ESP-IDF spi_device transport, bulk transfers are DMA transactions instead of
+    // one Arduino SPI.transfer() call per byte
+    static bool setup_spi_dma(SensorLibConfigure config, SensorSpiDmaDevice *device);
+    static void close_spi_dma(SensorSpiDmaDevice *device);
+    static int8_t bhy2_spi_dma_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr);
+    static int8_t bhy2_spi_dma_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length, void *intf_ptr);
+#endif
+
 private:
     static SPISettings  __spiSetting;
 };
-
-
-
-
-
-
-
-
-
-
-
-
-
@@ -0,0 +1,94 @@
+/**
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2026 lewis he
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      bosch_sample_ring.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @date      2026-10-16
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bosch_sample_ring.h"
+
+SensorSampleRing::SensorSampleRing() :
+    consumer(NULL), __buffer(NULL), __mask(0), __head(0), __tail(0), __overflows(0)
+{
+}
+
+SensorSampleRing::~SensorSampleRing()
+{
+    free(__buffer);
+}
+
+bool SensorSampleRing::begin(uint32_t depth)
+{
+    uint32_t size = 1;
+    while (size < depth) {
+        size <<= 1;
+    }
+    free(__buffer);
+    __buffer = (SensorSample *)malloc(size * sizeof(SensorSample));
+    if (!__buffer) {
+        return false;
+    }
+    __mask = size - 1;
+    __head = __tail = __overflows = 0;
+    return true;
+}
+
+bool SensorSampleRing::push(uint8_t sensor_id, const uint8_t *data, uint8_t size, uint64_t timestamp_ns)
+{
+    uint32_t head = __head;
+    if (!__buffer || size > SENSOR_SAMPLE_MAX_SIZE ||
+            head - __atomic_load_n(&__tail, __ATOMIC_ACQUIRE) > __mask) {
+        __overflows++;
+        return false;
+    }
+    SensorSample *sample = &__buffer[head & __mask];
+    sample->timestamp_ns = timestamp_ns;
+    sample->sensor_id = sensor_id;
+    sample->size = size;
+    memcpy(sample->data, data, size);
+    __atomic_store_n(&__head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t SensorSampleRing::read(SensorSample *samples, uint32_t max)
+{
+    uint32_t tail = __tail;
+    uint32_t count = __atomic_load_n(&__head, __ATOMIC_ACQUIRE) - tail;
+    if (count > max) {
+        count = max;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        samples[i] = __buffer[(tail + i) & __mask];
+    }
+    __atomic_store_n(&__tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+uint32_t SensorSampleRing::available() const
+{
+    return __atomic_load_n(&__head, __ATOMIC_ACQUIRE) - __atomic_load_n(&__tail, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,86 @@
+/**
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2026 lewis he
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      bosch_sample_ring.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Largest event payload kept in a sample, longer events are counted as overflow
+#define SENSOR_SAMPLE_MAX_SIZE          24
+
+// BHI260AP timestamps count in 1/64000 s
+#define SENSOR_TICKS_TO_NS(ticks)       ((ticks) * UINT64_C(15625))
+
+typedef struct {
+    uint64_t timestamp_ns;      // BHI260AP time of the sample
+    uint8_t sensor_id;
+    uint8_t size;               // payload bytes in data
+    uint8_t data[SENSOR_SAMPLE_MAX_SIZE];
+} SensorSample;
+
+/*
+ * Lock-free ring for one producer (the FIFO parser) and one consumer. Only the
+ * producer writes head and only the consumer writes tail, so neither side needs a lock.
+ */
+class SensorSampleRing
+{
+public:
+    SensorSampleRing();
+    ~SensorSampleRing();
+
+    // depth is rounded up to a power of two
+    bool begin(uint32_t depth);
+
+    // Producer side, counts an overflow and returns false if the ring is full
+    bool push(uint8_t sensor_id, const uint8_t *data, uint8_t size, uint64_t timestamp_ns);
+
+    // Consumer side, copies up to max samples and returns the number copied
+    uint32_t read(SensorSample *samples, uint32_t max);
+
+    uint32_t available() const;
+    uint32_t overflows() const
+    {
+        return __overflows;
+    }
+    uint32_t depth() const
+    {
+        return __mask + 1;
+    }
+
+    // Task blocked waiting for samples, woken by the producer after a FIFO drain
+    void *volatile consumer;
+
+private:
+    SensorSample *__buffer;
+    uint32_t __mask;
+    uint32_t __head;
+    uint32_t __tail;
+    uint32_t __overflows;
+};
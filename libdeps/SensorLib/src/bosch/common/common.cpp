@@ -698,6 +698,70 @@ float get_sensor_default_scaling(uint8_t sensor_id)
     return scaling;
 }
 
+uint8_t get_sensor_wakeup_id(uint8_t sensor_id)
+{
+    switch (sensor_id) {
+    case BHY2_SENSOR_ID_ACC:
+        return BHY2_SENSOR_ID_ACC_WU;
+    case BHY2_SENSOR_ID_ACC_RAW:
+        return BHY2_SENSOR_ID_ACC_RAW_WU;
+    case BHY2_SENSOR_ID_GYRO:
+        return BHY2_SENSOR_ID_GYRO_WU;
+    case BHY2_SENSOR_ID_GYRO_RAW:
+        return BHY2_SENSOR_ID_GYRO_RAW_WU;
+    case BHY2_SENSOR_ID_MAG:
+        return BHY2_SENSOR_ID_MAG_WU;
+    case BHY2_SENSOR_ID_MAG_RAW:
+        return BHY2_SENSOR_ID_MAG_RAW_WU;
+    case BHY2_SENSOR_ID_GRA:
+        return BHY2_SENSOR_ID_GRA_WU;
+    case BHY2_SENSOR_ID_LACC:
+        return BHY2_SENSOR_ID_LACC_WU;
+    case BHY2_SENSOR_ID_RV:
+        return BHY2_SENSOR_ID_RV_WU;
+    case BHY2_SENSOR_ID_GAMERV:
+        return BHY2_SENSOR_ID_GAMERV_WU;
+    case BHY2_SENSOR_ID_GEORV:
+        return BHY2_SENSOR_ID_GEORV_WU;
+    case BHY2_SENSOR_ID_ORI:
+        return BHY2_SENSOR_ID_ORI_WU;
+    case BHY2_SENSOR_ID_STC:
+        return BHY2_SENSOR_ID_STC_WU;
+    case BHY2_SENSOR_ID_DEVICE_ORI:
+        return BHY2_SENSOR_ID_DEVICE_ORI_WU;
+    case BHY2_SENSOR_ID_ACC_BIAS:
+        return BHY2_SENSOR_ID_ACC_BIAS_WU;
+    case BHY2_SENSOR_ID_GYRO_BIAS:
+        return BHY2_SENSOR_ID_GYRO_BIAS_WU;
+    case BHY2_SENSOR_ID_MAG_BIAS:
+        return BHY2_SENSOR_ID_MAG_BIAS_WU;
+    case BHY2_SENSOR_ID_STD:
+        return BHY2_SENSOR_ID_STD_WU;
+    case BHY2_SENSOR_ID_TEMP:
+        return BHY2_SENSOR_ID_TEMP_WU;
+    case BHY2_SENSOR_ID_BARO:
+        return BHY2_SENSOR_ID_BARO_WU;
+    case BHY2_SENSOR_ID_HUM:
+        return BHY2_SENSOR_ID_HUM_WU;
+    case BHY2_SENSOR_ID_GAS:
+        return BHY2_SENSOR_ID_GAS_WU;
+    case BHY2_SENSOR_ID_STC_LP:
+        return BHY2_SENSOR_ID_STC_LP_WU;
+    case BHY2_SENSOR_ID_STD_LP:
+        return BHY2_SENSOR_ID_STD_LP_WU;
+    case BHY2_SENSOR_ID_SIG_LP:
+        return BHY2_SENSOR_ID_SIG_LP_WU;
+    case BHY2_SENSOR_ID_ANY_MOTION_LP:
+        return BHY2_SENSOR_ID_ANY_MOTION_LP_WU;
+    case BHY2_SENSOR_ID_LIGHT:
+        return BHY2_SENSOR_ID_LIGHT_WU;
+    case BHY2_SENSOR_ID_PROX:
+        return BHY2_SENSOR_ID_PROX_WU;
+    default:
+        return 0;
+    }
+}
+
 const char *get_sensor_parse_format(uint8_t sensor_id)
 {
     const char *ret;
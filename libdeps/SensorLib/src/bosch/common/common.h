@@ -58,6 +58,8 @@ const char *get_api_error(int8_t error_code);
 const char *get_sensor_error_text(uint8_t sensor_error);
 const char *get_sensor_name(uint8_t sensor_id);
 float get_sensor_default_scaling(uint8_t sensor_id);
+// Wake up counterpart of a non wake up virtual sensor, 0 if there is none
+uint8_t get_sensor_wakeup_id(uint8_t sensor_id);
 const char *get_sensor_parse_format(uint8_t sensor_id);
 const char *get_sensor_axis_names(uint8_t sensor_id);
 
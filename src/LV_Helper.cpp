@@ -7,6 +7,7 @@
  *
  */
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "LV_Helper.h"
 
 
@@ -17,14 +18,95 @@
 static lv_disp_draw_buf_t draw_buf;
 static lv_disp_drv_t disp_drv;
 static lv_indev_drv_t  indev_drv;
+static lv_helper_flush_stats_t flush_stats;
+static volatile int64_t transfer_start_us;
+static volatile bool transfer_pending;
+static lv_helper_frame_cb_t frame_cb;
+static void *frame_cb_data;
 
 /* Display flushing */
 static void disp_flush( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
 {
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
+    flush_stats.flushes++;
+    flush_stats.pixels += w * h;
+    int64_t start = esp_timer_get_time();
     static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
+    // LVGL is blocked for the whole call, nothing of it overlaps with rendering
+    int64_t elapsed = esp_timer_get_time() - start;
+    flush_stats.transfer_us += elapsed;
+    flush_stats.wait_us += elapsed;
+    bool last = lv_disp_flush_is_last( disp_drv );
     lv_disp_flush_ready( disp_drv );
+    if (last && frame_cb) {
+        frame_cb(frame_cb_data);
+    }
+}
+
+/* Asynchronous display flushing, the buffer is released by disp_flush_done */
+static void disp_flush_async( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
+{
+    uint32_t w = ( area->x2 - area->x1 + 1 );
+    uint32_t h = ( area->y2 - area->y1 + 1 );
+    flush_stats.flushes++;
+    flush_stats.pixels += w * h;
+    transfer_start_us = esp_timer_get_time();
+    transfer_pending = true;
+    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
+}
+
+static void disp_flush_done(void *user_data)
+{
+    if (!transfer_pending) {
+        return;
+    }
+    transfer_pending = false;
+    flush_stats.transfer_us += esp_timer_get_time() - transfer_start_us;
+    // lv_disp_flush_ready() clears the flag
+    bool last = lv_disp_flush_is_last((lv_disp_drv_t *)user_data);
+    lv_disp_flush_ready((lv_disp_drv_t *)user_data);
+    if (last && frame_cb) {
+        frame_cb(frame_cb_data);
+    }
+}
+
+static void disp_wait(lv_disp_drv_t *disp_drv)
+{
+    int64_t start = esp_timer_get_time();
+    while (disp_drv->draw_buf->flushing) {
+    }
+    flush_stats.wait_us += esp_timer_get_time() - start;
+}
+
+static void disp_monitor(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+    (void)disp_drv;
+    (void)px;
+    flush_stats.frames++;
+    flush_stats.last_frame_ms = time;
+    flush_stats.total_frame_ms += time;
+    if (time > flush_stats.max_frame_ms) {
+        flush_stats.max_frame_ms = time;
+    }
+}
+
+void getLvglHelperFlushStats(lv_helper_flush_stats_t *stats)
+{
+    *stats = flush_stats;
+    stats->overlap_us = stats->transfer_us > stats->wait_us ? stats->transfer_us - stats->wait_us : 0;
+}
+
+void resetLvglHelperFlushStats()
+{
+    memset(&flush_stats, 0, sizeof(flush_stats));
+}
+
+void setLvglHelperFrameCallback(lv_helper_frame_cb_t cb, void *user_data)
+{
+    frame_cb = NULL;
+    frame_cb_data = user_data;
+    frame_cb = cb;
 }
 
 /*Read the touchpad*/
@@ -45,6 +127,7 @@ static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 #error "Please turn on PSRAM to QSPI !"
 #else
 static lv_color_t *buf = NULL;
+static lv_color_t *buf2 = NULL;
 #endif
 
 #if LV_USE_LOG
@@ -68,7 +151,17 @@ static void lv_rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
         area->y2++;
 }
 
-void beginLvglHelper(LilyGo_Display &board, bool debug)
+static lv_color_t *alloc_dma_buffer(size_t size)
+{
+    lv_color_t *p = (lv_color_t *)heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!p) {
+        log_w("No internal DMA memory for %zu bytes draw buffer, using PSRAM", size);
+        p = (lv_color_t *)ps_malloc(size);
+    }
+    return p;
+}
+
+void beginLvglHelper(LilyGo_Display &board, bool debug, bool async_flush)
 {
 
     lv_init();
@@ -79,25 +172,46 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
     }
 #endif
 
-    size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color_t);
-    buf = (lv_color_t *)ps_malloc(lv_buffer_size);
-    assert(buf);
+    bool full_refresh = board.needFullRefresh();
+
+    if (async_flush && !board.setFlushDoneCallback(disp_flush_done, &disp_drv)) {
+        log_w("Asynchronous flush is not supported by this board");
+        async_flush = false;
+    }
 
-    lv_disp_draw_buf_init( &draw_buf, buf, NULL, board.width() * board.height());
+    if (async_flush) {
+        // Full refresh needs whole frame buffers, otherwise a band of lines large enough
+        // for either orientation is sufficient
+        uint32_t buffer_pixels = full_refresh ? board.width() * board.height() :
+                                 max(board.width(), board.height()) * LV_HELPER_DMA_BUFFER_LINES;
+        buf = alloc_dma_buffer(buffer_pixels * sizeof(lv_color_t));
+        buf2 = alloc_dma_buffer(buffer_pixels * sizeof(lv_color_t));
+        assert(buf && buf2);
+        lv_disp_draw_buf_init( &draw_buf, buf, buf2, buffer_pixels);
+    } else {
+        size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color_t);
+        buf = (lv_color_t *)ps_malloc(lv_buffer_size);
+        assert(buf);
+        lv_disp_draw_buf_init( &draw_buf, buf, NULL, board.width() * board.height());
+    }
 
     /*Initialize the display*/
     lv_disp_drv_init( &disp_drv );
     /* display resolution */
     disp_drv.hor_res = board.width();
     disp_drv.ver_res = board.height();
-    disp_drv.flush_cb = disp_flush;
+    disp_drv.flush_cb = async_flush ? disp_flush_async : disp_flush;
+    disp_drv.monitor_cb = disp_monitor;
+    if (async_flush) {
+        disp_drv.wait_cb = disp_wait;
+    }
     disp_drv.draw_buf = &draw_buf;
-    bool full_refresh = board.needFullRefresh();
     disp_drv.full_refresh = full_refresh;
     disp_drv.user_data = &board;
-    // if (!full_refresh) {
-    // disp_drv.rounder_cb = lv_rounder_cb;
-    // }
+    if (!full_refresh) {
+        // JD9613 column and row windows must start on an even address
+        disp_drv.rounder_cb = lv_rounder_cb;
+    }
     lv_disp_drv_register( &disp_drv );
 
     // if (board.hasTouch()) {
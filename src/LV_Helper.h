@@ -11,5 +11,43 @@
 #include <lvgl.h>
 #include "LilyGo_Display.h"
 
+// Height in lines of each of the two DMA draw buffers used by the asynchronous flush
+#ifndef LV_HELPER_DMA_BUFFER_LINES
+#define LV_HELPER_DMA_BUFFER_LINES      40
+#endif
 
-void beginLvglHelper(LilyGo_Display &board, bool debug = false);
+typedef struct {
+    uint32_t frames;            // completed refresh cycles
+    uint32_t flushes;           // areas handed to the display
+    uint64_t pixels;            // pixels flushed
+    uint32_t last_frame_ms;     // render + flush time of the last refresh cycle
+    uint32_t max_frame_ms;
+    uint64_t total_frame_ms;
+    uint64_t transfer_us;       // time the display transfer was busy, in blocking mode the time pushColors took
+    uint64_t wait_us;           // time LVGL was blocked waiting for a transfer to finish
+    uint64_t overlap_us;        // transfer time hidden behind rendering, 0 in blocking mode
+} lv_helper_flush_stats_t;
+
+// Called when the last area of a refresh cycle has been sent to the display
+typedef void (*lv_helper_frame_cb_t)(void *user_data);
+
+/**
+ * @brief  Initialize lvgl and register the board as display
+ * @param  board:       display to render into
+ * @param  debug:       print lvgl log messages to Serial
+ * @param  async_flush: render into two DMA buffers and release each buffer from the
+ *                      transfer-done interrupt, so the next area is rendered while the
+ *                      previous one is still being sent. Falls back to blocking flush
+ *                      if the board does not support it.
+ */
+void beginLvglHelper(LilyGo_Display &board, bool debug = false, bool async_flush = false);
+
+void getLvglHelperFlushStats(lv_helper_flush_stats_t *stats);
+void resetLvglHelperFlushStats();
+
+/**
+ * @brief  Be told when a refresh has reached the panel, e.g. to measure the time from a
+ *         sensor sample to the frame showing it. With async_flush the callback runs in
+ *         the transfer-done interrupt and must be short. NULL removes it
+ */
+void setLvglHelperFrameCallback(lv_helper_frame_cb_t cb, void *user_data = NULL);
@@ -18,6 +18,8 @@ enum DispRotation {
 class LilyGo_Display
 {
 public:
+    typedef void (*flush_done_cb_t)(void *user_data);
+
     LilyGo_Display(): _rotation(0) {};
     virtual void setRotation(uint8_t rotation) = 0;
     virtual uint8_t getRotation() = 0;
@@ -32,8 +34,37 @@ public:
 
     virtual bool needFullRefresh() = 0;
 
+    // Restrict the display to a window of the panel, width() and height() then return the
+    // window size and pushColors(x, y, ...) is relative to the window origin.
+    // Coordinates are in the current rotation and should be even, setRotation() resets the viewport.
+    // Call before beginLvglHelper so that lvgl only renders the window.
+    void setViewport(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+        _offset_x = x;
+        _offset_y = y;
+        _viewport_width = w;
+        _viewport_height = h;
+    }
+
+    void resetViewport()
+    {
+        setViewport(0, 0, 0, 0);
+    }
+
+    // Boards whose pushColors returns before the transfer has finished report completion
+    // through this callback, it may be invoked from interrupt context.
+    // Returns false if the board only supports blocking transfers.
+    virtual bool setFlushDoneCallback(flush_done_cb_t cb, void *user_data)
+    {
+        (void)cb;
+        (void)user_data;
+        return false;
+    }
+
 protected:
     uint16_t _offset_x = 0;
     uint16_t _offset_y = 0;
+    uint16_t _viewport_width = 0;
+    uint16_t _viewport_height = 0;
     uint8_t _rotation;
 };
@@ -0,0 +1,198 @@
+/**
+ * @file      LilyGo_Runtime.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <esp_timer.h>
+#include "LilyGo_Runtime.h"
+
+static void *runtime_alloc(size_t size)
+{
+    // The channel is touched on every sample, keep it in internal RAM
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+LilyGo_Runtime::LilyGo_Runtime() :
+    _lvglLock(NULL), _uiTask(NULL), _ioTask(NULL), _msg(NULL), _uiLast(0), _ioLast(0)
+{
+    memset(&_channel, 0, sizeof(_channel));
+    memset(&_uiStats, 0, sizeof(_uiStats));
+    memset(&_ioStats, 0, sizeof(_ioStats));
+    _statsLock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+LilyGo_Runtime::~LilyGo_Runtime()
+{
+    if (_uiTask) {
+        vTaskDelete(_uiTask);
+    }
+    if (_ioTask) {
+        vTaskDelete(_ioTask);
+    }
+    if (_lvglLock) {
+        vSemaphoreDelete(_lvglLock);
+    }
+    msg_channel_deinit(&_channel);
+    free(_msg);
+}
+
+bool LilyGo_Runtime::begin(const runtime_config_t &config)
+{
+    if (_uiTask || !config.ui_period_ms || !config.io_period_ms) {
+        return false;
+    }
+    _config = config;
+
+    _lvglLock = xSemaphoreCreateRecursiveMutex();
+    if (!_lvglLock) {
+        return false;
+    }
+
+    if (_config.msg_size) {
+        if (!msg_channel_init(&_channel, _config.msg_size, _config.msg_depth, runtime_alloc)) {
+            log_e("Failed to allocate the message channel");
+            return false;
+        }
+        _msg = (uint8_t *)runtime_alloc(_config.msg_size);
+        if (!_msg) {
+            return false;
+        }
+    }
+
+    if (xTaskCreatePinnedToCore(uiTask, "ui", _config.ui_stack_size, this,
+                                _config.ui_priority, &_uiTask, _config.ui_core) != pdPASS) {
+        log_e("Failed to create the UI task");
+        return false;
+    }
+    if (_config.io_cb && xTaskCreatePinnedToCore(ioTask, "io", _config.io_stack_size, this,
+            _config.io_priority, &_ioTask, _config.io_core) != pdPASS) {
+        log_e("Failed to create the I/O task");
+        return false;
+    }
+    return true;
+}
+
+bool LilyGo_Runtime::post(const void *msg)
+{
+    if (!_msg) {
+        return false;
+    }
+    return msg_channel_push(&_channel, msg);
+}
+
+uint32_t LilyGo_Runtime::getDroppedMessages()
+{
+    return _channel.dropped;
+}
+
+bool LilyGo_Runtime::lockLvgl(uint32_t timeout_ms)
+{
+    if (!_lvglLock) {
+        return true;
+    }
+    TickType_t ticks = timeout_ms == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(_lvglLock, ticks) == pdTRUE;
+}
+
+void LilyGo_Runtime::unlockLvgl()
+{
+    if (_lvglLock) {
+        xSemaphoreGiveRecursive(_lvglLock);
+    }
+}
+
+void LilyGo_Runtime::getUiStats(runtime_task_stats_t &stats)
+{
+    portENTER_CRITICAL(&_statsLock);
+    stats = _uiStats;
+    portEXIT_CRITICAL(&_statsLock);
+}
+
+void LilyGo_Runtime::getIoStats(runtime_task_stats_t &stats)
+{
+    portENTER_CRITICAL(&_statsLock);
+    stats = _ioStats;
+    portEXIT_CRITICAL(&_statsLock);
+}
+
+void LilyGo_Runtime::resetStats()
+{
+    portENTER_CRITICAL(&_statsLock);
+    memset(&_uiStats, 0, sizeof(_uiStats));
+    memset(&_ioStats, 0, sizeof(_ioStats));
+    _uiLast = 0;
+    _ioLast = 0;
+    portEXIT_CRITICAL(&_statsLock);
+}
+
+void LilyGo_Runtime::account(runtime_task_stats_t &stats, int64_t start, int64_t end, int64_t expected, int64_t &last)
+{
+    uint32_t busy = end - start;
+    portENTER_CRITICAL(&_statsLock);
+    if (last) {
+        // Loop start to loop start, a late wake-up after a long body shows up as jitter
+        int64_t period = start - last;
+        int64_t jitter = period > expected ? period - expected : expected - period;
+        if (jitter > stats.max_jitter_us) {
+            stats.max_jitter_us = jitter;
+        }
+        stats.elapsed_us += period;
+    }
+    last = start;
+    stats.loops++;
+    stats.busy_us += busy;
+    if (busy > stats.max_busy_us) {
+        stats.max_busy_us = busy;
+    }
+    uint64_t load = stats.elapsed_us ? (stats.busy_us * 100) / stats.elapsed_us : 0;
+    stats.load = load > 100 ? 100 : load;
+    portEXIT_CRITICAL(&_statsLock);
+}
+
+void LilyGo_Runtime::uiTask(void *arg)
+{
+    LilyGo_Runtime *self = (LilyGo_Runtime *)arg;
+    const runtime_config_t &config = self->_config;
+    int64_t expected = config.ui_period_ms * 1000;
+    TickType_t wake = xTaskGetTickCount();
+
+    for (;;) {
+        int64_t start = esp_timer_get_time();
+
+        xSemaphoreTakeRecursive(self->_lvglLock, portMAX_DELAY);
+        // Drain at most one channel length, so a flooding producer cannot starve rendering
+        for (uint32_t i = 0; self->_msg && i <= self->_channel.mask; i++) {
+            if (!msg_channel_pop(&self->_channel, self->_msg)) {
+                break;
+            }
+            if (config.msg_cb) {
+                config.msg_cb(self->_msg, config.msg_user_data);
+            }
+        }
+        lv_timer_handler();
+        xSemaphoreGiveRecursive(self->_lvglLock);
+
+        int64_t end = esp_timer_get_time();
+        self->account(self->_uiStats, start, end, expected, self->_uiLast);
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(config.ui_period_ms));
+    }
+}
+
+void LilyGo_Runtime::ioTask(void *arg)
+{
+    LilyGo_Runtime *self = (LilyGo_Runtime *)arg;
+    const runtime_config_t &config = self->_config;
+    int64_t expected = config.io_period_ms * 1000;
+    TickType_t wake = xTaskGetTickCount();
+
+    for (;;) {
+        int64_t start = esp_timer_get_time();
+        config.io_cb(config.io_user_data);
+        int64_t end = esp_timer_get_time();
+        self->account(self->_ioStats, start, end, expected, self->_ioLast);
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(config.io_period_ms));
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file      LilyGo_Runtime.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "msgChannel.h"
+
+typedef void (*runtime_io_cb_t)(void *user_data);
+typedef void (*runtime_msg_cb_t)(const void *msg, void *user_data);
+
+typedef struct {
+    // I/O task, called every io_period_ms. Owns the sensor buses: amoled.update(), battery, microphone
+    runtime_io_cb_t io_cb;
+    void *io_user_data;
+    uint32_t io_period_ms;
+
+    // UI task, called with every message posted by the I/O task before lv_timer_handler
+    runtime_msg_cb_t msg_cb;
+    void *msg_user_data;
+    uint32_t msg_size;          // bytes of one message
+    uint32_t msg_depth;         // messages the channel can hold, rounded up to a power of two
+
+    uint32_t ui_period_ms;      // time between two lv_timer_handler calls
+
+    BaseType_t ui_core;
+    BaseType_t io_core;
+    uint32_t ui_stack_size;
+    uint32_t io_stack_size;
+    UBaseType_t ui_priority;
+    UBaseType_t io_priority;
+} runtime_config_t;
+
+#define RUNTIME_CONFIG_DEFAULT()    {       \
+    .io_cb = NULL,                          \
+    .io_user_data = NULL,                   \
+    .io_period_ms = 5,                      \
+    .msg_cb = NULL,                         \
+    .msg_user_data = NULL,                  \
+    .msg_size = 0,                          \
+    .msg_depth = 64,                        \
+    .ui_period_ms = 5,                      \
+    .ui_core = 1,                           \
+    .io_core = 0,                           \
+    .ui_stack_size = 8192,                  \
+    .io_stack_size = 4096,                  \
+    .ui_priority = 2,                       \
+    .io_priority = 3,                       \
+}
+
+typedef struct {
+    uint32_t loops;
+    uint64_t busy_us;           // time spent in the task body, without the delay
+    uint64_t elapsed_us;        // wall time since the stats were reset
+    uint32_t max_busy_us;
+    uint32_t max_jitter_us;     // largest deviation of a loop start from its period
+    uint8_t load;               // busy_us / elapsed_us in percent
+} runtime_task_stats_t;
+
+/*
+ * Runs LVGL on one core and the sensor I/O on the other. beginLvglHelper() must have
+ * been called before begin(). Afterwards LVGL belongs to the UI task: any other task,
+ * including setup() and loop(), must hold lockLvgl() while calling lv_* functions.
+ * Samples travel from the I/O task to the UI task through a lock-free channel, so a
+ * slow bus transfer never blocks rendering and a long render never stalls the FIFO drain.
+ */
+class LilyGo_Runtime
+{
+public:
+    LilyGo_Runtime();
+    ~LilyGo_Runtime();
+
+    bool begin(const runtime_config_t &config);
+
+    // I/O task only, returns false if the UI task has fallen behind and the channel is full
+    bool post(const void *msg);
+    uint32_t getDroppedMessages();
+
+    // Recursive, may be nested and may be called from the UI task message callback
+    bool lockLvgl(uint32_t timeout_ms = portMAX_DELAY);
+    void unlockLvgl();
+
+    void getUiStats(runtime_task_stats_t &stats);
+    void getIoStats(runtime_task_stats_t &stats);
+    void resetStats();
+
+private:
+    static void uiTask(void *arg);
+    static void ioTask(void *arg);
+    void account(runtime_task_stats_t &stats, int64_t start, int64_t end, int64_t expected, int64_t &last);
+
+    runtime_config_t _config;
+    msg_channel_t _channel;
+    SemaphoreHandle_t _lvglLock;
+    TaskHandle_t _uiTask;
+    TaskHandle_t _ioTask;
+    uint8_t *_msg;
+    portMUX_TYPE _statsLock;
+    runtime_task_stats_t _uiStats;
+    runtime_task_stats_t _ioStats;
+    int64_t _uiLast;
+    int64_t _ioLast;
+};
+
+// Holds the LVGL lock for the current scope
+class LvglLock
+{
+public:
+    LvglLock(LilyGo_Runtime &runtime) : _runtime(runtime)
+    {
+        _runtime.lockLvgl();
+    }
+    ~LvglLock()
+    {
+        _runtime.unlockLvgl();
+    }
+private:
+    LilyGo_Runtime &_runtime;
+};
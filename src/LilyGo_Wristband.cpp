@@ -16,8 +16,15 @@
 #include <hal/spi_types.h>
 #include <driver/spi_common.h>
 #include <esp_adc_cal.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <Preferences.h>
 #include "LilyGo_Wristband.h"
 #include "initSequence.h"
+#include "scanlineDelta.h"
+#include "panelIOSpi.h"
+#include "panelFlush.h"
 
 static volatile bool touchDetected;
 static void touchISR()
@@ -25,37 +32,108 @@ static void touchISR()
     touchDetected = true;
 }
 
+// Panel state kept over deep sleep, valid when the panel was put into sleep-in by sleep()
+#define JD9613_SLEEP_MAGIC      0x4A443936
+typedef struct {
+    uint32_t magic;
+    uint8_t rotation;
+    uint8_t brightness;
+    bool flipHorizontal;
+} jd9613_sleep_state_t;
+RTC_DATA_ATTR static jd9613_sleep_state_t sleepState;
+
+// NVS entry with the SensorFlashRecord of the BHI260AP flash
+#define BHI_FLASH_NVS_NAMESPACE     "bhi260ap"
+#define BHI_FLASH_NVS_KEY           "flash"
+// NVS entry with the BSX calibration state, see SensorBHI260AP::saveCalibration()
+#define BHI_CALIB_NVS_KEY           "calib"
+// How often update() looks for a calibration worth saving, and the longest time a fully
+// calibrated state goes unsaved. Unchanged states are not written again
+#define BHI_CALIB_CHECK_MS          1000
+#define BHI_CALIB_SAVE_PERIOD_MS    (10 * 60 * 1000UL)
+
+static uint32_t calibHash(const uint8_t *data, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+static LilyGo_Display::flush_done_cb_t flushDoneCallback;
+static void *flushDoneUserData;
+// esp_timer time of the last panel reset or warm resume
+static int64_t panelStartUs;
+// Microseconds from panelStartUs until the first flush left the bus, 0 before
+static volatile uint32_t firstFrameUs;
+static bool colorTransDoneISR(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    if (!firstFrameUs) {
+        int64_t elapsed = esp_timer_get_time() - panelStartUs;
+        firstFrameUs = elapsed > 0 ? (uint32_t)elapsed : 1;
+    }
+    if (flushDoneCallback) {
+        flushDoneCallback(flushDoneUserData);
+    }
+    return false;
+}
+
 
 __BEGIN_DECLS
 
 
 #define BOARD_DISP_HOST     SPI3_HOST
+#define BOARD_BHI_HOST      SPI2_HOST
 
 #define TAG  "jd9613"
 
+// Rotation 1 and 3 are turned by the CPU, the panel has only half the RAM to swap axes
+#ifdef SW_ROTATION
+#define JD9613_SW_ROTATION  true
+#else
+#define JD9613_SW_ROTATION  false
+#endif
+
+// Command list transport over the esp_lcd panel IO, for an IO that can only send one command at a time
+typedef struct {
+    panel_cmd_io_t base;
+    esp_lcd_panel_io_handle_t io;
+} panel_io_lcd_t;
+
 typedef struct {
     esp_lcd_panel_t base;
     esp_lcd_panel_io_handle_t io;
+    panel_cmd_io_t *cmd_io;         // NULL when the IO can only send one command at a time
+    panel_io_lcd_t lcd_io;          // used by the flush path when cmd_io is NULL
+    panel_flush_t flush;            // rotation, pixel format, frame and delta buffers
+    panel_cmd_list_t window;        // set by setAddrWindow, sent ahead of the next pushColors
     int reset_gpio_num;
     bool reset_level;
-    uint8_t rotation;
-    uint16_t *frame_buffer;
     uint16_t width;
     uint16_t height;
     bool flipHorizontal;
+    bool fast_boot;
 } jd9613_panel_t;
 
 static esp_err_t panel_jd9613_del(esp_lcd_panel_t *panel);
 static esp_err_t panel_jd9613_reset(esp_lcd_panel_t *panel);
 static esp_err_t panel_jd9613_init(esp_lcd_panel_t *panel);
+static esp_err_t panel_jd9613_fast_init(esp_lcd_panel_t *panel);
 static esp_err_t panel_jd9613_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data);
 static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r);
+static bool panel_jd9613_set_delta(jd9613_panel_t *jd9613, bool enable);
+static esp_err_t panel_jd9613_resume(esp_lcd_panel_t *panel, uint8_t rotation, bool flipHorizontal);
+static void panel_jd9613_set_pixel_format(jd9613_panel_t *jd9613);
+static void panel_io_lcd_init(panel_io_lcd_t *lcd, esp_lcd_panel_io_handle_t io);
+static void panel_jd9613_mark_start(void);
 
 
 static esp_err_t esp_lcd_new_panel_jd9613(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
 {
     esp_err_t ret = ESP_OK;
     jd9613_panel_t *jd9613 = NULL;
+    uint16_t *frame_buffer = NULL;
 
     ESP_GOTO_ON_FALSE(io && panel_dev_config && ret_panel, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
 
@@ -64,8 +142,8 @@ static esp_err_t esp_lcd_new_panel_jd9613(const esp_lcd_panel_io_handle_t io, co
     ESP_GOTO_ON_FALSE(jd9613, ESP_ERR_NO_MEM, err, TAG, "no mem for jd9613 panel");
 
 
-    jd9613->frame_buffer = (uint16_t *)heap_caps_malloc(JD9613_WIDTH * JD9613_HEIGHT * 2, MALLOC_CAP_DMA);
-    if (!jd9613->frame_buffer) {
+    frame_buffer = (uint16_t *)heap_caps_malloc(JD9613_WIDTH * JD9613_HEIGHT * 2, MALLOC_CAP_DMA);
+    if (!frame_buffer) {
         free(jd9613);
         return ESP_FAIL;
     }
@@ -78,12 +156,18 @@ static esp_err_t esp_lcd_new_panel_jd9613(const esp_lcd_panel_io_handle_t io, co
     case 16: // RGB565
         // fb_bits_per_pixel = 16;
         break;
+    case 12: // RGB444, converted from RGB565 when flushing
+        break;
     default:
         ESP_GOTO_ON_FALSE(false, ESP_ERR_NOT_SUPPORTED, err, TAG, "unsupported pixel width");
         break;
     }
 
     jd9613->io = io;
+    jd9613->cmd_io = (panel_cmd_io_t *)panel_dev_config->vendor_config;
+    panel_io_lcd_init(&jd9613->lcd_io, io);
+    panel_flush_init(&jd9613->flush, jd9613->cmd_io ? jd9613->cmd_io : &jd9613->lcd_io.base,
+                     frame_buffer, panel_dev_config->bits_per_pixel, JD9613_SW_ROTATION);
     // jd9613->fb_bits_per_pixel = fb_bits_per_pixel;
     jd9613->reset_gpio_num = panel_dev_config->reset_gpio_num;
     jd9613->reset_level = panel_dev_config->flags.reset_active_high;
@@ -113,6 +197,7 @@ err:
         }
         free(jd9613);
     }
+    free(frame_buffer);
     return ret;
 }
 
@@ -125,8 +210,9 @@ static esp_err_t panel_jd9613_del(esp_lcd_panel_t *panel)
         pinMode(jd9613->reset_gpio_num, OPEN_DRAIN);
     }
     log_d("del jd9613 panel @%p", jd9613);
+    panel_jd9613_set_delta(jd9613, false);
+    free(jd9613->flush.frame_buffer);
     free(jd9613);
-    free(jd9613->frame_buffer);
     return ESP_OK;
 }
 
@@ -136,14 +222,22 @@ static esp_err_t panel_jd9613_reset(esp_lcd_panel_t *panel)
     esp_lcd_panel_io_handle_t io = jd9613->io;
 
     // perform hardware reset
-    if (jd9613->reset_gpio_num >= 0) {
+    if (jd9613->reset_gpio_num >= 0 && jd9613->fast_boot) {
+        digitalWrite(jd9613->reset_gpio_num, jd9613->reset_level);
+        delay(JD9613_RESET_PULSE_MS);
+        digitalWrite(jd9613->reset_gpio_num, !jd9613->reset_level);
+        panel_jd9613_mark_start();
+        delay(JD9613_RESET_WAIT_MS);
+    } else if (jd9613->reset_gpio_num >= 0) {
         digitalWrite(jd9613->reset_gpio_num, jd9613->reset_level);
         delay((100));
         digitalWrite(jd9613->reset_gpio_num, !jd9613->reset_level);
+        panel_jd9613_mark_start();
         delay((100));
     } else {
         // perform software reset
         esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, NULL, 0);
+        panel_jd9613_mark_start();
         delay((20)); // spec, wait at least 5ms before sending new command
     }
 
@@ -156,6 +250,10 @@ static esp_err_t panel_jd9613_init(esp_lcd_panel_t *panel)
     jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
     esp_lcd_panel_io_handle_t io = jd9613->io;
 
+    if (jd9613->fast_boot) {
+        return panel_jd9613_fast_init(panel);
+    }
+
     // vendor specific initialization, it can be different between manufacturers
     // should consult the LCD supplier for initialization sequence code
     int cmd = 0;
@@ -163,12 +261,12 @@ static esp_err_t panel_jd9613_init(esp_lcd_panel_t *panel)
         esp_lcd_panel_io_tx_param(io, jd9613_cmd[cmd].addr, jd9613_cmd[cmd].param, (jd9613_cmd[cmd].len - 1) & 0x1F);
         cmd++;
     }
+    panel_jd9613_set_pixel_format(jd9613);
 
     // jd9613->flipHorizontal = 1;
     jd9613->flipHorizontal = 0;
-    jd9613->rotation = 1;
 
-    panel_jd9613_set_rotation(panel, jd9613->rotation);
+    panel_jd9613_set_rotation(panel, 1);
 
     esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
     delay((120));
@@ -179,68 +277,142 @@ static esp_err_t panel_jd9613_init(esp_lcd_panel_t *panel)
     return ESP_OK;
 }
 
-static esp_err_t panel_jd9613_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+// Same sequence as panel_jd9613_init, sent as one queued batch with the datasheet minimum delays
+static esp_err_t panel_jd9613_fast_init(esp_lcd_panel_t *panel)
 {
     jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
-    assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
     esp_lcd_panel_io_handle_t io = jd9613->io;
 
-    uint32_t width = x_start + x_end;
-    uint32_t height = y_start + y_end;
-    uint32_t _x = x_start,
-             _y = y_start,
-             _xe = width,
-             _ye = height;
-    size_t write_colors_bytes = width * height * sizeof(uint16_t);
-    uint16_t *data_ptr = (uint16_t *)color_data;
+    if (jd9613->cmd_io) {
+        // The table lives in flash, DMA reads it from the frame buffer that is not used yet
+        memcpy(jd9613->flush.frame_buffer, jd9613_init_stream, JD9613_INIT_STREAM_SIZE);
+        jd9613->cmd_io->tx_stream(jd9613->cmd_io, (const uint8_t *)jd9613->flush.frame_buffer, JD9613_INIT_STREAM_SIZE);
+        jd9613->cmd_io->wait(jd9613->cmd_io);
+    } else {
+        for (size_t pos = 0; pos < JD9613_INIT_STREAM_SIZE; pos += 2 + jd9613_init_stream[pos + 1]) {
+            esp_lcd_panel_io_tx_param(io, jd9613_init_stream[pos], &jd9613_init_stream[pos + 2], jd9613_init_stream[pos + 1]);
+        }
+    }
+    panel_jd9613_set_pixel_format(jd9613);
 
-    // log_i("%s W:%lu H:%lu B:%lu\n", __func__, width, height, write_colors_bytes);
+    jd9613->flipHorizontal = 0;
 
-#ifdef SW_ROTATION
-    bool sw_rotation = false;
-    switch (jd9613->rotation) {
-    case 1:
-    case 3:
-        sw_rotation = true;
-        break;
-    default:
-        sw_rotation = false;
-        break;
+    panel_jd9613_set_rotation(panel, 1);
+
+    // The panel is in sleep-in after power on and after sleep(), otherwise the reset
+    // happened in sleep-out and SLPOUT has to wait longer
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (reason != ESP_RST_POWERON && reason != ESP_RST_DEEPSLEEP) {
+        int64_t elapsed_ms = (esp_timer_get_time() - panelStartUs) / 1000;
+        if (elapsed_ms < JD9613_RESET_SLPOUT_MS) {
+            delay(JD9613_RESET_SLPOUT_MS - elapsed_ms);
+        }
     }
 
-    if (sw_rotation) {
-        _x = JD9613_WIDTH - (y_start + height);
-        _y = x_start;
-        _xe = height;
-        _ye = width;
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
+    delay(JD9613_SLPOUT_WAIT_MS);
+
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_DISPON, NULL, 0);
+
+    return ESP_OK;
+}
+
+// The panel kept its registers and memory in sleep-in, only leave sleep mode
+static esp_err_t panel_jd9613_resume(esp_lcd_panel_t *panel, uint8_t rotation, bool flipHorizontal)
+{
+    jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
+    esp_lcd_panel_io_handle_t io = jd9613->io;
+
+    panel_jd9613_mark_start();
+
+    // Reset was held inactive during deep sleep, keep it inactive when releasing the pad
+    if (jd9613->reset_gpio_num >= 0) {
+        digitalWrite(jd9613->reset_gpio_num, !jd9613->reset_level);
+        gpio_hold_dis((gpio_num_t)jd9613->reset_gpio_num);
     }
-#endif
 
-    // Direction 2 requires offset pixels
-    if (jd9613->rotation == 2) {
-        _x += 2;
-        _xe += 2;
+    jd9613->flipHorizontal = flipHorizontal;
+    panel_jd9613_set_rotation(panel, rotation);
+    // The format kept by the panel may differ from the one requested now
+    panel_jd9613_set_pixel_format(jd9613);
+
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
+    delay(JD9613_SLPOUT_WAIT_MS);
+
+    return ESP_OK;
+}
+
+static void panel_jd9613_set_pixel_format(jd9613_panel_t *jd9613)
+{
+    uint8_t colmod = jd9613->flush.bits_per_pixel == 12 ? 0x33 : 0x55;
+    esp_lcd_panel_io_tx_param(jd9613->io, LCD_CMD_COLMOD, &colmod, 1);
+}
+
+// The first frame time is measured from here
+static void panel_jd9613_mark_start(void)
+{
+    panelStartUs = esp_timer_get_time();
+    firstFrameUs = 0;
+}
+
+static esp_err_t panel_jd9613_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
+    panel_flush_draw(&jd9613->flush, x_start, y_start, x_end, y_end, (const uint16_t *)color_data);
+    return ESP_OK;
+}
+
+static void *panel_jd9613_dma_malloc(size_t size)
+{
+    return heap_caps_malloc(size, MALLOC_CAP_DMA);
+}
+
+static bool panel_jd9613_set_delta(jd9613_panel_t *jd9613, bool enable)
+{
+    if (!panel_flush_set_delta(&jd9613->flush, enable, panel_jd9613_dma_malloc, ps_malloc)) {
+        log_e("no mem for delta transmission");
+        return false;
     }
+    return true;
+}
 
-    uint8_t data1[] = {lowByte(_x >> 8), lowByte(_x), lowByte((_xe - 1) >> 8), lowByte(_xe - 1)};
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, data1, 4);
-    uint8_t data2[] = {lowByte(_y >> 8), lowByte(_y), lowByte((_ye - 1) >> 8), lowByte(_ye - 1)};
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, data2, 4);
+static bool panel_io_lcd_tx_list(panel_cmd_io_t *io, const panel_cmd_list_t *list, const void *color, size_t color_size, bool notify)
+{
+    panel_io_lcd_t *lcd = (panel_io_lcd_t *)io;
+    for (uint8_t i = 0; i < list->count; i++) {
+        esp_lcd_panel_io_tx_param(lcd->io, list->cmds[i].cmd, list->cmds[i].param, list->cmds[i].len);
+    }
+    if (color_size) {
+        esp_lcd_panel_io_tx_color(lcd->io, LCD_CMD_RAMWR, color, color_size);
+    }
+    return true;
+}
 
-#ifdef SW_ROTATION
-    if (sw_rotation) {
-        int index = 0;
-        uint16_t *pdat = (uint16_t *)color_data;
-        for (uint16_t j = 0; j < width; j++) {
-            for (uint16_t i = 0; i < height; i++) {
-                jd9613->frame_buffer[index++] = pdat[width * (height - i - 1) + j];
-            }
-        }
-        data_ptr = jd9613->frame_buffer;
+static bool panel_io_lcd_tx_stream(panel_cmd_io_t *io, const uint8_t *stream, size_t size)
+{
+    panel_io_lcd_t *lcd = (panel_io_lcd_t *)io;
+    size_t pos = 0;
+    while (pos + 2 <= size) {
+        esp_lcd_panel_io_tx_param(lcd->io, stream[pos], &stream[pos + 2], stream[pos + 1]);
+        pos += 2 + stream[pos + 1];
     }
-#endif
-    esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, data_ptr, write_colors_bytes);
-    return ESP_OK;
+    return pos == size;
+}
+
+// A polling command returns once the queued pixels have been sent
+static void panel_io_lcd_wait(panel_cmd_io_t *io)
+{
+    panel_io_lcd_t *lcd = (panel_io_lcd_t *)io;
+    esp_lcd_panel_io_tx_param(lcd->io, LCD_CMD_NOP, NULL, 0);
+}
+
+static void panel_io_lcd_init(panel_io_lcd_t *lcd, esp_lcd_panel_io_handle_t io)
+{
+    memset(lcd, 0, sizeof(panel_io_lcd_t));
+    lcd->base.tx_list = panel_io_lcd_tx_list;
+    lcd->base.tx_stream = panel_io_lcd_tx_stream;
+    lcd->base.wait = panel_io_lcd_wait;
+    lcd->io = io;
 }
 
 #define  LCD_CMD_RGB 0x00
@@ -298,9 +470,10 @@ static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r)
         write_data |= (0x01 << 1); //Flip Horizontal
     }
     // write_data |= 0x01; //Flip Vertical
-    jd9613->rotation = r;
     log_i("set_rotation:%d write reg :0x%X , data : 0x%X Width:%d Height:%d", r, LCD_CMD_MADCTL, write_data, jd9613->width, jd9613->height);
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, &write_data, 1);
+    // The address mapping changed, the shadow no longer matches the panel memory
+    panel_flush_set_rotation(&jd9613->flush, r);
     return ESP_OK;
 #else
     jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
@@ -330,9 +503,9 @@ static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r)
     }
     write_data |= (0x01 << 1); //Flip Horizontal
     // write_data |= 0x01; //Flip Vertical
-    jd9613->rotation = r;
     log_i("set_rotation:%d write reg :0x%X , data : 0x%X Width:%d Height:%d", r, LCD_CMD_MADCTL, write_data, jd9613->width, jd9613->height);
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, &write_data, 1);
+    panel_flush_set_rotation(&jd9613->flush, r);
     return ESP_OK;
 #endif
 }
@@ -343,7 +516,7 @@ static bool touchPadReadFunction()
     return touchInterruptGetLastStatus(BOARD_TOUCH_BUTTON) == 0;
 }
 
-LilyGo_Wristband::LilyGo_Wristband(): _brightness(AMOLED_DEFAULT_BRIGHTNESS), panel_handle(NULL), threshold(2000)
+LilyGo_Wristband::LilyGo_Wristband(): _brightness(AMOLED_DEFAULT_BRIGHTNESS), panel_handle(NULL), threshold(2000), _fullRefresh(false), _fastBoot(false), _warmResumed(false), _colorBits(16), _sensorFlashImage(NULL), _sensorFlashImageLen(0), _sensorCalibStore(true), _sensorCalibHash(0), _sensorCalibCheckMs(0)
 {
 }
 
@@ -378,12 +551,18 @@ bool LilyGo_Wristband::isPressed()
     return touchInterruptGetLastStatus(BOARD_TOUCH_BUTTON);
 }
 
-bool LilyGo_Wristband::begin()
+bool LilyGo_Wristband::begin(uint8_t colorBits)
 {
     if (panel_handle) {
         return true;
     }
 
+    if (colorBits != 16 && colorBits != 12) {
+        log_e("Unsupported color depth %u", colorBits);
+        return false;
+    }
+    _colorBits = colorBits;
+
     // Initialize display
     initBUS();
 
@@ -408,9 +587,36 @@ bool LilyGo_Wristband::begin()
 
     // Initialize Sensor
     SensorBHI260AP::setPins(BOARD_BHI_RST, BOARD_BHI_IRQ);
+#if BOARD_BHI_SPI_DMA
+    // The BHI260AP has the FSPI bus to itself, drain the FIFO with DMA transactions
+    SensorBHI260AP::setSpiDma(BOARD_BHI_HOST, BOARD_BHI_SPI_FREQ, BOARD_BHI_MAX_TRANSFER);
+#endif
+    Preferences prefs;
+    SensorFlashRecord flashRecord = {};
+    bool flashBoot = _sensorFlashImage && prefs.begin(BHI_FLASH_NVS_NAMESPACE, false);
+    if (flashBoot) {
+        SensorBHI260AP::setFirmware(_sensorFlashImage, _sensorFlashImageLen, true);
+        if (prefs.getBytes(BHI_FLASH_NVS_KEY, &flashRecord, sizeof(flashRecord)) == sizeof(flashRecord)) {
+            SensorBHI260AP::setFlashRecord(flashRecord);
+        }
+    }
     result = SensorBHI260AP::init(SPI, BOARD_BHI_CS, BOARD_BHI_MOSI, BOARD_BHI_MISO, BOARD_BHI_SCK);
     if (!result) {
         log_e("Motion sensor initialization failed!");
+    } else {
+        log_i("Motion sensor firmware running after %lu us, boot path %d",
+              (unsigned long)SensorBHI260AP::getBootTime(), SensorBHI260AP::getBootPath());
+        // Written once, later boots skip the upload
+        const SensorFlashRecord &written = SensorBHI260AP::getFlashRecord();
+        if (flashBoot && memcmp(&written, &flashRecord, sizeof(flashRecord))) {
+            prefs.putBytes(BHI_FLASH_NVS_KEY, &written, sizeof(written));
+        }
+    }
+    if (flashBoot) {
+        prefs.end();
+    }
+    if (result && _sensorCalibStore) {
+        restoreSensorCalibration();
     }
 
     return true;
@@ -420,6 +626,58 @@ void LilyGo_Wristband::update()
 {
     SensorBHI260AP::update();
     LilyGo_Button::update();
+
+    if (_sensorCalibStore && millis() - _sensorCalibCheckMs >= BHI_CALIB_CHECK_MS) {
+        _sensorCalibCheckMs = millis();
+        if (SensorBHI260AP::calibrationDue(BHI_CALIB_SAVE_PERIOD_MS)) {
+            saveSensorCalibration();
+        }
+    }
+}
+
+// Right after the firmware booted, before any sensor runs
+bool LilyGo_Wristband::restoreSensorCalibration()
+{
+    Preferences prefs;
+    if (!prefs.begin(BHI_FLASH_NVS_NAMESPACE, true)) {
+        return false;
+    }
+    size_t len = prefs.getBytesLength(BHI_CALIB_NVS_KEY);
+    uint8_t *state = len && len <= SENSOR_CALIB_STATE_MAX ? (uint8_t *)malloc(len) : NULL;
+    bool result = false;
+    if (state && prefs.getBytes(BHI_CALIB_NVS_KEY, state, len) == len) {
+        result = SensorBHI260AP::restoreCalibration(state, len);
+        if (result) {
+            _sensorCalibHash = calibHash(state, len);
+        }
+        log_i("Motion sensor calibration of %u bytes %s", (unsigned)len, result ? "restored" : "rejected");
+    }
+    free(state);
+    prefs.end();
+    return result;
+}
+
+bool LilyGo_Wristband::saveSensorCalibration()
+{
+    uint8_t *state = (uint8_t *)malloc(SENSOR_CALIB_STATE_MAX);
+    if (!state) {
+        return false;
+    }
+    size_t len = SensorBHI260AP::saveCalibration(state, SENSOR_CALIB_STATE_MAX);
+    bool result = len > 0;
+    uint32_t hash = calibHash(state, len);
+    // Spare the flash, the state only changes while the fusion still learns
+    if (result && hash != _sensorCalibHash) {
+        Preferences prefs;
+        result = prefs.begin(BHI_FLASH_NVS_NAMESPACE, false) && prefs.putBytes(BHI_CALIB_NVS_KEY, state, len) == len;
+        prefs.end();
+        if (result) {
+            _sensorCalibHash = hash;
+            log_i("Motion sensor calibration of %u bytes saved", (unsigned)len);
+        }
+    }
+    free(state);
+    return result;
 }
 
 void LilyGo_Wristband::attachRTC(void (*rtc_alarm_cb)(void *arg), void *arg)
@@ -429,8 +687,13 @@ void LilyGo_Wristband::attachRTC(void (*rtc_alarm_cb)(void *arg), void *arg)
 
 void LilyGo_Wristband::setBrightness(uint8_t level)
 {
-    lcd_cmd_t t = {0x51, {level}, 1};
-    writeCommand(t.addr, t.param, t.len);
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    panel_cmd_list_t list;
+    panel_cmd_list_clear(&list);
+    panel_cmd_list_add(&list, 0x51, &level, 1);
+    // Queued behind any pending pixels, does not wait for the bus
+    panel_flush_submit(&jd9613->flush, &list, NULL, 0, false);
     _brightness = level;
 }
 
@@ -442,6 +705,7 @@ uint8_t LilyGo_Wristband::getBrightness()
 void LilyGo_Wristband::setRotation(uint8_t rotation)
 {
     assert(panel_handle);
+    resetViewport();
     panel_jd9613_set_rotation(panel_handle, rotation);
 }
 
@@ -449,17 +713,20 @@ uint8_t LilyGo_Wristband::getRotation()
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
-    return (jd9613->rotation);
+    return (jd9613->flush.rotation);
 }
 
 void LilyGo_Wristband::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t w, uint16_t h)
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
-    uint8_t data1[] = {lowByte(xs >> 8), lowByte(xs), lowByte((xs + w - 1) >> 8), lowByte(xs + w - 1)};
-    esp_lcd_panel_io_tx_param(jd9613->io, LCD_CMD_CASET, data1, 4);
-    uint8_t data2[] = {lowByte(ys >> 8), lowByte(ys), lowByte((ys + h - 1) >> 8), lowByte(ys + h - 1)};
-    esp_lcd_panel_io_tx_param(jd9613->io, LCD_CMD_RASET, data2, 4);
+    // Raw writes bypass the delta shadow
+    if (jd9613->flush.delta) {
+        scanline_delta_invalidate(jd9613->flush.delta);
+    }
+    // Sent together with the pixels of the next pushColors
+    panel_cmd_list_clear(&jd9613->window);
+    panel_cmd_list_add_window(&jd9613->window, xs, ys, xs + w, ys + h);
 }
 
 void LilyGo_Wristband::flipHorizontal(bool enable)
@@ -467,20 +734,99 @@ void LilyGo_Wristband::flipHorizontal(bool enable)
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
     jd9613->flipHorizontal = enable;
-    panel_jd9613_set_rotation(panel_handle, jd9613->rotation);
+    panel_jd9613_set_rotation(panel_handle, jd9613->flush.rotation);
 }
 
 void LilyGo_Wristband::pushColors(uint16_t *data, uint32_t len)
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
-    esp_lcd_panel_io_tx_color(jd9613->io, LCD_CMD_RAMWR, data, len);
+    panel_flush_submit(&jd9613->flush, &jd9613->window, data, len, true);
+    panel_cmd_list_clear(&jd9613->window);
 }
 
 void LilyGo_Wristband::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
 {
     assert(panel_handle);
-    esp_lcd_panel_draw_bitmap(panel_handle, x, y, width, height, data);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    x += _offset_x;
+    y += _offset_y;
+    esp_lcd_panel_draw_bitmap(panel_handle, x, y, x + width, y + height, data);
+    // Nothing was sent, so no transfer-done interrupt will follow
+    if (!jd9613->flush.transmitted && flushDoneCallback) {
+        flushDoneCallback(flushDoneUserData);
+    }
+}
+
+bool LilyGo_Wristband::setDeltaFlush(bool enable)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    return panel_jd9613_set_delta(jd9613, enable);
+}
+
+void LilyGo_Wristband::setFastBoot(bool enable)
+{
+    _fastBoot = enable;
+}
+
+bool LilyGo_Wristband::isWarmResumed()
+{
+    return _warmResumed;
+}
+
+void LilyGo_Wristband::setSensorCalibrationStore(bool enable)
+{
+    _sensorCalibStore = enable;
+}
+
+bool LilyGo_Wristband::beginOrientation(orientation_backend_t backend, float rate_hz)
+{
+    return _orientation.begin(*this, backend, rate_hz);
+}
+
+void LilyGo_Wristband::endOrientation()
+{
+    _orientation.end();
+}
+
+OrientationProvider &LilyGo_Wristband::orientation()
+{
+    return _orientation;
+}
+
+void LilyGo_Wristband::setSensorFlashFirmware(const uint8_t *image, size_t image_len)
+{
+    _sensorFlashImage = image;
+    _sensorFlashImageLen = image_len;
+}
+
+uint32_t LilyGo_Wristband::getFirstFrameTime()
+{
+    assert(panel_handle);
+    return firstFrameUs;
+}
+
+bool LilyGo_Wristband::getPanelIOStats(panel_io_stats_t &stats)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    if (!jd9613->cmd_io) {
+        return false;
+    }
+    stats = jd9613->cmd_io->stats;
+    return true;
+}
+
+bool LilyGo_Wristband::getDeltaFlushStats(scanline_delta_stats_t &stats)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    if (!jd9613->flush.delta) {
+        return false;
+    }
+    stats = jd9613->flush.delta->stats;
+    return true;
 }
 
 bool LilyGo_Wristband::initBUS()
@@ -507,31 +853,17 @@ bool LilyGo_Wristband::initBUS()
 
     log_i( "Install panel IO");
     esp_lcd_panel_io_handle_t io_handle = NULL;
-    esp_lcd_panel_io_spi_config_t io_config;
+    panel_io_spi_config_t io_config;
     io_config.cs_gpio_num = BOARD_DISP_CS;
     io_config.dc_gpio_num = BOARD_DISP_DC;
     io_config.spi_mode = 0;
     io_config.pclk_hz = DEFAULT_SCK_SPEED;
-    io_config.trans_queue_depth = 10;
-    io_config.on_color_trans_done = NULL;
+    io_config.trans_queue_depth = 32;
+    io_config.max_transfer_sz = buscfg.max_transfer_sz;
+    io_config.on_color_trans_done = colorTransDoneISR;
     io_config.user_ctx = NULL;
-    io_config.lcd_cmd_bits = 8;
-    io_config.lcd_param_bits = 8;
-
-    io_config.flags.dc_low_on_data = 0;
-    io_config.flags.octal_mode = 0;
-    io_config.flags.lsb_first = 0;
-
-#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)
-    io_config.flags.quad_mode = 0;
-    io_config.flags.sio_mode = 0;
-    io_config.flags.cs_high_active = 0;
-#else
-    io_config.flags.dc_as_cmd_phase = 0;
-#endif
 
-
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)BOARD_DISP_HOST, &io_config, &io_handle));
+    ESP_ERROR_CHECK(panel_io_spi_new(BOARD_DISP_HOST, &io_config, &io_handle));
 
 
     esp_lcd_panel_dev_config_t panel_config;
@@ -541,13 +873,28 @@ bool LilyGo_Wristband::initBUS()
 #else
     panel_config.color_space = LCD_RGB_ELEMENT_ORDER_RGB;
 #endif
-    panel_config.bits_per_pixel = 16;
+    panel_config.bits_per_pixel = _colorBits;
     panel_config.flags.reset_active_high = 0;
-    panel_config.vendor_config = NULL;
+    // Lets the panel driver queue window setup and pixels as one batch
+    panel_config.vendor_config = panel_io_spi_get_cmd_io(io_handle);
 
     log_i( "Install JD9613 panel driver");
     ESP_ERROR_CHECK(esp_lcd_new_panel_jd9613(io_handle, &panel_config, &panel_handle));
 
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    jd9613->fast_boot = _fastBoot;
+
+    _warmResumed = _fastBoot && sleepState.magic == JD9613_SLEEP_MAGIC &&
+                   esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED;
+    sleepState.magic = 0;
+
+    if (_warmResumed) {
+        log_i( "Resume JD9613 panel from sleep-in");
+        _brightness = sleepState.brightness;
+        ESP_ERROR_CHECK(panel_jd9613_resume(panel_handle, sleepState.rotation, sleepState.flipHorizontal));
+        return true;
+    }
+
     ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
 
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
@@ -573,6 +920,17 @@ void LilyGo_Wristband::sleep()
     lcd_cmd_t t = {0x10, {0x00}, 1}; //Sleep in
     writeCommand(t.addr, t.param, t.len);
 
+    if (_fastBoot && panel_handle) {
+        jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+        sleepState.rotation = jd9613->flush.rotation;
+        sleepState.flipHorizontal = jd9613->flipHorizontal;
+        sleepState.brightness = _brightness;
+        sleepState.magic = JD9613_SLEEP_MAGIC;
+        // Without hold the reset pad floats in deep sleep and the panel loses its state
+        gpio_hold_en((gpio_num_t)BOARD_DISP_RST);
+        gpio_deep_sleep_hold_en();
+    }
+
     detachInterrupt(BOARD_RTC_IRQ);
 
     Wire.end();
@@ -591,8 +949,11 @@ uint16_t  LilyGo_Wristband::width()
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
 
+    if (_viewport_width) {
+        return _viewport_width;
+    }
 #ifdef SW_ROTATION
-    switch (jd9613->rotation) {
+    switch (jd9613->flush.rotation) {
     case 1:
     case 3:
         return jd9613->height;
@@ -608,8 +969,12 @@ uint16_t  LilyGo_Wristband::height()
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+
+    if (_viewport_height) {
+        return _viewport_height;
+    }
 #ifdef SW_ROTATION
-    switch (jd9613->rotation) {
+    switch (jd9613->flush.rotation) {
     case 1:
     case 3:
         return jd9613->width;
@@ -665,8 +1030,20 @@ void LilyGo_Wristband::vibration(uint8_t duty, uint32_t delay_ms)
     tone(BOARD_VIBRATION_PIN, 1000, delay_ms);
 }
 
+void LilyGo_Wristband::setFullRefresh(bool enable)
+{
+    _fullRefresh = enable;
+}
+
 bool LilyGo_Wristband::needFullRefresh()
 {
+    return _fullRefresh;
+}
+
+bool LilyGo_Wristband::setFlushDoneCallback(flush_done_cb_t cb, void *user_data)
+{
+    flushDoneUserData = user_data;
+    flushDoneCallback = cb;
     return true;
 }
 
@@ -16,6 +16,9 @@
 #include <esp_lcd_types.h>
 #include "LilyGo_Display.h"
 #include "LilyGo_Button.h"
+#include "scanlineDelta.h"
+#include "panelCmdList.h"
+#include "orientationProvider.h"
 #include <driver/i2s.h>
 
 #if ARDUINO_USB_CDC_ON_BOOT != 1
@@ -52,6 +55,17 @@
 #define BOARD_BHI_RST       (47)
 #define BOARD_BHI_EN        (48)
 
+// Set to 0 to use the Arduino SPI class for the BHI260AP, for comparison
+#ifndef BOARD_BHI_SPI_DMA
+#define BOARD_BHI_SPI_DMA   (1)
+#endif
+// BHI260AP host interface clock with BOARD_BHI_SPI_DMA, up to SENSORLIB_BHY2_SPI_MAX_FREQ
+#ifndef BOARD_BHI_SPI_FREQ
+#define BOARD_BHI_SPI_FREQ  (20 * 1000 * 1000)
+#endif
+// Largest single FIFO read, also the size of the BHI260AP process buffer
+#define BOARD_BHI_MAX_TRANSFER  (4096)
+
 #define BOARD_RTC_IRQ       (7)
 
 #define BOARD_TOUCH_BUTTON  (14)
@@ -69,6 +83,20 @@
 #define MIC_I2S_PORT                I2S_NUM_0
 #define MIC_I2S_BITS_PER_SAMPLE     I2S_BITS_PER_SAMPLE_16BIT
 
+// Area visible through the Wristband shell, rotation 0
+#define WRISTBAND_VIEWPORT_X        (0)
+#define WRISTBAND_VIEWPORT_Y        (44)
+#define WRISTBAND_VIEWPORT_WIDTH    (126)
+#define WRISTBAND_VIEWPORT_HEIGHT   (250)
+
+// Area visible through the Glass lens, rotation 1 (Glass) and rotation 0 (GlassV2)
+#define GLASS_VIEWPORT_X            (168)
+#define GLASS_VIEWPORT_Y            (0)
+#define GLASS_V2_VIEWPORT_X         (0)
+#define GLASS_V2_VIEWPORT_Y         (168)
+#define GLASS_VIEWPORT_WIDTH        (126)
+#define GLASS_VIEWPORT_HEIGHT       (126)
+
 
 class LilyGo_Wristband :
     public LilyGo_Display,
@@ -80,7 +108,10 @@ public:
     LilyGo_Wristband();
     ~LilyGo_Wristband();
 
-    bool begin();
+    // colorBits selects the interface pixel format, 16 for RGB565 or 12 for RGB444.
+    // Pixels are always passed as RGB565, with 12 bits they are converted when flushing,
+    // which sends 25% fewer bytes at the cost of the lower bits of every channel
+    bool begin(uint8_t colorBits = 16);
 
     void update();
 
@@ -118,17 +149,74 @@ public:
     void enableTouchWakeup(int threshold = 2000);
     void sleep();
     void wakeup();
+
+    // Partial refresh is used by default, only the areas invalidated by LVGL are sent.
+    // Must be called before beginLvglHelper
+    void setFullRefresh(bool enable);
     bool needFullRefresh();
 
+    // The callback is invoked from the SPI interrupt when the pixel DMA has finished
+    bool setFlushDoneCallback(flush_done_cb_t cb, void *user_data);
+
+    // Compare every flushed area with the last transmitted content and only send the
+    // changed line spans, or the whole area if that is cheaper.
+    // Needs a 74KB shadow buffer in PSRAM and a 74KB DMA buffer
+    bool setDeltaFlush(bool enable);
+    bool getDeltaFlushStats(scanline_delta_stats_t &stats);
+
+    // Must be called before begin(). The init table is sent as one batch with the datasheet
+    // minimum delays, and after a sleep() the panel is only woken from sleep-in instead of
+    // being reset and initialized again
+    void setFastBoot(bool enable);
+    bool isWarmResumed();
+
+    // Microseconds from the panel reset, or the start of a warm resume, until the pixels of
+    // the first flush were sent to the panel, 0 before the first flush finished
+    uint32_t getFirstFrameTime();
+
+    // Must be called before begin(). The BHI260AP boots from its external flash, which is only
+    // written with image when it does not hold it yet. What the flash holds is kept in NVS, see
+    // SensorBHI260AP::setFlashRecord(). image must be a flash build of the BHI260AP firmware.
+    // getBootPath() and getBootTime() tell how the firmware came up
+    void setSensorFlashFirmware(const uint8_t *image, size_t image_len);
+
+    // Must be called before begin(), enabled by default. The BSX calibration state is kept in
+    // NVS: begin() restores it, and update() saves it once the fusion reports full accuracy
+    // or an FOC passed, and every 10 minutes while it stays fully calibrated
+    void setSensorCalibrationStore(bool enable);
+    // Save the calibration state now, e.g. before sleep(). Skipped when NVS holds it already
+    bool saveSensorCalibration();
+
+    // Orientation for the UI, after begin(). The on chip backends leave the fusion to the
+    // BHI260AP, ORIENTATION_HOST runs it on the ESP32. Calling it again switches the backend,
+    // the angles of orientation() keep their meaning
+    bool beginOrientation(orientation_backend_t backend = ORIENTATION_GAME_RV, float rate_hz = 100);
+    void endOrientation();
+    OrientationProvider &orientation();
+
+    // SPI transactions and CPU waits of the display bus since begin()
+    bool getPanelIOStats(panel_io_stats_t &stats);
+
     bool initMicrophone();
     bool readMicrophone(void *dest, size_t size, size_t *bytes_read, TickType_t ticks_to_wait = portMAX_DELAY);
 
 private:
     bool initBUS();
+    bool restoreSensorCalibration();
     void writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length);
     uint8_t _brightness;
     esp_lcd_panel_handle_t panel_handle ;
     int  threshold ;
+    bool _fullRefresh;
+    bool _fastBoot;
+    bool _warmResumed;
+    uint8_t _colorBits;
+    const uint8_t *_sensorFlashImage;
+    size_t _sensorFlashImageLen;
+    bool _sensorCalibStore;
+    uint32_t _sensorCalibHash;
+    uint32_t _sensorCalibCheckMs;
+    OrientationProvider _orientation;
 };
 
 #ifndef LilyGo_Class
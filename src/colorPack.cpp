@@ -0,0 +1,53 @@
+/**
+ * @file      colorPack.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include "colorPack.h"
+
+// Pixel as stored in memory to 0x0RGB
+static inline uint32_t rgb444(const uint8_t *p)
+{
+    uint32_t c = ((uint32_t)p[0] << 8) | p[1];
+    return ((c >> 4) & 0xF00) | ((c >> 3) & 0x0F0) | ((c >> 1) & 0x00F);
+}
+
+size_t color_pack_rgb444(uint8_t *dst, const uint16_t *src, size_t count)
+{
+    const uint8_t *s = (const uint8_t *)src;
+    uint8_t *d = dst;
+
+    for (; count >= 4; count -= 4) {
+        uint32_t c0 = rgb444(s);
+        uint32_t c1 = rgb444(s + 2);
+        uint32_t c2 = rgb444(s + 4);
+        uint32_t c3 = rgb444(s + 6);
+        s += 8;
+        d[0] = c0 >> 4;
+        d[1] = (c0 << 4) | (c1 >> 8);
+        d[2] = c1;
+        d[3] = c2 >> 4;
+        d[4] = (c2 << 4) | (c3 >> 8);
+        d[5] = c3;
+        d += 6;
+    }
+    for (; count >= 2; count -= 2) {
+        uint32_t c0 = rgb444(s);
+        uint32_t c1 = rgb444(s + 2);
+        s += 4;
+        d[0] = c0 >> 4;
+        d[1] = (c0 << 4) | (c1 >> 8);
+        d[2] = c1;
+        d += 3;
+    }
+    if (count) {
+        uint32_t c0 = rgb444(s);
+        d[0] = c0 >> 4;
+        d[1] = c0 << 4;
+        d += 2;
+    }
+    return d - dst;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file      colorPack.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bytes of count pixels packed as RGB444, two pixels share three bytes
+#define COLOR_PACK_RGB444_SIZE(count)   (((count) * 3 + 1) / 2)
+
+/**
+ * @brief  Convert RGB565 pixels to the 12-bit interface format
+ * @param  dst:   receives COLOR_PACK_RGB444_SIZE(count) bytes, may be the same buffer as src
+ * @param  src:   RGB565 pixels in panel byte order, high byte first as with LV_COLOR_16_SWAP
+ * @param  count: number of pixels, an odd count leaves the low nibble of the last byte zero
+ * @retval Number of bytes written
+ * @note   Every color channel keeps its upper four bits. Four pixels are converted per step
+ *         and all of them are read before the six output bytes are written, so converting
+ *         in place is safe.
+ */
+size_t color_pack_rgb444(uint8_t *dst, const uint16_t *src, size_t count);
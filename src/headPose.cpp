@@ -0,0 +1,358 @@
+/**
+ * @file      headPose.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <math.h>
+#include <string.h>
+#include "headPose.h"
+
+#define HEAD_POSE_DEG_TO_RAD    0.0174533f
+#define HEAD_POSE_Q14           (1.0f / 16384.0f)
+
+// The clock of SensorBHI260AP::toHostTime()
+static int64_t host_time_us()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    return esp_timer_get_time();
+#else
+    return micros();
+#endif
+}
+
+// r = a * b, both w, x, y, z
+static void quat_multiply(const float a[4], const float b[4], float r[4])
+{
+    r[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+    r[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+    r[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+    r[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+HeadPose::HeadPose() : _sensor(NULL), _gyroScale(0), _calibrating(false), _calibrated(false),
+    _misalignmentOn(false), _seq(0), _frameSeq(0), _frameSampleUs(0), _framePredictUs(0),
+    _doneSeq(0), _photonDelayUs(0)
+{
+    memset(_gyro, 0, sizeof(_gyro));
+    memset(&_pose, 0, sizeof(_pose));
+    const float identity[4] = { 1, 0, 0, 0 };
+    setMisalignment(identity);
+    resetLatency();
+}
+
+bool HeadPose::begin(SensorBHI260AP &sensor, float rate_hz, bool initial_correction)
+{
+    end();
+    if (!bhy2_is_sensor_available(SENSOR_ID_IMU_HEAD_ORI_Q, sensor.getHandler())) {
+        log_e("The BHI260AP firmware has no head orientation");
+        return false;
+    }
+    _sensor = &sensor;
+
+    // The correction of an earlier calibration, the firmware keeps it until it resets
+    float q[4] = { 1, 0, 0, 0 };
+    _calibrated = sensor.getHeadMisalignment(q);
+    setMisalignment(q);
+    _calibrating = false;
+
+    memset(_gyro, 0, sizeof(_gyro));
+    _gyroScale = sensor.getScaling(SENSOR_ID_GYRO) * HEAD_POSE_DEG_TO_RAD;
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    _pose.valid = false;
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELEASE);
+
+    // Applies when the sensor is enabled
+    if (!sensor.setHeadInitialCorrection(initial_correction)) {
+        _sensor = NULL;
+        return false;
+    }
+    if (!sensor.onResultEvent(SENSOR_ID_GYRO, onGyro, this) ||
+            !sensor.onResultEvent(SENSOR_ID_IMU_HEAD_ORI_Q, onQuaternion, this)) {
+        sensor.removeResultEvent(SENSOR_ID_GYRO, onGyro, this);
+        _sensor = NULL;
+        return false;
+    }
+    // The gyroscope first, so the first pose already has a rate
+    if (!sensor.configure(SENSOR_ID_GYRO, rate_hz, 0) || !sensor.configure(SENSOR_ID_IMU_HEAD_ORI_Q, rate_hz, 0)) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void HeadPose::end()
+{
+    if (!_sensor) {
+        return;
+    }
+    stopCalibration();
+    _sensor->configure(SENSOR_ID_IMU_HEAD_ORI_Q, 0, 0);
+    _sensor->configure(SENSOR_ID_GYRO, 0, 0);
+    _sensor->removeResultEvent(SENSOR_ID_IMU_HEAD_ORI_Q, onQuaternion, this);
+    _sensor->removeResultEvent(SENSOR_ID_GYRO, onGyro, this);
+    _sensor = NULL;
+}
+
+bool HeadPose::calibrate()
+{
+    if (!_sensor || _calibrating) {
+        return false;
+    }
+    if (!_misalignmentOn) {
+        if (!_sensor->onResultEvent(SENSOR_ID_HEAD_ORI_MIS_ALG, onMisalignment, this)) {
+            return false;
+        }
+        // The progress comes as the accuracy of its samples
+        if (!_sensor->configure(SENSOR_ID_HEAD_ORI_MIS_ALG, 25, 0)) {
+            _sensor->removeResultEvent(SENSOR_ID_HEAD_ORI_MIS_ALG, onMisalignment, this);
+            return false;
+        }
+        _misalignmentOn = true;
+    }
+    _calibrating = true;
+    if (!_sensor->triggerHeadCalibration()) {
+        _calibrating = false;
+        stopCalibration();
+        return false;
+    }
+    return true;
+}
+
+void HeadPose::stopCalibration()
+{
+    if (!_misalignmentOn || _calibrating) {
+        return;
+    }
+    _sensor->configure(SENSOR_ID_HEAD_ORI_MIS_ALG, 0, 0);
+    _sensor->removeResultEvent(SENSOR_ID_HEAD_ORI_MIS_ALG, onMisalignment, this);
+    _misalignmentOn = false;
+}
+
+bool HeadPose::isCalibrating()
+{
+    if (!_calibrating) {
+        stopCalibration();
+    }
+    return _calibrating;
+}
+
+bool HeadPose::isCalibrated()
+{
+    isCalibrating();
+    return _calibrated;
+}
+
+void HeadPose::setMisalignment(const float q[4])
+{
+    memcpy(_mount, q, sizeof(_mount));
+}
+
+void HeadPose::onMisalignment(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data)
+{
+    (void)sensor_id;
+    (void)timestamp_ns;
+    HeadPose *self = (HeadPose *)user_data;
+    if (size < 9 || !self->_calibrating) {
+        return;
+    }
+    struct bhy2_head_tracker_quat_data quat;
+    bhy2_head_tracker_quat_parsing(data, &quat);
+    if (quat.accuracy < 3) {
+        return;
+    }
+    float q[4] = { quat.w * HEAD_POSE_Q14, quat.x * HEAD_POSE_Q14, quat.y * HEAD_POSE_Q14, quat.z * HEAD_POSE_Q14 };
+    self->setMisalignment(q);
+    self->_calibrated = true;
+    self->_calibrating = false;
+}
+
+// Sensor frame, turned into the head frame by the misalignment: v_head = m' * v * m
+void HeadPose::onGyro(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data)
+{
+    (void)sensor_id;
+    (void)timestamp_ns;
+    HeadPose *self = (HeadPose *)user_data;
+    if (size < 6) {
+        return;
+    }
+    float v[3];
+    for (int i = 0; i < 3; i++) {
+        v[i] = (int16_t)(data[2 * i] | (data[2 * i + 1] << 8)) * self->_gyroScale;
+    }
+    const float *m = self->_mount;
+    float u[3] = { -m[1], -m[2], -m[3] };
+    float t[3] = {
+        2 * (u[1] * v[2] - u[2] * v[1]),
+        2 * (u[2] * v[0] - u[0] * v[2]),
+        2 * (u[0] * v[1] - u[1] * v[0]),
+    };
+    self->_gyro[0] = v[0] + m[0] * t[0] + u[1] * t[2] - u[2] * t[1];
+    self->_gyro[1] = v[1] + m[0] * t[1] + u[2] * t[0] - u[0] * t[2];
+    self->_gyro[2] = v[2] + m[0] * t[2] + u[0] * t[1] - u[1] * t[0];
+}
+
+// x, y, z, w in Q14 and the accuracy
+void HeadPose::onQuaternion(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data)
+{
+    (void)sensor_id;
+    HeadPose *self = (HeadPose *)user_data;
+    if (size < 9) {
+        return;
+    }
+    struct bhy2_head_tracker_quat_data quat;
+    bhy2_head_tracker_quat_parsing(data, &quat);
+
+    // The time the sample was taken, or when it arrived before the clocks are in sync
+    int64_t sample_us;
+    if (!self->_sensor || !self->_sensor->toHostTime(timestamp_ns, sample_us)) {
+        sample_us = host_time_us();
+    }
+
+    // Q14 rounding leaves the norm off by up to 1e-4
+    float w = quat.w, x = quat.x, y = quat.y, z = quat.z;
+    float norm = sqrtf(w * w + x * x + y * y + z * z);
+    if (norm == 0) {
+        return;
+    }
+    norm = 1.0f / norm;
+
+    __atomic_store_n(&self->_seq, self->_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    pose_t &pose = self->_pose;
+    pose.q[0] = w * norm;
+    pose.q[1] = x * norm;
+    pose.q[2] = y * norm;
+    pose.q[3] = z * norm;
+    memcpy(pose.rate, self->_gyro, sizeof(pose.rate));
+    pose.sample_us = sample_us;
+    pose.valid = true;
+    __atomic_store_n(&self->_seq, self->_seq + 1, __ATOMIC_RELEASE);
+}
+
+bool HeadPose::readPose(pose_t &pose)
+{
+    uint32_t seq;
+    do {
+        seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+        memcpy(&pose, &_pose, sizeof(pose));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&_seq, __ATOMIC_RELAXED));
+    return pose.valid;
+}
+
+bool HeadPose::getPose(float q[4], int64_t *sample_us)
+{
+    pose_t pose;
+    if (!readPose(pose)) {
+        return false;
+    }
+    memcpy(q, pose.q, sizeof(pose.q));
+    if (sample_us) {
+        *sample_us = pose.sample_us;
+    }
+    return true;
+}
+
+bool HeadPose::predict(float q[4])
+{
+    pose_t pose;
+    if (!readPose(pose)) {
+        return false;
+    }
+    int64_t now = host_time_us();
+    int64_t ahead = now + _photonDelayUs - pose.sample_us;
+    if (ahead < 0) {
+        ahead = 0;
+    } else if (ahead > HEAD_POSE_MAX_PREDICT_US) {
+        ahead = HEAD_POSE_MAX_PREDICT_US;
+    }
+
+    // Constant rate in the head frame over the gap: q * exp(rate * dt / 2)
+    float half = ahead * 0.5e-6f;
+    float h[3] = { pose.rate[0] * half, pose.rate[1] * half, pose.rate[2] * half };
+    float angle = sqrtf(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+    float s = angle > 1e-6f ? sinf(angle) / angle : 1.0f;
+    float step[4] = { cosf(angle), h[0] * s, h[1] * s, h[2] * s };
+    quat_multiply(pose.q, step, q);
+
+    __atomic_store_n(&_frameSeq, _frameSeq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    _frameSampleUs = pose.sample_us;
+    _framePredictUs = now;
+    __atomic_store_n(&_frameSeq, _frameSeq + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// A frame without a predict() since the last one did not move with the head
+void HeadPose::onFrameDone(void *user_data)
+{
+    HeadPose *self = (HeadPose *)user_data;
+    int64_t done_us = host_time_us();
+    uint32_t seq = __atomic_load_n(&self->_frameSeq, __ATOMIC_ACQUIRE);
+    if ((seq & 1) || seq == self->_doneSeq) {
+        return;
+    }
+    int64_t sample_us = self->_frameSampleUs;
+    int64_t predict_us = self->_framePredictUs;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (seq != __atomic_load_n(&self->_frameSeq, __ATOMIC_RELAXED)) {
+        return;
+    }
+    self->_doneSeq = seq;
+
+    // Follows slow changes of the render and transfer time, 1/8 per frame
+    int32_t delay = (int32_t)(done_us - predict_us);
+    if (delay >= 0) {
+        int32_t old = self->_photonDelayUs;
+        self->_photonDelayUs = old ? old + (delay - old) / 8 : delay;
+    }
+
+    if (done_us < sample_us) {
+        return;
+    }
+    uint32_t latency = (uint32_t)(done_us - sample_us);
+    head_pose_latency_t &stats = self->_latency;
+    uint32_t bucket = latency / HEAD_POSE_BUCKET_US;
+    stats.buckets[bucket < HEAD_POSE_LATENCY_BUCKETS ? bucket : HEAD_POSE_LATENCY_BUCKETS - 1]++;
+    stats.min_us = latency < stats.min_us ? latency : stats.min_us;
+    stats.max_us = latency > stats.max_us ? latency : stats.max_us;
+    stats.total_us += latency;
+    stats.frames++;
+}
+
+void HeadPose::getLatency(head_pose_latency_t &latency)
+{
+    latency = _latency;
+    if (!latency.frames) {
+        latency.min_us = 0;
+    }
+}
+
+void HeadPose::resetLatency()
+{
+    memset(&_latency, 0, sizeof(_latency));
+    _latency.min_us = UINT32_MAX;
+}
+
+uint32_t HeadPose::getPercentile(const head_pose_latency_t &latency, uint8_t pct)
+{
+    uint64_t target = ((uint64_t)latency.frames * pct + 99) / 100;
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < HEAD_POSE_LATENCY_BUCKETS; i++) {
+        count += latency.buckets[i];
+        if (count >= target && count) {
+            // The last bucket is open, its frames stayed below the largest one
+            return i == HEAD_POSE_LATENCY_BUCKETS - 1 ? latency.max_us : (i + 1) * HEAD_POSE_BUCKET_US;
+        }
+    }
+    return 0;
+}
+
+uint32_t HeadPose::getPhotonDelayUs()
+{
+    return _photonDelayUs;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file      headPose.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <SensorBHI260AP.hpp>
+
+// Width of one bucket of the motion to photon histogram
+#ifndef HEAD_POSE_BUCKET_US
+#define HEAD_POSE_BUCKET_US         1000
+#endif
+
+// Buckets of the histogram, the last one collects the longer latencies
+#ifndef HEAD_POSE_LATENCY_BUCKETS
+#define HEAD_POSE_LATENCY_BUCKETS   40
+#endif
+
+// Longest extrapolation, a stalled stream holds the pose instead of spinning it on
+#ifndef HEAD_POSE_MAX_PREDICT_US
+#define HEAD_POSE_MAX_PREDICT_US    50000
+#endif
+
+// Time from the sample a frame was drawn with until the frame reached the panel
+typedef struct {
+    uint32_t frames;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t buckets[HEAD_POSE_LATENCY_BUCKETS];
+} head_pose_latency_t;
+
+/*
+ * Head orientation for the Glass HUD. Needs a BHI260AP firmware image with the head tracker
+ * module: it reads SENSOR_ID_IMU_HEAD_ORI_Q, already corrected for the way the glasses sit
+ * on the head, and the gyroscope, and turns the latest pose on by the gyroscope rate to the
+ * time the next frame is expected on the panel. That time is learned from the frames:
+ * call predict() right before lv_timer_handler() and pass onFrameDone() to
+ * setLvglHelperFrameCallback(), each frame then also adds its motion to photon latency
+ * to the histogram.
+ *
+ * Samples arrive in the task that drains the sensor, predict() runs in the UI task and
+ * onFrameDone() in the display transfer-done interrupt, which does integer math only.
+ */
+class HeadPose
+{
+public:
+    HeadPose();
+
+    /**
+     * @brief  Enable the head orientation and the gyroscope
+     * @param  rate_hz: rate of both, the BHI260AP rounds it up to 1.5625 Hz times a power of two
+     * @param  initial_correction: the heading at begin() becomes straight ahead
+     * @retval false without head tracker firmware
+     */
+    bool begin(SensorBHI260AP &sensor, float rate_hz = 200, bool initial_correction = true);
+    void end();
+
+    /**
+     * @brief  Start the head misalignment calibration: the wearer looks straight ahead and
+     *         nods a few times. Corrects the pose from then on and is kept by the firmware
+     *         until it resets
+     */
+    bool calibrate();
+    bool isCalibrating();
+    // A calibration of this or an earlier begin() is applied
+    bool isCalibrated();
+
+    /**
+     * @brief  Latest head orientation as w, x, y, z, and the host time of its sample
+     *         in esp_timer_get_time() on ESP32, micros() elsewhere
+     * @retval false before the first sample
+     */
+    bool getPose(float q[4], int64_t *sample_us = NULL);
+
+    /**
+     * @brief  The pose at the time the frame about to be drawn will be seen, from the
+     *         latest one and the gyroscope rate. Marks the frame for the latency histogram
+     * @retval false before the first sample
+     */
+    bool predict(float q[4]);
+
+    // lv_helper_frame_cb_t, user_data is the HeadPose
+    static void onFrameDone(void *user_data);
+
+    // The copy may mix two frames while one completes
+    void getLatency(head_pose_latency_t &latency);
+    void resetLatency();
+    // Smallest latency below which pct percent of the frames stayed, bucket resolution
+    static uint32_t getPercentile(const head_pose_latency_t &latency, uint8_t pct);
+
+    // Learned time from predict() until the frame is on the panel
+    uint32_t getPhotonDelayUs();
+
+private:
+    typedef struct {
+        float q[4];
+        float rate[3];          // head frame, rad/s
+        int64_t sample_us;
+        bool valid;
+    } pose_t;
+
+    static void onQuaternion(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data);
+    static void onGyro(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data);
+    static void onMisalignment(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data);
+    bool readPose(pose_t &pose);
+    void setMisalignment(const float q[4]);
+    void stopCalibration();
+
+    SensorBHI260AP *_sensor;
+
+    // Writer side, the task that drains the sensor
+    float _gyro[3];
+    float _gyroScale;
+    float _mount[4];            // misalignment the firmware corrects the pose by
+    volatile bool _calibrating;
+    volatile bool _calibrated;
+    bool _misalignmentOn;       // SENSOR_ID_HEAD_ORI_MIS_ALG enabled, turned off by the UI task
+
+    // A sequence lock: odd while the pose is written
+    volatile uint32_t _seq;
+    pose_t _pose;
+
+    // The frame being drawn, written by predict() under the sequence lock _frameSeq
+    volatile uint32_t _frameSeq;
+    int64_t _frameSampleUs;
+    int64_t _framePredictUs;
+    uint32_t _doneSeq;
+
+    volatile uint32_t _photonDelayUs;
+    head_pose_latency_t _latency;
+};
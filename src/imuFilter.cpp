@@ -0,0 +1,190 @@
+/**
+ * @file      imuFilter.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <math.h>
+#include "imuFilter.h"
+
+#define IMU_DEG_TO_RAD          0.0174533f
+#define IMU_TICKS_PER_SECOND    64000.0
+#define IMU_Q30                 1073741824.0f
+#define IMU_Q46                 70368744177664.0
+
+MahonyKernel::MahonyKernel()
+{
+    reset();
+}
+
+void MahonyKernel::reset()
+{
+    _q[0] = 1.0f;
+    _q[1] = _q[2] = _q[3] = 0.0f;
+    _bias[0] = _bias[1] = _bias[2] = 0.0f;
+}
+
+void MahonyKernel::update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+{
+    float q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+
+    gx *= IMU_DEG_TO_RAD;
+    gy *= IMU_DEG_TO_RAD;
+    gz *= IMU_DEG_TO_RAD;
+
+    if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
+        float recipNorm = 1.0f / sqrtf(ax * ax + ay * ay + az * az);
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        // Gravity as the quaternion sees it, crossed with the measured one
+        float vx = 2.0f * (q1 * q3 - q0 * q2);
+        float vy = 2.0f * (q0 * q1 + q2 * q3);
+        float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+
+        if (IMU_MAHONY_KI > 0.0f) {
+            _bias[0] += IMU_MAHONY_KI * ex * dt;
+            _bias[1] += IMU_MAHONY_KI * ey * dt;
+            _bias[2] += IMU_MAHONY_KI * ez * dt;
+            gx += _bias[0];
+            gy += _bias[1];
+            gz += _bias[2];
+        }
+        gx += IMU_MAHONY_KP * ex;
+        gy += IMU_MAHONY_KP * ey;
+        gz += IMU_MAHONY_KP * ez;
+    }
+
+    gx *= 0.5f * dt;
+    gy *= 0.5f * dt;
+    gz *= 0.5f * dt;
+    q0 += -q1 * gx - q2 * gy - q3 * gz;
+    q1 += _q[0] * gx + q2 * gz - q3 * gy;
+    q2 += _q[0] * gy - _q[1] * gz + q3 * gx;
+    q3 += _q[0] * gz + _q[1] * gy - _q[2] * gx;
+
+    float recipNorm = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    _q[0] = q0 * recipNorm;
+    _q[1] = q1 * recipNorm;
+    _q[2] = q2 * recipNorm;
+    _q[3] = q3 * recipNorm;
+}
+
+void MahonyKernel::getQuaternion(float q[4])
+{
+    q[0] = _q[0];
+    q[1] = _q[1];
+    q[2] = _q[2];
+    q[3] = _q[3];
+}
+
+ComplementaryFixed::ComplementaryFixed(float gyro_dps_per_lsb)
+{
+    _halfPerLsbTick = (int64_t)(gyro_dps_per_lsb * IMU_DEG_TO_RAD * 0.5 / IMU_TICKS_PER_SECOND * IMU_Q46);
+    _gainPerTick = (int64_t)(IMU_COMPLEMENTARY_KP * 0.5 / IMU_TICKS_PER_SECOND * IMU_Q46);
+    reset();
+}
+
+void ComplementaryFixed::reset()
+{
+    _q[0] = 1 << 30;
+    _q[1] = _q[2] = _q[3] = 0;
+}
+
+/*
+ * 1 / sqrt(x) by Newton steps from a straight line guess, multiplies only. Returns y in
+ * [1, 2] in Q30 and shift with 1 / sqrt(x) = y / 2^(30 + shift)
+ */
+static int32_t rsqrt_q30(uint32_t x, int *shift)
+{
+    // Scale x by a power of four into [0.25, 1) in Q30
+    int top = 31 - __builtin_clz(x);
+    int up = 28 - top;
+    if (up & 1) {
+        up++;
+    }
+    int64_t n = up >= 0 ? (int64_t)x << up : (int64_t)(x >> -up);
+    *shift = 15 - up / 2;
+
+    // 7/3 - 4/3 x is within 20 %, three steps bring that below 2^-20
+    int64_t y = (7LL << 30) / 3 - ((n * 1431655765LL) >> 30);
+    for (int i = 0; i < 3; i++) {
+        int64_t yy = (y * y) >> 30;
+        y = (y * ((3LL << 30) - ((n * yy) >> 30))) >> 31;
+    }
+    return (int32_t)y;
+}
+
+// half: rotation during the step halved, rad in Q30. gain: feedback times half the step in Q30
+void ComplementaryFixed::step(const int32_t half[3], const int32_t acc[3], int32_t gain)
+{
+    int64_t q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+    int32_t hx = half[0], hy = half[1], hz = half[2];
+
+    // Bring the accelerometer below 2^15 so its squares fit 32 bits
+    int32_t ax = acc[0], ay = acc[1], az = acc[2];
+    while (ax >= 32768 || ax <= -32768 || ay >= 32768 || ay <= -32768 || az >= 32768 || az <= -32768) {
+        ax >>= 1;
+        ay >>= 1;
+        az >>= 1;
+    }
+    uint32_t norm2 = (uint32_t)(ax * ax) + (uint32_t)(ay * ay) + (uint32_t)(az * az);
+    if (norm2) {
+        int shift;
+        int64_t recip = rsqrt_q30(norm2, &shift);
+        ax = (int32_t)((ax * recip) >> (shift + 15));
+        ay = (int32_t)((ay * recip) >> (shift + 15));
+        az = (int32_t)((az * recip) >> (shift + 15));
+
+        // Gravity as the quaternion sees it in Q15, the cross product in Q30
+        int32_t vx = (int32_t)((q1 * q3 - q0 * q2) >> 44);
+        int32_t vy = (int32_t)((q0 * q1 + q2 * q3) >> 44);
+        int32_t vz = (int32_t)((q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3) >> 45);
+        hx += (int32_t)(((int64_t)(ay * vz - az * vy) * gain) >> 30);
+        hy += (int32_t)(((int64_t)(az * vx - ax * vz) * gain) >> 30);
+        hz += (int32_t)(((int64_t)(ax * vy - ay * vx) * gain) >> 30);
+    }
+
+    q0 += (-q1 * hx - q2 * hy - q3 * hz) >> 30;
+    q1 += (_q[0] * (int64_t)hx + q2 * hz - q3 * hy) >> 30;
+    q2 += (_q[0] * (int64_t)hy - _q[1] * (int64_t)hz + q3 * hx) >> 30;
+    q3 += (_q[0] * (int64_t)hz + _q[1] * (int64_t)hy - _q[2] * (int64_t)hx) >> 30;
+
+    // The norm stays close to one, a first order step renormalizes
+    int64_t scale = (3LL << 30) - ((q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3) >> 30);
+    _q[0] = (int32_t)((q0 * scale) >> 31);
+    _q[1] = (int32_t)((q1 * scale) >> 31);
+    _q[2] = (int32_t)((q2 * scale) >> 31);
+    _q[3] = (int32_t)((q3 * scale) >> 31);
+}
+
+void ComplementaryFixed::update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+{
+    float k = dt * 0.5f * IMU_DEG_TO_RAD * IMU_Q30;
+    int32_t half[3] = { (int32_t)(gx * k), (int32_t)(gy * k), (int32_t)(gz * k) };
+    int32_t acc[3] = { (int32_t)(ax * 4096.0f), (int32_t)(ay * 4096.0f), (int32_t)(az * 4096.0f) };
+    step(half, acc, (int32_t)(IMU_COMPLEMENTARY_KP * 0.5f * dt * IMU_Q30));
+}
+
+void ComplementaryFixed::updateRaw(const int16_t gyro[3], const int16_t acc[3], uint32_t dt_ticks)
+{
+    int32_t half[3];
+    for (int i = 0; i < 3; i++) {
+        half[i] = (int32_t)(((int64_t)gyro[i] * (int32_t)dt_ticks * _halfPerLsbTick) >> 16);
+    }
+    int32_t a[3] = { acc[0], acc[1], acc[2] };
+    step(half, a, (int32_t)(((int64_t)dt_ticks * _gainPerTick) >> 16));
+}
+
+void ComplementaryFixed::getQuaternion(float q[4])
+{
+    for (int i = 0; i < 4; i++) {
+        q[i] = _q[i] * (1.0f / IMU_Q30);
+    }
+}
@@ -0,0 +1,128 @@
+/**
+ * @file      imuFilter.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <MadgwickAHRS.h>
+
+#ifndef IMU_MAHONY_KP
+#define IMU_MAHONY_KP               0.5f
+#endif
+
+#ifndef IMU_MAHONY_KI
+#define IMU_MAHONY_KI               0.0f
+#endif
+
+#ifndef IMU_COMPLEMENTARY_KP
+#define IMU_COMPLEMENTARY_KP        0.5f
+#endif
+
+// Orientation filter stepped by ImuFusion. Rates in deg/s, the accelerometer in any unit
+class ImuFilter
+{
+public:
+    virtual ~ImuFilter() {}
+    virtual void reset() = 0;
+    virtual void update(float gx, float gy, float gz, float ax, float ay, float az, float dt) = 0;
+    // w, x, y, z
+    virtual void getQuaternion(float q[4]) = 0;
+};
+
+/*
+ * Filter kernels share the methods of ImuFilter without the virtual calls, so a kernel
+ * can be stepped directly or plugged into ImuFusion through ImuFilterOf.
+ */
+class MadgwickKernel
+{
+public:
+    void reset()
+    {
+        _filter = Madgwick();
+    }
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+    {
+        _filter.setSamplePeriod(dt);
+        _filter.updateIMU(gx, gy, gz, ax, ay, az);
+    }
+    void getQuaternion(float q[4])
+    {
+        _filter.getQuaternion(&q[0], &q[1], &q[2], &q[3]);
+    }
+private:
+    Madgwick _filter;
+};
+
+// Proportional and integral feedback of the gravity direction, about half the work of Madgwick
+class MahonyKernel
+{
+public:
+    MahonyKernel();
+    void reset();
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+    void getQuaternion(float q[4]);
+private:
+    float _q[4];
+    float _bias[3];
+};
+
+/*
+ * Mahony with proportional feedback only, in integers: the quaternion in Q30, the
+ * accelerometer direction in Q15. Good for coarse tilt such as wake on raise or the UI
+ * rotation. updateRaw() takes the BHI260AP samples as they are and uses no float at all.
+ */
+class ComplementaryFixed
+{
+public:
+    // LSB of the raw gyroscope samples, the BHI260AP default range is 2000 deg/s
+    ComplementaryFixed(float gyro_dps_per_lsb = 2000.0f / 32768.0f);
+    void reset();
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+    // dt_ticks in BHI260AP timestamp ticks of 1/64000 s, at most 6400
+    void updateRaw(const int16_t gyro[3], const int16_t acc[3], uint32_t dt_ticks);
+    void getQuaternion(float q[4]);
+private:
+    void step(const int32_t half[3], const int32_t acc[3], int32_t gain);
+
+    int32_t _q[4];
+    int64_t _halfPerLsbTick;    // half the angle of one LSB during one tick, rad in Q46
+    int64_t _gainPerTick;       // feedback during one tick in Q46
+};
+
+// Any kernel as an ImuFilter, selected at compile time
+template <class Kernel>
+class ImuFilterOf : public ImuFilter
+{
+public:
+    ImuFilterOf()
+    {
+        _kernel.reset();
+    }
+    void reset()
+    {
+        _kernel.reset();
+    }
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+    {
+        _kernel.update(gx, gy, gz, ax, ay, az, dt);
+    }
+    void getQuaternion(float q[4])
+    {
+        _kernel.getQuaternion(q);
+    }
+    Kernel &kernel()
+    {
+        return _kernel;
+    }
+private:
+    Kernel _kernel;
+};
+
+typedef ImuFilterOf<MadgwickKernel> MadgwickFilter;
+typedef ImuFilterOf<MahonyKernel> MahonyFilter;
+typedef ImuFilterOf<ComplementaryFixed> ComplementaryFilter;
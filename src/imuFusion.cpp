@@ -0,0 +1,244 @@
+/**
+ * @file      imuFusion.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <math.h>
+#include <string.h>
+#include "imuFusion.h"
+#include "bosch/common/common.h"
+
+#define IMU_FUSION_MASK     (IMU_FUSION_QUEUE_SIZE - 1)
+
+ImuOrientation::ImuOrientation() : _seq(0)
+{
+    clear();
+}
+
+void ImuOrientation::clear()
+{
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    _q[0] = 1;
+    _q[1] = _q[2] = _q[3] = 0;
+    _qNs = 0;
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELEASE);
+    _anglesSeq = 0;
+}
+
+void ImuOrientation::publish(const float q[4], uint64_t timestamp_ns)
+{
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(_q, q, sizeof(_q));
+    _qNs = timestamp_ns;
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELEASE);
+}
+
+ImuFusion::ImuFusion() : _filter(NULL), _accId(BHY2_SENSOR_ID_ACC_PASS), _gyroId(BHY2_SENSOR_ID_GYRO_PASS)
+{
+    reset();
+}
+
+void ImuFusion::begin(ImuFilter *filter, uint8_t acc_id, uint8_t gyro_id)
+{
+    _filter = filter;
+    _accId = acc_id;
+    _gyroId = gyro_id;
+    reset();
+}
+
+// Not while samples are added
+void ImuFusion::reset()
+{
+    if (_filter) {
+        _filter->reset();
+    }
+    memset(&_acc, 0, sizeof(_acc));
+    memset(&_gyro, 0, sizeof(_gyro));
+    memset(&_stats, 0, sizeof(_stats));
+    _hasAccPrev = false;
+    _lastGyroNs = 0;
+    _started = false;
+    clear();
+}
+
+bool ImuFusion::push(queue_t &queue, const sample_t &sample)
+{
+    if (queue.count == IMU_FUSION_QUEUE_SIZE) {
+        return false;
+    }
+    // Each stream counts up
+    if (queue.count && queue.items[(queue.head + queue.count - 1) & IMU_FUSION_MASK].t >= sample.t) {
+        return false;
+    }
+    queue.items[(queue.head + queue.count) & IMU_FUSION_MASK] = sample;
+    queue.count++;
+    return true;
+}
+
+void ImuFusion::addAccel(float x, float y, float z, uint64_t timestamp_ns)
+{
+    sample_t sample = { { x, y, z }, timestamp_ns };
+    if ((_hasAccPrev && timestamp_ns <= _accPrev.t) || !push(_acc, sample)) {
+        _stats.dropped++;
+        return;
+    }
+    process();
+}
+
+void ImuFusion::addGyro(float x, float y, float z, uint64_t timestamp_ns)
+{
+    sample_t sample = { { x, y, z }, timestamp_ns };
+    if ((_started && timestamp_ns <= _lastGyroNs) || !push(_gyro, sample)) {
+        _stats.dropped++;
+        return;
+    }
+    process();
+}
+
+void ImuFusion::onSample(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data)
+{
+    ImuFusion *self = (ImuFusion *)user_data;
+    if (size < 6) {
+        return;
+    }
+    float scale = get_sensor_default_scaling(sensor_id);
+    float x = (int16_t)(data[0] | (data[1] << 8)) * scale;
+    float y = (int16_t)(data[2] | (data[3] << 8)) * scale;
+    float z = (int16_t)(data[4] | (data[5] << 8)) * scale;
+    if (sensor_id == self->_accId) {
+        self->addAccel(x, y, z, timestamp_ns);
+    } else if (sensor_id == self->_gyroId) {
+        self->addGyro(x, y, z, timestamp_ns);
+    }
+}
+
+// Step with every gyroscope sample the accelerometer has caught up with
+void ImuFusion::process()
+{
+    while (_gyro.count) {
+        const sample_t &gyro = _gyro.items[_gyro.head];
+        while (_acc.count && _acc.items[_acc.head].t <= gyro.t) {
+            _accPrev = _acc.items[_acc.head];
+            _hasAccPrev = true;
+            _acc.head = (_acc.head + 1) & IMU_FUSION_MASK;
+            _acc.count--;
+        }
+
+        float acc[3] = { 0, 0, 0 };
+        if (_hasAccPrev && _accPrev.t == gyro.t) {
+            memcpy(acc, _accPrev.v, sizeof(acc));
+        } else if (_acc.count) {
+            const sample_t &next = _acc.items[_acc.head];
+            if (_hasAccPrev) {
+                float f = (float)(gyro.t - _accPrev.t) / (float)(next.t - _accPrev.t);
+                for (int i = 0; i < 3; i++) {
+                    acc[i] = _accPrev.v[i] + (next.v[i] - _accPrev.v[i]) * f;
+                }
+                _stats.interpolated++;
+            } else {
+                memcpy(acc, next.v, sizeof(acc));
+            }
+        } else {
+            // Wait for the accelerometer unless its stream stalled
+            const sample_t &newest = _gyro.items[(_gyro.head + _gyro.count - 1) & IMU_FUSION_MASK];
+            bool stalled = _gyro.count == IMU_FUSION_QUEUE_SIZE ||
+                           newest.t - (_hasAccPrev ? _accPrev.t : _gyro.items[_gyro.head].t) > IMU_FUSION_MAX_GAP_NS;
+            if (!stalled) {
+                break;
+            }
+            // Without any accelerometer sample the gyroscope integrates alone
+            if (_hasAccPrev) {
+                memcpy(acc, _accPrev.v, sizeof(acc));
+            }
+            _stats.held++;
+        }
+        step(gyro, acc);
+        _gyro.head = (_gyro.head + 1) & IMU_FUSION_MASK;
+        _gyro.count--;
+    }
+}
+
+void ImuFusion::step(const sample_t &gyro, const float acc[3])
+{
+    if (!_started || gyro.t - _lastGyroNs > IMU_FUSION_MAX_GAP_NS) {
+        if (_started) {
+            _stats.restarts++;
+        }
+        _started = true;
+        _lastGyroNs = gyro.t;
+        return;
+    }
+    float dt = (gyro.t - _lastGyroNs) * 1e-9f;
+    _lastGyroNs = gyro.t;
+    if (!_filter) {
+        return;
+    }
+    _filter->update(gyro.v[0], gyro.v[1], gyro.v[2], acc[0], acc[1], acc[2], dt);
+    _stats.steps++;
+    if (dt > _stats.max_dt) {
+        _stats.max_dt = dt;
+    }
+
+    float q[4];
+    _filter->getQuaternion(q);
+    publish(q, gyro.t);
+}
+
+bool ImuOrientation::getQuaternion(float q[4], uint64_t *timestamp_ns)
+{
+    uint32_t seq;
+    uint64_t ns;
+    do {
+        seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+        memcpy(q, _q, sizeof(_q));
+        ns = _qNs;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&_seq, __ATOMIC_RELAXED));
+    if (timestamp_ns) {
+        *timestamp_ns = ns;
+    }
+    return ns != 0;
+}
+
+void ImuOrientation::computeAngles()
+{
+    uint32_t seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+    if (seq == _anglesSeq) {
+        return;
+    }
+    float q[4];
+    getQuaternion(q);
+    _anglesSeq = seq;
+    float sinp = -2.0f * (q[1] * q[3] - q[0] * q[2]);
+    _roll = atan2f(q[0] * q[1] + q[2] * q[3], 0.5f - q[1] * q[1] - q[2] * q[2]) * 57.29578f;
+    _pitch = asinf(sinp > 1.0f ? 1.0f : (sinp < -1.0f ? -1.0f : sinp)) * 57.29578f;
+    _yaw = atan2f(q[1] * q[2] + q[0] * q[3], 0.5f - q[2] * q[2] - q[3] * q[3]) * 57.29578f + 180.0f;
+}
+
+float ImuOrientation::getRoll()
+{
+    computeAngles();
+    return _roll;
+}
+
+float ImuOrientation::getPitch()
+{
+    computeAngles();
+    return _pitch;
+}
+
+float ImuOrientation::getYaw()
+{
+    computeAngles();
+    return _yaw;
+}
+
+void ImuFusion::getStats(imu_fusion_stats_t &stats)
+{
+    stats = _stats;
+}
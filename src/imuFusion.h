@@ -0,0 +1,123 @@
+/**
+ * @file      imuFusion.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "imuFilter.h"
+
+// Samples of one sensor waiting for their partner, a power of two
+#ifndef IMU_FUSION_QUEUE_SIZE
+#define IMU_FUSION_QUEUE_SIZE       32
+#endif
+
+// A longer gap between two gyroscope samples restarts the integration instead of spanning it
+#ifndef IMU_FUSION_MAX_GAP_NS
+#define IMU_FUSION_MAX_GAP_NS       100000000ULL
+#endif
+
+typedef struct {
+    uint32_t steps;             // filter updates, one per gyroscope sample
+    uint32_t interpolated;      // steps with the accelerometer interpolated between two samples
+    uint32_t held;              // steps with the last accelerometer sample, its stream stalled
+    uint32_t restarts;          // gaps longer than IMU_FUSION_MAX_GAP_NS
+    uint32_t dropped;           // samples out of order or without room in their queue
+    float max_dt;               // largest step in seconds
+} imu_fusion_stats_t;
+
+// Latest orientation, written by one task and read from any other
+class ImuOrientation
+{
+public:
+    ImuOrientation();
+
+    // The writer side, timestamp_ns of the samples q includes
+    void publish(const float q[4], uint64_t timestamp_ns);
+    void clear();
+
+    /**
+     * @brief  Latest orientation and the timestamp of the samples it includes
+     * @retval false before the first one
+     */
+    bool getQuaternion(float q[4], uint64_t *timestamp_ns = NULL);
+
+    // Angles in degrees like Madgwick, the yaw from 0 to 360. Computed from the latest
+    // quaternion when one of them is called, for one reading task
+    float getRoll();
+    float getPitch();
+    float getYaw();
+
+private:
+    void computeAngles();
+
+    // A sequence lock: odd while the quaternion is written
+    volatile uint32_t _seq;
+    float _q[4];
+    uint64_t _qNs;
+
+    // Reader side cache of the angles
+    uint32_t _anglesSeq;
+    float _roll;
+    float _pitch;
+    float _yaw;
+};
+
+/*
+ * Pairs accelerometer and gyroscope samples by their BHI260AP timestamp and steps the
+ * filter once per gyroscope sample, with the time since the previous one as its step.
+ * The accelerometer is interpolated to the gyroscope timestamp, so both may run at
+ * different rates. Samples come from one task, usually the FIFO drain through
+ * onSample(). The orientation, as of the gyroscope sample of the last step, may be read
+ * from any other task.
+ */
+class ImuFusion : public ImuOrientation
+{
+public:
+    ImuFusion();
+
+    // filter is owned by the caller. Sensor IDs of the samples given to onSample()
+    void begin(ImuFilter *filter, uint8_t acc_id = 1, uint8_t gyro_id = 10);
+    void reset();
+
+    // Sample producer, timestamps in ns from the same clock
+    void addAccel(float x, float y, float z, uint64_t timestamp_ns);
+    void addGyro(float x, float y, float z, uint64_t timestamp_ns);
+
+    // BhyParseDataTimeCallback, user_data is the ImuFusion
+    static void onSample(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data);
+
+    void getStats(imu_fusion_stats_t &stats);
+
+private:
+    typedef struct {
+        float v[3];
+        uint64_t t;
+    } sample_t;
+
+    typedef struct {
+        sample_t items[IMU_FUSION_QUEUE_SIZE];
+        uint32_t head;
+        uint32_t count;
+    } queue_t;
+
+    static bool push(queue_t &queue, const sample_t &sample);
+    void process();
+    void step(const sample_t &gyro, const float acc[3]);
+
+    ImuFilter *_filter;
+    uint8_t _accId;
+    uint8_t _gyroId;
+    queue_t _acc;
+    queue_t _gyro;
+    sample_t _accPrev;          // newest accelerometer sample at or before the next gyroscope one
+    bool _hasAccPrev;
+    uint64_t _lastGyroNs;
+    bool _started;
+    imu_fusion_stats_t _stats;
+};
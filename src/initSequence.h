@@ -23,6 +23,16 @@ extern const lcd_cmd_t jd9613_cmd[JD9613_INIT_SEQUENCE_LENGTH];
 #define JD9613_WIDTH                            126
 #define JD9613_HEIGHT                           294
 
+// jd9613_cmd as {cmd, param count, param...}, used by the fast boot path
+#define JD9613_INIT_STREAM_SIZE                 816
+extern const uint8_t jd9613_init_stream[JD9613_INIT_STREAM_SIZE];
+
+// Minimum delays of the fast boot path, in milliseconds
+#define JD9613_RESET_PULSE_MS                   1       // RESX low, at least 10us
+#define JD9613_RESET_WAIT_MS                    5       // after RESX, before the first command
+#define JD9613_RESET_SLPOUT_MS                  120     // after RESX in sleep-out, before SLPOUT
+#define JD9613_SLPOUT_WAIT_MS                   5       // after SLPOUT, before the next command
+
 
 
 
@@ -0,0 +1,65 @@
+/**
+ * @file      msgChannel.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "msgChannel.h"
+
+bool msg_channel_init(msg_channel_t *channel, uint32_t item_size, uint32_t capacity, void *(*alloc)(size_t))
+{
+    uint32_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    memset(channel, 0, sizeof(msg_channel_t));
+    channel->buffer = (uint8_t *)alloc(size * item_size);
+    if (!channel->buffer) {
+        return false;
+    }
+    channel->item_size = item_size;
+    channel->mask = size - 1;
+    return true;
+}
+
+void msg_channel_deinit(msg_channel_t *channel)
+{
+    free(channel->buffer);
+    channel->buffer = NULL;
+}
+
+bool msg_channel_push(msg_channel_t *channel, const void *item)
+{
+    uint32_t head = channel->head;
+    uint32_t tail = __atomic_load_n(&channel->tail, __ATOMIC_ACQUIRE);
+    if (head - tail > channel->mask) {
+        channel->dropped++;
+        return false;
+    }
+    memcpy(&channel->buffer[(head & channel->mask) * channel->item_size], item, channel->item_size);
+    // Publish the slot only after its content is written
+    __atomic_store_n(&channel->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool msg_channel_pop(msg_channel_t *channel, void *item)
+{
+    uint32_t tail = channel->tail;
+    uint32_t head = __atomic_load_n(&channel->head, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return false;
+    }
+    memcpy(item, &channel->buffer[(tail & channel->mask) * channel->item_size], channel->item_size);
+    // Release the slot only after its content is read
+    __atomic_store_n(&channel->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t msg_channel_count(const msg_channel_t *channel)
+{
+    return __atomic_load_n(&channel->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&channel->tail, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,39 @@
+/**
+ * @file      msgChannel.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Lock-free ring of fixed size messages between exactly one producer and one consumer,
+ * which may run on different cores. Each side only writes its own index, the other
+ * index is read with acquire ordering, so no lock and no critical section is needed.
+ */
+typedef struct {
+    uint8_t *buffer;
+    uint32_t item_size;
+    uint32_t mask;              // capacity - 1, capacity is a power of two
+    uint32_t head;              // next slot to write, only written by the producer
+    uint32_t tail;              // next slot to read, only written by the consumer
+    uint32_t dropped;           // messages rejected because the ring was full
+} msg_channel_t;
+
+// capacity is rounded up to a power of two
+bool msg_channel_init(msg_channel_t *channel, uint32_t item_size, uint32_t capacity, void *(*alloc)(size_t));
+void msg_channel_deinit(msg_channel_t *channel);
+
+// Producer side, returns false and counts a drop if the ring is full
+bool msg_channel_push(msg_channel_t *channel, const void *item);
+
+// Consumer side, returns false if the ring is empty
+bool msg_channel_pop(msg_channel_t *channel, void *item);
+
+// Messages waiting, exact only when called from one of the two sides
+uint32_t msg_channel_count(const msg_channel_t *channel);
@@ -0,0 +1,122 @@
+/**
+ * @file      orientationProvider.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include "orientationProvider.h"
+
+OrientationProvider::OrientationProvider() : _sensor(NULL), _backend(ORIENTATION_NONE)
+{
+}
+
+bool OrientationProvider::begin(SensorBHI260AP &sensor, orientation_backend_t backend, float rate_hz, ImuFilter *filter)
+{
+    end();
+    _sensor = &sensor;
+    switch (backend) {
+    case ORIENTATION_GAME_RV:
+    case ORIENTATION_RV: {
+        BhySensorID id = backend == ORIENTATION_RV ? SENSOR_ID_RV : SENSOR_ID_GAMERV;
+        _chip.clear();
+        if (!sensor.onResultEvent(id, onQuaternion, this)) {
+            return false;
+        }
+        if (!sensor.configure(id, rate_hz, 0)) {
+            sensor.removeResultEvent(id, onQuaternion, this);
+            return false;
+        }
+        break;
+    }
+    case ORIENTATION_HOST:
+        _fusion.begin(filter ? filter : &_madgwick, SENSOR_ID_ACC_PASS, SENSOR_ID_GYRO_PASS);
+        if (!sensor.onResultEvent(SENSOR_ID_ACC_PASS, ImuFusion::onSample, &_fusion) ||
+                !sensor.onResultEvent(SENSOR_ID_GYRO_PASS, ImuFusion::onSample, &_fusion)) {
+            sensor.removeResultEvent(SENSOR_ID_ACC_PASS, ImuFusion::onSample, &_fusion);
+            return false;
+        }
+        if (!sensor.configure(SENSOR_ID_ACC_PASS, rate_hz, 0) || !sensor.configure(SENSOR_ID_GYRO_PASS, rate_hz, 0)) {
+            sensor.configure(SENSOR_ID_ACC_PASS, 0, 0);
+            sensor.removeResultEvent(SENSOR_ID_ACC_PASS, ImuFusion::onSample, &_fusion);
+            sensor.removeResultEvent(SENSOR_ID_GYRO_PASS, ImuFusion::onSample, &_fusion);
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    _backend = backend;
+    return true;
+}
+
+void OrientationProvider::end()
+{
+    if (!_sensor) {
+        return;
+    }
+    switch (_backend) {
+    case ORIENTATION_GAME_RV:
+    case ORIENTATION_RV: {
+        BhySensorID id = _backend == ORIENTATION_RV ? SENSOR_ID_RV : SENSOR_ID_GAMERV;
+        _sensor->configure(id, 0, 0);
+        _sensor->removeResultEvent(id, onQuaternion, this);
+        break;
+    }
+    case ORIENTATION_HOST:
+        _sensor->configure(SENSOR_ID_ACC_PASS, 0, 0);
+        _sensor->configure(SENSOR_ID_GYRO_PASS, 0, 0);
+        _sensor->removeResultEvent(SENSOR_ID_ACC_PASS, ImuFusion::onSample, &_fusion);
+        _sensor->removeResultEvent(SENSOR_ID_GYRO_PASS, ImuFusion::onSample, &_fusion);
+        break;
+    default:
+        break;
+    }
+    _backend = ORIENTATION_NONE;
+}
+
+orientation_backend_t OrientationProvider::getBackend()
+{
+    return _backend;
+}
+
+// x, y, z, w in Q14 and the heading accuracy
+void OrientationProvider::onQuaternion(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data)
+{
+    (void)sensor_id;
+    OrientationProvider *self = (OrientationProvider *)user_data;
+    if (size < 10) {
+        return;
+    }
+    struct bhy2_data_quaternion quaternion;
+    bhy2_parse_quaternion(data, &quaternion);
+    const float scale = 1.0f / 16384.0f;
+    float q[4] = { quaternion.w * scale, quaternion.x * scale, quaternion.y * scale, quaternion.z * scale };
+    self->_chip.publish(q, timestamp_ns);
+}
+
+ImuOrientation &OrientationProvider::current()
+{
+    return _backend == ORIENTATION_HOST ? (ImuOrientation &)_fusion : _chip;
+}
+
+bool OrientationProvider::getQuaternion(float q[4], uint64_t *timestamp_ns)
+{
+    return current().getQuaternion(q, timestamp_ns);
+}
+
+float OrientationProvider::getRoll()
+{
+    return current().getRoll();
+}
+
+float OrientationProvider::getPitch()
+{
+    return current().getPitch();
+}
+
+float OrientationProvider::getYaw()
+{
+    return current().getYaw();
+}
@@ -0,0 +1,56 @@
+/**
+ * @file      orientationProvider.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <SensorBHI260AP.hpp>
+#include "imuFusion.h"
+
+typedef enum {
+    ORIENTATION_NONE,
+    ORIENTATION_GAME_RV,    // BHI260AP fusion of accelerometer and gyroscope, heading relative to the start
+    ORIENTATION_RV,         // BHI260AP fusion with the magnetometer, heading to the north. Needs one
+    ORIENTATION_HOST,       // ACC_PASS and GYRO_PASS fused on the ESP32 by ImuFusion
+} orientation_backend_t;
+
+/*
+ * One orientation for the UI whichever backend computes it. The on chip backends read a
+ * single quaternion stream and leave the ESP32 only the scaling of four integers, the host
+ * backend reads two raw streams and runs an ImuFilter over every sample. The angles follow
+ * the same convention for all of them, so a switch only changes the source.
+ */
+class OrientationProvider
+{
+public:
+    OrientationProvider();
+
+    /**
+     * @brief  Configure the sensors of backend and stop the ones of the previous backend
+     * @param  sensor: the BHI260AP, samples arrive through its update()
+     * @param  rate_hz: rate of the quaternion, or of both raw sensors
+     * @param  filter: host backend only, Madgwick when NULL. Owned by the caller
+     */
+    bool begin(SensorBHI260AP &sensor, orientation_backend_t backend, float rate_hz, ImuFilter *filter = NULL);
+    void end();
+    orientation_backend_t getBackend();
+
+    bool getQuaternion(float q[4], uint64_t *timestamp_ns = NULL);
+    float getRoll();
+    float getPitch();
+    float getYaw();
+
+private:
+    static void onQuaternion(uint8_t sensor_id, uint8_t *data, uint32_t size, uint64_t timestamp_ns, void *user_data);
+    ImuOrientation &current();
+
+    SensorBHI260AP *_sensor;
+    orientation_backend_t _backend;
+    ImuOrientation _chip;
+    ImuFusion _fusion;
+    MadgwickFilter _madgwick;
+};
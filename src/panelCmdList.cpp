@@ -0,0 +1,44 @@
+/**
+ * @file      panelCmdList.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <string.h>
+#include "panelCmdList.h"
+
+#define PANEL_CMD_CASET     0x2A
+#define PANEL_CMD_RASET     0x2B
+
+void panel_cmd_list_clear(panel_cmd_list_t *list)
+{
+    list->count = 0;
+}
+
+bool panel_cmd_list_add(panel_cmd_list_t *list, uint8_t cmd, const void *param, uint8_t len)
+{
+    if (list->count >= PANEL_CMD_LIST_SIZE || len > PANEL_CMD_PARAM_MAX) {
+        return false;
+    }
+    panel_cmd_t *entry = &list->cmds[list->count++];
+    entry->cmd = cmd;
+    entry->len = len;
+    if (len) {
+        memcpy(entry->param, param, len);
+    }
+    return true;
+}
+
+bool panel_cmd_list_add_window(panel_cmd_list_t *list, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end)
+{
+    uint8_t caset[] = {(uint8_t)(x_start >> 8), (uint8_t)x_start, (uint8_t)((x_end - 1) >> 8), (uint8_t)(x_end - 1)};
+    uint8_t raset[] = {(uint8_t)(y_start >> 8), (uint8_t)y_start, (uint8_t)((y_end - 1) >> 8), (uint8_t)(y_end - 1)};
+    if (list->count + 2 > PANEL_CMD_LIST_SIZE) {
+        return false;
+    }
+    panel_cmd_list_add(list, PANEL_CMD_CASET, caset, sizeof(caset));
+    panel_cmd_list_add(list, PANEL_CMD_RASET, raset, sizeof(raset));
+    return true;
+}
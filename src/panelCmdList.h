@@ -0,0 +1,65 @@
+/**
+ * @file      panelCmdList.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Commands recorded per list, a window plus a few register writes
+#ifndef PANEL_CMD_LIST_SIZE
+#define PANEL_CMD_LIST_SIZE         8
+#endif
+
+// Parameters are stored inside the SPI transaction descriptor, which holds four bytes
+#define PANEL_CMD_PARAM_MAX         4
+
+typedef struct {
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t param[PANEL_CMD_PARAM_MAX];
+} panel_cmd_t;
+
+typedef struct {
+    panel_cmd_t cmds[PANEL_CMD_LIST_SIZE];
+    uint8_t count;
+} panel_cmd_list_t;
+
+typedef struct {
+    uint32_t submits;           // command lists submitted
+    uint32_t commands;          // commands sent, including RAMWR
+    uint32_t transactions;      // SPI transactions, command bytes, parameter blocks and pixel chunks
+    uint32_t waits;             // times the CPU blocked until the bus was idle
+    uint64_t color_bytes;       // pixel bytes sent
+} panel_io_stats_t;
+
+typedef struct panel_cmd_io_t panel_cmd_io_t;
+
+/*
+ * Transport for command lists, implemented by the SPI panel IO on the device
+ * and by the mock IO on the host.
+ */
+struct panel_cmd_io_t {
+    // Send the commands, then RAMWR with color when color_size is not 0.
+    // When notify is set the transfer-done callback is invoked after the last pixel.
+    bool (*tx_list)(panel_cmd_io_t *io, const panel_cmd_list_t *list, const void *color, size_t color_size, bool notify);
+    // Send a stream of {cmd, param count, param...} entries without waiting.
+    // The stream is read by DMA, it must stay valid until wait() returns.
+    bool (*tx_stream)(panel_cmd_io_t *io, const uint8_t *stream, size_t size);
+    // Block until everything submitted so far has been sent
+    void (*wait)(panel_cmd_io_t *io);
+    panel_io_stats_t stats;
+};
+
+void panel_cmd_list_clear(panel_cmd_list_t *list);
+
+// Returns false if the list is full or the parameters do not fit
+bool panel_cmd_list_add(panel_cmd_list_t *list, uint8_t cmd, const void *param, uint8_t len);
+
+// CASET and RASET for a window, x_end and y_end are exclusive
+bool panel_cmd_list_add_window(panel_cmd_list_t *list, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end);
@@ -0,0 +1,186 @@
+/**
+ * @file      panelFlush.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-17
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "panelFlush.h"
+#include "initSequence.h"
+#include "swRotation.h"
+#include "colorPack.h"
+
+void panel_flush_init(panel_flush_t *flush, panel_cmd_io_t *io, uint16_t *frame_buffer, uint8_t bits_per_pixel, bool sw_rotation)
+{
+    memset(flush, 0, sizeof(panel_flush_t));
+    flush->io = io;
+    flush->frame_buffer = frame_buffer;
+    flush->bits_per_pixel = bits_per_pixel;
+    flush->sw_rotation = sw_rotation;
+}
+
+void panel_flush_set_rotation(panel_flush_t *flush, uint8_t rotation)
+{
+    flush->rotation = rotation;
+    if (flush->delta) {
+        scanline_delta_invalidate(flush->delta);
+    }
+}
+
+bool panel_flush_set_delta(panel_flush_t *flush, bool enable, void *(*dma_alloc)(size_t), void *(*alloc)(size_t))
+{
+    if (!enable) {
+        if (flush->delta) {
+            scanline_delta_deinit(flush->delta);
+        }
+        free(flush->delta);
+        free(flush->spans);
+        free(flush->delta_buffer);
+        flush->delta = NULL;
+        flush->spans = NULL;
+        flush->delta_buffer = NULL;
+        return true;
+    }
+
+    if (flush->delta) {
+        return true;
+    }
+
+    scanline_delta_t *delta = (scanline_delta_t *)calloc(1, sizeof(scanline_delta_t));
+    flush->spans = (scanline_span_t *)malloc(JD9613_DELTA_MAX_SPANS * sizeof(scanline_span_t));
+    flush->delta_buffer = (uint16_t *)dma_alloc(JD9613_WIDTH * JD9613_HEIGHT * sizeof(uint16_t));
+    if (!delta || !flush->spans || !flush->delta_buffer ||
+            !scanline_delta_init(delta, JD9613_WIDTH, JD9613_HEIGHT, alloc)) {
+        free(delta);
+        panel_flush_set_delta(flush, false, dma_alloc, alloc);
+        return false;
+    }
+    flush->delta = delta;
+    return true;
+}
+
+// x_end and y_end are exclusive
+static void panel_flush_add_window(panel_flush_t *flush, panel_cmd_list_t *list, uint32_t x_start, uint32_t y_start, uint32_t x_end, uint32_t y_end)
+{
+    // Direction 2 requires offset pixels
+    if (flush->rotation == 2) {
+        x_start += 2;
+        x_end += 2;
+    }
+    panel_cmd_list_add_window(list, x_start, y_start, x_end, y_end);
+}
+
+// Convert RGB565 to RGB444, in place when the pixels already are in a driver buffer
+static const void *panel_flush_pack(panel_flush_t *flush, const void *color, size_t *color_size)
+{
+    const size_t buffer_size = JD9613_WIDTH * JD9613_HEIGHT * sizeof(uint16_t);
+    const uint8_t *src = (const uint8_t *)color;
+    const uint8_t *fb = (const uint8_t *)flush->frame_buffer;
+    const uint8_t *db = (const uint8_t *)flush->delta_buffer;
+    uint8_t *dst = (uint8_t *)flush->frame_buffer;
+
+    if ((src >= fb && src < fb + buffer_size) || (db && src >= db && src < db + buffer_size)) {
+        dst = (uint8_t *)color;
+    } else {
+        // The frame buffer may still be read by the previous transfer
+        panel_flush_wait(flush);
+        if (*color_size > buffer_size) {
+            *color_size = buffer_size;
+        }
+    }
+    *color_size = color_pack_rgb444(dst, (const uint16_t *)color, *color_size / sizeof(uint16_t));
+    return dst;
+}
+
+void panel_flush_submit(panel_flush_t *flush, const panel_cmd_list_t *list, const void *color, size_t color_size, bool notify)
+{
+    if (color_size && flush->bits_per_pixel == 12) {
+        color = panel_flush_pack(flush, color, &color_size);
+    }
+    flush->io->tx_list(flush->io, list, color, color_size, notify);
+}
+
+void panel_flush_wait(panel_flush_t *flush)
+{
+    flush->io->wait(flush->io);
+}
+
+// Only the spans that differ from the last transmitted content are sent, each in its own window
+static void panel_flush_draw_delta(panel_flush_t *flush, uint32_t xs, uint32_t ys, uint32_t xe, uint32_t ye, const uint16_t *pixels)
+{
+    panel_cmd_list_t list;
+    uint32_t width = xe - xs;
+    uint32_t height = ye - ys;
+
+    int32_t count = scanline_delta_encode(flush->delta, xs, ys, width, height, pixels, flush->spans, JD9613_DELTA_MAX_SPANS);
+    if (count == 0) {
+        flush->transmitted = false;
+        return;
+    }
+
+    if (count < 0) {
+        panel_cmd_list_clear(&list);
+        panel_flush_add_window(flush, &list, xs, ys, xe, ye);
+        panel_flush_submit(flush, &list, pixels, width * height * sizeof(uint16_t), true);
+        return;
+    }
+
+    uint16_t *dst = flush->delta_buffer;
+    for (int32_t i = 0; i < count; i++) {
+        const scanline_span_t *span = &flush->spans[i];
+        uint32_t pixel_count = scanline_delta_pack(span, xs, ys, width, pixels, dst);
+        panel_cmd_list_clear(&list);
+        panel_flush_add_window(flush, &list, span->x, span->y, span->x + span->width, span->y + 2);
+        // Only the last span completes the flush
+        panel_flush_submit(flush, &list, dst, pixel_count * sizeof(uint16_t), i == count - 1);
+        dst += pixel_count;
+    }
+}
+
+void panel_flush_draw(panel_flush_t *flush, uint32_t x_start, uint32_t y_start, uint32_t x_end, uint32_t y_end, const uint16_t *color)
+{
+    assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
+
+    // The area may be any sub-rectangle of the frame
+    uint32_t width = x_end - x_start;
+    uint32_t height = y_end - y_start;
+    uint32_t _x = x_start,
+             _y = y_start,
+             _xe = x_end,
+             _ye = y_end;
+    const uint16_t *data_ptr = color;
+    bool sw_rotation = flush->sw_rotation && (flush->rotation == 1 || flush->rotation == 3);
+
+    // Logical (x, y) maps to panel column (JD9613_WIDTH - 1 - y) and panel row x
+    if (sw_rotation) {
+        _x = JD9613_WIDTH - y_end;
+        _y = x_start;
+        _xe = _x + height;
+        _ye = _y + width;
+    }
+
+    flush->transmitted = true;
+
+    // The driver buffers may still be read by the previous transfer
+    if (flush->delta || sw_rotation) {
+        panel_flush_wait(flush);
+    }
+    if (sw_rotation) {
+        sw_rotation_copy(flush->frame_buffer, color, width, height, SW_ROTATION_90);
+        data_ptr = flush->frame_buffer;
+    }
+
+    if (flush->delta) {
+        panel_flush_draw_delta(flush, _x, _y, _xe, _ye, data_ptr);
+        return;
+    }
+
+    panel_cmd_list_t list;
+    panel_cmd_list_clear(&list);
+    panel_flush_add_window(flush, &list, _x, _y, _xe, _ye);
+    panel_flush_submit(flush, &list, data_ptr, width * height * sizeof(uint16_t), true);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file      panelFlush.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-17
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "panelCmdList.h"
+#include "scanlineDelta.h"
+
+// Most changed spans sent for one area, an area with more is sent whole
+#ifndef JD9613_DELTA_MAX_SPANS
+#define JD9613_DELTA_MAX_SPANS      256
+#endif
+
+/*
+ * Flush path of the JD9613 driver: software rotation, changed span encoding and RGB444
+ * packing, sent as command lists through a panel_cmd_io_t. It has no ESP-IDF dependency,
+ * the device driver runs it on the SPI panel IO and the host display on the mock IO.
+ */
+typedef struct {
+    panel_cmd_io_t *io;
+    uint8_t rotation;
+    bool sw_rotation;           // rotation 1 and 3 are turned by the CPU, the panel RAM cannot swap axes
+    uint8_t bits_per_pixel;     // interface format, 16 (RGB565) or 12 (RGB444)
+    bool transmitted;           // the last draw sent pixels, a transfer-done callback follows
+    uint16_t *frame_buffer;     // JD9613_WIDTH * JD9613_HEIGHT pixels the DMA can read
+    scanline_delta_t *delta;
+    scanline_span_t *spans;
+    uint16_t *delta_buffer;
+} panel_flush_t;
+
+void panel_flush_init(panel_flush_t *flush, panel_cmd_io_t *io, uint16_t *frame_buffer, uint8_t bits_per_pixel, bool sw_rotation);
+
+// The address mapping changed, the delta shadow no longer matches the panel memory
+void panel_flush_set_rotation(panel_flush_t *flush, uint8_t rotation);
+
+/**
+ * @brief  Send only the spans that differ from the last transmitted content
+ * @param  dma_alloc: allocates the span buffer the transfers read
+ * @param  alloc: allocates the shadow of the panel memory
+ */
+bool panel_flush_set_delta(panel_flush_t *flush, bool enable, void *(*dma_alloc)(size_t), void *(*alloc)(size_t));
+
+/**
+ * @brief  Send an area of the frame
+ * @param  x_start, y_start, x_end, y_end: area in the coordinates of the rotation,
+ *         x_end and y_end are exclusive. Panel windows must start on an even column and row
+ * @param  color: RGB565 pixels in panel byte order, row major with a stride of the area width
+ */
+void panel_flush_draw(panel_flush_t *flush, uint32_t x_start, uint32_t y_start, uint32_t x_end, uint32_t y_end, const uint16_t *color);
+
+// Send the commands and then the pixels, packed to the interface format
+void panel_flush_submit(panel_flush_t *flush, const panel_cmd_list_t *list, const void *color, size_t color_size, bool notify);
+
+// Wait until the frame and delta buffers are no longer read by a transfer
+void panel_flush_wait(panel_flush_t *flush);
@@ -0,0 +1,148 @@
+/**
+ * @file      panelIOMock.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <string.h>
+#include "panelIOMock.h"
+
+#define PANEL_CMD_CASET     0x2A
+#define PANEL_CMD_RASET     0x2B
+#define PANEL_CMD_RAMWR     0x2C
+
+static void panel_io_mock_wait(panel_cmd_io_t *io)
+{
+    panel_io_mock_t *mock = (panel_io_mock_t *)io;
+    if (mock->inflight) {
+        io->stats.waits++;
+        mock->inflight = 0;
+    }
+}
+
+static void panel_io_mock_tx_cmd(panel_io_mock_t *mock, uint8_t cmd, size_t param_size)
+{
+    panel_io_stats_t *stats = &mock->base.stats;
+    uint32_t transactions = param_size ? 2 : 1;
+    if (!mock->batched) {
+        panel_io_mock_wait(&mock->base);
+        stats->waits += transactions;
+    } else {
+        mock->inflight += transactions;
+    }
+    stats->transactions += transactions;
+    stats->commands++;
+    mock->last_cmd = cmd;
+}
+
+static void panel_io_mock_param(panel_io_mock_t *mock, const panel_cmd_t *cmd)
+{
+    if (cmd->cmd == PANEL_CMD_CASET && cmd->len == 4) {
+        memcpy(mock->caset, cmd->param, 4);
+        mock->windows++;
+    } else if (cmd->cmd == PANEL_CMD_RASET && cmd->len == 4) {
+        memcpy(mock->raset, cmd->param, 4);
+    }
+}
+
+// Pixels fill the window row by row from its start and wrap around at its end, like RAMWR
+static void panel_io_mock_write(panel_io_mock_t *mock, const uint8_t *color, size_t color_size)
+{
+    uint32_t xs = (mock->caset[0] << 8) | mock->caset[1];
+    uint32_t xe = (mock->caset[2] << 8) | mock->caset[3];
+    uint32_t ys = (mock->raset[0] << 8) | mock->raset[1];
+    uint32_t ye = (mock->raset[2] << 8) | mock->raset[3];
+    uint32_t count = mock->bits_per_pixel == 12 ? color_size * 2 / 3 : color_size / 2;
+    uint32_t x = xs, y = ys;
+
+    if (xe < xs || ye < ys) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t value;
+        if (mock->bits_per_pixel == 12) {
+            const uint8_t *p = color + (i / 2) * 3;
+            uint32_t c = (i & 1) ? ((p[1] & 0x0F) << 8) | p[2] : (p[0] << 4) | (p[1] >> 4);
+            uint32_t r = (c >> 8) & 0x0F, g = (c >> 4) & 0x0F, b = c & 0x0F;
+            uint16_t rgb565 = ((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3);
+            value = (rgb565 >> 8) | (rgb565 << 8);
+        } else {
+            memcpy(&value, color + i * 2, 2);
+        }
+        if (x < mock->memory_width && y < mock->memory_height) {
+            mock->memory[y * mock->memory_width + x] = value;
+        }
+        if (++x > xe) {
+            x = xs;
+            if (++y > ye) {
+                y = ys;
+            }
+        }
+    }
+}
+
+static bool panel_io_mock_tx_list(panel_cmd_io_t *io, const panel_cmd_list_t *list, const void *color, size_t color_size, bool notify)
+{
+    panel_io_mock_t *mock = (panel_io_mock_t *)io;
+    io->stats.submits++;
+    for (uint8_t i = 0; i < list->count; i++) {
+        panel_io_mock_tx_cmd(mock, list->cmds[i].cmd, list->cmds[i].len);
+        panel_io_mock_param(mock, &list->cmds[i]);
+    }
+    if (color_size) {
+        uint32_t chunks = (color_size + mock->max_transfer - 1) / mock->max_transfer;
+        // The RAMWR command byte itself is a polling transaction in esp_lcd
+        panel_io_mock_tx_cmd(mock, PANEL_CMD_RAMWR, 0);
+        io->stats.transactions += chunks;
+        io->stats.color_bytes += color_size;
+        mock->inflight += chunks;
+        if (mock->memory) {
+            panel_io_mock_write(mock, (const uint8_t *)color, color_size);
+        }
+        if (notify) {
+            mock->notifies++;
+        }
+    }
+    return true;
+}
+
+static bool panel_io_mock_tx_stream(panel_cmd_io_t *io, const uint8_t *stream, size_t size)
+{
+    panel_io_mock_t *mock = (panel_io_mock_t *)io;
+    size_t pos = 0;
+    io->stats.submits++;
+    while (pos + 2 <= size) {
+        panel_io_mock_tx_cmd(mock, stream[pos], stream[pos + 1]);
+        pos += 2 + stream[pos + 1];
+    }
+    return pos == size;
+}
+
+void panel_io_mock_init(panel_io_mock_t *mock, bool batched, uint32_t max_transfer)
+{
+    memset(mock, 0, sizeof(panel_io_mock_t));
+    mock->base.tx_list = panel_io_mock_tx_list;
+    mock->base.tx_stream = panel_io_mock_tx_stream;
+    mock->base.wait = panel_io_mock_wait;
+    mock->batched = batched;
+    mock->max_transfer = max_transfer ? max_transfer : 4096;
+}
+
+void panel_io_mock_tx_param(panel_io_mock_t *mock, uint8_t cmd, size_t param_size)
+{
+    bool batched = mock->batched;
+    // A polling command is blocking on both transports
+    mock->batched = false;
+    panel_io_mock_tx_cmd(mock, cmd, param_size);
+    mock->batched = batched;
+}
+
+void panel_io_mock_attach_memory(panel_io_mock_t *mock, uint16_t *memory, uint16_t width, uint16_t height, uint8_t bits_per_pixel)
+{
+    mock->memory = memory;
+    mock->memory_width = width;
+    mock->memory_height = height;
+    mock->bits_per_pixel = bits_per_pixel;
+}
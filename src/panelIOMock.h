@@ -0,0 +1,42 @@
+/**
+ * @file      panelIOMock.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include "panelCmdList.h"
+
+/*
+ * Command list transport that counts what would go over the bus, for measuring
+ * the panel driver on the host. With batched cleared it models the esp_lcd SPI IO,
+ * where every command and parameter block is a polling transaction that first waits
+ * for the queued pixels. With batched set it models panel_io_spi, where everything is queued.
+ * With a memory attached, RAMWR writes the pixels into it like the panel RAM.
+ */
+typedef struct {
+    panel_cmd_io_t base;
+    bool batched;
+    uint32_t max_transfer;      // pixel chunk size in bytes
+    uint32_t inflight;          // queued transactions not waited for
+    uint8_t last_cmd;
+    uint8_t caset[4];           // parameters of the last CASET and RASET
+    uint8_t raset[4];
+    uint32_t windows;           // CASET and RASET pairs received
+    uint32_t notifies;          // transfer-done callbacks the IO would invoke
+    uint16_t *memory;           // RGB565 in panel byte order, NULL to only count
+    uint16_t memory_width;
+    uint16_t memory_height;
+    uint8_t bits_per_pixel;     // format of the pixels sent, 16 or 12
+} panel_io_mock_t;
+
+void panel_io_mock_init(panel_io_mock_t *mock, bool batched, uint32_t max_transfer);
+
+// Keep the pixels sent, 12-bit pixels are stored with every channel widened back to RGB565
+void panel_io_mock_attach_memory(panel_io_mock_t *mock, uint16_t *memory, uint16_t width, uint16_t height, uint8_t bits_per_pixel);
+
+// Single blocking command, as sent by esp_lcd_panel_io_tx_param
+void panel_io_mock_tx_param(panel_io_mock_t *mock, uint8_t cmd, size_t param_size);
@@ -0,0 +1,269 @@
+/**
+ * @file      panelIOSpi.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <sys/cdefs.h>
+#include <stdlib.h>
+#include <string.h>
+#include <esp_lcd_panel_io_interface.h>
+#include <esp_lcd_panel_commands.h>
+#include <esp_heap_caps.h>
+#include <esp_check.h>
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include "panelIOSpi.h"
+
+#define TAG  "panel_io_spi"
+
+typedef struct {
+    spi_transaction_t base;
+    uint8_t dc_level;
+    bool notify;
+} panel_io_trans_t;
+
+typedef struct {
+    esp_lcd_panel_io_t base;
+    panel_cmd_io_t cmd_io;
+    spi_device_handle_t dev;
+    int dc_gpio_num;
+    size_t max_transfer_sz;
+    size_t queue_size;
+    size_t inflight;            // queued transactions whose result was not collected
+    size_t next;                // next descriptor of the pool, reused in queue order
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+    panel_io_trans_t *trans_pool;
+} panel_io_spi_t;
+
+static void IRAM_ATTR panel_io_spi_pre_trans_cb(spi_transaction_t *trans)
+{
+    panel_io_spi_t *io = (panel_io_spi_t *)trans->user;
+    panel_io_trans_t *t = __containerof(trans, panel_io_trans_t, base);
+    gpio_set_level((gpio_num_t)io->dc_gpio_num, t->dc_level);
+}
+
+static void IRAM_ATTR panel_io_spi_post_trans_cb(spi_transaction_t *trans)
+{
+    panel_io_spi_t *io = (panel_io_spi_t *)trans->user;
+    panel_io_trans_t *t = __containerof(trans, panel_io_trans_t, base);
+    if (t->notify && io->on_color_trans_done) {
+        io->on_color_trans_done(&io->base, NULL, io->user_ctx);
+    }
+}
+
+static void panel_io_spi_drain(panel_io_spi_t *io)
+{
+    spi_transaction_t *done;
+    if (io->inflight) {
+        io->cmd_io.stats.waits++;
+    }
+    while (io->inflight) {
+        spi_device_get_trans_result(io->dev, &done, portMAX_DELAY);
+        io->inflight--;
+    }
+}
+
+static panel_io_trans_t *panel_io_spi_get_trans(panel_io_spi_t *io)
+{
+    spi_transaction_t *done;
+    // The oldest descriptor is still owned by the driver
+    if (io->inflight == io->queue_size) {
+        spi_device_get_trans_result(io->dev, &done, portMAX_DELAY);
+        io->inflight--;
+    }
+    panel_io_trans_t *t = &io->trans_pool[io->next];
+    io->next = (io->next + 1) % io->queue_size;
+    memset(t, 0, sizeof(panel_io_trans_t));
+    t->base.user = io;
+    return t;
+}
+
+static esp_err_t panel_io_spi_queue(panel_io_spi_t *io, uint8_t dc_level, const void *data, size_t size, bool notify)
+{
+    panel_io_trans_t *t = panel_io_spi_get_trans(io);
+    t->dc_level = dc_level;
+    t->notify = notify;
+    t->base.length = size * 8;
+    // Short transfers are copied into the descriptor, the caller may reuse its buffer at once
+    if (size <= sizeof(t->base.tx_data)) {
+        t->base.flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t->base.tx_data, data, size);
+    } else {
+        t->base.tx_buffer = data;
+    }
+    esp_err_t ret = spi_device_queue_trans(io->dev, &t->base, portMAX_DELAY);
+    if (ret == ESP_OK) {
+        io->inflight++;
+        io->cmd_io.stats.transactions++;
+    }
+    return ret;
+}
+
+static esp_err_t panel_io_spi_polling(panel_io_spi_t *io, uint8_t dc_level, const void *data, size_t size)
+{
+    panel_io_trans_t t;
+    memset(&t, 0, sizeof(panel_io_trans_t));
+    t.base.user = io;
+    t.base.length = size * 8;
+    t.base.tx_buffer = data;
+    t.dc_level = dc_level;
+    io->cmd_io.stats.transactions++;
+    io->cmd_io.stats.waits++;
+    return spi_device_polling_transmit(io->dev, &t.base);
+}
+
+static esp_err_t panel_io_spi_queue_color(panel_io_spi_t *io, uint8_t cmd, const void *color, size_t color_size, bool notify)
+{
+    esp_err_t ret = panel_io_spi_queue(io, 0, &cmd, 1, false);
+    io->cmd_io.stats.commands++;
+    io->cmd_io.stats.color_bytes += color_size;
+
+    const uint8_t *ptr = (const uint8_t *)color;
+    while (ret == ESP_OK && color_size) {
+        size_t chunk = color_size > io->max_transfer_sz ? io->max_transfer_sz : color_size;
+        color_size -= chunk;
+        ret = panel_io_spi_queue(io, 1, ptr, chunk, notify && color_size == 0);
+        ptr += chunk;
+    }
+    return ret;
+}
+
+static esp_err_t panel_io_spi_tx_param(esp_lcd_panel_io_t *panel_io, int lcd_cmd, const void *param, size_t param_size)
+{
+    panel_io_spi_t *io = __containerof(panel_io, panel_io_spi_t, base);
+    esp_err_t ret = ESP_OK;
+
+    panel_io_spi_drain(io);
+    if (lcd_cmd >= 0) {
+        uint8_t cmd = lcd_cmd;
+        ret = panel_io_spi_polling(io, 0, &cmd, 1);
+        io->cmd_io.stats.commands++;
+    }
+    if (ret == ESP_OK && param && param_size) {
+        ret = panel_io_spi_polling(io, 1, param, param_size);
+    }
+    return ret;
+}
+
+static esp_err_t panel_io_spi_tx_color(esp_lcd_panel_io_t *panel_io, int lcd_cmd, const void *color, size_t color_size)
+{
+    panel_io_spi_t *io = __containerof(panel_io, panel_io_spi_t, base);
+    return panel_io_spi_queue_color(io, lcd_cmd, color, color_size, true);
+}
+
+static esp_err_t panel_io_spi_del(esp_lcd_panel_io_t *panel_io)
+{
+    panel_io_spi_t *io = __containerof(panel_io, panel_io_spi_t, base);
+    panel_io_spi_drain(io);
+    spi_bus_remove_device(io->dev);
+    free(io->trans_pool);
+    free(io);
+    return ESP_OK;
+}
+
+static bool panel_io_spi_tx_list(panel_cmd_io_t *cmd_io, const panel_cmd_list_t *list, const void *color, size_t color_size, bool notify)
+{
+    panel_io_spi_t *io = __containerof(cmd_io, panel_io_spi_t, cmd_io);
+    esp_err_t ret = ESP_OK;
+
+    cmd_io->stats.submits++;
+    for (uint8_t i = 0; i < list->count && ret == ESP_OK; i++) {
+        const panel_cmd_t *cmd = &list->cmds[i];
+        ret = panel_io_spi_queue(io, 0, &cmd->cmd, 1, false);
+        if (ret == ESP_OK && cmd->len) {
+            ret = panel_io_spi_queue(io, 1, cmd->param, cmd->len, false);
+        }
+        cmd_io->stats.commands++;
+    }
+    if (ret == ESP_OK && color_size) {
+        ret = panel_io_spi_queue_color(io, LCD_CMD_RAMWR, color, color_size, notify);
+    }
+    return ret == ESP_OK;
+}
+
+static bool panel_io_spi_tx_stream(panel_cmd_io_t *cmd_io, const uint8_t *stream, size_t size)
+{
+    panel_io_spi_t *io = __containerof(cmd_io, panel_io_spi_t, cmd_io);
+    esp_err_t ret = ESP_OK;
+    size_t pos = 0;
+
+    cmd_io->stats.submits++;
+    while (ret == ESP_OK && pos + 2 <= size) {
+        uint8_t len = stream[pos + 1];
+        ret = panel_io_spi_queue(io, 0, &stream[pos], 1, false);
+        if (ret == ESP_OK && len) {
+            ret = panel_io_spi_queue(io, 1, &stream[pos + 2], len, false);
+        }
+        cmd_io->stats.commands++;
+        pos += 2 + len;
+    }
+    return ret == ESP_OK && pos == size;
+}
+
+static void panel_io_spi_wait(panel_cmd_io_t *cmd_io)
+{
+    panel_io_spi_t *io = __containerof(cmd_io, panel_io_spi_t, cmd_io);
+    panel_io_spi_drain(io);
+}
+
+esp_err_t panel_io_spi_new(spi_host_device_t host, const panel_io_spi_config_t *config, esp_lcd_panel_io_handle_t *ret_io)
+{
+    esp_err_t ret = ESP_OK;
+    panel_io_spi_t *io = NULL;
+    gpio_config_t dc_config;
+    spi_device_interface_config_t devcfg;
+
+    ESP_GOTO_ON_FALSE(config && ret_io && config->trans_queue_depth && config->max_transfer_sz, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+
+    io = (panel_io_spi_t *)heap_caps_calloc(1, sizeof(panel_io_spi_t), MALLOC_CAP_INTERNAL);
+    ESP_GOTO_ON_FALSE(io, ESP_ERR_NO_MEM, err, TAG, "no mem for panel io");
+    // Descriptors carry parameters in tx_data, so they must be DMA capable
+    io->trans_pool = (panel_io_trans_t *)heap_caps_calloc(config->trans_queue_depth, sizeof(panel_io_trans_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    ESP_GOTO_ON_FALSE(io->trans_pool, ESP_ERR_NO_MEM, err, TAG, "no mem for transaction pool");
+
+    memset(&dc_config, 0, sizeof(dc_config));
+    dc_config.pin_bit_mask = 1ULL << config->dc_gpio_num;
+    dc_config.mode = GPIO_MODE_OUTPUT;
+    ESP_GOTO_ON_ERROR(gpio_config(&dc_config), err, TAG, "configure D/C gpio failed");
+
+    memset(&devcfg, 0, sizeof(devcfg));
+    devcfg.flags = SPI_DEVICE_HALFDUPLEX;
+    devcfg.clock_speed_hz = config->pclk_hz;
+    devcfg.mode = config->spi_mode;
+    devcfg.spics_io_num = config->cs_gpio_num;
+    devcfg.queue_size = config->trans_queue_depth;
+    devcfg.pre_cb = panel_io_spi_pre_trans_cb;
+    devcfg.post_cb = panel_io_spi_post_trans_cb;
+    ESP_GOTO_ON_ERROR(spi_bus_add_device(host, &devcfg, &io->dev), err, TAG, "adding spi device to bus failed");
+
+    io->dc_gpio_num = config->dc_gpio_num;
+    io->max_transfer_sz = config->max_transfer_sz;
+    io->queue_size = config->trans_queue_depth;
+    io->on_color_trans_done = config->on_color_trans_done;
+    io->user_ctx = config->user_ctx;
+    io->base.tx_param = panel_io_spi_tx_param;
+    io->base.tx_color = panel_io_spi_tx_color;
+    io->base.del = panel_io_spi_del;
+    io->cmd_io.tx_list = panel_io_spi_tx_list;
+    io->cmd_io.tx_stream = panel_io_spi_tx_stream;
+    io->cmd_io.wait = panel_io_spi_wait;
+
+    *ret_io = &io->base;
+    return ESP_OK;
+
+err:
+    if (io) {
+        free(io->trans_pool);
+        free(io);
+    }
+    return ret;
+}
+
+panel_cmd_io_t *panel_io_spi_get_cmd_io(esp_lcd_panel_io_handle_t io)
+{
+    return &__containerof(io, panel_io_spi_t, base)->cmd_io;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file      panelIOSpi.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <esp_lcd_panel_io.h>
+#include <hal/spi_types.h>
+#include "panelCmdList.h"
+
+typedef struct {
+    int cs_gpio_num;
+    int dc_gpio_num;
+    int spi_mode;
+    uint32_t pclk_hz;
+    size_t trans_queue_depth;   // must hold a window, RAMWR and the first pixel chunk
+    size_t max_transfer_sz;     // same as the bus max_transfer_sz
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+} panel_io_spi_config_t;
+
+/**
+ * @brief  Create an SPI panel IO that can also queue command lists.
+ * @note   It is used through the esp_lcd_panel_io_* functions like the esp_lcd SPI IO.
+ *         In addition, the command list interface queues every command byte and parameter
+ *         block as its own DMA transaction ahead of the pixels, so the CPU does not wait
+ *         for the bus between the window setup and the pixel transfer.
+ */
+esp_err_t panel_io_spi_new(spi_host_device_t host, const panel_io_spi_config_t *config, esp_lcd_panel_io_handle_t *ret_io);
+
+panel_cmd_io_t *panel_io_spi_get_cmd_io(esp_lcd_panel_io_handle_t io);
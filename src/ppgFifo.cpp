@@ -0,0 +1,397 @@
+/**
+ * @file      ppgFifo.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <string.h>
+#include "ppgFifo.h"
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#endif
+
+#define PPG_REG_INTSTAT1        0x00
+#define PPG_REG_FIFO_DATA       0x07
+#define PPG_REG_FIFO_CONFIG     0x08
+#define PPG_REG_MODE_CONFIG     0x09
+#define PPG_REG_SPO2_CONFIG     0x0A
+#define PPG_REG_MULTI_LED1      0x11
+#define PPG_REG_MULTI_LED2      0x12
+
+#define PPG_INT_A_FULL          0x80
+
+// INT_STATUS1, INT_STATUS2, INT_ENABLE1, INT_ENABLE2, FIFO_WR_PTR, OVF_COUNTER, FIFO_RD_PTR
+#define PPG_HEADER_BYTES        7
+
+static const uint16_t ppg_sample_rates[] = { 50, 100, 200, 400, 800, 1000, 1600, 3200 };
+
+static int64_t IRAM_ATTR host_time_us()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    return esp_timer_get_time();
+#else
+    return micros();
+#endif
+}
+
+// Red only, red and IR, or the slots up to the first disabled one
+static uint8_t active_leds(uint8_t mode, uint8_t slots12, uint8_t slots34)
+{
+    switch (mode & 0x07) {
+    case 2:
+        return 1;
+    case 3:
+        return 2;
+    case 7: {
+        uint8_t slots[4] = {
+            (uint8_t)(slots12 & 0x07), (uint8_t)((slots12 >> 4) & 0x07),
+            (uint8_t)(slots34 & 0x07), (uint8_t)((slots34 >> 4) & 0x07),
+        };
+        uint8_t count = 0;
+        while (count < 4 && slots[count]) {
+            count++;
+        }
+        return count;
+    }
+    default:
+        return 0;
+    }
+}
+
+PpgFifo::PpgFifo() : _sensor(NULL), _wire(NULL), _irqPin(-1), _leds(0), _almostFull(PPG_FIFO_ALMOST_FULL),
+    _periodUs(0), _drainUs(0), _irqPending(false), _irqUs(0), _ring(NULL), _mask(0), _head(0), _tail(0)
+#if defined(ARDUINO_ARCH_ESP32)
+    , _drainTask(NULL), _stopTask(false)
+#endif
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+PpgFifo::~PpgFifo()
+{
+    end();
+}
+
+bool PpgFifo::begin(MAX30105 &sensor, TwoWire &wire, int irq_pin, uint32_t depth, uint8_t almost_full)
+{
+    end();
+    if (almost_full < PPG_FIFO_SENSOR_DEPTH - 15 || almost_full > PPG_FIFO_SENSOR_DEPTH) {
+        log_e("almost_full must be 17 to 32");
+        return false;
+    }
+
+    // The configuration of MAX30105::setup()
+    uint8_t fifo_config = sensor.readRegister8(MAX30105_ADDRESS, PPG_REG_FIFO_CONFIG);
+    uint8_t mode = sensor.readRegister8(MAX30105_ADDRESS, PPG_REG_MODE_CONFIG);
+    uint8_t spo2_config = sensor.readRegister8(MAX30105_ADDRESS, PPG_REG_SPO2_CONFIG);
+    uint8_t leds = active_leds(mode, sensor.readRegister8(MAX30105_ADDRESS, PPG_REG_MULTI_LED1),
+                               sensor.readRegister8(MAX30105_ADDRESS, PPG_REG_MULTI_LED2));
+    if (!leds || leds > 3) {
+        log_e("The sensor is not set up, or uses %u LED slots", leds);
+        return false;
+    }
+    uint8_t average = (fifo_config >> 5) & 0x07;
+    float rate = ppg_sample_rates[(spo2_config >> 2) & 0x07] / (float)(1 << (average > 5 ? 5 : average));
+
+    uint32_t size = 1;
+    while (size < depth) {
+        size <<= 1;
+    }
+    _ring = (ppg_sample_t *)ps_malloc(size * sizeof(ppg_sample_t));
+    if (!_ring) {
+        _ring = (ppg_sample_t *)malloc(size * sizeof(ppg_sample_t));
+    }
+    if (!_ring) {
+        log_e("ring alloc failed!");
+        return false;
+    }
+    _mask = size - 1;
+    _head = _tail = 0;
+    memset(&_stats, 0, sizeof(_stats));
+
+    _sensor = &sensor;
+    _wire = &wire;
+    _irqPin = irq_pin;
+    _leds = leds;
+    _almostFull = almost_full;
+    _periodUs = 1000000.0f / rate;
+
+    // A full FIFO keeps the newest samples, the overflow counter tells how many were lost
+    sensor.setFIFOAlmostFull(PPG_FIFO_SENSOR_DEPTH - almost_full);
+    sensor.enableFIFORollover();
+    sensor.enableAFULL();
+    sensor.clearFIFO();
+    // Releases INT, held low since power up
+    sensor.getINT1();
+
+    _irqPending = false;
+    _drainUs = host_time_us();
+    if (irq_pin >= 0) {
+        pinMode(irq_pin, INPUT_PULLUP);
+        attachInterruptArg(irq_pin, handleISR, this, FALLING);
+    }
+    return true;
+}
+
+void PpgFifo::end()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+    stopDrainTask();
+#endif
+    if (!_sensor) {
+        return;
+    }
+    if (_irqPin >= 0) {
+        detachInterrupt(_irqPin);
+    }
+    _sensor->disableAFULL();
+    _sensor = NULL;
+    free(_ring);
+    _ring = NULL;
+}
+
+uint32_t PpgFifo::update()
+{
+    if (!_sensor) {
+        return 0;
+    }
+#if defined(ARDUINO_ARCH_ESP32)
+    // The drain task owns the FIFO
+    if (_drainTask) {
+        return 0;
+    }
+#endif
+    if (_irqPin >= 0) {
+        // The level check catches an edge lost while interrupts were off
+        if (!_irqPending && digitalRead(_irqPin) != LOW) {
+            return 0;
+        }
+    } else {
+        uint8_t due = _almostFull < PPG_FIFO_SENSOR_DEPTH - PPG_FIFO_TIMER_MARGIN ?
+                      _almostFull : PPG_FIFO_SENSOR_DEPTH - PPG_FIFO_TIMER_MARGIN;
+        if (host_time_us() - _drainUs < (int64_t)(due * _periodUs)) {
+            return 0;
+        }
+    }
+    return drain();
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool PpgFifo::startDrainTask(uint32_t stack_size, UBaseType_t priority, BaseType_t core)
+{
+    if (_drainTask || !_sensor || _irqPin < 0) {
+        return false;
+    }
+    _stopTask = false;
+    TaskHandle_t task = NULL;
+    if (xTaskCreatePinnedToCore(drainTask, "ppg", stack_size, this, priority, &task, core) != pdPASS) {
+        log_e("drain task create failed!");
+        return false;
+    }
+    _drainTask = task;
+    // An interrupt before the task existed raised no notification
+    xTaskNotifyGive(task);
+    return true;
+}
+
+// Lets the task finish its drain, so no transaction is cut off
+void PpgFifo::stopDrainTask()
+{
+    if (!_drainTask) {
+        return;
+    }
+    _stopTask = true;
+    xTaskNotifyGive(_drainTask);
+    while (_drainTask) {
+        delay(1);
+    }
+}
+
+void PpgFifo::drainTask(void *arg)
+{
+    PpgFifo *self = (PpgFifo *)arg;
+    for (;;) {
+        // The timeout only guards against a lost edge
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PPG_FIFO_DRAIN_TASK_TIMEOUT_MS));
+        if (self->_stopTask) {
+            break;
+        }
+        if (self->_irqPending || digitalRead(self->_irqPin) == LOW) {
+            self->drain();
+        }
+    }
+    self->_drainTask = NULL;
+    vTaskDelete(NULL);
+}
+#endif
+
+uint32_t PpgFifo::read(ppg_sample_t *samples, uint32_t max)
+{
+    if (!_ring) {
+        return 0;
+    }
+    uint32_t tail = _tail;
+    uint32_t count = __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - tail;
+    if (count > max) {
+        count = max;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        samples[i] = _ring[(tail + i) & _mask];
+    }
+    __atomic_store_n(&_tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+uint32_t PpgFifo::available() const
+{
+    return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+}
+
+uint32_t PpgFifo::getOverflows() const
+{
+    return _stats.sensor_overflows + _stats.ring_overflows;
+}
+
+void PpgFifo::getStats(ppg_fifo_stats_t &stats) const
+{
+    stats = _stats;
+}
+
+float PpgFifo::getSampleRate() const
+{
+    return _periodUs > 0 ? 1000000.0f / _periodUs : 0;
+}
+
+uint8_t PpgFifo::getLeds() const
+{
+    return _leds;
+}
+
+void IRAM_ATTR PpgFifo::handleISR(void *arg)
+{
+    PpgFifo *self = (PpgFifo *)arg;
+    self->_irqUs = host_time_us();
+    self->_irqPending = true;
+    self->_stats.interrupts++;
+#if defined(ARDUINO_ARCH_ESP32)
+    if (self->_drainTask) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(self->_drainTask, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+#endif
+}
+
+uint32_t PpgFifo::drain()
+{
+    int64_t now = host_time_us();
+    int64_t last = _drainUs;
+    bool edge = _irqPending;
+    int64_t irq_us = _irqUs;
+    // Cleared before reading, an interrupt raised during the drain is kept
+    _irqPending = false;
+    _drainUs = now;
+    _stats.drains++;
+
+    // The status read also releases INT
+    uint8_t header[PPG_HEADER_BYTES];
+    if (!readRegisters(PPG_REG_INTSTAT1, header, sizeof(header))) {
+        _stats.errors++;
+        return 0;
+    }
+    uint8_t ovf = header[5] & 0x1F;
+    uint32_t count = (header[4] - header[6]) & 0x1F;
+    // Equal pointers are a full FIFO once it reached the threshold or lost samples
+    if (!count && (ovf || (header[0] & PPG_INT_A_FULL))) {
+        count = PPG_FIFO_SENSOR_DEPTH;
+    }
+    // A full FIFO keeps losing samples until the first one is read, and the counter stops
+    // at 31. Count the samples that were due since the last drain instead
+    uint32_t lost = ovf;
+    if (count == PPG_FIFO_SENSOR_DEPTH) {
+        int64_t due = (int64_t)((now - last) / _periodUs + 0.5f);
+        if (due > (int64_t)(count + lost)) {
+            lost = due - count;
+        }
+    }
+    _stats.sensor_overflows += lost;
+    if (!count) {
+        return 0;
+    }
+
+    // The interrupt came as almost_full samples were unread, unless samples were lost.
+    // Otherwise the newest sample is on average half a period old
+    int64_t first_us;
+    if (edge && !lost && count >= _almostFull) {
+        first_us = irq_us - (int64_t)((_almostFull - 1) * _periodUs);
+    } else {
+        first_us = now - (int64_t)((count - 0.5f) * _periodUs);
+    }
+
+    _wire->beginTransmission(MAX30105_ADDRESS);
+    _wire->write(PPG_REG_FIFO_DATA);
+    if (_wire->endTransmission(false) != 0) {
+        _stats.errors++;
+        return 0;
+    }
+    // FIFO_DATA keeps its address, so a split burst carries on where the last one ended
+    uint32_t record = _leds * 3;
+    uint32_t burst_max = sizeof(_burst) / record;
+    uint32_t done = 0, added = 0;
+    while (done < count) {
+        uint32_t want = count - done < burst_max ? count - done : burst_max;
+        size_t got = _wire->requestFrom((uint16_t)MAX30105_ADDRESS, (size_t)(want * record));
+        uint32_t whole = _wire->readBytes(_burst, got) / record;
+        added += unpack(_burst, whole, first_us + (int64_t)(done * _periodUs));
+        done += whole;
+        if (whole < want) {
+            _stats.errors++;
+            break;
+        }
+    }
+    return added;
+}
+
+bool PpgFifo::readRegisters(uint8_t reg, uint8_t *data, size_t size)
+{
+    _wire->beginTransmission(MAX30105_ADDRESS);
+    _wire->write(reg);
+    if (_wire->endTransmission(false) != 0) {
+        return false;
+    }
+    if (_wire->requestFrom((uint16_t)MAX30105_ADDRESS, size) != size) {
+        return false;
+    }
+    return _wire->readBytes(data, size) == size;
+}
+
+// Three big endian bytes of 18 bits per LED, in the order of the slots
+uint32_t PpgFifo::unpack(const uint8_t *data, uint32_t count, int64_t first_us)
+{
+    uint32_t head = _head;
+    uint32_t added = 0;
+    for (uint32_t i = 0; i < count; i++, data += _leds * 3) {
+        if (head - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) > _mask) {
+            _stats.ring_overflows++;
+            continue;
+        }
+        uint32_t values[3] = { 0, 0, 0 };
+        for (uint8_t c = 0; c < _leds; c++) {
+            values[c] = (((uint32_t)data[c * 3] << 16) | (data[c * 3 + 1] << 8) | data[c * 3 + 2]) & 0x3FFFF;
+        }
+        ppg_sample_t *sample = &_ring[head & _mask];
+        sample->red = values[0];
+        sample->ir = values[1];
+        sample->green = values[2];
+        sample->timestamp_us = first_us + (int64_t)(i * _periodUs);
+        head++;
+        added++;
+    }
+    __atomic_store_n(&_head, head, __ATOMIC_RELEASE);
+    _stats.samples += added;
+    return added;
+}
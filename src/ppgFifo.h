@@ -0,0 +1,147 @@
+/**
+ * @file      ppgFifo.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <MAX30105.h>
+
+// Samples the FIFO of the MAX3010x holds
+#define PPG_FIFO_SENSOR_DEPTH       32
+
+// Largest read request, a whole FIFO of three LEDs. The Wire buffer must hold it
+#ifndef PPG_FIFO_BURST_BYTES
+#define PPG_FIFO_BURST_BYTES        (PPG_FIFO_SENSOR_DEPTH * 3 * 3)
+#endif
+
+// Samples the ring holds, about five seconds of red and IR at 100 Hz
+#ifndef PPG_FIFO_DEPTH
+#define PPG_FIFO_DEPTH              512
+#endif
+
+// Unread samples that raise the almost full interrupt, leaving the most time to drain
+#ifndef PPG_FIFO_ALMOST_FULL
+#define PPG_FIFO_ALMOST_FULL        17
+#endif
+
+// Without the INT pin, samples of room the timer leaves for a late update()
+#ifndef PPG_FIFO_TIMER_MARGIN
+#define PPG_FIFO_TIMER_MARGIN       8
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+// Drains run at least this often, in case an edge was lost
+#ifndef PPG_FIFO_DRAIN_TASK_TIMEOUT_MS
+#define PPG_FIFO_DRAIN_TASK_TIMEOUT_MS  1000
+#endif
+#endif
+
+typedef struct {
+    uint32_t red;
+    uint32_t ir;                // 0 in red only mode
+    uint32_t green;             // MAX30105 with three LEDs only
+    int64_t timestamp_us;       // esp_timer_get_time() on ESP32, micros() elsewhere
+} ppg_sample_t;
+
+typedef struct {
+    uint32_t samples;           // samples put into the ring
+    uint32_t sensor_overflows;  // samples the sensor FIFO lost before they were read
+    uint32_t ring_overflows;    // samples dropped because the ring was full
+    uint32_t drains;
+    uint32_t interrupts;
+    uint32_t errors;            // reads that returned fewer bytes than asked
+} ppg_fifo_stats_t;
+
+/*
+ * Reads the MAX3010x FIFO in bursts. The almost full interrupt, or without the INT pin the
+ * time almost_full samples take, tells when to read: then the status and the FIFO pointers
+ * come in one read, and all pending samples in one more. Samples are unpacked with their
+ * host time into a lock-free ring for one producer, update() or the drain task, and one
+ * consumer, read(). read() never waits, update() only uses the bus when a drain is due.
+ */
+class PpgFifo
+{
+public:
+    PpgFifo();
+    ~PpgFifo();
+
+    /**
+     * @brief  Start reading a sensor configured by MAX30105::setup(), which the other
+     *         settings come from. Clears the FIFO
+     * @param  wire: the bus of sensor, at I2C_SPEED_FAST. On ESP32 give it a buffer of
+     *         PPG_FIFO_BURST_BYTES with setBufferSize() before begin(), or bursts are split
+     * @param  irq_pin: the INT output of the sensor, -1 to read on a timer instead
+     * @param  depth: samples the ring holds, rounded up to a power of two
+     * @param  almost_full: unread samples that raise the interrupt, 17 to 32
+     */
+    bool begin(MAX30105 &sensor, TwoWire &wire, int irq_pin = -1, uint32_t depth = PPG_FIFO_DEPTH,
+               uint8_t almost_full = PPG_FIFO_ALMOST_FULL);
+    void end();
+
+    /**
+     * @brief  Drain the sensor FIFO if the interrupt fired, or without the pin once
+     *         almost_full samples are due, at most PPG_FIFO_TIMER_MARGIN short of a full
+     *         FIFO. Returns at once otherwise
+     * @retval Samples put into the ring
+     */
+    uint32_t update();
+
+#if defined(ARDUINO_ARCH_ESP32)
+    /**
+     * @brief  Drain from a task that sleeps until the interrupt instead of polling
+     *         update(). Needs the INT pin. Other users of the bus must not leave a
+     *         transaction open across calls
+     */
+    bool startDrainTask(uint32_t stack_size = 3072, UBaseType_t priority = 5, BaseType_t core = tskNO_AFFINITY);
+    void stopDrainTask();
+#endif
+
+    // Copies up to max of the oldest samples, one consumer, never blocks
+    uint32_t read(ppg_sample_t *samples, uint32_t max);
+    uint32_t available() const;
+
+    // Samples lost in the sensor FIFO or dropped by the ring
+    uint32_t getOverflows() const;
+    void getStats(ppg_fifo_stats_t &stats) const;
+
+    // FIFO samples per second after averaging, and LEDs per sample
+    float getSampleRate() const;
+    uint8_t getLeds() const;
+
+private:
+    static void IRAM_ATTR handleISR(void *arg);
+    uint32_t drain();
+    bool readRegisters(uint8_t reg, uint8_t *data, size_t size);
+    uint32_t unpack(const uint8_t *data, uint32_t count, int64_t first_us);
+
+    MAX30105 *_sensor;
+    TwoWire *_wire;
+    int _irqPin;
+    uint8_t _leds;
+    uint8_t _almostFull;
+    float _periodUs;
+    int64_t _drainUs;           // host time of the last drain
+
+    // Set by the interrupt, with the host time the almost full level was reached
+    volatile bool _irqPending;
+    volatile int64_t _irqUs;
+
+    ppg_sample_t *_ring;
+    uint32_t _mask;
+    uint32_t _head;
+    uint32_t _tail;
+    ppg_fifo_stats_t _stats;
+    uint8_t _burst[PPG_FIFO_BURST_BYTES];
+
+#if defined(ARDUINO_ARCH_ESP32)
+    static void drainTask(void *arg);
+    TaskHandle_t volatile _drainTask;
+    volatile bool _stopTask;
+#endif
+};
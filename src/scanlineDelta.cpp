@@ -0,0 +1,173 @@
+/**
+ * @file      scanlineDelta.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "scanlineDelta.h"
+
+bool scanline_delta_init(scanline_delta_t *delta, uint16_t width, uint16_t height, void *(*alloc)(size_t))
+{
+    memset(delta, 0, sizeof(scanline_delta_t));
+    delta->width = width;
+    delta->height = height;
+    delta->transaction_cost = SCANLINE_DELTA_TRANSACTION_COST;
+    delta->shadow = (uint16_t *)alloc(width * height * sizeof(uint16_t));
+    delta->valid_start = (uint16_t *)calloc((height + 1) / 2, sizeof(uint16_t));
+    delta->valid_end = (uint16_t *)calloc((height + 1) / 2, sizeof(uint16_t));
+    if (!delta->shadow || !delta->valid_start || !delta->valid_end) {
+        scanline_delta_deinit(delta);
+        return false;
+    }
+    return true;
+}
+
+void scanline_delta_deinit(scanline_delta_t *delta)
+{
+    free(delta->shadow);
+    free(delta->valid_start);
+    free(delta->valid_end);
+    delta->shadow = NULL;
+    delta->valid_start = NULL;
+    delta->valid_end = NULL;
+}
+
+void scanline_delta_invalidate(scanline_delta_t *delta)
+{
+    memset(delta->valid_start, 0, ((delta->height + 1) / 2) * sizeof(uint16_t));
+    memset(delta->valid_end, 0, ((delta->height + 1) / 2) * sizeof(uint16_t));
+}
+
+static void mark_valid(scanline_delta_t *delta, uint16_t pair, uint16_t start, uint16_t end)
+{
+    uint16_t vs = delta->valid_start[pair];
+    uint16_t ve = delta->valid_end[pair];
+    if (ve > vs) {
+        if (start <= ve && vs <= end) {
+            start = start < vs ? start : vs;
+            end = end > ve ? end : ve;
+        } else if (end - start < ve - vs) {
+            // Disjoint ranges, only one can be tracked
+            return;
+        }
+    }
+    delta->valid_start[pair] = start;
+    delta->valid_end[pair] = end;
+}
+
+static void update_shadow(scanline_delta_t *delta, uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *pixels)
+{
+    for (uint16_t i = 0; i < height; i++) {
+        memcpy(delta->shadow + (y + i) * delta->width + x, pixels + i * width, width * sizeof(uint16_t));
+    }
+}
+
+int32_t scanline_delta_encode(scanline_delta_t *delta, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                              const uint16_t *pixels, scanline_span_t *spans, uint32_t max_spans)
+{
+    const uint32_t window_bytes = width * height * sizeof(uint16_t);
+
+    delta->stats.flushes++;
+    delta->stats.bytes_requested += window_bytes;
+
+    if (x + width > delta->width || y + height > delta->height) {
+        scanline_delta_invalidate(delta);
+        delta->stats.transactions++;
+        delta->stats.bytes_sent += window_bytes;
+        return -1;
+    }
+
+    if ((x | y | width | height) & 1) {
+        // Line pairs only partially written keep their previous valid range
+        update_shadow(delta, x, y, width, height, pixels);
+        for (uint16_t row = (y + 1) & ~1; row + 1 < y + height; row += 2) {
+            mark_valid(delta, row / 2, x, x + width);
+        }
+        delta->stats.transactions++;
+        delta->stats.bytes_sent += window_bytes;
+        return -1;
+    }
+
+    uint32_t count = 0;
+    uint32_t delta_bytes = 0;
+    bool overflow = false;
+
+    for (uint16_t row = 0; row < height; row += 2) {
+        const uint16_t *line0 = pixels + row * width;
+        const uint16_t *line1 = line0 + width;
+        const uint16_t *shadow0 = delta->shadow + (y + row) * delta->width + x;
+        const uint16_t *shadow1 = shadow0 + delta->width;
+        uint16_t pair = (y + row) / 2;
+        uint16_t vs = delta->valid_start[pair];
+        uint16_t ve = delta->valid_end[pair];
+        int32_t span_start = -1;
+        uint16_t span_end = 0;
+
+        for (uint16_t col = 0; col < width; col += 2) {
+            bool changed = (x + col) < vs || (x + col + 2) > ve ||
+                           line0[col] != shadow0[col] || line0[col + 1] != shadow0[col + 1] ||
+                           line1[col] != shadow1[col] || line1[col + 1] != shadow1[col + 1];
+            if (!changed) {
+                continue;
+            }
+            // Close the span when resending the unchanged gap costs more than a new address window
+            if (span_start >= 0 && (uint32_t)(col - span_end) * 2 * sizeof(uint16_t) > delta->transaction_cost) {
+                if (count < max_spans) {
+                    spans[count] = {(uint16_t)(x + span_start), (uint16_t)(y + row), (uint16_t)(span_end - span_start)};
+                } else {
+                    overflow = true;
+                }
+                count++;
+                delta_bytes += (span_end - span_start) * 2 * sizeof(uint16_t);
+                span_start = -1;
+            }
+            if (span_start < 0) {
+                span_start = col;
+            }
+            span_end = col + 2;
+        }
+
+        if (span_start >= 0) {
+            if (count < max_spans) {
+                spans[count] = {(uint16_t)(x + span_start), (uint16_t)(y + row), (uint16_t)(span_end - span_start)};
+            } else {
+                overflow = true;
+            }
+            count++;
+            delta_bytes += (span_end - span_start) * 2 * sizeof(uint16_t);
+        }
+
+        memcpy((uint16_t *)shadow0, line0, width * sizeof(uint16_t));
+        memcpy((uint16_t *)shadow1, line1, width * sizeof(uint16_t));
+        mark_valid(delta, pair, x, x + width);
+    }
+
+    if (count == 0) {
+        delta->stats.skipped_flushes++;
+        return 0;
+    }
+
+    if (overflow || delta_bytes + count * delta->transaction_cost >= window_bytes + delta->transaction_cost) {
+        delta->stats.transactions++;
+        delta->stats.bytes_sent += window_bytes;
+        return -1;
+    }
+
+    delta->stats.delta_flushes++;
+    delta->stats.transactions += count;
+    delta->stats.bytes_sent += delta_bytes;
+    return count;
+}
+
+uint32_t scanline_delta_pack(const scanline_span_t *span, uint16_t x, uint16_t y, uint16_t width,
+                             const uint16_t *pixels, uint16_t *dst)
+{
+    const uint16_t *src = pixels + (span->y - y) * width + (span->x - x);
+    memcpy(dst, src, span->width * sizeof(uint16_t));
+    memcpy(dst + span->width, src + width, span->width * sizeof(uint16_t));
+    return span->width * 2;
+}
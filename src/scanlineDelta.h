@@ -0,0 +1,66 @@
+/**
+ * @file      scanlineDelta.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Cost of one CASET/RASET/RAMWR sequence, expressed in pixel bytes that could be sent in the same time
+#ifndef SCANLINE_DELTA_TRANSACTION_COST
+#define SCANLINE_DELTA_TRANSACTION_COST     128
+#endif
+
+// Spans cover two lines and start on an even column, matching the panel address alignment
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+} scanline_span_t;
+
+typedef struct {
+    uint32_t flushes;           // windows passed to scanline_delta_encode
+    uint32_t delta_flushes;     // windows sent as changed spans
+    uint32_t skipped_flushes;   // windows identical to the shadow, nothing sent
+    uint32_t transactions;      // address windows sent to the panel
+    uint64_t bytes_requested;   // pixel bytes of all windows
+    uint64_t bytes_sent;        // pixel bytes actually sent
+} scanline_delta_stats_t;
+
+typedef struct {
+    uint16_t *shadow;           // last transmitted content, width * height
+    uint16_t *valid_start;      // per line pair, shadow columns known to match the panel
+    uint16_t *valid_end;
+    uint16_t width;
+    uint16_t height;
+    uint32_t transaction_cost;
+    scanline_delta_stats_t stats;
+} scanline_delta_t;
+
+bool scanline_delta_init(scanline_delta_t *delta, uint16_t width, uint16_t height, void *(*alloc)(size_t));
+void scanline_delta_deinit(scanline_delta_t *delta);
+
+// Forget the shadow content, e.g. after the panel addressing mode changed
+void scanline_delta_invalidate(scanline_delta_t *delta);
+
+/**
+ * @brief  Compare a window with the shadow and update the shadow
+ * @param  x, y, width, height: window in panel coordinates
+ * @param  pixels: window content, row major with a stride of width
+ * @param  spans:  receives the changed spans
+ * @param  max_spans: capacity of spans
+ * @retval Number of spans to send, 0 if nothing changed.
+ *         -1 if the whole window should be sent because that is cheaper,
+ *         or because the window is not aligned to line pairs.
+ */
+int32_t scanline_delta_encode(scanline_delta_t *delta, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                              const uint16_t *pixels, scanline_span_t *spans, uint32_t max_spans);
+
+// Copy the two lines of a span into a contiguous buffer, returns the number of pixels written
+uint32_t scanline_delta_pack(const scanline_span_t *span, uint16_t x, uint16_t y, uint16_t width,
+                             const uint16_t *pixels, uint16_t *dst);
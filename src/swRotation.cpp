@@ -0,0 +1,124 @@
+/**
+ * @file      swRotation.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#include <string.h>
+#include "swRotation.h"
+
+static void rotate_pixels(uint16_t *dst, const uint16_t *src, uint32_t width, uint32_t height, uint8_t rotation)
+{
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint16_t color = src[y * width + x];
+            switch (rotation) {
+            case SW_ROTATION_90:
+                dst[x * height + (height - 1 - y)] = color;
+                break;
+            case SW_ROTATION_180:
+                dst[(height - 1 - y) * width + (width - 1 - x)] = color;
+                break;
+            case SW_ROTATION_270:
+                dst[(width - 1 - x) * height + y] = color;
+                break;
+            default:
+                dst[y * width + x] = color;
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * Each step reads a 2x2 pixel block as two words from source rows y and y + 1,
+ * and writes it as two words to the destination rows of columns x and x + 1.
+ */
+static void rotate_90_tiled(uint32_t *dst, const uint32_t *src, uint32_t width, uint32_t height)
+{
+    const uint32_t src_stride = width / 2;
+    const uint32_t dst_stride = height / 2;
+
+    for (uint32_t ty = 0; ty < height; ty += SW_ROTATION_TILE_SIZE) {
+        uint32_t ye = ty + SW_ROTATION_TILE_SIZE < height ? ty + SW_ROTATION_TILE_SIZE : height;
+        for (uint32_t tx = 0; tx < width; tx += SW_ROTATION_TILE_SIZE) {
+            uint32_t xe = tx + SW_ROTATION_TILE_SIZE < width ? tx + SW_ROTATION_TILE_SIZE : width;
+            for (uint32_t y = ty; y < ye; y += 2) {
+                const uint32_t *row0 = src + y * src_stride;
+                const uint32_t *row1 = row0 + src_stride;
+                uint32_t col = (height - 2 - y) / 2;
+                for (uint32_t x = tx; x < xe; x += 2) {
+                    uint32_t a = row0[x / 2];
+                    uint32_t b = row1[x / 2];
+                    dst[x * dst_stride + col] = (b & 0xFFFF) | (a << 16);
+                    dst[(x + 1) * dst_stride + col] = (b >> 16) | (a & 0xFFFF0000);
+                }
+            }
+        }
+    }
+}
+
+static void rotate_270_tiled(uint32_t *dst, const uint32_t *src, uint32_t width, uint32_t height)
+{
+    const uint32_t src_stride = width / 2;
+    const uint32_t dst_stride = height / 2;
+
+    for (uint32_t ty = 0; ty < height; ty += SW_ROTATION_TILE_SIZE) {
+        uint32_t ye = ty + SW_ROTATION_TILE_SIZE < height ? ty + SW_ROTATION_TILE_SIZE : height;
+        for (uint32_t tx = 0; tx < width; tx += SW_ROTATION_TILE_SIZE) {
+            uint32_t xe = tx + SW_ROTATION_TILE_SIZE < width ? tx + SW_ROTATION_TILE_SIZE : width;
+            for (uint32_t y = ty; y < ye; y += 2) {
+                const uint32_t *row0 = src + y * src_stride;
+                const uint32_t *row1 = row0 + src_stride;
+                uint32_t col = y / 2;
+                for (uint32_t x = tx; x < xe; x += 2) {
+                    uint32_t a = row0[x / 2];
+                    uint32_t b = row1[x / 2];
+                    dst[(width - 1 - x) * dst_stride + col] = (a & 0xFFFF) | (b << 16);
+                    dst[(width - 2 - x) * dst_stride + col] = (a >> 16) | (b & 0xFFFF0000);
+                }
+            }
+        }
+    }
+}
+
+static void rotate_180_words(uint32_t *dst, const uint32_t *src, uint32_t width, uint32_t height)
+{
+    const uint32_t words = width * height / 2;
+    for (uint32_t i = 0; i < words; i++) {
+        uint32_t a = src[i];
+        dst[words - 1 - i] = (a >> 16) | (a << 16);
+    }
+}
+
+void sw_rotation_copy(uint16_t *dst, const uint16_t *src, uint32_t width, uint32_t height, uint8_t rotation)
+{
+    if (rotation == SW_ROTATION_0) {
+        memcpy(dst, src, width * height * sizeof(uint16_t));
+        return;
+    }
+
+    bool word_access = ((width | height) & 1) == 0 &&
+                       (((uintptr_t)dst | (uintptr_t)src) & 3) == 0;
+    if (!word_access) {
+        rotate_pixels(dst, src, width, height, rotation);
+        return;
+    }
+
+    switch (rotation) {
+    case SW_ROTATION_90:
+        rotate_90_tiled((uint32_t *)dst, (const uint32_t *)src, width, height);
+        break;
+    case SW_ROTATION_180:
+        rotate_180_words((uint32_t *)dst, (const uint32_t *)src, width, height);
+        break;
+    case SW_ROTATION_270:
+        rotate_270_tiled((uint32_t *)dst, (const uint32_t *)src, width, height);
+        break;
+    default:
+        rotate_pixels(dst, src, width, height, rotation);
+        break;
+    }
+}
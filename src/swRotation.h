@@ -0,0 +1,37 @@
+/**
+ * @file      swRotation.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2026  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2026-10-16
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Side length in pixels of the square tile processed at once, 16x16 RGB565 is 512 bytes
+#ifndef SW_ROTATION_TILE_SIZE
+#define SW_ROTATION_TILE_SIZE       16
+#endif
+
+enum SwRotation {
+    SW_ROTATION_0,
+    SW_ROTATION_90,     // src(x, y) -> dst row x, column (height - 1 - y)
+    SW_ROTATION_180,
+    SW_ROTATION_270,    // src(x, y) -> dst row (width - 1 - x), column y
+};
+
+/**
+ * @brief  Rotate an RGB565 image
+ * @param  dst:    destination, width * height pixels, must not overlap src
+ * @param  src:    source image, row major with a stride of width
+ * @param  width:  source width in pixels
+ * @param  height: source height in pixels
+ * @param  rotation: SwRotation
+ * @note   For 90 and 270 degrees the destination is height pixels wide and width pixels high.
+ *         When both dimensions are even and the buffers are 32-bit aligned, pixels are moved
+ *         two at a time and the image is walked in cache sized tiles, otherwise a per pixel
+ *         loop is used.
+ */
+void sw_rotation_copy(uint16_t *dst, const uint16_t *src, uint32_t width, uint32_t height, uint8_t rotation);